@@ -0,0 +1,128 @@
+/*
+ * Description:
+ * This code benchmarks the throughput of writing and reading ciphertext streams of the PALISADE pke library.
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or other
+ * materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#define _USE_MATH_DEFINES
+#include "benchmark/benchmark.h"
+
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+#include "palisade.h"
+#include "ciphertextstream.h"
+
+using namespace std;
+using namespace lbcrypto;
+
+// number of ciphertexts written or read per iteration
+static const size_t STREAM_BATCH_SIZE = 256;
+
+static const string STREAM_FILE = "CiphertextStream.bench";
+
+// holds a BFVrns context of the given depth and a batch of ciphertexts
+struct StreamBenchmarkSetup {
+	CryptoContext<DCRTPoly> cc;
+	vector<Ciphertext<DCRTPoly>> cts;
+	size_t bytes;
+
+	StreamBenchmarkSetup(usint depth) {
+		cc = CryptoContextFactory<DCRTPoly>::genCryptoContextBFVrns(
+				65537, HEStd_128_classic, 3.2, 0, depth, 0, OPTIMIZED);
+		cc->Enable(ENCRYPTION);
+		cc->Enable(SHE);
+		LPKeyPair<DCRTPoly> kp = cc->KeyGen();
+		for (size_t i = 0; i < STREAM_BATCH_SIZE; i++) {
+			vector<int64_t> row = { int64_t(i), 1, 2, 3 };
+			cts.push_back(cc->Encrypt(kp.publicKey, cc->MakePackedPlaintext(row)));
+		}
+		bytes = Write();
+	}
+
+	~StreamBenchmarkSetup() {
+		std::remove(STREAM_FILE.c_str());
+		CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+	}
+
+	size_t Write() {
+		CiphertextStreamWriter<DCRTPoly> writer(cc, STREAM_FILE);
+		for (const auto& ct : cts)
+			writer.Write(ct);
+		writer.Close();
+		ifstream f(STREAM_FILE, ios::binary | ios::ate);
+		return f.tellg();
+	}
+
+	void Read(size_t prefetch) {
+		CiphertextStreamReader<DCRTPoly> reader(cc, STREAM_FILE, prefetch);
+		Ciphertext<DCRTPoly> ct;
+		while (reader.Read(ct))
+			benchmark::DoNotOptimize(ct);
+	}
+};
+
+static void BM_CiphertextStream_Write(benchmark::State& state) { // benchmark
+	StreamBenchmarkSetup setup(state.range(0));
+
+	while (state.KeepRunning()) {
+		setup.Write();
+	}
+	state.SetItemsProcessed(state.iterations() * STREAM_BATCH_SIZE);
+	state.SetBytesProcessed(state.iterations() * setup.bytes);
+}
+
+// reads on demand, decoding each ciphertext in place
+static void BM_CiphertextStream_Read(benchmark::State& state) { // benchmark
+	StreamBenchmarkSetup setup(state.range(0));
+
+	while (state.KeepRunning()) {
+		setup.Read(0);
+	}
+	state.SetItemsProcessed(state.iterations() * STREAM_BATCH_SIZE);
+	state.SetBytesProcessed(state.iterations() * setup.bytes);
+}
+
+// reads with a background thread keeping eight frames ahead of decoding
+static void BM_CiphertextStream_ReadPrefetch(benchmark::State& state) { // benchmark
+	StreamBenchmarkSetup setup(state.range(0));
+
+	while (state.KeepRunning()) {
+		setup.Read(8);
+	}
+	state.SetItemsProcessed(state.iterations() * STREAM_BATCH_SIZE);
+	state.SetBytesProcessed(state.iterations() * setup.bytes);
+}
+
+#define DO_STREAM_BENCHMARK(X) \
+		BENCHMARK(X)->Unit(benchmark::kMillisecond)->ArgName("depth_1")->Arg(1); \
+		BENCHMARK(X)->Unit(benchmark::kMillisecond)->ArgName("depth_4")->Arg(4);
+
+DO_STREAM_BENCHMARK(BM_CiphertextStream_Write)
+DO_STREAM_BENCHMARK(BM_CiphertextStream_Read)
+DO_STREAM_BENCHMARK(BM_CiphertextStream_ReadPrefetch)
+
+//execute the benchmarks
+BENCHMARK_MAIN();
@@ -0,0 +1,101 @@
+/*
+ * Description:
+ * This code benchmarks context lookups and ciphertext deserialization of the PALISADE pke library as the number of live contexts grows.
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or other
+ * materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#define _USE_MATH_DEFINES
+#include "benchmark/benchmark.h"
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "palisade.h"
+#include "cryptocontext-ser.h"
+#include "ciphertext-ser.h"
+#include "utils/serialize-binary.h"
+
+using namespace std;
+using namespace lbcrypto;
+
+// a BFVrns context and ciphertext, registered alongside other live contexts
+struct RegistryBenchmarkSetup {
+	CryptoContext<DCRTPoly> cc;
+	vector<CryptoContext<DCRTPoly>> others;
+	Ciphertext<DCRTPoly> ct;
+
+	RegistryBenchmarkSetup(size_t liveContexts) {
+		CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+		cc = CryptoContextFactory<DCRTPoly>::genCryptoContextBFVrns(
+				65537, HEStd_128_classic, 3.2, 0, 2, 0, OPTIMIZED);
+		cc->Enable(ENCRYPTION);
+		cc->Enable(SHE);
+		LPKeyPair<DCRTPoly> kp = cc->KeyGen();
+		vector<int64_t> vals = { 1, 2, 3, 4 };
+		ct = cc->Encrypt(kp.publicKey, cc->MakePackedPlaintext(vals));
+
+		// cheap contexts that differ only in their plaintext modulus
+		for (size_t i = 1; i < liveContexts; i++)
+			others.push_back(CryptoContextFactory<DCRTPoly>::genCryptoContextNull(16, 3 + 2*i));
+	}
+
+	~RegistryBenchmarkSetup() {
+		CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+	}
+};
+
+// the lookup every deserialized context goes through
+static void BM_Registry_GetContext(benchmark::State& state) { // benchmark
+	RegistryBenchmarkSetup setup(state.range(0));
+	auto params = setup.cc->GetCryptoParameters();
+	auto scheme = setup.cc->GetEncryptionAlgorithm();
+
+	while (state.KeepRunning()) {
+		benchmark::DoNotOptimize(CryptoContextFactory<DCRTPoly>::GetContext(params, scheme));
+	}
+}
+
+static void BM_Registry_DeserializeCiphertext(benchmark::State& state) { // benchmark
+	RegistryBenchmarkSetup setup(state.range(0));
+	stringstream s;
+	Serial::Serialize(setup.ct, s, SerType::BINARY);
+	const string serialized = s.str();
+
+	while (state.KeepRunning()) {
+		stringstream in(serialized);
+		Ciphertext<DCRTPoly> ct;
+		Serial::Deserialize(ct, in, SerType::BINARY);
+		benchmark::DoNotOptimize(ct);
+	}
+}
+
+#define DO_REGISTRY_BENCHMARK(X) \
+		BENCHMARK(X)->Unit(benchmark::kMicrosecond)->ArgName("contexts")->Arg(1)->Arg(16)->Arg(256);
+
+DO_REGISTRY_BENCHMARK(BM_Registry_GetContext)
+DO_REGISTRY_BENCHMARK(BM_Registry_DeserializeCiphertext)
+
+//execute the benchmarks
+BENCHMARK_MAIN();
@@ -0,0 +1,117 @@
+/*
+ * Description:
+ * This code benchmarks decryption with the PALISADE pke library: BGV and StSt, which reduce [c0 + c1*s]_q mod p in RNS, against BFVrns, and the RNS reduction against the multiprecision CRT interpolation it replaces.
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or other
+ * materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#define _USE_MATH_DEFINES
+#include "benchmark/benchmark.h"
+
+#include <iostream>
+#include <vector>
+
+#include "palisade.h"
+#include "cryptocontext.h"
+#include "cryptocontextgen.h"
+
+using namespace std;
+using namespace lbcrypto;
+
+// every context has ring dimension 8192 and three 60-bit towers
+static const usint ORDER = 16384;
+static const PlaintextModulus PTM = 65537;
+
+static CryptoContext<DCRTPoly> GenBFVrns() {
+	CryptoContext<DCRTPoly> cc = CryptoContextFactory<DCRTPoly>::genCryptoContextBFVrns(
+			PTM, HEStd_128_classic, 3.2, 0, 2, 0, OPTIMIZED);
+	cc->Enable(ENCRYPTION);
+	cc->Enable(SHE);
+	return cc;
+}
+
+static CryptoContext<DCRTPoly> GenBGV() {
+	return GenCryptoContextBGV<DCRTPoly>(ORDER, PTM, 60, 3);
+}
+
+static CryptoContext<DCRTPoly> GenStSt() {
+	return GenCryptoContextStSt<DCRTPoly>(ORDER, PTM, 60, 3);
+}
+
+static void DecryptPacked(benchmark::State& state, CryptoContext<DCRTPoly> (*gen)()) {
+	CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+	CryptoContext<DCRTPoly> cc = gen();
+	LPKeyPair<DCRTPoly> kp = cc->KeyGen();
+
+	vector<int64_t> values;
+	for( usint i = 0; i < cc->GetRingDimension(); i++ )
+		values.push_back(i % 1000);
+	Ciphertext<DCRTPoly> ciphertext = cc->Encrypt(kp.publicKey, cc->MakePackedPlaintext(values));
+
+	Plaintext plaintext;
+	while (state.KeepRunning()) {
+		cc->Decrypt(kp.secretKey, ciphertext, &plaintext);
+	}
+}
+
+static void BM_Decrypt_BFVrns(benchmark::State& state) { // benchmark
+	DecryptPacked(state, GenBFVrns);
+}
+
+static void BM_Decrypt_BGV(benchmark::State& state) { // benchmark
+	DecryptPacked(state, GenBGV);
+}
+
+static void BM_Decrypt_StSt(benchmark::State& state) { // benchmark
+	DecryptPacked(state, GenStSt);
+}
+
+// the reduction step alone, on a uniformly random element
+static void BM_DecryptionCRTInterpolate_RNS(benchmark::State& state) { // benchmark
+	shared_ptr<ILDCRTParams<BigInteger>> params = GenerateDCRTParams<BigInteger>(ORDER, 3, 60);
+	DCRTPoly::DugType dug;
+	DCRTPoly x(dug, params, Format::COEFFICIENT);
+
+	while (state.KeepRunning()) {
+		NativePoly result = x.DecryptionCRTInterpolate(PTM);
+	}
+}
+
+static void BM_DecryptionCRTInterpolate_Multiprecision(benchmark::State& state) { // benchmark
+	shared_ptr<ILDCRTParams<BigInteger>> params = GenerateDCRTParams<BigInteger>(ORDER, 3, 60);
+	DCRTPoly::DugType dug;
+	DCRTPoly x(dug, params, Format::COEFFICIENT);
+
+	while (state.KeepRunning()) {
+		NativePoly result = x.CRTInterpolate().DecryptionCRTInterpolate(PTM);
+	}
+}
+
+BENCHMARK(BM_Decrypt_BFVrns)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Decrypt_BGV)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Decrypt_StSt)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DecryptionCRTInterpolate_RNS)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DecryptionCRTInterpolate_Multiprecision)->Unit(benchmark::kMicrosecond);
+
+//execute the benchmarks
+BENCHMARK_MAIN();
@@ -160,6 +160,46 @@ void BM_encoding_PackedIntPlaintext_SetParams(benchmark::State& state) {
 
 BENCHMARK(BM_encoding_PackedIntPlaintext_SetParams);
 
+static CryptoContext<DCRTPoly> GeneratePackedDCRTContext() {
+	CryptoContext<DCRTPoly> cc = CryptoContextFactory<DCRTPoly>::genCryptoContextBFVrns(
+			65537, HEStd_128_classic, 3.2, 0, 2, 0, OPTIMIZED, 2, 0, 60);
+	cc->Enable(ENCRYPTION);
+	return cc;
+}
+
+static vector<int64_t> MakeSlotValues(const CryptoContext<DCRTPoly> cc, int64_t offset) {
+	vector<int64_t> values(cc->GetRingDimension());
+	for( size_t i = 0; i < values.size(); i++ )
+		values[i] = int64_t((i*131 + offset) % 65537) - 32768;
+	return values;
+}
+
+void BM_encoding_PackedDCRTPoly(benchmark::State& state) {
+	CryptoContext<DCRTPoly> cc = GeneratePackedDCRTContext();
+	vector<int64_t> values = MakeSlotValues(cc, 0);
+
+	while (state.KeepRunning()) {
+		Plaintext plaintext = cc->MakePackedPlaintext(values);
+	}
+}
+
+BENCHMARK(BM_encoding_PackedDCRTPoly)->Unit(benchmark::kMicrosecond);
+
+void BM_encoding_PackedDCRTPoly_Batch(benchmark::State& state) {
+	CryptoContext<DCRTPoly> cc = GeneratePackedDCRTContext();
+	vector<vector<int64_t>> values(state.range(0));
+	for( size_t t = 0; t < values.size(); t++ )
+		values[t] = MakeSlotValues(cc, t);
+
+	while (state.KeepRunning()) {
+		vector<Plaintext> plaintexts = cc->MakePackedPlaintexts(values);
+	}
+
+	state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+BENCHMARK(BM_encoding_PackedDCRTPoly_Batch)->Unit(benchmark::kMillisecond)->Arg(16)->Arg(64);
+
 
 void BM_Encoding_String(benchmark::State& state) { // benchmark
 	CryptoContext<Poly> cc;
@@ -0,0 +1,95 @@
+/*
+ * Description:
+ * This code benchmarks encrypting vectors of slot values with the PALISADE pke library: MakePackedPlaintext followed by Encrypt, against the fused EncryptPacked and its batch variant.
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or other
+ * materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#define _USE_MATH_DEFINES
+#include "benchmark/benchmark.h"
+
+#include <iostream>
+#include <vector>
+
+#include "palisade.h"
+#include "cryptocontext.h"
+
+using namespace std;
+using namespace lbcrypto;
+
+// a BFVrns context with ring dimension 8192, a key pair and rows of slot values filling every slot
+struct EncryptPackedSetup {
+	CryptoContext<DCRTPoly> cc;
+	LPKeyPair<DCRTPoly> kp;
+	vector<vector<int64_t>> rows;
+
+	EncryptPackedSetup(size_t count) {
+		CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+		cc = CryptoContextFactory<DCRTPoly>::genCryptoContextBFVrns(
+				65537, HEStd_128_classic, 3.2, 0, 2, 0, OPTIMIZED);
+		cc->Enable(ENCRYPTION);
+		cc->Enable(SHE);
+		kp = cc->KeyGen();
+
+		rows.resize(count);
+		for (size_t r = 0; r < count; r++)
+			for (size_t i = 0; i < cc->GetRingDimension(); i++)
+				rows[r].push_back(int64_t((i*131 + r) % 65537) - 32768);
+	}
+
+	~EncryptPackedSetup() {
+		CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+	}
+};
+
+static void BM_MakePackedPlaintext_Encrypt(benchmark::State& state) { // benchmark
+	EncryptPackedSetup setup(1);
+
+	while (state.KeepRunning()) {
+		Ciphertext<DCRTPoly> ct = setup.cc->Encrypt(setup.kp.publicKey, setup.cc->MakePackedPlaintext(setup.rows[0]));
+	}
+}
+
+static void BM_EncryptPacked(benchmark::State& state) { // benchmark
+	EncryptPackedSetup setup(1);
+
+	while (state.KeepRunning()) {
+		Ciphertext<DCRTPoly> ct = setup.cc->EncryptPacked(setup.kp.publicKey, setup.rows[0]);
+	}
+}
+
+static void BM_EncryptPacked_Batch(benchmark::State& state) { // benchmark
+	EncryptPackedSetup setup(state.range(0));
+
+	while (state.KeepRunning()) {
+		vector<Ciphertext<DCRTPoly>> cts = setup.cc->EncryptPacked(setup.kp.publicKey, setup.rows);
+	}
+	state.SetItemsProcessed(state.iterations() * setup.rows.size());
+}
+
+BENCHMARK(BM_MakePackedPlaintext_Encrypt)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_EncryptPacked)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_EncryptPacked_Batch)->Unit(benchmark::kMillisecond)->Arg(16)->Arg(64);
+
+//execute the benchmarks
+BENCHMARK_MAIN();
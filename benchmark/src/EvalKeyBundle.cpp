@@ -0,0 +1,105 @@
+/*
+ * Description:
+ * This code benchmarks loading a full set of rotation keys of the PALISADE pke library, comparing cereal deserialization with evaluation-key bundles.
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or other
+ * materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#define _USE_MATH_DEFINES
+#include "benchmark/benchmark.h"
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "palisade.h"
+#include "cryptocontext-ser.h"
+#include "pubkeylp-ser.h"
+#include "utils/serialize-binary.h"
+
+using namespace std;
+using namespace lbcrypto;
+
+// a BFVrns context with ring dimension 16384 and the given number of rotation keys
+struct BundleBenchmarkSetup {
+	CryptoContext<DCRTPoly> cc;
+	string keyTag;
+
+	BundleBenchmarkSetup(size_t rotations) {
+		CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+		cc = CryptoContextFactory<DCRTPoly>::genCryptoContextBFVrns(
+				65537, HEStd_128_classic, 3.2, 0, 4, 0, OPTIMIZED);
+		cc->Enable(ENCRYPTION);
+		cc->Enable(SHE);
+		LPKeyPair<DCRTPoly> kp = cc->KeyGen();
+		keyTag = kp.secretKey->GetKeyTag();
+
+		vector<int32_t> indexList;
+		for (size_t i = 1; i <= rotations; i++)
+			indexList.push_back(i);
+		cc->EvalAtIndexKeyGen(kp.secretKey, indexList);
+	}
+
+	~BundleBenchmarkSetup() {
+		CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+	}
+};
+
+// the baseline: one cereal archive of the whole map, copied into the cache
+static void BM_EvalKeys_DeserializeCereal(benchmark::State& state) { // benchmark
+	BundleBenchmarkSetup setup(state.range(0));
+	stringstream s;
+	CryptoContextImpl<DCRTPoly>::SerializeEvalAutomorphismKey(s, SerType::BINARY, setup.keyTag);
+	const string serialized = s.str();
+
+	while (state.KeepRunning()) {
+		CryptoContextImpl<DCRTPoly>::ClearEvalAutomorphismKeys();
+		stringstream in(serialized);
+		CryptoContextImpl<DCRTPoly>::DeserializeEvalAutomorphismKey(in, SerType::BINARY);
+	}
+	state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(serialized.size()));
+}
+
+// the bundle: keys decoded in parallel from the offset table and moved into the cache
+static void BM_EvalKeys_DeserializeBundle(benchmark::State& state) { // benchmark
+	BundleBenchmarkSetup setup(state.range(0));
+	stringstream s;
+	CryptoContextImpl<DCRTPoly>::SerializeEvalKeyBundle(s, setup.cc, setup.keyTag);
+	const string serialized = s.str();
+
+	while (state.KeepRunning()) {
+		CryptoContextImpl<DCRTPoly>::ClearEvalAutomorphismKeys();
+		stringstream in(serialized);
+		CryptoContextImpl<DCRTPoly>::DeserializeEvalKeyBundle(in, setup.cc);
+	}
+	state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(serialized.size()));
+}
+
+#define DO_BUNDLE_BENCHMARK(X) \
+		BENCHMARK(X)->Unit(benchmark::kMillisecond)->ArgName("keys")->Arg(16)->Arg(128);
+
+DO_BUNDLE_BENCHMARK(BM_EvalKeys_DeserializeCereal)
+DO_BUNDLE_BENCHMARK(BM_EvalKeys_DeserializeBundle)
+
+//execute the benchmarks
+BENCHMARK_MAIN();
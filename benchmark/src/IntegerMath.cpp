@@ -211,5 +211,75 @@ BENCHMARK_TEMPLATE(BM_BigInt_Multeq,M6Integer)->Unit(benchmark::kMicrosecond)->A
 #endif
 BENCHMARK_TEMPLATE(BM_BigInt_Multeq,NativeInteger)->Unit(benchmark::kMicrosecond)->ArgName("Small")->Arg(0);
 
+// operands of a given bit length, built from a fixed pseudorandom sequence so that all backends see the same values
+template<typename I>
+static I make_BigInt_bits(usint bits, uint32_t seed, bool odd) {
+	I x(0);
+	for( usint i = 0; i < bits; i += 32 ) {
+		seed = seed*1664525 + 1013904223;
+		x <<= 32;
+		x += I(uint64_t(seed));
+	}
+	x >>= (bits+31)/32*32 - bits;
+	x += I(1) << (bits-1);
+	if( odd && x.GetBitAtIndex(1) == 0 )
+		x += I(1);
+	return x;
+}
+
+// mult of operands of range(0) bits
+template<typename I>
+static void BM_BigInt_Mult_Bits(benchmark::State& state) { // benchmark
+	I a = make_BigInt_bits<I>(state.range(0), 1, false);
+	I b = make_BigInt_bits<I>(state.range(0), 2, false);
+
+	while (state.KeepRunning()) {
+		mult_BigInt(a,b);
+	}
+}
+
+// products of more than BigIntegerBitLength bits overflow backend 2
+BENCHMARK_TEMPLATE(BM_BigInt_Mult_Bits,M2Integer)->Unit(benchmark::kMicrosecond)->ArgName("bits")->RangeMultiplier(2)->Range(128,1024);
+BENCHMARK_TEMPLATE(BM_BigInt_Mult_Bits,M4Integer)->Unit(benchmark::kMicrosecond)->ArgName("bits")->RangeMultiplier(2)->Range(128,4096);
+#ifdef WITH_NTL
+BENCHMARK_TEMPLATE(BM_BigInt_Mult_Bits,M6Integer)->Unit(benchmark::kMicrosecond)->ArgName("bits")->RangeMultiplier(2)->Range(128,4096);
+#endif
+
+// ModMul of operands below an odd modulus of range(0) bits
+template<typename I>
+static void BM_BigInt_ModMul_Bits(benchmark::State& state) { // benchmark
+	I m = make_BigInt_bits<I>(state.range(0), 3, true);
+	I a = make_BigInt_bits<I>(state.range(0), 1, false).Mod(m);
+	I b = make_BigInt_bits<I>(state.range(0), 2, false).Mod(m);
+
+	while (state.KeepRunning()) {
+		I c = a.ModMul(b, m);
+	}
+}
+
+BENCHMARK_TEMPLATE(BM_BigInt_ModMul_Bits,M2Integer)->Unit(benchmark::kMicrosecond)->ArgName("bits")->RangeMultiplier(2)->Range(128,1024);
+BENCHMARK_TEMPLATE(BM_BigInt_ModMul_Bits,M4Integer)->Unit(benchmark::kMicrosecond)->ArgName("bits")->RangeMultiplier(2)->Range(128,4096);
+#ifdef WITH_NTL
+BENCHMARK_TEMPLATE(BM_BigInt_ModMul_Bits,M6Integer)->Unit(benchmark::kMicrosecond)->ArgName("bits")->RangeMultiplier(2)->Range(128,4096);
+#endif
+
+// ModExp with base, exponent and odd modulus of range(0) bits, the shape of a Miller-Rabin round
+template<typename I>
+static void BM_BigInt_ModExp_Bits(benchmark::State& state) { // benchmark
+	I m = make_BigInt_bits<I>(state.range(0), 3, true);
+	I a = make_BigInt_bits<I>(state.range(0), 1, false).Mod(m);
+	I e = make_BigInt_bits<I>(state.range(0), 2, false);
+
+	while (state.KeepRunning()) {
+		I c = a.ModExp(e, m);
+	}
+}
+
+BENCHMARK_TEMPLATE(BM_BigInt_ModExp_Bits,M2Integer)->Unit(benchmark::kMicrosecond)->ArgName("bits")->RangeMultiplier(2)->Range(128,1024);
+BENCHMARK_TEMPLATE(BM_BigInt_ModExp_Bits,M4Integer)->Unit(benchmark::kMicrosecond)->ArgName("bits")->RangeMultiplier(2)->Range(128,4096);
+#ifdef WITH_NTL
+BENCHMARK_TEMPLATE(BM_BigInt_ModExp_Bits,M6Integer)->Unit(benchmark::kMicrosecond)->ArgName("bits")->RangeMultiplier(2)->Range(128,4096);
+#endif
+
 //execute the benchmarks
 BENCHMARK_MAIN();
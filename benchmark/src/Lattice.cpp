@@ -48,6 +48,7 @@
 #include "math/discreteuniformgenerator.cpp"
 #include "math/discretegaussiangenerator.cpp"
 #include "lattice/elemparamfactory.h"
+#include "lattice/field2n.h"
 
 using namespace std;
 using namespace lbcrypto;
@@ -467,5 +468,21 @@ DO_POLY_BENCHMARK_TEMPLATE(BM_doubleswitchformat_LATTICE,M4DCRTPoly)
 DO_POLY_BENCHMARK_TEMPLATE(BM_doubleswitchformat_LATTICE,M6DCRTPoly)
 #endif
 
+// Field2n format switch, as used by the GPV perturbation sampler (SampleMat/ZSampleSigma2x2)
+static void BM_doubleswitchformat_Field2n(benchmark::State& state) { // benchmark
+	Field2n a(state.range(0), COEFFICIENT, true);
+	for (size_t i = 0; i < a.size(); i++)
+		a.at(i) = std::complex<double>(i % 17, 0);
+
+	while (state.KeepRunning()) {
+		a.SwitchFormat();
+		a.SwitchFormat();
+	}
+}
+
+BENCHMARK(BM_doubleswitchformat_Field2n)->Unit(benchmark::kMicrosecond)->ArgName("n_512")->Arg(512);
+BENCHMARK(BM_doubleswitchformat_Field2n)->Unit(benchmark::kMicrosecond)->ArgName("n_1024")->Arg(1024);
+BENCHMARK(BM_doubleswitchformat_Field2n)->Unit(benchmark::kMicrosecond)->ArgName("n_4096")->Arg(4096);
+
 //execute the benchmarks
 BENCHMARK_MAIN();
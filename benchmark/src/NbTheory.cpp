@@ -388,6 +388,24 @@ static void BM_PROU3(benchmark::State& state) { // benchmark
 
 BENCHMARK(BM_PROU3);		// register benchmark
 
+// moduli chain and roots of unity as generated for a DCRT context
+static void BM_DCRT_MODULI_CHAIN(benchmark::State& state) {
+  usint m = 2 * state.range(0);
+  size_t towers = state.range(1);
+
+  vector<NativeInteger> moduli(towers);
+  vector<NativeInteger> roots;
+  while (state.KeepRunning()) {
+    moduli[0] = lbcrypto::FirstPrime<NativeInteger>(60, m);
+    for (size_t i = 1; i < towers; i++)
+      moduli[i] = lbcrypto::NextPrime<NativeInteger>(moduli[i-1], m);
+    roots = lbcrypto::RootsOfUnity<NativeInteger>(m, moduli);
+  }
+  state.SetLabel(roots.back().ToString());
+}
+
+BENCHMARK(BM_DCRT_MODULI_CHAIN)->Unit(benchmark::kMillisecond)->Args({8192, 8})->Args({65536, 20})->Args({65536, 40});
+
 
 
 //execute the benchmarks
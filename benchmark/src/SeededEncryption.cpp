@@ -0,0 +1,169 @@
+/*
+ * Description:
+ * This code benchmarks seeded private-key encryption and seeded public keys of the PALISADE pke library: their serialized size, and the time to produce and load them.
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or other
+ * materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#define _USE_MATH_DEFINES
+#include "benchmark/benchmark.h"
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "palisade.h"
+#include "cryptocontext-ser.h"
+#include "ciphertext-ser.h"
+#include "pubkeylp-ser.h"
+#include "utils/serialize-binary.h"
+
+using namespace std;
+using namespace lbcrypto;
+
+// a BFVrns context with ring dimension 8192, a key pair and a packed plaintext filling every slot
+struct SeededBenchmarkSetup {
+	CryptoContext<DCRTPoly> cc;
+	LPKeyPair<DCRTPoly> kp;
+	Plaintext plaintext;
+
+	SeededBenchmarkSetup() {
+		CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+		cc = CryptoContextFactory<DCRTPoly>::genCryptoContextBFVrns(
+				65537, HEStd_128_classic, 3.2, 0, 2, 0, OPTIMIZED);
+		cc->Enable(ENCRYPTION);
+		cc->Enable(SHE);
+		kp = cc->KeyGen();
+
+		vector<int64_t> vals(cc->GetRingDimension());
+		for (size_t i = 0; i < vals.size(); i++)
+			vals[i] = i % 65537;
+		plaintext = cc->MakePackedPlaintext(vals);
+	}
+
+	~SeededBenchmarkSetup() {
+		CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+	}
+};
+
+template<typename T>
+static string SerializeBinary(const T& obj) {
+	stringstream s;
+	Serial::Serialize(obj, s, SerType::BINARY);
+	return s.str();
+}
+
+static void SetSizeLabel(benchmark::State& state, size_t bytes) {
+	stringstream ss;
+	ss << bytes << " bytes serialized";
+	state.SetLabel(ss.str().c_str());
+}
+
+// private-key encryption followed by serialization, the client side of an upload
+static void BM_EncryptPrivate_Serialize(benchmark::State& state) { // benchmark
+	SeededBenchmarkSetup setup;
+	size_t bytes = 0;
+
+	while (state.KeepRunning()) {
+		Ciphertext<DCRTPoly> ct = setup.cc->Encrypt(setup.kp.secretKey, setup.plaintext);
+		bytes = SerializeBinary(ct).size();
+	}
+	SetSizeLabel(state, bytes);
+	state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(bytes));
+}
+
+static void BM_EncryptSeeded_Serialize(benchmark::State& state) { // benchmark
+	SeededBenchmarkSetup setup;
+	size_t bytes = 0;
+
+	while (state.KeepRunning()) {
+		Ciphertext<DCRTPoly> ct = setup.cc->EncryptSeeded(setup.kp.secretKey, setup.plaintext);
+		bytes = SerializeBinary(ct).size();
+	}
+	SetSizeLabel(state, bytes);
+	state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(bytes));
+}
+
+// deserialization, the server side; a seeded ciphertext is expanded from its seed
+static void BM_Ciphertext_Deserialize(benchmark::State& state) { // benchmark
+	SeededBenchmarkSetup setup;
+	const string serialized = SerializeBinary(setup.cc->Encrypt(setup.kp.secretKey, setup.plaintext));
+
+	while (state.KeepRunning()) {
+		Ciphertext<DCRTPoly> ct;
+		stringstream in(serialized);
+		Serial::Deserialize(ct, in, SerType::BINARY);
+	}
+	SetSizeLabel(state, serialized.size());
+	state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(serialized.size()));
+}
+
+static void BM_SeededCiphertext_Deserialize(benchmark::State& state) { // benchmark
+	SeededBenchmarkSetup setup;
+	const string serialized = SerializeBinary(setup.cc->EncryptSeeded(setup.kp.secretKey, setup.plaintext));
+
+	while (state.KeepRunning()) {
+		Ciphertext<DCRTPoly> ct;
+		stringstream in(serialized);
+		Serial::Deserialize(ct, in, SerType::BINARY);
+	}
+	SetSizeLabel(state, serialized.size());
+	state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(serialized.size()));
+}
+
+// key generation; the size is that of the serialized public key
+static void BM_KeyGen(benchmark::State& state) { // benchmark
+	SeededBenchmarkSetup setup;
+	size_t bytes = 0;
+
+	while (state.KeepRunning()) {
+		LPKeyPair<DCRTPoly> kp = setup.cc->KeyGen();
+		state.PauseTiming();
+		bytes = SerializeBinary(kp.publicKey).size();
+		state.ResumeTiming();
+	}
+	SetSizeLabel(state, bytes);
+}
+
+static void BM_KeyGenSeeded(benchmark::State& state) { // benchmark
+	SeededBenchmarkSetup setup;
+	size_t bytes = 0;
+
+	while (state.KeepRunning()) {
+		LPKeyPair<DCRTPoly> kp = setup.cc->KeyGenSeeded();
+		state.PauseTiming();
+		bytes = SerializeBinary(kp.publicKey).size();
+		state.ResumeTiming();
+	}
+	SetSizeLabel(state, bytes);
+}
+
+BENCHMARK(BM_EncryptPrivate_Serialize)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_EncryptSeeded_Serialize)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Ciphertext_Deserialize)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SeededCiphertext_Deserialize)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_KeyGen)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_KeyGenSeeded)->Unit(benchmark::kMicrosecond);
+
+//execute the benchmarks
+BENCHMARK_MAIN();
@@ -0,0 +1,125 @@
+/*
+ * Description:
+ * This code benchmarks JSON serialization of ciphertexts of the PALISADE pke library, comparing JSON arrays of numbers with the base64 vector blobs of JSONCOMPACT.
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or other
+ * materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#define _USE_MATH_DEFINES
+#include "benchmark/benchmark.h"
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "palisade.h"
+#include "cryptocontext-ser.h"
+#include "ciphertext-ser.h"
+#include "pubkeylp-ser.h"
+#include "utils/serialize-json.h"
+
+using namespace std;
+using namespace lbcrypto;
+
+// a BFVrns ciphertext with ring dimension 8192 and three towers
+struct JSONBenchmarkSetup {
+	CryptoContext<DCRTPoly> cc;
+	Ciphertext<DCRTPoly> ciphertext;
+
+	JSONBenchmarkSetup() {
+		CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+		cc = CryptoContextFactory<DCRTPoly>::genCryptoContextBFVrns(
+				65537, HEStd_128_classic, 3.2, 0, 2, 0, OPTIMIZED);
+		cc->Enable(ENCRYPTION);
+		LPKeyPair<DCRTPoly> kp = cc->KeyGen();
+
+		vector<int64_t> vals(cc->GetRingDimension());
+		for (size_t i = 0; i < vals.size(); i++)
+			vals[i] = i % 65537;
+		ciphertext = cc->Encrypt(kp.publicKey, cc->MakePackedPlaintext(vals));
+	}
+
+	~JSONBenchmarkSetup() {
+		CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+	}
+};
+
+static void SetSizeLabel(benchmark::State& state, size_t bytes) {
+	stringstream ss;
+	ss << bytes << " bytes serialized";
+	state.SetLabel(ss.str().c_str());
+}
+
+template<typename ST>
+static void BM_Ciphertext_Serialize(benchmark::State& state, const ST& sertype) {
+	JSONBenchmarkSetup setup;
+	size_t bytes = 0;
+
+	while (state.KeepRunning()) {
+		stringstream s;
+		Serial::Serialize(setup.ciphertext, s, sertype);
+		bytes = s.str().size();
+	}
+	SetSizeLabel(state, bytes);
+	state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(bytes));
+}
+
+template<typename ST>
+static void BM_Ciphertext_Deserialize(benchmark::State& state, const ST& sertype) {
+	JSONBenchmarkSetup setup;
+	stringstream s;
+	Serial::Serialize(setup.ciphertext, s, sertype);
+	const string serialized = s.str();
+
+	while (state.KeepRunning()) {
+		Ciphertext<DCRTPoly> ct;
+		stringstream in(serialized);
+		Serial::Deserialize(ct, in, sertype);
+	}
+	SetSizeLabel(state, serialized.size());
+	state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(serialized.size()));
+}
+
+static void BM_Ciphertext_Serialize_JSON(benchmark::State& state) { // benchmark
+	BM_Ciphertext_Serialize(state, SerType::JSON);
+}
+
+static void BM_Ciphertext_Serialize_JSONCOMPACT(benchmark::State& state) { // benchmark
+	BM_Ciphertext_Serialize(state, SerType::JSONCOMPACT);
+}
+
+static void BM_Ciphertext_Deserialize_JSON(benchmark::State& state) { // benchmark
+	BM_Ciphertext_Deserialize(state, SerType::JSON);
+}
+
+static void BM_Ciphertext_Deserialize_JSONCOMPACT(benchmark::State& state) { // benchmark
+	BM_Ciphertext_Deserialize(state, SerType::JSONCOMPACT);
+}
+
+BENCHMARK(BM_Ciphertext_Serialize_JSON)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Ciphertext_Serialize_JSONCOMPACT)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Ciphertext_Deserialize_JSON)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Ciphertext_Deserialize_JSONCOMPACT)->Unit(benchmark::kMicrosecond);
+
+//execute the benchmarks
+BENCHMARK_MAIN();
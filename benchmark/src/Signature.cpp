@@ -0,0 +1,120 @@
+/*
+ * Description:
+ * This code benchmarks single and batched GPV signing and verification throughput of the PALISADE signature library.
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or other
+ * materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#define _USE_MATH_DEFINES
+#include "benchmark/benchmark.h"
+
+#include <iostream>
+#include <vector>
+
+#include "palisade.h"
+#include "signaturecontext.h"
+
+using namespace std;
+using namespace lbcrypto;
+
+// number of messages signed or verified per iteration
+static const size_t GPV_BATCH_SIZE = 64;
+
+// holds the context, keys and a batch of plaintexts for a ring dimension
+struct GPVBenchmarkSetup {
+	SignatureContext<NativePoly> context;
+	GPVVerificationKey<NativePoly> vk;
+	GPVSignKey<NativePoly> sk;
+	vector<GPVPlaintext<NativePoly>> plaintexts;
+	vector<GPVSignature<NativePoly>> signatures;
+	vector<const LPSignPlaintext<NativePoly>*> pts;
+	vector<LPSignature<NativePoly>*> signs;
+	vector<const LPSignature<NativePoly>*> constSigns;
+
+	GPVBenchmarkSetup(usint ringsize, size_t batchSize) : plaintexts(batchSize), signatures(batchSize) {
+		context.GenerateGPVContext(ringsize);
+		context.KeyGen(&sk, &vk);
+		for (size_t i = 0; i < batchSize; i++) {
+			plaintexts[i].SetPlaintext("Audit log entry " + std::to_string(i));
+			pts.push_back(&plaintexts[i]);
+			signs.push_back(&signatures[i]);
+			constSigns.push_back(&signatures[i]);
+		}
+	}
+};
+
+// signs the batch one message at a time
+static void BM_GPV_Sign(benchmark::State& state) { // benchmark
+	GPVBenchmarkSetup setup(state.range(0), GPV_BATCH_SIZE);
+
+	while (state.KeepRunning()) {
+		for (size_t i = 0; i < setup.plaintexts.size(); i++)
+			setup.context.Sign(setup.plaintexts[i], setup.sk, setup.vk, &setup.signatures[i]);
+	}
+	state.SetItemsProcessed(state.iterations() * GPV_BATCH_SIZE);
+}
+
+// signs the batch with SignBatch
+static void BM_GPV_SignBatch(benchmark::State& state) { // benchmark
+	GPVBenchmarkSetup setup(state.range(0), GPV_BATCH_SIZE);
+
+	while (state.KeepRunning()) {
+		setup.context.SignBatch(setup.pts, setup.sk, setup.vk, setup.signs);
+	}
+	state.SetItemsProcessed(state.iterations() * GPV_BATCH_SIZE);
+}
+
+// verifies the batch one signature at a time
+static void BM_GPV_Verify(benchmark::State& state) { // benchmark
+	GPVBenchmarkSetup setup(state.range(0), GPV_BATCH_SIZE);
+	setup.context.SignBatch(setup.pts, setup.sk, setup.vk, setup.signs);
+
+	while (state.KeepRunning()) {
+		for (size_t i = 0; i < setup.plaintexts.size(); i++)
+			benchmark::DoNotOptimize(setup.context.Verify(setup.plaintexts[i], setup.signatures[i], setup.vk));
+	}
+	state.SetItemsProcessed(state.iterations() * GPV_BATCH_SIZE);
+}
+
+// verifies the batch with VerifyBatch
+static void BM_GPV_VerifyBatch(benchmark::State& state) { // benchmark
+	GPVBenchmarkSetup setup(state.range(0), GPV_BATCH_SIZE);
+	setup.context.SignBatch(setup.pts, setup.sk, setup.vk, setup.signs);
+
+	while (state.KeepRunning()) {
+		benchmark::DoNotOptimize(setup.context.VerifyBatch(setup.pts, setup.constSigns, setup.vk));
+	}
+	state.SetItemsProcessed(state.iterations() * GPV_BATCH_SIZE);
+}
+
+#define DO_GPV_BENCHMARK(X) \
+		BENCHMARK(X)->Unit(benchmark::kMillisecond)->ArgName("ring_512")->Arg(512); \
+		BENCHMARK(X)->Unit(benchmark::kMillisecond)->ArgName("ring_1024")->Arg(1024);
+
+DO_GPV_BENCHMARK(BM_GPV_Sign)
+DO_GPV_BENCHMARK(BM_GPV_SignBatch)
+DO_GPV_BENCHMARK(BM_GPV_Verify)
+DO_GPV_BENCHMARK(BM_GPV_VerifyBatch)
+
+//execute the benchmarks
+BENCHMARK_MAIN();
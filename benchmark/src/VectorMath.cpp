@@ -41,6 +41,7 @@
 #include "lattice/dcrtpoly.cpp"
 #include "math/nbtheory.cpp"
 #include "math/transfrm.cpp"
+#include "math/transfrm32.h"
 #include "math/discreteuniformgenerator.cpp"
 #include "math/discretegaussiangenerator.cpp"
 #include "lattice/elemparamfactory.h"
@@ -168,5 +169,114 @@ DO_VECTOR_BENCHMARK_TEMPLATE(BM_BigVec_Multeq, M4Vector)
 DO_VECTOR_BENCHMARK_TEMPLATE(BM_BigVec_Multeq, M6Vector)
 #endif
 
+// native modular multiplication and NTT for each class of moduli with a specialized kernel (see modmul.h)
+#define DO_MODULUS_CLASS_BENCHMARK(X) \
+		BENCHMARK(X)->Unit(benchmark::kMicrosecond)->ArgName("bits_30")->Arg(30); \
+		BENCHMARK(X)->Unit(benchmark::kMicrosecond)->ArgName("bits_50")->Arg(50); \
+		BENCHMARK(X)->Unit(benchmark::kMicrosecond)->ArgName("bits_60")->Arg(60); \
+		BENCHMARK(X)->Unit(benchmark::kMicrosecond)->ArgName("bits_62")->Arg(62);
+
+static const usint modulusClassCycloOrder = 8192;
+
+static void BM_NativeVec_ModMul_ModulusClass(benchmark::State& state) { // benchmark
+	NativeInteger q = FirstPrime<NativeInteger>(state.range(0), modulusClassCycloOrder);
+	NativeVector a = makeVector<NativeVector>(modulusClassCycloOrder/2, q);
+	NativeVector b = makeVector<NativeVector>(modulusClassCycloOrder/2, q);
+
+	while (state.KeepRunning()) {
+		a.ModMulEq(b);
+	}
+}
+
+DO_MODULUS_CLASS_BENCHMARK(BM_NativeVec_ModMul_ModulusClass)
+
+static void BM_NativeVec_ModMulScalar_ModulusClass(benchmark::State& state) { // benchmark
+	NativeInteger q = FirstPrime<NativeInteger>(state.range(0), modulusClassCycloOrder);
+	NativeVector a = makeVector<NativeVector>(modulusClassCycloOrder/2, q);
+	NativeInteger b = q - NativeInteger(3);
+
+	while (state.KeepRunning()) {
+		a.ModMulEq(b);
+	}
+}
+
+DO_MODULUS_CLASS_BENCHMARK(BM_NativeVec_ModMulScalar_ModulusClass)
+
+static void BM_NativeVec_NTT_ModulusClass(benchmark::State& state) { // benchmark
+	NativeInteger q = FirstPrime<NativeInteger>(state.range(0), modulusClassCycloOrder);
+	NativeInteger root = RootOfUnity<NativeInteger>(modulusClassCycloOrder, q);
+	NativeVector x = makeVector<NativeVector>(modulusClassCycloOrder/2, q);
+	NativeVector X(modulusClassCycloOrder/2);
+
+	// the first transform computes the tables of powers of the root of unity
+	ChineseRemainderTransformFTT<NativeVector>::ForwardTransform(x, root, modulusClassCycloOrder, &X);
+
+	while (state.KeepRunning()) {
+		ChineseRemainderTransformFTT<NativeVector>::ForwardTransform(x, root, modulusClassCycloOrder, &X);
+	}
+}
+
+DO_MODULUS_CLASS_BENCHMARK(BM_NativeVec_NTT_ModulusClass)
+
+// residues of a 30-bit tower stored in 64-bit words (NativeVector) and in 32-bit words (NativeVector32)
+#define DO_TOWER_WIDTH_BENCHMARK(X) \
+		BENCHMARK_TEMPLATE(X,NativeVector)->Unit(benchmark::kMicrosecond)->ArgName("n_4096")->Arg(4096); \
+		BENCHMARK_TEMPLATE(X,NativeVector32)->Unit(benchmark::kMicrosecond)->ArgName("n_4096")->Arg(4096); \
+		BENCHMARK_TEMPLATE(X,NativeVector)->Unit(benchmark::kMicrosecond)->ArgName("n_524288")->Arg(524288); \
+		BENCHMARK_TEMPLATE(X,NativeVector32)->Unit(benchmark::kMicrosecond)->ArgName("n_524288")->Arg(524288);
+
+static void towerForwardTransform(const NativeVector& x, const NativeInteger& root, usint m, NativeVector* X) {
+	ChineseRemainderTransformFTT<NativeVector>::ForwardTransform(x, root, m, X);
+}
+
+static void towerForwardTransform(const NativeVector32& x, const NativeInteger& root, usint m, NativeVector32* X) {
+	ChineseRemainderTransformFTT32::ForwardTransform(x, root, m, X);
+}
+
+template <typename V>
+static void BM_Tower_ModAdd(benchmark::State& state) { // benchmark
+	usint n = state.range(0);
+	NativeInteger q = FirstPrime<NativeInteger>(30, 2*n);
+	V a(makeVector<NativeVector>(n, q));
+	V b(makeVector<NativeVector>(n, q));
+
+	while (state.KeepRunning()) {
+		a.ModAddEq(b);
+	}
+}
+
+DO_TOWER_WIDTH_BENCHMARK(BM_Tower_ModAdd)
+
+template <typename V>
+static void BM_Tower_ModMul(benchmark::State& state) { // benchmark
+	usint n = state.range(0);
+	NativeInteger q = FirstPrime<NativeInteger>(30, 2*n);
+	V a(makeVector<NativeVector>(n, q));
+	V b(makeVector<NativeVector>(n, q));
+
+	while (state.KeepRunning()) {
+		a.ModMulEq(b);
+	}
+}
+
+DO_TOWER_WIDTH_BENCHMARK(BM_Tower_ModMul)
+
+template <typename V>
+static void BM_Tower_NTT(benchmark::State& state) { // benchmark
+	usint n = state.range(0);
+	NativeInteger q = FirstPrime<NativeInteger>(30, 2*n);
+	NativeInteger root = RootOfUnity<NativeInteger>(2*n, q);
+	V x(makeVector<NativeVector>(n, q));
+	V X(x);
+
+	towerForwardTransform(x, root, 2*n, &X);
+
+	while (state.KeepRunning()) {
+		towerForwardTransform(x, root, 2*n, &X);
+	}
+}
+
+DO_TOWER_WIDTH_BENCHMARK(BM_Tower_NTT)
+
 //execute the benchmarks
 BENCHMARK_MAIN();
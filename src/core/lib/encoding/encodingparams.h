@@ -27,11 +27,14 @@
 #ifndef LBCRYPTO_ENCODING_ENCODINGPARAMS_H
 #define LBCRYPTO_ENCODING_ENCODINGPARAMS_H
 
+#include <memory>
+
 #include "../math/backend.h"
 
 namespace lbcrypto
 {
 class EncodingParamsImpl;
+class PackedEncodingPlan;
 
 typedef std::shared_ptr<EncodingParamsImpl>	EncodingParams;
 typedef uint64_t							PlaintextModulus;
@@ -81,6 +84,7 @@ public:
 		m_plaintextBigRootOfUnity = rhs.m_plaintextBigRootOfUnity;
 		m_plaintextGenerator = rhs.m_plaintextGenerator;
 		m_batchSize = rhs.m_batchSize;
+		m_packedEncodingPlan = rhs.GetPackedEncodingPlan();
 	}
 
 	/**
@@ -95,6 +99,7 @@ public:
 		m_plaintextBigRootOfUnity = std::move(rhs.m_plaintextBigRootOfUnity);
 		m_plaintextGenerator = std::move(rhs.m_plaintextGenerator);
 		m_batchSize = rhs.m_batchSize;
+		m_packedEncodingPlan = rhs.GetPackedEncodingPlan();
 	}
 
 	/**
@@ -110,6 +115,7 @@ public:
 		m_plaintextBigRootOfUnity = rhs.m_plaintextBigRootOfUnity;
 		m_plaintextGenerator = rhs.m_plaintextGenerator;
 		m_batchSize = rhs.m_batchSize;
+		SetPackedEncodingPlan(rhs.GetPackedEncodingPlan());
 		return *this;
 	}
 
@@ -208,6 +214,23 @@ public:
 		m_batchSize = batchSize;
 	}
 
+	/**
+	* @brief Getter for the packed encoding plan last used with these parameters.
+	* The plan is not part of the parameters: it is not compared or serialized, and it may be
+	* replaced from any thread.
+	* @return The plan, or null if no plan was set.
+	*/
+	std::shared_ptr<const PackedEncodingPlan> GetPackedEncodingPlan() const {
+		return std::atomic_load(&m_packedEncodingPlan);
+	}
+
+	/**
+	* @brief Setter for the packed encoding plan.
+	*/
+	void SetPackedEncodingPlan(std::shared_ptr<const PackedEncodingPlan> plan) {
+		std::atomic_store(&m_packedEncodingPlan, plan);
+	}
+
 	// Operators
 	/**
 	 * @brief output stream operator.
@@ -265,6 +288,8 @@ private:
 	uint32_t			m_plaintextGenerator;
 	// maximum batch size used by EvalSumKeyGen for packed encoding
 	uint32_t			m_batchSize;
+	// tables used by packed encoding, kept here so that encoding does not have to look them up
+	std::shared_ptr<const PackedEncodingPlan>	m_packedEncodingPlan;
 
 public:
 	template <class Archive>
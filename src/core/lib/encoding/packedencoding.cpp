@@ -28,35 +28,45 @@
 
 namespace lbcrypto {
 
-std::map<ModulusM, NativeInteger> PackedEncoding::m_initRoot;
-std::map<ModulusM, NativeInteger> PackedEncoding::m_bigModulus;
-std::map<ModulusM, NativeInteger> PackedEncoding::m_bigRoot;
-
-std::map<usint, usint> PackedEncoding::m_automorphismGenerator;
-std::map<usint, std::vector<usint>> PackedEncoding::m_toCRTPerm;
-std::map<usint, std::vector<usint>> PackedEncoding::m_fromCRTPerm;
-
 bool PackedEncoding::Encode() {
 	if( this->isEncoded ) return true;
 	auto mod = this->encodingParams->GetPlaintextModulus();
 
-	if (( this->typeFlag == IsNativePoly ) || (this->typeFlag == IsDCRTPoly )) {
+	if ( this->typeFlag == IsDCRTPoly ) {
 
-		NativeInteger q;
+		const shared_ptr<ILDCRTParams<BigInteger>> params = this->encodedVectorDCRT.GetParams();
+		const std::vector<std::shared_ptr<ILNativeParams>> &nativeParams = params->GetParams();
 
-		NativeVector temp;
-		if ( this->typeFlag == IsNativePoly ) {
-			q = this->GetElementModulus().ConvertToInt();
-			temp = NativeVector(this->GetElementRingDimension(), this->GetElementModulus().ConvertToInt());
-		}
-		else
-		{
-			q = this->encodedVectorDCRT.GetParams()->GetParams()[0]->GetModulus().ConvertToInt();
-			temp = NativeVector(this->GetElementRingDimension(), q);
-			if( q < mod )
+		for (size_t k = 0; k < nativeParams.size(); k++ )
+			if( nativeParams[k]->GetModulus() < mod )
 				throw std::logic_error("the plaintext modulus size is larger than the size of CRT moduli; either decrease the plaintext modulus or increase the CRT moduli.");
+
+		// the slots are checked and permuted straight into the transform, and the coefficients it returns
+		// are lifted, centered at p/2, to every tower: a coefficient c > p/2 stands for c - p
+		NativeVector coefficients;
+		GetPlan(params->GetCyclotomicOrder(), this->encodingParams)->Pack(value, &coefficients);
+
+		usint n = params->GetRingDimension();
+		NativeInteger p(mod);
+		NativeInteger half(mod >> 1);
+
+		for (size_t k = 0; k < nativeParams.size(); k++ ) {
+			const NativeInteger &qk = nativeParams[k]->GetModulus();
+			NativeInteger shift = qk - p;
+			NativeVector tower(n, qk);
+			for (usint i = 0; i < n; i++) {
+				const NativeInteger &c = coefficients[i];
+				tower[i] = c > half ? c + shift : c;
+			}
+			this->encodedVectorDCRT.ElementAtIndex(k).SetValues(std::move(tower), Format::COEFFICIENT);
 		}
 
+		this->isEncoded = true;
+	}
+	else if ( this->typeFlag == IsNativePoly ) {
+
+		NativeVector temp(this->GetElementRingDimension(), this->GetElementModulus().ConvertToInt());
+
 		size_t i;
 
 		for( i=0; i < value.size(); i++ ) {
@@ -84,29 +94,8 @@ bool PackedEncoding::Encode() {
 			temp[i] = NativeInteger(0);
 		this->isEncoded = true;
 
-		if ( this->typeFlag == IsNativePoly ) {
-			this->GetElement<NativePoly>().SetValues(temp, Format::EVALUATION); //the input plaintext data is in the evaluation format
-			this->Pack(&this->GetElement<NativePoly>(), this->encodingParams->GetPlaintextModulus());//ilVector coefficients are packed and resulting ilVector is in COEFFICIENT form.
-		}
-		else
-		{
-			NativePoly firstElement = this->GetElement<DCRTPoly>().GetElementAtIndex(0);
-			firstElement.SetValues(temp, Format::EVALUATION); //the input plaintext data is in the evaluation format
-			this->Pack(&firstElement, this->encodingParams->GetPlaintextModulus());//ilVector coefficients are packed and resulting ilVector is in COEFFICIENT form.
-			this->encodedVectorDCRT.SetElementAtIndex(0,firstElement);
-
-			const shared_ptr<ILDCRTParams<BigInteger>> params = this->encodedVectorDCRT.GetParams();
-			const std::vector<std::shared_ptr<ILNativeParams>> &nativeParams = params->GetParams();
-
-			for (size_t i = 1; i < nativeParams.size(); i++ ) {
-				NativePoly temp(firstElement);
-				temp.SwitchModulus(nativeParams[i]->GetModulus(),nativeParams[i]->GetRootOfUnity(),
-						nativeParams[i]->GetBigModulus(),nativeParams[i]->GetBigRootOfUnity());
-				this->encodedVectorDCRT.SetElementAtIndex(i,temp);
-			}
-
-		}
-
+		this->GetElement<NativePoly>().SetValues(temp, Format::EVALUATION); //the input plaintext data is in the evaluation format
+		this->Pack(&this->GetElement<NativePoly>(), *GetPlan(this->GetElement<NativePoly>().GetCyclotomicOrder(), this->encodingParams));//ilVector coefficients are packed and resulting ilVector is in COEFFICIENT form.
 	}
 	else {
 
@@ -140,7 +129,7 @@ bool PackedEncoding::Encode() {
 
 		this->GetElement<Poly>().SetValues(temp, Format::EVALUATION); //the input plaintext data is in the evaluation format
 
-		this->Pack(&this->GetElement<Poly>(), this->encodingParams->GetPlaintextModulus());//ilVector coefficients are packed and resulting ilVector is in COEFFICIENT form.
+		this->Pack(&this->GetElement<Poly>(), *GetPlan(this->GetElement<Poly>().GetCyclotomicOrder(), this->encodingParams));//ilVector coefficients are packed and resulting ilVector is in COEFFICIENT form.
 	}
 
 	return true;
@@ -174,18 +163,18 @@ bool PackedEncoding::Decode() {
 
 	if (( this->typeFlag == IsNativePoly ) || (this->typeFlag == IsDCRTPoly )) {
 		if ( this->typeFlag == IsNativePoly ) {
-			this->Unpack(&this->GetElement<NativePoly>(), ptm);
+			this->Unpack(&this->GetElement<NativePoly>(), *GetPlan(this->GetElement<NativePoly>().GetCyclotomicOrder(), this->encodingParams));
 			fillVec(this->encodedNativeVector, ptm, this->value);
 		}
 		else
 		{
 			NativePoly firstElement = this->GetElement<DCRTPoly>().GetElementAtIndex(0);
-			this->Unpack(&firstElement, ptm);
+			this->Unpack(&firstElement, *GetPlan(firstElement.GetCyclotomicOrder(), this->encodingParams));
 			fillVec(firstElement, ptm, this->value);
 		}
 	}
 	else {
-		this->Unpack(&this->GetElement<Poly>(), ptm);
+		this->Unpack(&this->GetElement<Poly>(), *GetPlan(this->GetElement<Poly>().GetCyclotomicOrder(), this->encodingParams));
 		fillVec(this->encodedVector, ptm, this->value);
 	}
 
@@ -194,118 +183,59 @@ bool PackedEncoding::Decode() {
 
 void PackedEncoding::Destroy()
 {
-	m_initRoot.clear();
-	m_bigModulus.clear();
-	m_bigRoot.clear();
-
-	m_automorphismGenerator.clear();
-	m_toCRTPerm.clear();
-	m_fromCRTPerm.clear();
+	PackedEncodingPlan::Clear();
 }
 
 void PackedEncoding::SetParams(usint m, EncodingParams params)
 {
-	NativeInteger modulusNI(params->GetPlaintextModulus()); //native int modulus
-	std::string exception_message;
-	bool hadEx = false;
+	std::shared_ptr<const PackedEncodingPlan> plan;
 
-	//initialize the CRT coefficients if not initialized
-#pragma omp critical
 	try {
-		if (!(m & (m - 1))) { // Check if m is a power of 2
-			SetParams_2n(m, params);
-		}
-		else {
-			const ModulusM modulusM = {modulusNI,m};
-			// Arbitrary: Bluestein based CRT Arb. So we need the 2mth root of unity
-			if (params->GetPlaintextRootOfUnity() == 0) {
-				NativeInteger initRoot = RootOfUnity<NativeInteger>(2 * m, modulusNI);
-				m_initRoot[modulusM] = initRoot;
-				params->SetPlaintextRootOfUnity(m_initRoot[modulusM].ConvertToInt());
-			}
-			else
-				m_initRoot[modulusM] = params->GetPlaintextRootOfUnity();
-
-			// Find a compatible big-modulus and root of unity for CRTArb
-			if (params->GetPlaintextBigModulus() == 0) {
-				usint nttDim = pow(2, ceil(log2(2 * m - 1)));
-				if ((modulusNI.ConvertToInt() - 1) % nttDim == 0) {
-					m_bigModulus[modulusM] = modulusNI;
-				}
-				else {
-					usint bigModulusSize = ceil(log2(2 * m - 1)) + 2 * modulusNI.GetMSB() + 1;
-					m_bigModulus[modulusM] = FirstPrime<NativeInteger>(bigModulusSize, nttDim);
-				}
-				m_bigRoot[modulusM] = RootOfUnity<NativeInteger>(nttDim, m_bigModulus[modulusM]);
-				params->SetPlaintextBigModulus(m_bigModulus[modulusM]);
-				params->SetPlaintextBigRootOfUnity(m_bigRoot[modulusM]);
-			}
-			else
-			{
-				m_bigModulus[modulusM] = params->GetPlaintextBigModulus();
-				m_bigRoot[modulusM] = params->GetPlaintextBigRootOfUnity();
-			}
-
-			// Find a generator for the automorphism group
-			if (params->GetPlaintextGenerator() == 0) {
-				NativeInteger M(m); // Hackish typecast
-				NativeInteger automorphismGenerator = FindGeneratorCyclic<NativeInteger>(M);
-				m_automorphismGenerator[m] = automorphismGenerator.ConvertToInt();
-				params->SetPlaintextGenerator(m_automorphismGenerator[m]);
-			}
-			else
-				m_automorphismGenerator[m] = params->GetPlaintextGenerator();
-
-			// Create the permutations that interchange the automorphism and crt ordering
-			usint phim = GetTotient(m);
-			auto tList = GetTotientList(m);
-			auto tIdx = std::vector<usint>(m, -1);
-			for(usint i=0; i<phim; i++){
-				tIdx[tList[i]] = i;
-			}
-
-			m_toCRTPerm[m] = std::vector<usint>(phim);
-			m_fromCRTPerm[m] = std::vector<usint>(phim);
+		plan = PackedEncodingPlan::Get(m, *params);
+	}
+	catch( std::exception& e ) {
+		throw std::logic_error(e.what());
+	}
 
-			usint curr_index = 1;
-			for (usint i=0; i<phim; i++){
-				m_toCRTPerm[m][tIdx[curr_index]] = i;
-				m_fromCRTPerm[m][i] = tIdx[curr_index];
+	if (params->GetPlaintextRootOfUnity() == 0)
+		params->SetPlaintextRootOfUnity(plan->GetRootOfUnity());
 
-				curr_index = curr_index*m_automorphismGenerator[m] % m;
-			}
+	if (m & (m - 1)) { // arbitrary cyclotomics also need the Bluestein modulus and the generator
+		if (params->GetPlaintextBigModulus() == 0) {
+			params->SetPlaintextBigModulus(plan->GetBigModulus());
+			params->SetPlaintextBigRootOfUnity(plan->GetBigRootOfUnity());
+		}
+		if (params->GetPlaintextGenerator() == 0) {
+			usint generator = plan->GetAutomorphismGenerator();
+			params->SetPlaintextGenerator(generator);
 		}
-	}
-	catch( std::exception& e ) {
-		exception_message = e.what();
-		hadEx = true;
 	}
 
-	if( hadEx )
-		throw std::logic_error(exception_message);
+	params->SetPackedEncodingPlan(plan);
 }
 
-template<typename P>
-void PackedEncoding::Pack(P *ring, const PlaintextModulus &modulus) const {
-
-	DEBUG_FLAG(false);
+std::shared_ptr<const PackedEncodingPlan> PackedEncoding::GetPlan(usint m, const EncodingParams &params) {
 
-	usint m = ring->GetCyclotomicOrder();//cyclotomic order
-	NativeInteger modulusNI(modulus);//native int modulus
+	// the plan kept in the parameters is the one for this order unless the parameters are used with several
+	std::shared_ptr<const PackedEncodingPlan> plan = params->GetPackedEncodingPlan();
+	if (!plan || !plan->Matches(m, *params)) {
+		plan = PackedEncodingPlan::Get(m, *params);
+		params->SetPackedEncodingPlan(plan);
+	}
+	return plan;
+}
 
-	const ModulusM modulusM = {modulusNI,m};
+template<typename P>
+void PackedEncoding::Pack(P *ring, const PackedEncodingPlan &plan) const {
 
-	//Do the precomputation if not initialized
-	if (this->m_initRoot[modulusM].GetMSB() == 0) {
-		SetParams(m, EncodingParams(new EncodingParamsImpl(modulus)));
-	}
+	DEBUG_FLAG(false);
 
 	usint phim = ring->GetRingDimension();
 
-	DEBUG("Pack for order " << m << " phim " << phim << " modulus " << modulusNI);
+	DEBUG("Pack for order " << plan.GetCyclotomicOrder() << " phim " << phim << " modulus " << plan.GetPlaintextModulus());
 
 	//copy values from ring to the vector
-	NativeVector slotValues(phim, modulusNI);
+	NativeVector slotValues(phim, plan.GetPlaintextModulus());
 	for (usint i = 0; i < phim; i++) {
 		slotValues[i] = (*ring)[i].ConvertToInt();
 	}
@@ -314,39 +244,7 @@ void PackedEncoding::Pack(P *ring, const PlaintextModulus &modulus) const {
 	DEBUG(slotValues);
 
 	// Transform Eval to Coeff
-	if (!(m & (m-1))) { // Check if m is a power of 2
-
-		if (m_toCRTPerm[m].size() > 0)
-		{
-			// Permute to CRT Order
-			NativeVector permutedSlots(phim, modulusNI);
-
-			for (usint i = 0; i < phim; i++) {
-				permutedSlots[i] = slotValues[m_toCRTPerm[m][i]];
-			}
-			ChineseRemainderTransformFTT<NativeVector>::InverseTransform(permutedSlots, m_initRoot[modulusM], m, &slotValues);
-		}
-		else
-		{
-			ChineseRemainderTransformFTT<NativeVector>::InverseTransform(slotValues, m_initRoot[modulusM], m, &slotValues);
-		}
-
-	} else { // Arbitrary cyclotomic
-
-		// Permute to CRT Order
-		NativeVector permutedSlots(phim, modulusNI);
-		for (usint i = 0; i < phim; i++) {
-			permutedSlots[i] = slotValues[m_toCRTPerm[m][i]];
-		}
-
-		DEBUG("permutedSlots " << permutedSlots);
-		DEBUG("m_initRoot[modulusM] " << m_initRoot[modulusM]);
-		DEBUG("m_bigModulus[modulusM] " << m_bigModulus[modulusM]);
-		DEBUG("m_bigRoot[modulusM] " << m_bigRoot[modulusM]);
-
-		slotValues = ChineseRemainderTransformArb<NativeVector>::
-				InverseTransform(permutedSlots, m_initRoot[modulusM], m_bigModulus[modulusM], m_bigRoot[modulusM], m);
-	}
+	plan.Pack(&slotValues);
 
 	DEBUG("slotvalues now " << slotValues);
 	//copy values into the slotValuesRing
@@ -360,49 +258,30 @@ void PackedEncoding::Pack(P *ring, const PlaintextModulus &modulus) const {
 }
 
 template<typename P>
-void PackedEncoding::Unpack(P *ring, const PlaintextModulus &modulus) const {
+void PackedEncoding::Unpack(P *ring, const PackedEncodingPlan &plan) const {
 
 	DEBUG_FLAG(false);
 
-	usint m = ring->GetCyclotomicOrder(); // cyclotomic order
-	NativeInteger modulusNI(modulus); //native int modulus
-
-	const ModulusM modulusM = {modulusNI,m};
-
-	//Do the precomputation if not initialized
-	if (this->m_initRoot[modulusM].GetMSB() == 0) {
-		SetParams(m, EncodingParams(new EncodingParamsImpl(modulus)));
-	}
-
 	usint phim = ring->GetRingDimension(); //ring dimension
 
-	DEBUG("Unpack for order " << m << " phim " << phim << " modulus " << modulusNI);
+	DEBUG("Unpack for order " << plan.GetCyclotomicOrder() << " phim " << phim << " modulus " << plan.GetPlaintextModulus());
 
-	//copy aggregate plaintext values
-	NativeVector packedVector(phim, modulusNI);
+	//copy aggregate plaintext values; values above q/2 were lifted from negative ones
+	const NativeInteger &p = plan.GetPlaintextModulus();
+	const typename P::Integer &q = ring->GetModulus();
+	typename P::Integer qHalf = q >> 1;
+	NativeVector packedVector(phim, p);
 	for (usint i = 0; i < phim; i++) {
-		packedVector[i] = NativeInteger((*ring)[i].ConvertToInt());
+		if ((*ring)[i] > qHalf)
+			packedVector[i] = NativeInteger(0).ModSub(NativeInteger((q - (*ring)[i]).Mod(p.ConvertToInt()).ConvertToInt()), p);
+		else
+			packedVector[i] = NativeInteger((*ring)[i].ConvertToInt());
 	}
 
 	DEBUG(packedVector);
 
 	// Transform Coeff to Eval
-	NativeVector permutedSlots(phim, modulusNI);
-	if (!(m & (m-1))) { // Check if m is a power of 2
-		ChineseRemainderTransformFTT<NativeVector>::ForwardTransform(packedVector, m_initRoot[modulusM], m, &permutedSlots);
-	} else { // Arbitrary cyclotomic
-		permutedSlots = ChineseRemainderTransformArb<NativeVector>::
-				ForwardTransform(packedVector, m_initRoot[modulusM], m_bigModulus[modulusM], m_bigRoot[modulusM], m);
-	}
-
-	if (m_fromCRTPerm[m].size() > 0) {
-		// Permute to automorphism Order
-		for (usint i = 0; i < phim; i++) {
-			packedVector[i] = permutedSlots[m_fromCRTPerm[m][i]];
-		}
-	}
-	else
-		packedVector = permutedSlots;
+	plan.Unpack(&packedVector);
 
 	DEBUG(packedVector);
 
@@ -415,74 +294,4 @@ void PackedEncoding::Unpack(P *ring, const PlaintextModulus &modulus) const {
 	ring->SetValues(packedVectorRing, Format::COEFFICIENT);
 }
 
-void PackedEncoding::SetParams_2n(usint m, const NativeInteger &modulusNI) {
-
-	const ModulusM modulusM = {modulusNI,m};
-
-	// Power of two: m/2-point FTT. So we need the mth root of unity
-	m_initRoot[modulusM] = RootOfUnity<NativeInteger>(m, modulusNI);
-
-	// Create the permutations that interchange the automorphism and crt ordering
-	// First we create the cyclic group generated by 5 and then adjoin the co-factor by multiplying by 3
-
-	usint phim = (m >> 1);
-	usint phim_by_2 = (m >> 2);
-
-	m_toCRTPerm[m] = std::vector<usint>(phim);
-	m_fromCRTPerm[m] = std::vector<usint>(phim);
-
-	usint curr_index = 1;
-	for (usint i = 0; i < phim_by_2; i++) {
-		m_toCRTPerm[m][(curr_index - 1) / 2] = i;
-		m_fromCRTPerm[m][i] = (curr_index - 1) / 2;
-
-		usint cofactor_index = curr_index * (m-1) % m;
-		m_toCRTPerm[m][(cofactor_index - 1) / 2] = i + phim_by_2;
-		m_fromCRTPerm[m][i + phim_by_2] = (cofactor_index - 1) / 2;
-
-		curr_index = curr_index * 5 % m;
-
-	}
-
-}
-
-void PackedEncoding::SetParams_2n(usint m, EncodingParams params){
-
-		NativeInteger modulusNI(params->GetPlaintextModulus()); //native int modulus
-
-		const ModulusM modulusM = {modulusNI,m};
-
-		// Power of two: m/2-point FTT. So we need the mth root of unity
-		if (params->GetPlaintextRootOfUnity() == 0)
-		{
-			m_initRoot[modulusM] = RootOfUnity<NativeInteger>(m, modulusNI);
-			params->SetPlaintextRootOfUnity(m_initRoot[modulusM]);
-		}
-		else
-			m_initRoot[modulusM] = params->GetPlaintextRootOfUnity();
-
-		// Create the permutations that interchange the automorphism and crt ordering
-		// First we create the cyclic group generated by 5 and then adjoin the co-factor by multiplying by 3
-
-		usint phim = (m >> 1);
-		usint phim_by_2 = (m >> 2);
-
-		m_toCRTPerm[m] = std::vector<usint>(phim);
-		m_fromCRTPerm[m] = std::vector<usint>(phim);
-
-		usint curr_index = 1;
-		for (usint i = 0; i < phim_by_2; i++) {
-			m_toCRTPerm[m][(curr_index - 1) / 2] = i;
-			m_fromCRTPerm[m][i] = (curr_index - 1) / 2;
-
-			usint cofactor_index = curr_index * (m-1) % m;
-			m_toCRTPerm[m][(cofactor_index - 1) / 2] = i + phim_by_2;
-			m_fromCRTPerm[m][i + phim_by_2] = (cofactor_index - 1) / 2;
-
-			curr_index = curr_index * 5 % m;
-
-		}
-
-	}
-
 }
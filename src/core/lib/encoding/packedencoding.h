@@ -31,15 +31,13 @@
 #include <initializer_list>
 #include "plaintext.h"
 #include "encodingparams.h"
+#include "packedencodingplan.h"
 #include <functional>
 #include <numeric>
 
 namespace lbcrypto
 {
 
-// STL pair used as a key for some tables in PackedEncoding
-using ModulusM = std::pair<NativeInteger, uint64_t>;
-
 /**
  * @class PackedEncoding
  * @brief Type used for representing IntArray types.
@@ -102,7 +100,7 @@ public:
 		: PlaintextImpl(shared_ptr<Poly::Params>(0),NULL), value() {}
 
 	static usint GetAutomorphismGenerator(usint m) {
-		return m_automorphismGenerator[m];
+		return PackedEncodingPlan::GetAutomorphismGenerator(m);
 	}
 
 	bool Encode();
@@ -146,6 +144,15 @@ public:
 	*/
 	static void SetParams(usint m, const PlaintextModulus &modulus) __attribute__ ((deprecated("use SetParams(usint m, EncodingParams p)")));
 
+	/**
+	* @brief Finds the plan for encoding parameters and a cyclotomic order, and keeps it in the parameters.
+	*
+	* @param m is the cyclotomic order.
+	* @param params are the encoding parameters.
+	* @return the plan.
+	*/
+	static std::shared_ptr<const PackedEncodingPlan> GetPlan(usint m, const EncodingParams &params);
+
 	/**
 	 * SetLength of the plaintext to the given size
 	 * @param siz
@@ -186,38 +193,23 @@ public:
 	}
 
 private:
-	//initial root of unity for plaintext space
-	static std::map<ModulusM, NativeInteger> m_initRoot;
-	//modulus and root of unity to be used for Arbitrary CRT
-	static std::map<ModulusM, NativeInteger> m_bigModulus;
-	static std::map<ModulusM, NativeInteger> m_bigRoot;
-
-	//stores the list of primitive roots used in packing.
-	static std::map<usint, usint> m_automorphismGenerator;
-	static std::map<usint, std::vector<usint>> m_toCRTPerm;
-	static std::map<usint, std::vector<usint>> m_fromCRTPerm;
-
-	static void SetParams_2n(usint m, const NativeInteger &modulusNI);
-
-	static void SetParams_2n(usint m, EncodingParams params);
-
 	/**
 	* @brief Packs the slot values into aggregate plaintext space.
 	*
 	* @param ring is the element containing slot values.
-	* @param modulus is the plaintext modulus used for packing.
+	* @param plan is the plan for the plaintext modulus and the cyclotomic order of ring.
 	*/
 	template<typename P>
-	void Pack(P *ring, const PlaintextModulus &modulus) const;
+	void Pack(P *ring, const PackedEncodingPlan &plan) const;
 
 	/**
 	* @brief Unpacks the data from aggregated plaintext to slot values.
 	*
 	* @param ring is the input polynomial ring in aggregate plaintext.
-	* @param modulus is the plaintext modulus used in packing operation.
+	* @param plan is the plan for the plaintext modulus and the cyclotomic order of ring.
 	*/
 	template<typename P>
-	void Unpack(P *ring, const PlaintextModulus &modulus) const;
+	void Unpack(P *ring, const PackedEncodingPlan &plan) const;
 
 };
 
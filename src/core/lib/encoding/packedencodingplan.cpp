@@ -0,0 +1,341 @@
+/*
+ * @file packedencodingplan.cpp Precomputed tables for packing and unpacking plaintext slots.
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or other
+ * materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <map>
+#include <mutex>
+
+#include "packedencodingplan.h"
+#include "math/nbtheory.h"
+#include "math/transfrm.h"
+#include "utils/precomputecache.h"
+
+namespace lbcrypto {
+
+// the plans built so far, by plaintext modulus and cyclotomic order
+static std::map<std::pair<NativeInteger, usint>, std::shared_ptr<const PackedEncodingPlan>> s_plans;
+static std::mutex s_plansMutex;
+// automorphism generator of the last plan built for each cyclotomic order
+static std::map<usint, usint> s_generators;
+
+PackedEncodingPlan::PackedEncodingPlan(usint m, const EncodingParamsImpl &params)
+	: m_m(m), m_modulus(params.GetPlaintextModulus()), m_generator(params.GetPlaintextGenerator())
+{
+	if (!(m & (m - 1))) { // Check if m is a power of 2
+
+		// Power of two: m/2-point FTT. So we need the mth root of unity
+		m_root = params.GetPlaintextRootOfUnity() == 0 ? RootOfUnity<NativeInteger>(m, m_modulus) : params.GetPlaintextRootOfUnity();
+
+		// Create the permutations that interchange the automorphism and crt ordering
+		// First we create the cyclic group generated by 5 and then adjoin the co-factor by multiplying by 3
+
+		usint phim = (m >> 1);
+		usint phim_by_2 = (m >> 2);
+
+		m_toCRTPerm.resize(phim);
+		m_fromCRTPerm.resize(phim);
+
+		usint curr_index = 1;
+		for (usint i = 0; i < phim_by_2; i++) {
+			m_toCRTPerm[(curr_index - 1) / 2] = i;
+			m_fromCRTPerm[i] = (curr_index - 1) / 2;
+
+			usint cofactor_index = curr_index * (m-1) % m;
+			m_toCRTPerm[(cofactor_index - 1) / 2] = i + phim_by_2;
+			m_fromCRTPerm[i + phim_by_2] = (cofactor_index - 1) / 2;
+
+			curr_index = curr_index * 5 % m;
+		}
+
+		BuildNTTTables();
+	}
+	else {
+		// Arbitrary: Bluestein based CRT Arb. So we need the 2mth root of unity
+		m_root = params.GetPlaintextRootOfUnity() == 0 ? RootOfUnity<NativeInteger>(2 * m, m_modulus) : params.GetPlaintextRootOfUnity();
+
+		// Find a compatible big-modulus and root of unity for CRTArb
+		if (params.GetPlaintextBigModulus() == 0) {
+			usint nttDim = pow(2, ceil(log2(2 * m - 1)));
+			if ((m_modulus.ConvertToInt() - 1) % nttDim == 0) {
+				m_bigModulus = m_modulus;
+			}
+			else {
+				usint bigModulusSize = ceil(log2(2 * m - 1)) + 2 * m_modulus.GetMSB() + 1;
+				m_bigModulus = FirstPrime<NativeInteger>(bigModulusSize, nttDim);
+			}
+			m_bigRoot = RootOfUnity<NativeInteger>(nttDim, m_bigModulus);
+		}
+		else {
+			m_bigModulus = params.GetPlaintextBigModulus();
+			m_bigRoot = params.GetPlaintextBigRootOfUnity();
+		}
+
+		// Find a generator for the automorphism group
+		if (m_generator == 0) {
+			NativeInteger M(m); // Hackish typecast
+			m_generator = FindGeneratorCyclic<NativeInteger>(M).ConvertToInt();
+		}
+
+		// Create the permutations that interchange the automorphism and crt ordering
+		usint phim = GetTotient(m);
+		auto tList = GetTotientList(m);
+		auto tIdx = std::vector<usint>(m, -1);
+		for(usint i=0; i<phim; i++){
+			tIdx[tList[i]] = i;
+		}
+
+		m_toCRTPerm.resize(phim);
+		m_fromCRTPerm.resize(phim);
+
+		usint curr_index = 1;
+		for (usint i=0; i<phim; i++){
+			m_toCRTPerm[tIdx[curr_index]] = i;
+			m_fromCRTPerm[i] = tIdx[curr_index];
+
+			curr_index = curr_index*m_generator % m;
+		}
+
+		// one transform in each direction computes the Bluestein tables, so that packing only reads them
+		NativeVector values(phim, m_modulus);
+		Unpack(&values);
+		Pack(&values);
+	}
+}
+
+void PackedEncodingPlan::BuildNTTTables() {
+
+	if (m_root == NativeInteger(1) || m_root == NativeInteger(0))
+		return;
+
+	usint n = m_m >> 1;
+
+	const std::vector<NativeInteger> moduli = { m_modulus };
+	const std::vector<NativeInteger> roots = { m_root };
+	const std::string key = PrecomputeCache::Enabled() ? PrecomputeCache::MakeKey("PackedEncodingPlan", m_m, moduli, roots, 0) : std::string();
+
+	PrecomputeTableReader cached;
+	if (!key.empty() && PrecomputeCache::Load(key, &cached)) {
+		try {
+			cached(m_rootTable);
+			cached(m_rootInverseTable);
+			cached(m_rootPreconTable);
+			cached(m_rootInversePreconTable);
+			if (cached.AtEnd() && m_rootTable.GetLength() == n && m_rootInverseTable.GetLength() == n &&
+					m_rootPreconTable.GetLength() == n && m_rootInversePreconTable.GetLength() == n)
+				return;
+		}
+		catch (deserialize_error&) {
+			// computed again below
+		}
+	}
+
+	NativeInteger rootInverse;
+	try {
+		rootInverse = m_root.ModInverse(m_modulus);
+	}
+	catch (std::exception& e) {
+		throw std::logic_error(std::string(e.what()) + ": rootOfUnity " + m_root.ToString() + " has no inverse");
+	}
+
+	m_rootTable = NativeVector(n, m_modulus);
+	m_rootInverseTable = NativeVector(n, m_modulus);
+	m_rootPreconTable = NativeVector(n, m_modulus);
+	m_rootInversePreconTable = NativeVector(n, m_modulus);
+
+	NativeInteger x(1);
+	NativeInteger xInverse(1);
+	for (usint i = 0; i < n; i++) {
+		m_rootTable[i] = x;
+		m_rootInverseTable[i] = xInverse;
+		x.ModMulEq(m_root, m_modulus);
+		xInverse.ModMulEq(rootInverse, m_modulus);
+	}
+
+	if (m_modulus.GetMSB() < MAX_MODULUS_SIZE + 1) {
+		for (usint i = 0; i < n; i++) {
+			m_rootPreconTable[i] = m_rootTable[i].PrepModMulPreconOptimized(m_modulus);
+			m_rootInversePreconTable[i] = m_rootInverseTable[i].PrepModMulPreconOptimized(m_modulus);
+		}
+	}
+
+	if (!key.empty()) {
+		PrecomputeTableWriter tables;
+		tables(m_rootTable);
+		tables(m_rootInverseTable);
+		tables(m_rootPreconTable);
+		tables(m_rootInversePreconTable);
+		PrecomputeCache::Store(key, tables);
+	}
+}
+
+std::shared_ptr<const PackedEncodingPlan> PackedEncodingPlan::Get(usint m, const EncodingParamsImpl &params) {
+
+	const std::pair<NativeInteger, usint> key = {NativeInteger(params.GetPlaintextModulus()), m};
+
+	std::lock_guard<std::mutex> lock(s_plansMutex);
+
+	auto found = s_plans.find(key);
+	if (found != s_plans.end() && found->second->Matches(m, params))
+		return found->second;
+
+	// a plan with other roots replaces the one stored, as the last parameters set are the ones used
+	std::shared_ptr<const PackedEncodingPlan> plan(new PackedEncodingPlan(m, params));
+	s_plans[key] = plan;
+	s_generators[m] = plan->GetAutomorphismGenerator();
+	return plan;
+}
+
+usint PackedEncodingPlan::GetAutomorphismGenerator(usint m) {
+
+	std::lock_guard<std::mutex> lock(s_plansMutex);
+
+	auto found = s_generators.find(m);
+	return found == s_generators.end() ? 0 : found->second;
+}
+
+void PackedEncodingPlan::Clear() {
+	std::lock_guard<std::mutex> lock(s_plansMutex);
+	s_plans.clear();
+	s_generators.clear();
+}
+
+bool PackedEncodingPlan::Matches(usint m, const EncodingParamsImpl &params) const {
+	return m_m == m &&
+			m_modulus == NativeInteger(params.GetPlaintextModulus()) &&
+			(params.GetPlaintextRootOfUnity() == 0 || params.GetPlaintextRootOfUnity() == m_root) &&
+			(params.GetPlaintextBigModulus() == 0 || (params.GetPlaintextBigModulus() == m_bigModulus &&
+					params.GetPlaintextBigRootOfUnity() == m_bigRoot)) &&
+			(params.GetPlaintextGenerator() == 0 || params.GetPlaintextGenerator() == m_generator);
+}
+
+void PackedEncodingPlan::Pack(NativeVector *values) const {
+
+	usint phim = m_toCRTPerm.size();
+
+	if (values->GetLength() != phim)
+		PALISADE_THROW(math_error, "PackedEncodingPlan::Pack expects " + std::to_string(phim) + " slot values");
+
+	// Permute to CRT Order
+	NativeVector permutedSlots(phim, m_modulus);
+	for (usint i = 0; i < phim; i++)
+		permutedSlots[i] = (*values)[m_toCRTPerm[i]];
+
+	InverseTransform(permutedSlots, values);
+}
+
+void PackedEncodingPlan::Pack(const std::vector<int64_t> &slots, NativeVector *coefficients) const {
+
+	usint phim = m_toCRTPerm.size();
+
+	if (slots.size() > phim)
+		PALISADE_THROW(math_error, "PackedEncodingPlan::Pack expects at most " + std::to_string(phim) + " slot values");
+
+	const uint64_t p = m_modulus.ConvertToInt();
+
+	// Permute to CRT Order, mapping negative values to [0, p)
+	NativeVector permutedSlots(phim, m_modulus);
+	for (usint i = 0; i < phim; i++) {
+		usint j = m_toCRTPerm[i];
+		if (j >= slots.size())
+			continue;
+		// negated as unsigned, as llabs is undefined for the most negative value
+		uint64_t magnitude = slots[j] < 0 ? uint64_t(0) - uint64_t(slots[j]) : uint64_t(slots[j]);
+		if (magnitude >= p)
+			throw std::logic_error("Cannot encode integer " + std::to_string(slots[j]) +
+					" at position " + std::to_string(j) +
+					" that is > plaintext modulus " + std::to_string(p) );
+		permutedSlots[i] = slots[j] < 0 ? p - magnitude : magnitude;
+	}
+
+	if (coefficients->GetLength() != phim)
+		*coefficients = NativeVector(phim, m_modulus);
+	InverseTransform(permutedSlots, coefficients);
+}
+
+void PackedEncodingPlan::InverseTransform(const NativeVector &permutedSlots, NativeVector *values) const {
+
+	usint phim = permutedSlots.GetLength();
+
+	// Transform Eval to Coeff
+	if (!(m_m & (m_m-1))) { // Check if m is a power of 2
+
+		if (m_rootTable.GetLength() == 0) {
+			*values = permutedSlots;
+			return;
+		}
+
+		NumberTheoreticTransform<NativeVector>::InverseTransformIterative(permutedSlots, m_rootInverseTable,
+				m_rootInversePreconTable, phim, values);
+
+		if (m_modulus.GetMSB() < MAX_MODULUS_SIZE + 1)
+			for (usint i = 0; i < phim; i++)
+				(*values)[i].ModMulPreconOptimizedEq(m_rootInverseTable[i], m_modulus, m_rootInversePreconTable[i]);
+		else
+			for (usint i = 0; i < phim; i++)
+				(*values)[i].ModMulEq(m_rootInverseTable[i], m_modulus);
+
+	} else { // Arbitrary cyclotomic
+		*values = ChineseRemainderTransformArb<NativeVector>::
+				InverseTransform(permutedSlots, m_root, m_bigModulus, m_bigRoot, m_m);
+	}
+}
+
+void PackedEncodingPlan::Unpack(NativeVector *values) const {
+
+	usint phim = m_fromCRTPerm.size();
+
+	if (values->GetLength() != phim)
+		PALISADE_THROW(math_error, "PackedEncodingPlan::Unpack expects " + std::to_string(phim) + " coefficients");
+
+	// Transform Coeff to Eval
+	NativeVector permutedSlots(phim, m_modulus);
+	if (!(m_m & (m_m-1))) { // Check if m is a power of 2
+
+		if (m_rootTable.GetLength() == 0)
+			permutedSlots = *values;
+		else {
+			NativeVector twisted(phim, m_modulus);
+			if (m_modulus.GetMSB() < MAX_MODULUS_SIZE + 1)
+				for (usint i = 0; i < phim; i++)
+					twisted[i] = (*values)[i].ModMulPreconOptimized(m_rootTable[i], m_modulus, m_rootPreconTable[i]);
+			else
+				for (usint i = 0; i < phim; i++)
+					twisted[i] = (*values)[i].ModMulFast(m_rootTable[i], m_modulus);
+
+			NumberTheoreticTransform<NativeVector>::ForwardTransformIterative(twisted, m_rootTable,
+					m_rootPreconTable, phim, &permutedSlots);
+		}
+
+	} else { // Arbitrary cyclotomic
+		permutedSlots = ChineseRemainderTransformArb<NativeVector>::
+				ForwardTransform(*values, m_root, m_bigModulus, m_bigRoot, m_m);
+	}
+
+	// Permute to automorphism Order
+	for (usint i = 0; i < phim; i++)
+		(*values)[i] = permutedSlots[m_fromCRTPerm[i]];
+}
+
+}
@@ -0,0 +1,145 @@
+/**
+ * @file packedencodingplan.h Precomputed tables for packing and unpacking plaintext slots.
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or other
+ * materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#ifndef LBCRYPTO_ENCODING_PACKEDENCODINGPLAN_H
+#define LBCRYPTO_ENCODING_PACKEDENCODINGPLAN_H
+
+#include <memory>
+#include <vector>
+
+#include "encodingparams.h"
+
+namespace lbcrypto
+{
+
+/**
+ * @class PackedEncodingPlan
+ * @brief Everything PackedEncoding needs to move slot values between the automorphism order of the
+ * slots and the coefficients of a plaintext, for one plaintext modulus and cyclotomic order.
+ *
+ * A plan holds the permutations between the automorphism and CRT orders and, for power-of-two
+ * cyclotomic orders, its own NTT tables. It is never changed once built, so any number of threads
+ * can pack and unpack through the same plan. Arbitrary cyclotomic orders use the Bluestein tables
+ * kept by ChineseRemainderTransformArb; the plan computes them when it is built.
+ */
+class PackedEncodingPlan
+{
+public:
+	/**
+	 * Build a plan. The root of unity, big modulus, its root of unity and the automorphism generator
+	 * are taken from params when they are set there, and computed otherwise.
+	 *
+	 * @param m - the cyclotomic order
+	 * @param params - the encoding parameters; only read
+	 */
+	PackedEncodingPlan(usint m, const EncodingParamsImpl &params);
+
+	/**
+	 * Find the plan for the plaintext modulus of params and a cyclotomic order, building it if no
+	 * plan that agrees with params was built before.
+	 *
+	 * @param m - the cyclotomic order
+	 * @param params - the encoding parameters
+	 * @return the plan
+	 */
+	static std::shared_ptr<const PackedEncodingPlan> Get(usint m, const EncodingParamsImpl &params);
+
+	/**
+	 * @param m - a cyclotomic order
+	 * @return the automorphism generator of the last plan built for m, or 0 if there is none
+	 */
+	static usint GetAutomorphismGenerator(usint m);
+
+	/**
+	 * Forget every plan built so far; plans still held by EncodingParams stay valid
+	 */
+	static void Clear();
+
+	/**
+	 * @param m - a cyclotomic order
+	 * @param params - encoding parameters
+	 * @return true if this plan is for m and the plaintext modulus of params, and agrees with every
+	 * root of unity, big modulus and generator set in params
+	 */
+	bool Matches(usint m, const EncodingParamsImpl &params) const;
+
+	/**
+	 * Turn slot values, in automorphism order, into plaintext coefficients
+	 *
+	 * @param values - the slot values; replaced by the coefficients
+	 */
+	void Pack(NativeVector *values) const;
+
+	/**
+	 * Turn slot values, in automorphism order, into plaintext coefficients; the values are permuted
+	 * straight into the buffer the inverse transform reads
+	 *
+	 * @param slots - the slot values, each of magnitude less than the plaintext modulus, or a
+	 * std::logic_error is thrown; slots past the end of the vector are zero
+	 * @param coefficients - the coefficients, in [0, p) - output; a vector of the right length is reused
+	 */
+	void Pack(const std::vector<int64_t> &slots, NativeVector *coefficients) const;
+
+	/**
+	 * Turn plaintext coefficients into slot values in automorphism order
+	 *
+	 * @param values - the coefficients; replaced by the slot values
+	 */
+	void Unpack(NativeVector *values) const;
+
+	usint GetCyclotomicOrder() const { return m_m; }
+	usint GetRingDimension() const { return m_toCRTPerm.size(); }
+	const NativeInteger &GetPlaintextModulus() const { return m_modulus; }
+	const NativeInteger &GetRootOfUnity() const { return m_root; }
+	const NativeInteger &GetBigModulus() const { return m_bigModulus; }
+	const NativeInteger &GetBigRootOfUnity() const { return m_bigRoot; }
+	usint GetAutomorphismGenerator() const { return m_generator; }
+
+private:
+	void BuildNTTTables();
+
+	void InverseTransform(const NativeVector &permutedSlots, NativeVector *values) const;
+
+	usint						m_m;
+	NativeInteger				m_modulus;
+	NativeInteger				m_root;
+	// modulus and root of unity used by the Bluestein transform of arbitrary cyclotomics
+	NativeInteger				m_bigModulus;
+	NativeInteger				m_bigRoot;
+	usint						m_generator;
+
+	std::vector<usint>			m_toCRTPerm;
+	std::vector<usint>			m_fromCRTPerm;
+
+	// powers of the root of unity and its inverse, and their precomputations; power-of-two orders only
+	NativeVector				m_rootTable;
+	NativeVector				m_rootInverseTable;
+	NativeVector				m_rootPreconTable;
+	NativeVector				m_rootInversePreconTable;
+};
+
+}
+
+#endif
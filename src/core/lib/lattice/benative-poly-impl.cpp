@@ -32,6 +32,7 @@
 #include "elemparams.cpp"
 #include "ilparams.cpp"
 #include "poly.cpp"
+#include "slabmatrix.cpp"
 
 namespace lbcrypto {
 
@@ -50,6 +51,8 @@ SPLIT32ALT_FOR_TYPE(NativePoly)
 template Matrix<NativeVector> RotateVecResult(Matrix<NativePoly> const& inMat);
 template Matrix<NativeInteger> Rotate(Matrix<NativePoly> const& inMat);
 
+template class SlabMatrix<NativePoly>;
+
 }  // namespace lbcrypto
 
 CEREAL_CLASS_VERSION( lbcrypto::NativePoly, lbcrypto::NativePoly::SerializedVersion() );
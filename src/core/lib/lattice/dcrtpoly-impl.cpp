@@ -33,6 +33,7 @@
 #include "../math/ternaryuniformgenerator.cpp"
 #include "dcrtpoly.cpp"
 #include "poly.cpp"
+#include "slabmatrix.cpp"
 
 // This creates all the necessary class implementations for DCRTPoly
 
@@ -41,10 +42,13 @@ namespace lbcrypto
 
 template class ILDCRTParams<M2Integer>;
 template class DCRTPolyImpl<M2Vector>;
+template class SlabMatrix<M2DCRTPoly>;
 template class ILDCRTParams<M4Integer>;
 template class DCRTPolyImpl<M4Vector>;
+template class SlabMatrix<M4DCRTPoly>;
 #ifdef WITH_NTL
 template class ILDCRTParams<M6Integer>;
 template class DCRTPolyImpl<M6Vector>;
+template class SlabMatrix<M6DCRTPoly>;
 #endif
 }
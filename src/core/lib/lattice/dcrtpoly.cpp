@@ -1311,10 +1311,90 @@ typename DCRTPolyImpl<VecType>::PolyLargeType DCRTPolyImpl<VecType>::CRTInterpol
 }
 
 
-// todo can we be smarter with this method?
+// Reduces the centered representative of x mod q to mod p without leaving RNS, using the fast base
+// conversion of ScaleAndRound and SwitchCRTBasis:
+// x = \sum_i y_i*q/qi - v*q, where y_i = [x_i*(q/qi)^{-1}]_qi and v = Round(\sum_i y_i/qi)
+// Rounding v to the nearest integer selects the representative in (-q/2, q/2), so
+// [x]_p = [\sum_i y_i*[q/qi]_p - v*[q]_p]_p.
+// The sum of y_i/qi is kept in double precision; it is only misrounded when x is within about
+// nTowers*2^{-52}*q of +-q/2, where decryption fails anyway.
 template<typename VecType>
 NativePoly DCRTPolyImpl<VecType>::DecryptionCRTInterpolate(PlaintextModulus ptm) const {
-    return this->CRTInterpolate().DecryptionCRTInterpolate(ptm);
+
+    usint ringDimension = GetRingDimension();
+    usint nTowers = m_vectors.size();
+
+    const NativeInteger p(ptm);
+
+    // Barrett and Shoup reductions mod p need a few spare bits
+    if( p.GetMSB() > MAX_MODULUS_SIZE )
+        return this->CRTInterpolate().DecryptionCRTInterpolate(ptm);
+
+    // the CRT factors only take O(nTowers^2) native operations, so they are not kept between calls
+    std::vector<NativeInteger> qHatInv(nTowers);
+    std::vector<NativeInteger> qHatInvPrecon(nTowers);
+    std::vector<NativeInteger> qHatModp(nTowers);
+    std::vector<NativeInteger> qHatModpPrecon(nTowers);
+    std::vector<double> qInv(nTowers);
+    NativeInteger qModp(1);
+    for( usint i = 0; i < nTowers; i++ ) {
+        const NativeInteger &qi = m_vectors[i].GetModulus();
+        NativeInteger qHat(1);
+        NativeInteger qHatp(1);
+        for( usint j = 0; j < nTowers; j++ ) {
+            if( j == i )
+                continue;
+            const NativeInteger &qj = m_vectors[j].GetModulus();
+            qHat = qHat.ModMul(qj.Mod(qi), qi);
+            qHatp = qHatp.ModMul(qj.Mod(p), p);
+        }
+        qHatInv[i] = qHat.ModInverse(qi);
+        qHatInvPrecon[i] = qHatInv[i].PrepModMulPreconOptimized(qi);
+        qHatModp[i] = qHatp;
+        qHatModpPrecon[i] = qHatp.PrepModMulPreconOptimized(p);
+        qInv[i] = 1.0/qi.ConvertToDouble();
+        qModp = qModp.ModMul(qi.Mod(p), p);
+    }
+
+    // v*[q]_p for every v the rounding can produce
+    std::vector<NativeInteger> vqModp(nTowers + 1);
+    for( usint v = 0; v <= nTowers; v++ )
+        vqModp[v] = NativeInteger(v).ModMul(qModp, p);
+
+    // the towers are needed in coefficient form
+    const std::vector<PolyType> *vecs = &m_vectors;
+    std::vector<PolyType> coeffVecs;
+    if( m_format == EVALUATION ) {
+        coeffVecs = m_vectors;
+#pragma omp parallel for
+        for( usint i = 0; i < nTowers; i++ )
+            coeffVecs[i].SetFormat(COEFFICIENT);
+        vecs = &coeffVecs;
+    }
+
+    NativeVector coefficients(ringDimension, p);
+
+#pragma omp parallel for
+    for( usint ri = 0; ri < ringDimension; ri++ ) {
+        double curFloatSum = 0.0;
+        NativeInteger curIntSum = 0;
+        for( usint vi = 0; vi < nTowers; vi++ ) {
+            const NativeInteger &qi = (*vecs)[vi].GetModulus();
+            NativeInteger yi = (*vecs)[vi].GetValues()[ri].ModMulPreconOptimized(qHatInv[vi], qi, qHatInvPrecon[vi]);
+
+            curIntSum.ModAddFastEq(yi.ModMulPreconOptimized(qHatModp[vi], p, qHatModpPrecon[vi]), p);
+            curFloatSum += yi.ConvertToDouble()*qInv[vi];
+        }
+
+        coefficients[ri] = curIntSum.ModSubFast(vqModp[std::llround(curFloatSum)], p);
+    }
+
+    // Setting the root of unity to ONE as the calculation is expensive
+    // It is assumed that no polynomial multiplications in evaluation representation are performed after this
+    NativePoly result( shared_ptr<ILNativeParams>( new ILNativeParams(GetCyclotomicOrder(), ptm, 1) ) );
+    result.SetValues(std::move(coefficients), COEFFICIENT);
+
+    return std::move(result);
 }
 
 //Source: Halevi S., Polyakov Y., and Shoup V. An Improved RNS Variant of the BFV Homomorphic Encryption Scheme. Cryptology ePrint Archive, Report 2018/117. (https://eprint.iacr.org/2018/117)
@@ -1471,10 +1551,11 @@ DCRTPolyImpl<VecType> DCRTPolyImpl<VecType>::SwitchCRTBasis(
     usint nTowers = m_vectors.size();
     usint nTowersNew = ans.m_vectors.size();
 
-    std::vector<NativeInteger> mu(nTowersNew);
+    // qModsi is fixed per tower, so the multiplication by it uses a precomputation instead of Barrett reduction
+    std::vector<NativeInteger> qModsiPrecon(nTowersNew);
     for (usint i = 0; i < nTowersNew; i ++ ) {
     	const NativeInteger &si = ans.m_vectors[i].GetModulus();
-    	mu[i] = si.ComputeMu();
+    	qModsiPrecon[i] = qModsi[i].PrepModMulPreconOptimized(si);
     }
 
 #pragma omp parallel for
@@ -1512,7 +1593,7 @@ DCRTPolyImpl<VecType> DCRTPolyImpl<VecType>::SwitchCRTBasis(
             const NativeInteger &curNativeValue = NativeInteger(BarrettUint128ModUint64( curValue, si.ConvertToInt(), siModulimu[newvIndex]));
 
             //second round - remove q-overflows
-            ans.m_vectors[newvIndex].at(rIndex) = curNativeValue.ModSubFast(alpha.ModMulFastOptimized(qModsi[newvIndex],si,mu[newvIndex]),si);
+            ans.m_vectors[newvIndex].at(rIndex) = curNativeValue.ModSubFast(alpha.ModMulPreconOptimized(qModsi[newvIndex],si,qModsiPrecon[newvIndex]),si);
 
         }
 
@@ -747,6 +747,14 @@ public:
 	*/
 	PolyLargeType CRTInterpolate() const;
 
+	/**
+	* @brief Reduces the element, lifted to (-q/2, q/2), mod ptm; used in the decryption of BGV, StSt and
+	* the other schemes that keep the plaintext in the low-order bits. The computation stays in RNS,
+	* like ScaleAndRound, instead of interpolating to multiprecision integers.
+	*
+	* @param ptm the plaintext modulus
+	* @return the result as a polynomial with native 64-bit coefficients mod ptm, in COEFFICIENT format
+	*/
 	PolyType DecryptionCRTInterpolate(PlaintextModulus ptm) const;
 
 
@@ -1071,6 +1079,12 @@ public:
 	template <class Archive>
 	void save( Archive & ar, std::uint32_t const version ) const
 	{
+		// small errors in several residues are not small in the composed integer,
+		// so low-order bits may only be dropped from a single tower
+		BinaryPacking packing = BinaryPacking::Current();
+		packing.lossy = packing.lossy && m_vectors.size() == 1;
+		BinaryPackingScope scope(packing);
+
 		ar( ::cereal::make_nvp("v", m_vectors) );
 		ar( ::cereal::make_nvp("f", m_format) );
 		ar( ::cereal::make_nvp("p", m_params) );
@@ -394,11 +394,11 @@ namespace lbcrypto {
 				qF1(i,0) = Field2n(q1->ExtractRows(i*n,i*n+n-1));
 
 			Field2n det(n,EVALUATION,true);
-			D.Determinant(&det);
+			Matrix<Field2n> adjugate = D.Adjugate(&det);
 
 			Field2n detInverse = det.Inverse();
 
-			Dinverse = (D.CofactorMatrix()).Transpose() * detInverse;
+			Dinverse = adjugate * detInverse;
 
 		}
 
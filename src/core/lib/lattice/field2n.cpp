@@ -309,21 +309,11 @@ Field2n Field2n::ScalarMult(double d)
 void Field2n::SwitchFormat()
 {
 	if (format == COEFFICIENT) {
-		std::vector<std::complex<double>> r = DiscreteFourierTransform::ForwardTransform(*this);
-
-		for (size_t i = 0; i < r.size(); i++) {
-			this->at(i) = r.at(i);
-		}
-
+		DiscreteFourierTransform::ForwardTransformInPlace(*this);
 		format = EVALUATION;
 	} else {
-		std::vector<std::complex<double>> r = DiscreteFourierTransform::InverseTransform(*this);
-
-		for (size_t i = 0; i < r.size(); i++) {
-			this->at(i) = r.at(i);
-		}
+		DiscreteFourierTransform::InverseTransformInPlace(*this);
 		format = COEFFICIENT;
-
 	}
 }
 }
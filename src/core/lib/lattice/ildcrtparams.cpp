@@ -42,17 +42,16 @@ ILDCRTParams<IntType>::ILDCRTParams(usint order, usint depth, usint bits) : Elem
 	m_parms.resize(depth);
 	this->ciphertextModulus = IntType(0);
 
-	NativeInteger q = FirstPrime<NativeInteger>(bits, order);
+	std::vector<NativeInteger> moduli(depth);
+	moduli[0] = FirstPrime<NativeInteger>(bits, order);
+	for(size_t j = 1; j < depth; j++)
+		moduli[j] = NextPrime<NativeInteger>(moduli[j-1], order);
 
-	for(size_t j = 0; ;) {
-		NativeInteger root = RootOfUnity<NativeInteger>(order, q);
-		std::shared_ptr<ILNativeParams> p( new ILNativeParams(order, q, root) );
-		m_parms[j] = p;
-
-		if( ++j >= depth )
-			break;
+	std::vector<NativeInteger> roots = RootsOfUnity<NativeInteger>(order, moduli);
 
-		q = NextPrime<NativeInteger>(q, order);
+	for(size_t j = 0; j < depth; j++) {
+		std::shared_ptr<ILNativeParams> p( new ILNativeParams(order, moduli[j], roots[j]) );
+		m_parms[j] = p;
 	}
 
 	RecalculateModulus();
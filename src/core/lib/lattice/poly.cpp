@@ -509,6 +509,19 @@ void PolyImpl<VecType>::SetValues(const VecType& values, Format format)
 	m_format = format;
 }
 
+template<typename VecType>
+void PolyImpl<VecType>::SetValues(VecType&& values, Format format)
+{
+	if (m_params->GetRootOfUnity() == Integer(0)){
+		PALISADE_THROW(type_error, "Polynomial has a 0 root of unity");
+	}
+	if (m_params->GetRingDimension() != values.GetLength() || m_params->GetModulus() != values.GetModulus()) {
+		PALISADE_THROW(type_error, "Parameter mismatch on SetValues for Polynomial");
+	}
+	m_values = make_unique<VecType>(std::move(values));
+	m_format = format;
+}
+
 template<typename VecType>
 void PolyImpl<VecType>::SetValuesToZero()
 {
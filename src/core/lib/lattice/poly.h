@@ -398,6 +398,14 @@ public:
 	 */
 	void SetValues(const VecType& values, Format format);
 
+	/**
+	 * @brief Set method of the values, taking over the given vector.
+	 *
+	 * @param values is the set of values of the vector.
+	 * @param format is the format, either COEFFICIENT or EVALUATION.
+	 */
+	void SetValues(VecType&& values, Format format);
+
 	/**
 	 * @brief Sets all values of element to zero.
 	 */
@@ -0,0 +1,295 @@
+/**
+ * @file slabmatrix.cpp This code provides a matrix of ring elements stored in one contiguous slab
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or other
+ * materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef LBCRYPTO_LATTICE_SLABMATRIX_CPP
+#define LBCRYPTO_LATTICE_SLABMATRIX_CPP
+
+#include "slabmatrix.h"
+
+namespace lbcrypto {
+
+template<class Element>
+SlabMatrix<Element>::SlabMatrix(const shared_ptr<ParmType> params, size_t rows, size_t cols, Format format)
+	: m_rows(0), m_cols(0), m_ringDim(0), m_format(format) {
+	Init(params, rows, cols, format);
+}
+
+template<class Element>
+SlabMatrix<Element>::SlabMatrix(const Matrix<Element>& other)
+	: m_rows(0), m_cols(0), m_ringDim(0), m_format(EVALUATION) {
+
+	if( other.GetRows() == 0 || other.GetCols() == 0 )
+		PALISADE_THROW(math_error, "Cannot build a SlabMatrix from an empty Matrix");
+
+	Init(other(0,0).GetParams(), other.GetRows(), other.GetCols(), other(0,0).GetFormat());
+
+#pragma omp parallel for
+	for( size_t row = 0; row < m_rows; row++ )
+		for( size_t col = 0; col < m_cols; col++ )
+			SetElement(row, col, other(row, col));
+}
+
+template<class Element>
+void SlabMatrix<Element>::Init(const shared_ptr<ParmType> params, size_t rows, size_t cols, Format format) {
+	if( params == nullptr )
+		PALISADE_THROW(math_error, "SlabMatrix requires element parameters");
+
+	m_params = params;
+	m_towerParams = TowerParams(params);
+	m_rows = rows;
+	m_cols = cols;
+	m_ringDim = params->GetRingDimension();
+	m_format = format;
+	m_data.assign(m_towerParams.size()*TowerStride(), NativeInteger(0));
+}
+
+template<class Element>
+Matrix<Element> SlabMatrix<Element>::ToMatrix() const {
+	shared_ptr<ParmType> params = m_params;
+	Format format = m_format;
+	Matrix<Element> result([params,format]() { return Element(params, format, true); }, m_rows, m_cols);
+
+#pragma omp parallel for
+	for( size_t row = 0; row < m_rows; row++ )
+		for( size_t col = 0; col < m_cols; col++ )
+			result(row, col) = GetElement(row, col);
+
+	return result;
+}
+
+template<class Element>
+Element SlabMatrix<Element>::GetElement(size_t row, size_t col) const {
+	Element result(m_params, m_format, true);
+
+	for( usint t = 0; t < m_towerParams.size(); t++ ) {
+		const NativeInteger &q = m_towerParams[t]->GetModulus();
+		NativeVector values(m_ringDim, q);
+		const NativeInteger *src = Tower(t, row, col);
+		for( usint i = 0; i < m_ringDim; i++ )
+			values[i] = src[i];
+
+		NativePoly tower(m_towerParams[t], m_format, false);
+		tower.SetValues(values, m_format);
+		SetTower(result, t, tower);
+	}
+
+	return result;
+}
+
+template<class Element>
+void SlabMatrix<Element>::SetElement(size_t row, size_t col, const Element& element) {
+	if( element.GetRingDimension() != m_ringDim )
+		PALISADE_THROW(math_error, "SlabMatrix::SetElement ring dimension mismatch");
+
+	if( element.GetFormat() != m_format ) {
+		Element converted(element);
+		converted.SwitchFormat();
+		SetElement(row, col, converted);
+		return;
+	}
+
+	for( usint t = 0; t < m_towerParams.size(); t++ ) {
+		const NativeVector &values = TowerOf(element, t).GetValues();
+		NativeInteger *dst = Tower(t, row, col);
+		for( usint i = 0; i < m_ringDim; i++ )
+			dst[i] = values[i];
+	}
+}
+
+template<class Element>
+void SlabMatrix<Element>::CheckCompatible(const SlabMatrix<Element>& other, const std::string& op) const {
+	if( m_rows != other.m_rows || m_cols != other.m_cols )
+		PALISADE_THROW(math_error, op + " operands have incompatible dimensions");
+	if( m_format != other.m_format )
+		PALISADE_THROW(math_error, op + " operands are in different formats");
+	if( m_towerParams.size() != other.m_towerParams.size() || m_ringDim != other.m_ringDim )
+		PALISADE_THROW(math_error, op + " operands have different parameters");
+}
+
+template<class Element>
+SlabMatrix<Element>& SlabMatrix<Element>::operator+=(const SlabMatrix<Element>& other) {
+	CheckCompatible(other, "Addition");
+
+	size_t stride = TowerStride();
+	for( usint t = 0; t < m_towerParams.size(); t++ ) {
+		const NativeInteger q = m_towerParams[t]->GetModulus();
+		NativeInteger *a = m_data.data() + t*stride;
+		const NativeInteger *b = other.m_data.data() + t*stride;
+#pragma omp parallel for
+		for( size_t i = 0; i < stride; i++ )
+			a[i].ModAddFastEq(b[i], q);
+	}
+	return *this;
+}
+
+template<class Element>
+SlabMatrix<Element>& SlabMatrix<Element>::operator-=(const SlabMatrix<Element>& other) {
+	CheckCompatible(other, "Subtraction");
+
+	size_t stride = TowerStride();
+	for( usint t = 0; t < m_towerParams.size(); t++ ) {
+		const NativeInteger q = m_towerParams[t]->GetModulus();
+		NativeInteger *a = m_data.data() + t*stride;
+		const NativeInteger *b = other.m_data.data() + t*stride;
+#pragma omp parallel for
+		for( size_t i = 0; i < stride; i++ )
+			a[i].ModSubFastEq(b[i], q);
+	}
+	return *this;
+}
+
+template<class Element>
+SlabMatrix<Element> SlabMatrix<Element>::Mult(const SlabMatrix<Element>& other) const {
+	if( m_cols != other.m_rows )
+		PALISADE_THROW(math_error, "Multiplication operands have incompatible dimensions");
+	if( m_format != EVALUATION || other.m_format != EVALUATION )
+		PALISADE_THROW(math_error, "SlabMatrix multiplication requires EVALUATION format");
+	if( m_towerParams.size() != other.m_towerParams.size() || m_ringDim != other.m_ringDim )
+		PALISADE_THROW(math_error, "Multiplication operands have different parameters");
+
+	SlabMatrix<Element> result(m_params, m_rows, other.m_cols, EVALUATION);
+
+	size_t towers = m_towerParams.size();
+	size_t outCols = other.m_cols;
+	size_t jobs = towers*m_rows*outCols;
+
+	// one job per (tower, row, col) of the result; each accumulates a
+	// contiguous run of m_ringDim residues
+#pragma omp parallel for
+	for( size_t job = 0; job < jobs; job++ ) {
+		usint t = job / (m_rows*outCols);
+		size_t row = (job / outCols) % m_rows;
+		size_t col = job % outCols;
+
+		const NativeInteger &q = m_towerParams[t]->GetModulus();
+		NativeInteger *acc = result.Tower(t, row, col);
+
+		if( q.GetMSB() <= MAX_MODULUS_SIZE ) {
+			NativeInteger mu = q.ComputeMu();
+			for( size_t k = 0; k < m_cols; k++ ) {
+				const NativeInteger *a = Tower(t, row, k);
+				const NativeInteger *b = other.Tower(t, k, col);
+				for( usint i = 0; i < m_ringDim; i++ )
+					acc[i].ModAddFastEq(a[i].ModMulFastOptimized(b[i], q, mu), q);
+			}
+		}
+		else {
+			for( size_t k = 0; k < m_cols; k++ ) {
+				const NativeInteger *a = Tower(t, row, k);
+				const NativeInteger *b = other.Tower(t, k, col);
+				for( usint i = 0; i < m_ringDim; i++ )
+					acc[i].ModAddFastEq(a[i].ModMulFast(b[i], q), q);
+			}
+		}
+	}
+
+	return result;
+}
+
+template<class Element>
+void SlabMatrix<Element>::SwitchFormat() {
+	usint m = m_params->GetCyclotomicOrder();
+	if( !IsPowerOfTwo(m) )
+		PALISADE_THROW(not_implemented_error, "SlabMatrix::SwitchFormat supports only power-of-two cyclotomic orders");
+
+	size_t entries = m_rows*m_cols;
+	size_t jobs = m_towerParams.size()*entries;
+
+	// the NTT works on NativeVector, so each thread reuses one pair of
+	// scratch vectors instead of allocating per entry
+#pragma omp parallel
+	{
+		NativeVector in, out;
+		usint current = m_towerParams.size();
+
+#pragma omp for
+		for( size_t job = 0; job < jobs; job++ ) {
+			usint t = job / entries;
+			const NativeInteger &q = m_towerParams[t]->GetModulus();
+			const NativeInteger &root = m_towerParams[t]->GetRootOfUnity();
+
+			if( t != current ) {
+				in = NativeVector(m_ringDim, q);
+				out = NativeVector(m_ringDim, q);
+				current = t;
+			}
+
+			NativeInteger *values = m_data.data() + job*m_ringDim;
+			for( usint i = 0; i < m_ringDim; i++ )
+				in[i] = values[i];
+
+			if( m_format == COEFFICIENT )
+				ChineseRemainderTransformFTT<NativeVector>::ForwardTransform(in, root, m, &out);
+			else
+				ChineseRemainderTransformFTT<NativeVector>::InverseTransform(in, root, m, &out);
+
+			for( usint i = 0; i < m_ringDim; i++ )
+				values[i] = out[i];
+		}
+	}
+
+	m_format = (m_format == COEFFICIENT) ? EVALUATION : COEFFICIENT;
+}
+
+template<class Element>
+bool SlabMatrix<Element>::Equal(const SlabMatrix<Element>& other) const {
+	if( m_rows != other.m_rows || m_cols != other.m_cols || m_format != other.m_format )
+		return false;
+	if( m_towerParams.size() != other.m_towerParams.size() || m_ringDim != other.m_ringDim )
+		return false;
+	for( usint t = 0; t < m_towerParams.size(); t++ )
+		if( m_towerParams[t]->GetModulus() != other.m_towerParams[t]->GetModulus() )
+			return false;
+	return m_data == other.m_data;
+}
+
+template<class Element>
+typename SlabMatrix<Element>::EntryView& SlabMatrix<Element>::EntryView::operator+=(const EntryView& rhs) {
+	for( usint t = 0; t < GetNumOfElements(); t++ ) {
+		const NativeInteger &q = m_mat->m_towerParams[t]->GetModulus();
+		NativeInteger *a = GetTowerValues(t);
+		const NativeInteger *b = rhs.GetTowerValues(t);
+		for( usint i = 0; i < GetRingDimension(); i++ )
+			a[i].ModAddFastEq(b[i], q);
+	}
+	return *this;
+}
+
+template<class Element>
+typename SlabMatrix<Element>::EntryView& SlabMatrix<Element>::EntryView::operator-=(const EntryView& rhs) {
+	for( usint t = 0; t < GetNumOfElements(); t++ ) {
+		const NativeInteger &q = m_mat->m_towerParams[t]->GetModulus();
+		NativeInteger *a = GetTowerValues(t);
+		const NativeInteger *b = rhs.GetTowerValues(t);
+		for( usint i = 0; i < GetRingDimension(); i++ )
+			a[i].ModSubFastEq(b[i], q);
+	}
+	return *this;
+}
+
+} // namespace lbcrypto ends
+
+#endif
@@ -0,0 +1,373 @@
+/**
+ * @file slabmatrix.h This code provides a matrix of ring elements stored in one contiguous slab
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or other
+ * materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef LBCRYPTO_LATTICE_SLABMATRIX_H
+#define LBCRYPTO_LATTICE_SLABMATRIX_H
+
+#include "../math/backend.h"
+#include "../lattice/backend.h"
+#include "../math/matrix.h"
+#include "../math/transfrm.h"
+#include "../utils/memory.h"
+#include "../utils/exception.h"
+
+namespace lbcrypto {
+
+/**
+ * @class SlabMatrix
+ * @brief Matrix of NativePoly or DCRTPoly ring elements whose residues live in a
+ * single contiguous, cache-line aligned buffer.
+ *
+ * Matrix<Element> keeps one heap vector per tower per entry; for a matrix of
+ * DCRTPoly this means rows*cols*towers separate allocations. SlabMatrix lays all
+ * residues out as [tower][row][col][coeff], so whole-matrix operations (add,
+ * multiply, format switches, serialization) become linear passes over memory.
+ * Conversion to and from Matrix<Element> is provided for interoperability.
+ *
+ * @tparam Element NativePoly or a DCRTPolyImpl type
+ */
+template<class Element>
+class SlabMatrix : public Serializable {
+public:
+	typedef typename Element::Params ParmType;
+	typedef std::vector<NativeInteger, AlignedAllocator<NativeInteger>> slab_t;
+
+	/**
+	 * @class EntryView
+	 * @brief Non-owning view of one matrix entry. Exposes the per-tower layout
+	 * of the entry the way DCRTPoly does, without materializing it.
+	 */
+	class EntryView {
+	public:
+		EntryView(SlabMatrix<Element> *m, size_t row, size_t col) : m_mat(m), m_row(row), m_col(col) {}
+
+		usint GetNumOfElements() const { return m_mat->GetNumOfTowers(); }
+		usint GetRingDimension() const { return m_mat->GetRingDimension(); }
+		Format GetFormat() const { return m_mat->GetFormat(); }
+		const shared_ptr<ParmType> GetParams() const { return m_mat->GetParams(); }
+
+		/**
+		 * Pointer to the GetRingDimension() residues of tower i
+		 */
+		NativeInteger *GetTowerValues(usint i) const { return m_mat->Tower(i, m_row, m_col); }
+
+		/**
+		 * Materialize the entry as an owning ring element
+		 */
+		Element ToElement() const { return m_mat->GetElement(m_row, m_col); }
+
+		EntryView& operator=(const Element& rhs) {
+			m_mat->SetElement(m_row, m_col, rhs);
+			return *this;
+		}
+
+		EntryView& operator+=(const EntryView& rhs);
+		EntryView& operator-=(const EntryView& rhs);
+
+	private:
+		SlabMatrix<Element> *m_mat;
+		size_t m_row;
+		size_t m_col;
+	};
+
+	/**
+	 * Constructor of an empty matrix; used for deserialization
+	 */
+	SlabMatrix() : m_rows(0), m_cols(0), m_ringDim(0), m_format(EVALUATION) {}
+
+	/**
+	 * Constructor of a zero matrix
+	 *
+	 * @param params parameters of every entry
+	 * @param rows number of rows
+	 * @param cols number of columns
+	 * @param format representation of the entries
+	 */
+	SlabMatrix(const shared_ptr<ParmType> params, size_t rows, size_t cols, Format format = EVALUATION);
+
+	/**
+	 * Copy a Matrix<Element> into contiguous storage. All entries must share
+	 * the same parameters; the format of the first entry is used for the slab.
+	 *
+	 * @param &other matrix to pack
+	 */
+	explicit SlabMatrix(const Matrix<Element>& other);
+
+	/**
+	 * Unpack into a conventional Matrix<Element>
+	 *
+	 * @return matrix with one owning element per entry
+	 */
+	Matrix<Element> ToMatrix() const;
+
+	/**
+	 * Materialize a single entry
+	 *
+	 * @param row row index
+	 * @param col column index
+	 * @return the entry as a ring element
+	 */
+	Element GetElement(size_t row, size_t col) const;
+
+	/**
+	 * Overwrite a single entry; the element is converted to the format of the slab if needed
+	 *
+	 * @param row row index
+	 * @param col column index
+	 * @param &element the new value
+	 */
+	void SetElement(size_t row, size_t col, const Element& element);
+
+	/**
+	 * View of a single entry
+	 */
+	EntryView operator()(size_t row, size_t col) {
+		return EntryView(this, row, col);
+	}
+
+	size_t GetRows() const { return m_rows; }
+	size_t GetCols() const { return m_cols; }
+	usint GetNumOfTowers() const { return m_towerParams.size(); }
+	usint GetRingDimension() const { return m_ringDim; }
+	Format GetFormat() const { return m_format; }
+	const shared_ptr<ParmType> GetParams() const { return m_params; }
+
+	/**
+	 * Pointer to the residues of one tower of one entry
+	 *
+	 * @param tower tower index
+	 * @param row row index
+	 * @param col column index
+	 */
+	NativeInteger *Tower(usint tower, size_t row, size_t col) {
+		return m_data.data() + Offset(tower, row, col);
+	}
+
+	const NativeInteger *Tower(usint tower, size_t row, size_t col) const {
+		return m_data.data() + Offset(tower, row, col);
+	}
+
+	/**
+	 * Access to the whole slab, laid out as [tower][row][col][coeff]
+	 */
+	const slab_t& GetData() const { return m_data; }
+
+	/**
+	 * Matrix addition
+	 *
+	 * @param &other the matrix to be added
+	 * @return the resulting matrix
+	 */
+	SlabMatrix<Element> Add(const SlabMatrix<Element>& other) const {
+		SlabMatrix<Element> result(*this);
+		result += other;
+		return result;
+	}
+
+	SlabMatrix<Element> operator+(const SlabMatrix<Element>& other) const {
+		return Add(other);
+	}
+
+	SlabMatrix<Element>& operator+=(const SlabMatrix<Element>& other);
+
+	/**
+	 * Matrix subtraction
+	 *
+	 * @param &other the matrix to be subtracted
+	 * @return the resulting matrix
+	 */
+	SlabMatrix<Element> Sub(const SlabMatrix<Element>& other) const {
+		SlabMatrix<Element> result(*this);
+		result -= other;
+		return result;
+	}
+
+	SlabMatrix<Element> operator-(const SlabMatrix<Element>& other) const {
+		return Sub(other);
+	}
+
+	SlabMatrix<Element>& operator-=(const SlabMatrix<Element>& other);
+
+	/**
+	 * Matrix multiplication; both operands must be in EVALUATION format
+	 *
+	 * @param &other the multiplier matrix
+	 * @return the result of multiplication
+	 */
+	SlabMatrix<Element> Mult(const SlabMatrix<Element>& other) const;
+
+	SlabMatrix<Element> operator*(const SlabMatrix<Element>& other) const {
+		return Mult(other);
+	}
+
+	/**
+	 * Switch every entry between COEFFICIENT and EVALUATION representation
+	 */
+	void SwitchFormat();
+
+	/**
+	 * Set every entry to the given representation
+	 *
+	 * @param format the desired representation
+	 */
+	void SetFormat(Format format) {
+		if( m_format != format )
+			SwitchFormat();
+	}
+
+	bool Equal(const SlabMatrix<Element>& other) const;
+
+	bool operator==(const SlabMatrix<Element>& other) const {
+		return Equal(other);
+	}
+
+	bool operator!=(const SlabMatrix<Element>& other) const {
+		return !Equal(other);
+	}
+
+	template <class Archive>
+	typename std::enable_if<!cereal::traits::is_text_archive<Archive>::value,void>::type
+	save( Archive & ar, std::uint32_t const version ) const
+	{
+		ar( ::cereal::make_nvp("p", m_params) );
+		ar( ::cereal::make_nvp("r", m_rows) );
+		ar( ::cereal::make_nvp("c", m_cols) );
+		ar( ::cereal::make_nvp("f", m_format) );
+		ar( ::cereal::binary_data(m_data.data(), m_data.size()*sizeof(NativeInteger)) );
+	}
+
+	template <class Archive>
+	typename std::enable_if<cereal::traits::is_text_archive<Archive>::value,void>::type
+	save( Archive & ar, std::uint32_t const version ) const
+	{
+		ar( ::cereal::make_nvp("p", m_params) );
+		ar( ::cereal::make_nvp("r", m_rows) );
+		ar( ::cereal::make_nvp("c", m_cols) );
+		ar( ::cereal::make_nvp("f", m_format) );
+		std::vector<uint64_t> values(m_data.size());
+		for( size_t i = 0; i < m_data.size(); i++ )
+			values[i] = m_data[i].ConvertToInt();
+		ar( ::cereal::make_nvp("v", values) );
+	}
+
+	template <class Archive>
+	typename std::enable_if<!cereal::traits::is_text_archive<Archive>::value,void>::type
+	load( Archive & ar, std::uint32_t const version )
+	{
+		if( version > SerializedVersion() ) {
+			PALISADE_THROW(deserialize_error, "serialized object version " + std::to_string(version) + " is from a later version of the library");
+		}
+		loadHeader(ar);
+		ar( ::cereal::binary_data(m_data.data(), m_data.size()*sizeof(NativeInteger)) );
+	}
+
+	template <class Archive>
+	typename std::enable_if<cereal::traits::is_text_archive<Archive>::value,void>::type
+	load( Archive & ar, std::uint32_t const version )
+	{
+		if( version > SerializedVersion() ) {
+			PALISADE_THROW(deserialize_error, "serialized object version " + std::to_string(version) + " is from a later version of the library");
+		}
+		loadHeader(ar);
+		std::vector<uint64_t> values;
+		ar( ::cereal::make_nvp("v", values) );
+		if( values.size() != m_data.size() )
+			PALISADE_THROW(deserialize_error, "SlabMatrix data size does not match its dimensions");
+		for( size_t i = 0; i < m_data.size(); i++ )
+			m_data[i] = values[i];
+	}
+
+	std::string SerializedObjectName() const { return "SlabMatrix"; }
+	static uint32_t	SerializedVersion() { return 1; }
+
+private:
+	shared_ptr<ParmType> m_params;
+	std::vector<shared_ptr<ILNativeParams>> m_towerParams;
+	size_t m_rows;
+	size_t m_cols;
+	usint m_ringDim;
+	Format m_format;
+	slab_t m_data;
+
+	size_t Offset(usint tower, size_t row, size_t col) const {
+		return ((tower*m_rows + row)*m_cols + col)*m_ringDim;
+	}
+
+	// size of one tower of the whole matrix
+	size_t TowerStride() const {
+		return m_rows*m_cols*m_ringDim;
+	}
+
+	void Init(const shared_ptr<ParmType> params, size_t rows, size_t cols, Format format);
+
+	void CheckCompatible(const SlabMatrix<Element>& other, const std::string& op) const;
+
+	template <class Archive>
+	void loadHeader( Archive & ar )
+	{
+		shared_ptr<ParmType> params;
+		size_t rows, cols;
+		Format format;
+		ar( ::cereal::make_nvp("p", params) );
+		ar( ::cereal::make_nvp("r", rows) );
+		ar( ::cereal::make_nvp("c", cols) );
+		ar( ::cereal::make_nvp("f", format) );
+		Init(params, rows, cols, format);
+	}
+
+	// the helpers below let the same code handle NativePoly (one tower)
+	// and DCRTPoly (many towers)
+	static std::vector<shared_ptr<ILNativeParams>> TowerParams(const shared_ptr<ILNativeParams> params) {
+		return std::vector<shared_ptr<ILNativeParams>>(1, params);
+	}
+
+	template<typename IntType>
+	static std::vector<shared_ptr<ILNativeParams>> TowerParams(const shared_ptr<ILDCRTParams<IntType>> params) {
+		return params->GetParams();
+	}
+
+	static const NativePoly& TowerOf(const NativePoly& element, usint i) {
+		return element;
+	}
+
+	template<typename VecType>
+	static const NativePoly& TowerOf(const DCRTPolyImpl<VecType>& element, usint i) {
+		return element.GetElementAtIndex(i);
+	}
+
+	static void SetTower(NativePoly& element, usint i, const NativePoly& tower) {
+		element = tower;
+	}
+
+	template<typename VecType>
+	static void SetTower(DCRTPolyImpl<VecType>& element, usint i, const NativePoly& tower) {
+		element.SetElementAtIndex(i, tower);
+	}
+};
+
+} // namespace lbcrypto ends
+
+#endif
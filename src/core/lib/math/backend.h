@@ -106,12 +106,15 @@ namespace native_int
 #endif
 
 ////////// cpu_int code
-typedef uint32_t integral_dtype;
+// 64-bit limbs, multiplied and divided through unsigned __int128, need half as many limbs as 32-bit ones
+typedef uint64_t integral_dtype;
 
 	/** Define the mapping for BigInteger
-	    1500 is the maximum bit width supported by BigIntegeregers, large enough for most use cases
-		The bitwidth can be decreased to the least value still supporting BigInteger operations for a specific application -
-		to achieve smaller runtimes
+	    3000 is the maximum bit width supported by BigIntegers, large enough for most use cases
+		The arithmetic only loops over the limbs in use, but every BigInteger stores this many bits whatever the modulus,
+		so the memory use is fixed at build time. The bitwidth should be decreased to the least value still supporting
+		the moduli of the parameter sets in use (for instance with cmake -DBIGINTEGER_BITLENGTH=...) -
+		to achieve smaller memory use and copies
 	**/
 
 #ifndef BigIntegerBitLength
@@ -232,10 +235,13 @@ typedef BigInteger DoubleNativeInt;
 ////////// definitions for native integer and native vector
 #include "native_int/binint.h"
 #include "native_int/binvect.h"
+#include "native_int/modmul.h"
+#include "native_int/binvect32.h"
 #include <initializer_list>
 
 typedef native_int::NativeInteger NativeInteger;
 typedef native_int::NativeVector<NativeInteger>		NativeVector;
+typedef native_int::NativeVector32					NativeVector32;
 
 // COMMON TESTING DEFINITIONS
 extern bool TestB2;
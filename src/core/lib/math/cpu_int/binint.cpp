@@ -99,7 +99,8 @@ BigInteger<uint_type,BITLENGTH>::BigInteger(uint64_t init){
 	//setting the values of the array
 	for(;i>= (int)(m_nSize-ceilInt);i--){
 		this->m_value[i] = (uint_type)init;
-		init>>=m_uintBitLength;
+		// a shift by the full width of init would be undefined for 64-bit limbs
+		init = m_uintBitLength < 64 ? init >> (m_uintBitLength & 63) : 0;
 	}
 	for(;i>=0;i--) {
 		this->m_value[i] = 0;
@@ -122,19 +123,11 @@ BigInteger<uint_type,BITLENGTH>::BigInteger(const NativeInteger& native) : BigIn
 template<typename uint_type,usint BITLENGTH>
 BigInteger<uint_type,BITLENGTH>::BigInteger(const BigInteger& bigInteger){
 	m_MSB = bigInteger.m_MSB;
-	//copy array values
-	for (size_t i=0; i < m_nSize; ++i) {
-		m_value[i] = bigInteger.m_value[i];
-	}
+	memcpy(m_value, bigInteger.m_value, sizeof(m_value));
 }
 
 template<typename uint_type,usint BITLENGTH>
-BigInteger<uint_type,BITLENGTH>::BigInteger(BigInteger&& bigInteger){
-	m_MSB = std::move(bigInteger.m_MSB);
-	for (size_t i=0; i < m_nSize; ++i) {
-		m_value[i] = std::move(bigInteger.m_value[i]);
-	}
-}
+BigInteger<uint_type,BITLENGTH>::BigInteger(BigInteger&& bigInteger) : BigInteger((const BigInteger&)bigInteger) {}
 
 /*
 *Converts the BigInteger to unsigned integer or returns the first 32 bits of the BigInteger.
@@ -172,10 +165,8 @@ template<typename uint_type,usint BITLENGTH>
 const BigInteger<uint_type,BITLENGTH>&  BigInteger<uint_type,BITLENGTH>::operator=(const BigInteger &rhs){
 
 	if(this!=&rhs){
-	    this->m_MSB = rhs.m_MSB;
-		for (size_t i=0; i < m_nSize; ++i) {
-			m_value[i] = rhs.m_value[i];
-		}
+		this->m_MSB = rhs.m_MSB;
+		memcpy(m_value, rhs.m_value, sizeof(m_value));
 	}
 	
 	return *this;
@@ -183,14 +174,7 @@ const BigInteger<uint_type,BITLENGTH>&  BigInteger<uint_type,BITLENGTH>::operato
 
 template<typename uint_type,usint BITLENGTH>
 const BigInteger<uint_type,BITLENGTH>&  BigInteger<uint_type,BITLENGTH>::operator=(BigInteger &&rhs){
-
-	if(this!=&rhs){
-	    this->m_MSB = std::move(rhs.m_MSB);
-	    for( size_t i=0; i < m_nSize; i++ )
-	    		this->m_value[i] = std::move(rhs.m_value[i]);
-	}
-
-	return *this;
+	return *this = (const BigInteger&)rhs;
 }
 
 /*
@@ -693,7 +677,8 @@ const BigInteger<uint_type,BITLENGTH>& BigInteger<uint_type,BITLENGTH>::MinusEq(
 }
 
 /* Times operation:
-*  Algorithm used is usual school book shift and add after multiplication, except for that radix is 2^m_bitLength.
+*  Algorithm used is usual school book multiplication with radix 2^m_bitLength, accumulating the partial products
+*  limb by limb over the limbs in use.
 */
 template<typename uint_type,usint BITLENGTH>
 BigInteger<uint_type,BITLENGTH> BigInteger<uint_type, BITLENGTH>::Times(const BigInteger& b) const {
@@ -710,19 +695,36 @@ BigInteger<uint_type,BITLENGTH> BigInteger<uint_type, BITLENGTH>::Times(const Bi
 	if (this->m_MSB == 1) {
 		return b;
 	}
-	
-	BigInteger ans;
 
-	//position of B in the array where the multiplication should start
-	uint_type ceilInt = ceilIntByUInt(b.m_MSB);
-	//Multiplication is done by getting a uint_type from b and multiplying it with *this
-	//after multiplication the result is shifted and added to the final answer
-	BigInteger temp;
-	for(size_t i= m_nSize-1;i>= m_nSize-ceilInt;i--){
-		this->MulByUintToInt(b.m_value[i], &temp);
-		ans += temp <<= (m_nSize-1-i)*m_uintBitLength;
+	usint na = ceilIntByUInt(this->m_MSB);
+	usint nb = ceilIntByUInt(b.m_MSB);
+
+	//product limbs, least significant first; only the na+nb limbs in use are touched
+	uint_type prod[2*((BITLENGTH+8*sizeof(uint_type)-1)/(8*sizeof(uint_type)))];
+	memset(prod, 0, (na+nb)*sizeof(uint_type));
+	for(usint i=0;i<nb;i++){
+		Duint_type bi = b.m_value[m_nSize-1-i];
+		uint_type ofl = 0;
+		for(usint j=0;j<na;j++){
+			Duint_type temp = bi*this->m_value[m_nSize-1-j] + prod[i+j] + ofl;
+			prod[i+j] = (uint_type)temp;
+			ofl = temp>>m_uintBitLength;
+		}
+		prod[i+na] = ofl;
 	}
 
+	usint n = na+nb;
+	while(n>1 && prod[n-1]==0)
+		n--;
+	usint msb = (n-1)*m_uintBitLength + GetMSBUint_type(prod[n-1]);
+	if(msb > BITLENGTH)
+		throw std::logic_error("OVERFLOW");
+
+	BigInteger ans;
+	for(usint i=0;i<n;i++)
+		ans.m_value[m_nSize-1-i] = prod[i];
+	ans.m_MSB = msb;
+
 	return ans;
 }
 
@@ -780,8 +782,7 @@ BigInteger<uint_type,BITLENGTH> BigInteger<uint_type,BITLENGTH>::MulByUint(const
 }
 
 /* Division operation:
-*  Algorithm used is usual school book long division , except for that radix is 2^m_bitLength.
-*  Optimization done: Uses bit shift operation for logarithmic convergence.
+*  Algorithm used is usual school book long division, see Divide.
 */
 template<typename uint_type,usint BITLENGTH>
 BigInteger<uint_type,BITLENGTH> BigInteger<uint_type,BITLENGTH>::DividedBy(const BigInteger& b) const{
@@ -796,220 +797,129 @@ BigInteger<uint_type,BITLENGTH> BigInteger<uint_type,BITLENGTH>::DividedBy(const
 		return 1;
 
 	BigInteger ans;
-
-	//normalised_dividend = result*quotient
-	BigInteger normalised_dividend( this->Minus( this->Mod(b) ) );
-	//Number of array elements in Divisor
-	uint_type ncharInDivisor = ceilIntByUInt(b.m_MSB);
-	//Number of array elements in Normalised_dividend
-	uint_type ncharInNormalised_dividend = ceilIntByUInt(normalised_dividend.m_MSB);
-	//variable to store the running dividend
-	BigInteger running_dividend;
-	//variable to store the running remainder
-	BigInteger runningRemainder;
-	BigInteger expectedProd;
-	BigInteger estimateFinder;
-
-	//Initialize the running dividend
-	for(usint i=0;i<ncharInDivisor;i++){
-		running_dividend.m_value[ m_nSize-ncharInDivisor+i] = normalised_dividend.m_value[ m_nSize-ncharInNormalised_dividend+i]; 
-	}
-	running_dividend.m_MSB = GetMSBUint_type(running_dividend.m_value[m_nSize-ncharInDivisor]) + (ncharInDivisor-1)*m_uintBitLength;
-	
-	uint_type estimate=0;
-	uint_type maskBit = 0;
-	uint_type shifts =0;
-	usint ansCtr = m_nSize - ncharInNormalised_dividend+ncharInDivisor-1;
-	//Long Division Computation to determine quotient
-	for(usint i=ncharInNormalised_dividend-ncharInDivisor;;){
-		//Get the remainder from the Modulus operation
-		runningRemainder = running_dividend.Mod(b);
-		//Compute the expected product from the running dividend and remainder
-		expectedProd = running_dividend-runningRemainder;
-		estimateFinder = expectedProd;
-		
-		estimate =0;
-		
-		//compute the quotient
-		if(expectedProd>b){	
-			while(estimateFinder.m_MSB > 0){
-				/*
-				if(expectedProd.m_MSB-b.m_MSB==m_uintBitLength){
-					maskBit= (uint_type)1<<(m_uintBitLength-1);
-				}
-				else
-					maskBit= (uint_type)1<<(expectedProd.m_MSB-b.m_MSB);
-					*/
-				shifts = estimateFinder.m_MSB-b.m_MSB;
-				if(shifts==m_uintBitLength){
-					maskBit= (uint_type)1<<(m_uintBitLength-1);
-				}
-				else
-					maskBit= (uint_type)1<<(shifts);
-				
-				if((b.MulByUint(maskBit))>estimateFinder){
-					maskBit>>=1;
-					estimateFinder-= b<<(shifts-1);
-				}
-				else if(shifts==m_uintBitLength)
-					estimateFinder-= b<<(shifts-1);
-				else
-					estimateFinder-= b<<shifts;
-				
-				estimate |= maskBit;
-			}
-			
-		}
-		else if(expectedProd.m_MSB==0)
-			estimate = 0;
-		else
-			estimate = 1; 
-		//assigning the quotient in the result array
-		ans.m_value[ansCtr] = estimate;
-		ansCtr++;		
-		if(i==0)
-			break;
-		//Get the next uint element from the divisor and proceed with long division
-		if(running_dividend.m_MSB==0){
-			running_dividend.m_MSB=GetMSBUint_type(normalised_dividend.m_value[m_nSize-i]);
-		}
-		else
-			running_dividend = runningRemainder<<m_uintBitLength;
-
-		running_dividend.m_value[ m_nSize-1] = normalised_dividend.m_value[m_nSize-i];	
-		if (running_dividend.m_MSB == 0)
-			running_dividend.m_MSB = GetMSBUint_type(normalised_dividend.m_value[m_nSize - i]);
-		i--;
-	}
-	ansCtr = m_nSize - ncharInNormalised_dividend+ncharInDivisor-1;
-	//Loop to the MSB position
-	while(ans.m_value[ansCtr]==0){
-		ansCtr++;
-	}
-	//Computation of MSB value 
-	ans.m_MSB = GetMSBUint_type(ans.m_value[ansCtr]) + (m_nSize-1-ansCtr)*m_uintBitLength;
+	Divide(b, &ans, nullptr);
 
 	return ans;
 
 }
 
-// FIXME this really doesn't divide in place...
 /* Division operation:
-*  Algorithm used is usual school book long division , except for that radix is 2^m_bitLength.
-*  Optimization done: Uses bit shift operation for logarithmic convergence.
+*  Algorithm used is usual school book long division, see Divide.
 */
 template<typename uint_type,usint BITLENGTH>
 const BigInteger<uint_type,BITLENGTH>& BigInteger<uint_type,BITLENGTH>::DividedByEq(const BigInteger& b) {
+	*this = this->DividedBy(b);
+	return *this;
+}
 
-	//check for the 0 condition
-	if(b==0)
-		throw std::logic_error("DIVISION BY ZERO");
-
-	if(b>*this) {
-		*this = 0;
-		return *this;
-	}
-	else if(b==*this) {
-		*this = 1;
-		return *this;
+/* Long division:
+*  Algorithm D of Knuth, TAOCP vol. 2, section 4.3.1, in radix 2^m_uintBitLength.
+*  Each quotient limb is estimated from the top two limbs of the running remainder divided by the top limb of
+*  the normalized divisor, so the cost is proportional to the product of the limb counts of the operands.
+*/
+template<typename uint_type,usint BITLENGTH>
+void BigInteger<uint_type,BITLENGTH>::Divide(const BigInteger& b, BigInteger* quotient, BigInteger* remainder) const{
+	static const usint N = (BITLENGTH+8*sizeof(uint_type)-1)/(8*sizeof(uint_type));
+	const Duint_type base = (Duint_type)1 << m_uintBitLength;
+
+	usint m = ceilIntByUInt(this->m_MSB);
+	usint n = ceilIntByUInt(b.m_MSB);
+
+	//limbs, least significant first; the dividend gets one extra limb for normalization
+	uint_type u[N+1], v[N], q[N];
+	for(usint i=0;i<m;i++)
+		u[i] = this->m_value[m_nSize-1-i];
+	u[m] = 0;
+	for(usint i=0;i<n;i++)
+		v[i] = b.m_value[m_nSize-1-i];
+
+	if(n==1){
+		//short division by a single limb
+		Duint_type rem = 0;
+		for(usint i=m;i-- > 0;){
+			Duint_type cur = (rem<<m_uintBitLength) | u[i];
+			q[i] = (uint_type)(cur/v[0]);
+			rem = cur%v[0];
+		}
+		u[0] = (uint_type)rem;
 	}
+	else{
+		//normalize so that the top limb of the divisor has its high bit set
+		usint s = m_uintBitLength - GetMSBUint_type(v[n-1]);
+		if(s){
+			for(usint i=n-1;i>0;i--)
+				v[i] = (v[i]<<s) | (v[i-1]>>(m_uintBitLength-s));
+			v[0] <<= s;
+			u[m] = u[m-1]>>(m_uintBitLength-s);
+			for(usint i=m-1;i>0;i--)
+				u[i] = (u[i]<<s) | (u[i-1]>>(m_uintBitLength-s));
+			u[0] <<= s;
+		}
 
-	BigInteger ans;
-
-	//normalised_dividend = result*quotient
-	BigInteger normalised_dividend( this->Minus( this->Mod(b) ) );
-	//Number of array elements in Divisor
-	uint_type ncharInDivisor = ceilIntByUInt(b.m_MSB);
-	//Number of array elements in Normalised_dividend
-	uint_type ncharInNormalised_dividend = ceilIntByUInt(normalised_dividend.m_MSB);
-	//variable to store the running dividend
-	BigInteger running_dividend;
-	//variable to store the running remainder
-	BigInteger runningRemainder;
-	BigInteger expectedProd;
-	BigInteger estimateFinder;
-
-	//Initialize the running dividend
-	for(usint i=0;i<ncharInDivisor;i++){
-		running_dividend.m_value[ m_nSize-ncharInDivisor+i] = normalised_dividend.m_value[ m_nSize-ncharInNormalised_dividend+i];
-	}
-	running_dividend.m_MSB = GetMSBUint_type(running_dividend.m_value[m_nSize-ncharInDivisor]) + (ncharInDivisor-1)*m_uintBitLength;
-
-	uint_type estimate=0;
-	uint_type maskBit = 0;
-	uint_type shifts =0;
-	usint ansCtr = m_nSize - ncharInNormalised_dividend+ncharInDivisor-1;
-	//Long Division Computation to determine quotient
-	for(usint i=ncharInNormalised_dividend-ncharInDivisor;;){
-		//Get the remainder from the Modulus operation
-		runningRemainder = running_dividend.Mod(b);
-		//Compute the expected product from the running dividend and remainder
-		expectedProd = running_dividend-runningRemainder;
-		estimateFinder = expectedProd;
-
-		estimate =0;
-
-		//compute the quotient
-		if(expectedProd>b){
-			while(estimateFinder.m_MSB > 0){
-				/*
-				if(expectedProd.m_MSB-b.m_MSB==m_uintBitLength){
-					maskBit= (uint_type)1<<(m_uintBitLength-1);
-				}
-				else
-					maskBit= (uint_type)1<<(expectedProd.m_MSB-b.m_MSB);
-					*/
-				shifts = estimateFinder.m_MSB-b.m_MSB;
-				if(shifts==m_uintBitLength){
-					maskBit= (uint_type)1<<(m_uintBitLength-1);
-				}
-				else
-					maskBit= (uint_type)1<<(shifts);
+		for(usint j=m-n+1;j-- > 0;){
+			Duint_type top = ((Duint_type)u[j+n]<<m_uintBitLength) | u[j+n-1];
+			Duint_type qhat = top/v[n-1];
+			Duint_type rhat = top%v[n-1];
+			while(qhat>=base || qhat*v[n-2] > ((rhat<<m_uintBitLength) | u[j+n-2])){
+				qhat--;
+				rhat += v[n-1];
+				if(rhat>=base)
+					break;
+			}
 
-				if((b.MulByUint(maskBit))>estimateFinder){
-					maskBit>>=1;
-					estimateFinder-= b<<(shifts-1);
+			//multiply and subtract
+			uint_type carry = 0;
+			uint_type borrow = 0;
+			for(usint i=0;i<n;i++){
+				Duint_type p = qhat*v[i] + carry;
+				carry = p>>m_uintBitLength;
+				Duint_type t = (Duint_type)u[i+j] - (uint_type)p - borrow;
+				u[i+j] = (uint_type)t;
+				borrow = (t>>m_uintBitLength) ? 1 : 0;
+			}
+			Duint_type t = (Duint_type)u[j+n] - carry - borrow;
+			u[j+n] = (uint_type)t;
+
+			//the estimate was one too large: add the divisor back
+			if(t>>m_uintBitLength){
+				qhat--;
+				uint_type c = 0;
+				for(usint i=0;i<n;i++){
+					Duint_type sum = (Duint_type)u[i+j] + v[i] + c;
+					u[i+j] = (uint_type)sum;
+					c = sum>>m_uintBitLength;
 				}
-				else if(shifts==m_uintBitLength)
-					estimateFinder-= b<<(shifts-1);
-				else
-					estimateFinder-= b<<shifts;
-
-				estimate |= maskBit;
+				u[j+n] += c;
 			}
-
+			q[j] = (uint_type)qhat;
 		}
-		else if(expectedProd.m_MSB==0)
-			estimate = 0;
-		else
-			estimate = 1;
-		//assgning the quotient in the result array
-		ans.m_value[ansCtr] = estimate;
-		ansCtr++;
-		if(i==0)
-			break;
-		//Get the next uint element from the divisor and proceed with long division
-		if(running_dividend.m_MSB==0){
-			running_dividend.m_MSB=GetMSBUint_type(normalised_dividend.m_value[m_nSize-i]);
+
+		//unnormalize the remainder
+		if(s){
+			for(usint i=0;i<n-1;i++)
+				u[i] = (u[i]>>s) | (u[i+1]<<(m_uintBitLength-s));
+			u[n-1] >>= s;
 		}
-		else
-			running_dividend = runningRemainder<<m_uintBitLength;
+	}
 
-		running_dividend.m_value[ m_nSize-1] = normalised_dividend.m_value[m_nSize-i];
-		if (running_dividend.m_MSB == 0)
-			running_dividend.m_MSB = GetMSBUint_type(normalised_dividend.m_value[m_nSize - i]);
-		i--;
+	if(quotient){
+		usint nq = m-n+1;
+		while(nq>1 && q[nq-1]==0)
+			nq--;
+		*quotient = 0;
+		for(usint i=0;i<nq;i++)
+			quotient->m_value[m_nSize-1-i] = q[i];
+		quotient->m_MSB = (nq-1)*m_uintBitLength + GetMSBUint_type(q[nq-1]);
 	}
-	ansCtr = m_nSize - ncharInNormalised_dividend+ncharInDivisor-1;
-	//Loop to the MSB position
-	while(ans.m_value[ansCtr]==0){
-		ansCtr++;
+	if(remainder){
+		usint nr = n;
+		while(nr>1 && u[nr-1]==0)
+			nr--;
+		*remainder = 0;
+		for(usint i=0;i<nr;i++)
+			remainder->m_value[m_nSize-1-i] = u[i];
+		remainder->m_MSB = (nr-1)*m_uintBitLength + GetMSBUint_type(u[nr-1]);
 	}
-	//Computation of MSB value
-	ans.m_MSB = GetMSBUint_type(ans.m_value[ansCtr]) + (m_nSize-1-ansCtr)*m_uintBitLength;
-
-	*this = ans;
-	return *this;
 }
 
 //Initializes the array of uint_array from the string equivalent of BigInteger
@@ -1108,8 +1018,8 @@ void BigInteger<uint_type, BITLENGTH>::SetValue(const std::string& str){
 	AssignVal(str);
 }
 
-//Algorithm used: Repeated subtraction by a multiple of modulus, which will be referred to as "Classical Modulo Reduction Algorithm"
-//Complexity: O(log(*this)-log(modulus))
+//Algorithm used: the remainder of the long division in Divide
+//Complexity: O(limbs(modulus)*(limbs(*this)-limbs(modulus)+1))
 template<typename uint_type,usint BITLENGTH>
 BigInteger<uint_type,BITLENGTH> BigInteger<uint_type,BITLENGTH>::Mod(const BigInteger& modulus) const{
 	//return the same value if value is less than modulus
@@ -1123,46 +1033,15 @@ BigInteger<uint_type,BITLENGTH> BigInteger<uint_type,BITLENGTH>::Mod(const BigIn
 		else
 			return 1;
 	}
-	
-	Duint_type initial_shift = 0;
-	//No of initial left shift that can be performed which will make it comparable to the current value.
-	if(this->m_MSB > modulus.m_MSB)
-		initial_shift=this->m_MSB - modulus.m_MSB -1;
-	
-	BigInteger j = modulus<<initial_shift;
-	
-	BigInteger result(*this);
-
-	BigInteger temp;
-	while(true){
-		//exit criteria
-		if(result<modulus) break;
-		if (result.m_MSB > j.m_MSB) {
-			temp = j<<1;
-			if (result.m_MSB == j.m_MSB + 1) {
-				if(result>temp){
-					j=temp;
-				}
-			}
-		}
-		//subtracting the running remainder by a multiple of modulus
-		result -= j;
-		
-		initial_shift = j.m_MSB - result.m_MSB +1;
-		if(result.m_MSB-1>=modulus.m_MSB){
-			j>>=initial_shift;
-		}
-		else{ 
-			j = modulus;
-		}
 
-	}
+	BigInteger result;
+	Divide(modulus, nullptr, &result);
 
 	return result;
 }
 
-//Algorithm used: Repeated subtraction by a multiple of modulus, which will be referred to as "Classical Modulo Reduction Algorithm"
-//Complexity: O(log(*this)-log(modulus))
+//Algorithm used: the remainder of the long division in Divide
+//Complexity: O(limbs(modulus)*(limbs(*this)-limbs(modulus)+1))
 template<typename uint_type,usint BITLENGTH>
 const BigInteger<uint_type,BITLENGTH>& BigInteger<uint_type,BITLENGTH>::ModEq(const BigInteger& modulus) {
 	//return the same value if value is less than modulus
@@ -1177,37 +1056,7 @@ const BigInteger<uint_type,BITLENGTH>& BigInteger<uint_type,BITLENGTH>::ModEq(co
 			return *this = 1;
 	}
 
-	Duint_type initial_shift = 0;
-	//No of initial left shift that can be performed which will make it comparable to the current value.
-	if(this->m_MSB > modulus.m_MSB)
-		initial_shift=this->m_MSB - modulus.m_MSB -1;
-
-	BigInteger j = modulus<<initial_shift;
-
-	BigInteger temp;
-	while(true){
-		//exit criteria
-		if(*this < modulus) break;
-		if (this->m_MSB > j.m_MSB) {
-			temp = j<<1;
-			if (this->m_MSB == j.m_MSB + 1) {
-				if(*this>temp){
-					j=temp;
-				}
-			}
-		}
-		//subtracting the running remainder by a multiple of modulus
-		*this -= j;
-
-		initial_shift = j.m_MSB - this->m_MSB +1;
-		if(this->m_MSB-1>=modulus.m_MSB){
-			j>>=initial_shift;
-		}
-		else{
-			j = modulus;
-		}
-
-	}
+	Divide(modulus, nullptr, this);
 
 	return *this;
 }
@@ -1750,6 +1599,326 @@ BigInteger<uint_type,BITLENGTH> BigInteger<uint_type,BITLENGTH>::ModBarrettMul(c
 	return a.ModBarrett(modulus,mu_arr);
 }
 
+/*
+Montgomery multiplication with coarsely integrated operand scanning (CIOS), Algorithm in
+Section 5 of C. K. Koc, T. Acar, B. S. Kaliski, "Analyzing and Comparing Montgomery Multiplication
+Algorithms", IEEE Micro 16(3), 1996.
+Works on the k limbs of the modulus only; the intermediate value stays below 2*modulus, so a
+single conditional subtraction completes the reduction.
+*/
+template<typename uint_type,usint BITLENGTH>
+void BigInteger<uint_type,BITLENGTH>::ModMulMontgomeryInPlace(const BigInteger& b, const BigInteger& modulus, uint_type mInv) {
+
+	//if a is greater than q reduce a to its mod value
+	if (*this >= modulus)
+		this->ModEq(modulus);
+
+	//if b is greater than q reduce b to its mod value
+	BigInteger bb;
+	const BigInteger *bp = &b;
+	if (b >= modulus) {
+		bb = b.Mod(modulus);
+		bp = &bb;
+	}
+
+	//limb arrays below are least significant first; t holds k+2 limbs
+	uint_type a[(BITLENGTH+8*sizeof(uint_type)-1)/(8*sizeof(uint_type))];
+	uint_type bl[(BITLENGTH+8*sizeof(uint_type)-1)/(8*sizeof(uint_type))];
+	uint_type q[(BITLENGTH+8*sizeof(uint_type)-1)/(8*sizeof(uint_type))];
+	uint_type t[(BITLENGTH+8*sizeof(uint_type)-1)/(8*sizeof(uint_type))+2];
+
+	//limbs above the MSB of a value are not necessarily zero, so only the used ones are read
+	const usint k = ceilIntByUInt(modulus.m_MSB);
+	const usint ka = (m_MSB + m_uintBitLength - 1) >> m_logUintBitLength;
+	const usint kb = (bp->m_MSB + m_uintBitLength - 1) >> m_logUintBitLength;
+	for (usint j = 0; j < k; j++) {
+		a[j] = j < ka ? m_value[m_nSize-1-j] : 0;
+		bl[j] = j < kb ? bp->m_value[m_nSize-1-j] : 0;
+		q[j] = modulus.m_value[m_nSize-1-j];
+	}
+	for (usint j = 0; j < k+2; j++)
+		t[j] = 0;
+
+	Duint_type uv;
+	uint_type c;
+	for (usint i = 0; i < k; i++) {
+		//t += a*b[i]
+		c = 0;
+		for (usint j = 0; j < k; j++) {
+			uv = (Duint_type)a[j]*bl[i] + t[j] + c;
+			t[j] = (uint_type)uv;
+			c = (uint_type)(uv >> m_uintBitLength);
+		}
+		uv = (Duint_type)t[k] + c;
+		t[k] = (uint_type)uv;
+		t[k+1] = (uint_type)(uv >> m_uintBitLength);
+
+		//t = (t + m*q)/2^w, where m clears the least significant limb
+		uint_type m = t[0]*mInv;
+		uv = (Duint_type)m*q[0] + t[0];
+		c = (uint_type)(uv >> m_uintBitLength);
+		for (usint j = 1; j < k; j++) {
+			uv = (Duint_type)m*q[j] + t[j] + c;
+			t[j-1] = (uint_type)uv;
+			c = (uint_type)(uv >> m_uintBitLength);
+		}
+		uv = (Duint_type)t[k] + c;
+		t[k-1] = (uint_type)uv;
+		t[k] = t[k+1] + (uint_type)(uv >> m_uintBitLength);
+	}
+
+	//t - q goes to a; keep t if the subtraction borrows out of the top limb t[k]
+	c = 0;
+	for (usint j = 0; j < k; j++) {
+		uv = (Duint_type)t[j] - q[j] - c;
+		a[j] = (uint_type)uv;
+		c = (uint_type)(uv >> m_uintBitLength) & 1;
+	}
+	const uint_type *r = t[k] < c ? t : a;
+
+	m_MSB = 0;
+	for (usint j = 0; j < k; j++) {
+		m_value[m_nSize-1-j] = r[j];
+		if (r[j] != 0)
+			m_MSB = j*m_uintBitLength + GetMSBUint_type(r[j]);
+	}
+}
+
+template<typename uint_type,usint BITLENGTH>
+uint_type BigInteger<uint_type,BITLENGTH>::ComputeMontgomeryInverse(const BigInteger& modulus) {
+	uint_type q0 = modulus.m_value[m_nSize-1];
+	//Newton iteration x = x*(2 - q0*x) doubles the number of correct low bits of q0^{-1};
+	//x = q0 is correct to 3 bits for odd q0
+	uint_type x = q0;
+	for (usint bits = 3; bits < m_uintBitLength; bits *= 2)
+		x *= 2 - q0*x;
+	return (uint_type)0 - x;
+}
+
+template<typename uint_type,usint BITLENGTH>
+BigInteger<uint_type,BITLENGTH> BigInteger<uint_type,BITLENGTH>::ComputeMontgomeryR2(const BigInteger& modulus) {
+
+	//limb arrays are least significant first, with one spare limb for the doubling
+	uint_type q[(BITLENGTH+8*sizeof(uint_type)-1)/(8*sizeof(uint_type))+1];
+	uint_type r[(BITLENGTH+8*sizeof(uint_type)-1)/(8*sizeof(uint_type))+1];
+
+	const usint k = ceilIntByUInt(modulus.m_MSB);
+	for (usint j = 0; j < k; j++) {
+		q[j] = modulus.m_value[m_nSize-1-j];
+		r[j] = 0;
+	}
+	q[k] = 0;
+	r[k] = 0;
+	r[0] = 1;
+
+	//double 2*w*k times, subtracting the modulus each time the value reaches it
+	for (usint i = 0; i < 2*m_uintBitLength*k; i++) {
+		uint_type carry = 0;
+		for (usint j = 0; j <= k; j++) {
+			uint_type top = r[j] >> (m_uintBitLength-1);
+			r[j] = (r[j] << 1) | carry;
+			carry = top;
+		}
+		usint j = k;
+		while (j > 0 && r[j] == q[j])
+			j--;
+		if (r[j] >= q[j]) {
+			uint_type borrow = 0;
+			for (j = 0; j <= k; j++) {
+				Duint_type d = (Duint_type)r[j] - q[j] - borrow;
+				r[j] = (uint_type)d;
+				borrow = (uint_type)(d >> m_uintBitLength) & 1;
+			}
+		}
+	}
+
+	BigInteger ans;
+	for (usint j = 0; j < k; j++)
+		ans.m_value[m_nSize-1-j] = r[j];
+	ans.SetMSB();
+	return ans;
+}
+
+/*
+Montgomery multiplication of a block of integers, with the limbs held as a structure of arrays: digit j of all
+MontgomeryBlockSize elements is contiguous, so the loops below run across elements and the compiler can vectorize
+them. A digit is a 64-bit limb split into two 32-bit halves, which keeps every product a 32x32->64 multiplication
+that SIMD units provide; smaller limbs are digits themselves. R is the same as for ModMulMontgomeryInPlace.
+*/
+//largest modulus for which ModMulMontgomeryBlock uses the block product; SSE2 multiplies two 32-bit digit pairs
+//at a time, which beats one 64x64-bit product per limb only for moduli of up to two limbs
+#if defined(__AVX2__)
+#define MontgomeryBlockMaxBits 512
+#else
+#define MontgomeryBlockMaxBits 128
+#endif
+
+namespace {
+
+const size_t MontgomeryBlockSize = 64;
+
+//a = a*b*R^{-1} for the d digit moduli q, element-wise over a block; t holds d+2 digits
+template<typename Digit, typename Ddigit>
+void MontgomeryBlockMul(Digit *a, const Digit *b, const Digit *q, usint d, Digit mInv, Ddigit *t) {
+	const usint w = 8*sizeof(Digit);
+	const size_t B = MontgomeryBlockSize;
+	Ddigit c[MontgomeryBlockSize];
+	Digit m[MontgomeryBlockSize];
+
+	for (size_t j = 0; j < (d+2)*B; j++)
+		t[j] = 0;
+
+	for (usint i = 0; i < d; i++) {
+		//t += a*b[i]
+		const Digit *bi = b + i*B;
+		for (size_t e = 0; e < B; e++)
+			c[e] = 0;
+		for (usint j = 0; j < d; j++) {
+			const Digit *aj = a + j*B;
+			Ddigit *tj = t + j*B;
+			for (size_t e = 0; e < B; e++) {
+				Ddigit uv = (Ddigit)aj[e]*bi[e] + tj[e] + c[e];
+				tj[e] = (Digit)uv;
+				c[e] = uv >> w;
+			}
+		}
+		for (size_t e = 0; e < B; e++) {
+			Ddigit uv = t[d*B+e] + c[e];
+			t[d*B+e] = (Digit)uv;
+			t[(d+1)*B+e] = uv >> w;
+		}
+
+		//t = (t + m*q)/2^w, where m clears the least significant digit
+		for (size_t e = 0; e < B; e++) {
+			m[e] = (Digit)t[e]*mInv;
+			c[e] = ((Ddigit)m[e]*q[0] + t[e]) >> w;
+		}
+		for (usint j = 1; j < d; j++) {
+			const Ddigit qj = q[j];
+			const Ddigit *tj = t + j*B;
+			Ddigit *tjm1 = t + (j-1)*B;
+			for (size_t e = 0; e < B; e++) {
+				Ddigit uv = m[e]*qj + tj[e] + c[e];
+				tjm1[e] = (Digit)uv;
+				c[e] = uv >> w;
+			}
+		}
+		for (size_t e = 0; e < B; e++) {
+			Ddigit uv = t[d*B+e] + c[e];
+			t[(d-1)*B+e] = (Digit)uv;
+			t[d*B+e] = t[(d+1)*B+e] + (uv >> w);
+		}
+	}
+
+	//t - q goes to a; keep t where the subtraction borrows out of the top digit t[d]
+	for (size_t e = 0; e < B; e++)
+		c[e] = 0;
+	for (usint j = 0; j < d; j++) {
+		for (size_t e = 0; e < B; e++) {
+			Ddigit uv = t[j*B+e] - q[j] - c[e];
+			a[j*B+e] = (Digit)uv;
+			c[e] = (uv >> w) & 1;
+		}
+	}
+	for (usint j = 0; j < d; j++) {
+		for (size_t e = 0; e < B; e++) {
+			if (t[d*B+e] < c[e])
+				a[j*B+e] = (Digit)t[j*B+e];
+		}
+	}
+}
+
+}
+
+template<typename uint_type,usint BITLENGTH>
+void BigInteger<uint_type,BITLENGTH>::ModMulMontgomeryBlock(BigInteger *a, const BigInteger *b, size_t bStep, size_t n,
+		const BigInteger& modulus, uint_type mInv, const BigInteger *r2) {
+
+	if (modulus.m_MSB > MontgomeryBlockMaxBits) {
+		for (size_t i = 0; i < n; i++) {
+			a[i].ModMulMontgomeryInPlace(b[i*bStep], modulus, mInv);
+			if (r2 != NULL)
+				a[i].ModMulMontgomeryInPlace(*r2, modulus, mInv);
+		}
+		return;
+	}
+
+	typedef typename std::conditional<(sizeof(uint_type) > 4), uint32_t, uint_type>::type Digit;
+	typedef typename DoubleDataType<Digit>::T Ddigit;
+	const usint w = 8*sizeof(Digit);
+	const usint perLimb = sizeof(uint_type)/sizeof(Digit);
+	const usint maxDigits = (MontgomeryBlockMaxBits+w-1)/w;
+	const size_t B = MontgomeryBlockSize;
+
+	Digit ad[maxDigits*MontgomeryBlockSize];
+	Digit bd[maxDigits*MontgomeryBlockSize];
+	Ddigit t[(maxDigits+2)*MontgomeryBlockSize];
+	Digit q[maxDigits];
+	Digit r2d[maxDigits];
+
+	const usint k = ceilIntByUInt(modulus.m_MSB);
+	const usint d = k*perLimb;
+
+	//digit j of x goes to dst[j*B]; limbs above the MSB of a value are not necessarily zero, so only the used ones are read
+	auto load = [k, perLimb, w](Digit *dst, size_t stride, const BigInteger& x) {
+		const usint used = (x.m_MSB + m_uintBitLength - 1) >> m_logUintBitLength;
+		for (usint l = 0; l < k; l++) {
+			uint_type limb = l < used ? x.m_value[m_nSize-1-l] : 0;
+			for (usint h = 0; h < perLimb; h++)
+				dst[(l*perLimb+h)*stride] = (Digit)(limb >> (h*w));
+		}
+	};
+
+	load(q, 1, modulus);
+	if (r2 != NULL)
+		load(r2d, 1, *r2);
+
+	for (size_t start = 0; start < n; start += B) {
+		const size_t len = std::min(B, n - start);
+
+		//padding elements are zero, which the product keeps at zero
+		for (size_t e = 0; e < B; e++) {
+			if (e < len) {
+				BigInteger& x = a[start+e];
+				if (x >= modulus)
+					x.ModEq(modulus);
+				load(ad + e, B, x);
+
+				const BigInteger& y = b[(start+e)*bStep];
+				if (y >= modulus)
+					load(bd + e, B, y.Mod(modulus));
+				else
+					load(bd + e, B, y);
+			}
+			else {
+				for (usint j = 0; j < d; j++)
+					ad[j*B+e] = bd[j*B+e] = 0;
+			}
+		}
+
+		MontgomeryBlockMul<Digit,Ddigit>(ad, bd, q, d, (Digit)mInv, t);
+		if (r2 != NULL) {
+			for (usint j = 0; j < d; j++)
+				for (size_t e = 0; e < B; e++)
+					bd[j*B+e] = r2d[j];
+			MontgomeryBlockMul<Digit,Ddigit>(ad, bd, q, d, (Digit)mInv, t);
+		}
+
+		for (size_t e = 0; e < len; e++) {
+			BigInteger& x = a[start+e];
+			x.m_MSB = 0;
+			for (usint l = 0; l < k; l++) {
+				uint_type limb = 0;
+				for (usint h = 0; h < perLimb; h++)
+					limb |= (uint_type)ad[(l*perLimb+h)*B+e] << (h*w);
+				x.m_value[m_nSize-1-l] = limb;
+				if (limb != 0)
+					x.m_MSB = l*m_uintBitLength + GetMSBUint_type(limb);
+			}
+		}
+	}
+}
+
 //Modular Multiplication using Square and Multiply Algorithm
 //reference:http://guan.cse.nsysu.edu.tw/note/expn.pdf
 template<typename uint_type,usint BITLENGTH>
@@ -1798,42 +1967,36 @@ BigInteger<uint_type,BITLENGTH> BigInteger<uint_type,BITLENGTH>::ModExp(const Bi
 template<typename uint_type,usint BITLENGTH>
 const std::string BigInteger<uint_type,BITLENGTH>::ToString() const {
 
-	//this string object will store this BigInteger's value
-	std::string bbiString;
-
-	usint counter;
-
-	//print_VALUE array stores the decimal value in the array
-	uschar *print_VALUE = new uschar[m_numDigitInPrintval];
-
-	//reset to zero
-	for(size_t i=0;i<m_numDigitInPrintval;i++)
-		*(print_VALUE+i)=0;
-
-	//starts the conversion from base r to decimal value
-	for(size_t i=this->m_MSB;i>0;i--){
-
-		//print_VALUE = print_VALUE*2
-		BigInteger<uint_type,BITLENGTH>::double_bitVal(print_VALUE);	
-
-		//adds the bit value to the print_VALUE
-		BigInteger<uint_type,BITLENGTH>::add_bitVal(print_VALUE,this->GetBitAtIndex(i));
-
-
+	// the limbs in use, most significant first, are divided by 10^9 until nothing is left;
+	// each remainder is the next group of nine decimal digits
+	typedef typename std::conditional<(sizeof(uint_type) < 8), uint64_t, Duint_type>::type Wide;
+	const uint32_t groupBase = 1000000000;
+
+	usint used = ceilIntByUInt(this->m_MSB);
+	std::vector<uint_type> limbs(this->m_value + m_nSize - used, this->m_value + m_nSize);
+	std::vector<uint32_t> groups;
+	size_t first = 0;
+	while (first < limbs.size()) {
+		Wide rem = 0;
+		for (size_t i = first; i < limbs.size(); i++) {
+			Wide cur = (rem << m_uintBitLength) | limbs[i];
+			limbs[i] = (uint_type)(cur / groupBase);
+			rem = cur % groupBase;
+		}
+		groups.push_back((uint32_t)rem);
+		while (first < limbs.size() && limbs[first] == 0)
+			first++;
 	}
 
-	//find the first occurrence of non-zero value in print_VALUE
-	for(counter=0;counter<m_numDigitInPrintval-1;counter++){
-		if((int)print_VALUE[counter]!=0)break;
-	}
+	if (groups.empty())
+		return "0";
 
-	//append this BigInteger's digits to this method's returned string object
-	for (; counter < m_numDigitInPrintval; counter++) {
-		bbiString += std::to_string(print_VALUE[counter]);
+	std::string bbiString = std::to_string(groups.back());
+	for (size_t i = groups.size() - 1; i-- > 0; ) {
+		std::string group = std::to_string(groups[i]);
+		bbiString.append(9 - group.size(), '0');
+		bbiString += group;
 	}
-
-	delete [] print_VALUE;
-
 	return bbiString;
 }
 
@@ -1848,11 +2011,11 @@ int BigInteger<uint_type,BITLENGTH>::Compare(const BigInteger& a) const
 	else if(this->m_MSB>a.m_MSB)
 		return 1;
 	if(this->m_MSB==a.m_MSB){
-		uschar ceilInt = ceilIntByUInt(this->m_MSB); 
+		usint ceilInt = ceilIntByUInt(this->m_MSB);
+		// compare limbs directly: a signed difference overflows for 64-bit limbs
 		for(usint i=m_nSize-ceilInt;i< m_nSize;i++) {
-			auto testChar = int64_t(this->m_value[i]) - int64_t(a.m_value[i]) ;
-			if(testChar<0) return -1;
-			else if(testChar>0) return 1;
+			if(this->m_value[i]<a.m_value[i]) return -1;
+			else if(this->m_value[i]>a.m_value[i]) return 1;
 		}
 	}
 
@@ -1971,101 +2134,11 @@ BigInteger<uint_type, BITLENGTH> BigInteger<uint_type, BITLENGTH>::DivideAndRoun
 	}
 
 	BigInteger ans;
+	BigInteger remainder;
+	Divide(q, &ans, &remainder);
 
-	//normalised_dividend = result*quotient
-	BigInteger normalised_dividend(*this);
-	//Number of array elements in Divisor
-	uint_type ncharInDivisor = ceilIntByUInt(q.m_MSB);
-	//Number of array elements in Normalised_dividend
-	uint_type ncharInNormalised_dividend = ceilIntByUInt(normalised_dividend.m_MSB);
-	//variable to store the running dividend
-	BigInteger running_dividend;
-	//variable to store the running remainder
-	BigInteger runningRemainder;
-	BigInteger expectedProd;
-	BigInteger estimateFinder;
-
-	//Initialize the running dividend
-	for (usint i = 0; i<ncharInDivisor; i++) {
-		running_dividend.m_value[m_nSize - ncharInDivisor + i] = normalised_dividend.m_value[m_nSize - ncharInNormalised_dividend + i];
-	}
-	running_dividend.m_MSB = GetMSBUint_type(running_dividend.m_value[m_nSize - ncharInDivisor]) + (ncharInDivisor - 1)*m_uintBitLength;
-
-	uint_type estimate = 0;
-	uint_type maskBit = 0;
-	uint_type shifts = 0;
-	usint ansCtr = m_nSize - ncharInNormalised_dividend + ncharInDivisor - 1;
-	//Long Division Computation to determine quotient
-	for (usint i = ncharInNormalised_dividend - ncharInDivisor;;) {
-		//Get the remainder from the Modulus operation
-		runningRemainder = running_dividend.Mod(q);
-		//Compute the expected product from the running dividend and remainder
-		expectedProd = running_dividend - runningRemainder;
-		estimateFinder = expectedProd;
-		
-		estimate = 0;
-
-		//compute the quotient
-		if (expectedProd>q) {
-			while (estimateFinder.m_MSB > 0) {
-				/*
-				if(expectedProd.m_MSB-b.m_MSB==m_uintBitLength){
-				maskBit= (uint_type)1<<(m_uintBitLength-1);
-				}
-				else
-				maskBit= (uint_type)1<<(expectedProd.m_MSB-b.m_MSB);
-				*/
-				shifts = estimateFinder.m_MSB - q.m_MSB;
-				if (shifts == m_uintBitLength) {
-					maskBit = 1 << (m_uintBitLength - 1);
-				}
-				else
-					maskBit = 1 << (shifts);
-
-				if ((q.MulByUint(maskBit))>estimateFinder) {
-					maskBit >>= 1;
-					estimateFinder -= q << (shifts - 1);
-				}
-				else if (shifts == m_uintBitLength)
-					estimateFinder -= q << (shifts - 1);
-				else
-					estimateFinder -= q << shifts;
-
-				estimate |= maskBit;
-			}
-
-		}
-		else if (expectedProd.m_MSB == 0)
-			estimate = 0;
-		else
-			estimate = 1;
-		//assgning the quotient in the result array
-		ans.m_value[ansCtr] = estimate;
-		ansCtr++;
-		if (i == 0)
-			break;
-		//Get the next uint element from the divisor and proceed with long division
-		if (running_dividend.m_MSB == 0) {
-			running_dividend.m_MSB = GetMSBUint_type(normalised_dividend.m_value[m_nSize - i]);
-		}
-		else
-			running_dividend = runningRemainder << m_uintBitLength;
-
-		running_dividend.m_value[m_nSize - 1] = normalised_dividend.m_value[m_nSize - i];
-		if (running_dividend.m_MSB == 0)
-			running_dividend.m_MSB = GetMSBUint_type(normalised_dividend.m_value[m_nSize - i]);
-		i--;
-	}
-	ansCtr = m_nSize - ncharInNormalised_dividend + ncharInDivisor - 1;
-	//Loop to the MSB position
-	while (ans.m_value[ansCtr] == 0) {
-		ansCtr++;
-	}
-	//Computation of MSB value 
-	ans.m_MSB = GetMSBUint_type(ans.m_value[ansCtr]) + (m_nSize - 1 - ansCtr)*m_uintBitLength;
-
-	//Rounding operation from running remainder
-	if (!(runningRemainder <= halfQ)){
+	//Rounding operation from the remainder
+	if (!(remainder <= halfQ)){
 		ans += 1;
 	}
 
@@ -2075,7 +2148,13 @@ BigInteger<uint_type, BITLENGTH> BigInteger<uint_type, BITLENGTH>::DivideAndRoun
 
 template<typename uint_type,usint BITLENGTH>
 usint BigInteger<uint_type,BITLENGTH>::GetMSBDUint_type(Duint_type x){
-	return lbcrypto::GetMSB64(x);
+	// with 64-bit limbs Duint_type is 128 bits wide
+	if( sizeof(Duint_type) > 8 ) {
+		uint64_t hi = (uint64_t)(x >> (4*sizeof(Duint_type)) >> (4*sizeof(Duint_type)));
+		if( hi )
+			return 64 + lbcrypto::GetMSB64(hi);
+	}
+	return lbcrypto::GetMSB64((uint64_t)x);
 }
 
 //Algoritm used is shift and add
@@ -2093,37 +2172,6 @@ template<typename uint_type,usint BITLENGTH>
  }
 
  
- template<typename uint_type,usint BITLENGTH>
- void BigInteger<uint_type,BITLENGTH>::double_bitVal(uschar* a){
-	
-	uschar ofl=0;
-	for(int i=m_numDigitInPrintval-1;i>-1;i--){
-		*(a+i)<<=1;
-		if(*(a+i)>9){
-			*(a+i)=*(a+i)-10+ofl;
-			ofl=1;
-		}
-		else{
-			*(a+i)=*(a+i)+ofl;
-			ofl = 0;
-		}
-
-	}
- }
-
- template<typename uint_type,usint BITLENGTH>
- void BigInteger<uint_type,BITLENGTH>::add_bitVal(uschar* a,uschar b){
-	uschar ofl=0;
-	*(a+m_numDigitInPrintval-1)+=b;
-	for(int i=m_numDigitInPrintval-1;i>-1;i--){
-		*(a+i) += ofl;
-		if(*(a+i)>9){
-			*(a+i)=0;
-			ofl=1;
-		}
-		
-	}
- }
 
 template<typename uint_type,usint BITLENGTH>
 uschar BigInteger<uint_type,BITLENGTH>::GetBitAtIndex(usint index) const{
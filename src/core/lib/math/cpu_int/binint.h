@@ -26,7 +26,7 @@
 /*
  * This file contains the main class for big integers: BigInteger. Big integers are represented
  * as arrays of native usigned integers. The native integer type is supplied as a template parameter.
- * Currently implementations based on uint8_t, uint16_t, and uint32_t are supported. The second template parameter
+ * Currently implementations based on uint8_t, uint16_t, uint32_t and uint64_t are supported. The second template parameter
  * is the maximum bitwidth for the big integer.
  */
 
@@ -95,7 +95,7 @@ namespace cpu_int{
 	};
     
     /**
-    * @brief Struct for validating if Dtype is amongst {uint8_t, uint16_t, uint32_t}
+    * @brief Struct for validating if Dtype is amongst {uint8_t, uint16_t, uint32_t, uint64_t}
     *
 	* @tparam Dtype primitive datatype.
     */
@@ -105,7 +105,7 @@ namespace cpu_int{
 	};
 
     /**
-    * @brief Struct for validating if Dtype is amongst {uint8_t, uint16_t, uint32_t}. 
+    * @brief Struct for validating if Dtype is amongst {uint8_t, uint16_t, uint32_t, uint64_t}. 
     * sets value true if datatype is unsigned integer 8 bit.
     */
 	template<>
@@ -114,7 +114,7 @@ namespace cpu_int{
 	};
 
     /**
-    * @brief Struct for validating if Dtype is amongst {uint8_t, uint16_t, uint32_t}. 
+    * @brief Struct for validating if Dtype is amongst {uint8_t, uint16_t, uint32_t, uint64_t}. 
     * sets value true if datatype is unsigned integer 16 bit.
     */
 	template<>
@@ -123,7 +123,7 @@ namespace cpu_int{
 	};
 
     /**
-    * @brief Struct for validating if Dtype is amongst {uint8_t, uint16_t, uint32_t}.
+    * @brief Struct for validating if Dtype is amongst {uint8_t, uint16_t, uint32_t, uint64_t}.
     * sets value true if datatype is unsigned integer 32 bit.
     */
 	template<>
@@ -132,7 +132,7 @@ namespace cpu_int{
 	};
 
     /**
-    * @brief Struct for validating if Dtype is amongst {uint8_t, uint16_t, uint32_t}.
+    * @brief Struct for validating if Dtype is amongst {uint8_t, uint16_t, uint32_t, uint64_t}.
     * sets value true if datatype is unsigned integer 64 bit.
     */
 	template<>
@@ -668,6 +668,55 @@ namespace cpu_int{
     */
     BigInteger ModBarrettMul(const BigInteger& b, const BigInteger& modulus,const BigInteger mu_arr[BARRETT_LEVELS]) const;
 
+	/**
+	* Montgomery modular multiplication - In-place version.
+	* Sets this to this*b*R^{-1} mod modulus, where R = 2^(w*k), w is the bit width of the
+	* integral data type and k is the number of limbs of the modulus. Only the low k limbs
+	* are touched, so the cost depends on the size of the modulus rather than on BITLENGTH.
+	* Operands that are not less than the modulus are reduced first.
+	*
+	* @param b is the scalar to multiply.
+	* @param modulus is the odd modulus to perform operations with.
+	* @param mInv is the precomputed value from ComputeMontgomeryInverse(modulus).
+	*/
+	void ModMulMontgomeryInPlace(const BigInteger& b, const BigInteger& modulus, uint_type mInv);
+
+	/**
+	* Precomputation for ModMulMontgomeryInPlace: -modulus^{-1} mod 2^w.
+	*
+	* @param modulus is the odd modulus.
+	* @return the Montgomery constant for the modulus.
+	*/
+	static uint_type ComputeMontgomeryInverse(const BigInteger& modulus);
+
+	/**
+	* Precomputation for ModMulMontgomeryInPlace: R^2 mod modulus. A Montgomery multiplication
+	* by this value converts into the Montgomery domain; one following a Montgomery
+	* multiplication of two ordinary residues leaves it again.
+	*
+	* @param modulus is the odd modulus.
+	* @return R^2 mod modulus.
+	*/
+	static BigInteger ComputeMontgomeryR2(const BigInteger& modulus);
+
+	/**
+	* Montgomery modular multiplication of n integers: sets a[i] to a[i]*b[i*bStep]*R^{-1} mod modulus,
+	* followed by a Montgomery multiplication by *r2 unless r2 is NULL. With r2 from
+	* ComputeMontgomeryR2(modulus) that gives a[i]*b[i*bStep] mod modulus; bStep 0 multiplies every
+	* a[i] by b[0]. Blocks of elements are transposed so that the same limb of all elements is
+	* contiguous, and the product works across elements.
+	*
+	* @param a is the array of integers to multiply in place.
+	* @param b is the array of multipliers.
+	* @param bStep is the distance between the multipliers of consecutive elements, 0 or 1.
+	* @param n is the number of elements.
+	* @param modulus is the odd modulus to perform operations with.
+	* @param mInv is the precomputed value from ComputeMontgomeryInverse(modulus).
+	* @param r2 is the optional second multiplier.
+	*/
+	static void ModMulMontgomeryBlock(BigInteger *a, const BigInteger *b, size_t bStep, size_t n,
+			const BigInteger& modulus, uint_type mInv, const BigInteger *r2);
+
 	/**
 	 * NTL-optimized modular multiplication using a precomputation for the multiplicand
 	 *
@@ -820,45 +869,7 @@ namespace cpu_int{
 	 */
     template<typename uint_type_c,usint BITLENGTH_c>
     friend std::ostream& operator<<(std::ostream& os, const BigInteger<uint_type_c,BITLENGTH_c>& ptr_obj) {
-
-    	//create reference for the object to be printed
-    	BigInteger<uint_type_c,BITLENGTH_c> *print_obj;
-
-    	usint counter;
-
-    	//initiate to object to be printed
-    	print_obj = new BigInteger<uint_type_c,BITLENGTH_c>(ptr_obj);
-
-    	//print_VALUE array stores the decimal value in the array
-    	uschar *print_VALUE = new uschar[ptr_obj.m_numDigitInPrintval];
-
-    	//reset to zero
-    	for(size_t i=0;i<ptr_obj.m_numDigitInPrintval;i++)
-    		*(print_VALUE+i)=0;
-
-    	//starts the conversion from base r to decimal value
-    	for(size_t i=print_obj->m_MSB;i>0;i--){
-
-    		//print_VALUE = print_VALUE*2
-    		BigInteger<uint_type_c,BITLENGTH_c>::double_bitVal(print_VALUE);
-    		//adds the bit value to the print_VALUE
-    		BigInteger<uint_type_c,BITLENGTH_c>::add_bitVal(print_VALUE,print_obj->GetBitAtIndex(i));
-    	}
-
-    	//find the first occurence of non-zero value in print_VALUE
-    	for(counter=0;counter<ptr_obj.m_numDigitInPrintval-1;counter++){
-    		if((int)print_VALUE[counter]!=0)break;
-    	}
-
-    	//start inserting values into the ostream object
-    	for(;counter<ptr_obj.m_numDigitInPrintval;counter++){
-    		os<<(int)print_VALUE[counter];
-    	}
-
-    	delete [] print_VALUE;
-    	//deallocate the memory since values are inserted into the ostream object
-    	delete print_obj;
-    	return os;
+    	return os << ptr_obj.ToString();
     }
 
    /**
@@ -906,6 +917,7 @@ namespace cpu_int{
 	typename std::enable_if<!cereal::traits::is_text_archive<Archive>::value,void>::type
 	save( Archive & ar, std::uint32_t const version ) const
 	{
+		SaveLayout(ar);
 		ar( ::cereal::binary_data(m_value, sizeof(m_value)) );
 		ar( ::cereal::binary_data(&m_MSB, sizeof(m_MSB)) );
 	}
@@ -914,6 +926,7 @@ namespace cpu_int{
 	typename std::enable_if <cereal::traits::is_text_archive<Archive>::value,void>::type
 	save( Archive & ar, std::uint32_t const version ) const
 	{
+		SaveLayout(ar);
 		ar( ::cereal::make_nvp("v", m_value) );
 		ar( ::cereal::make_nvp("m", m_MSB) );
 	}
@@ -925,6 +938,15 @@ namespace cpu_int{
 		if( version > SerializedVersion() ) {
 			PALISADE_THROW(lbcrypto::deserialize_error, "serialized object version " + std::to_string(version) + " is from a later version of the library");
 		}
+		if( version == 1 ) {
+			uint8_t image[V1ImageSize()];
+			ar( ::cereal::binary_data(image, 4*V1Limbs()) );
+			ar( ::cereal::binary_data(image + 4*V1Limbs(), sizeof(m_MSB)) );
+			SetValueFromV1Image(image);
+			return;
+		}
+		if( version != 2 )
+			LoadLayout(ar);
 		ar( ::cereal::binary_data(m_value, sizeof(m_value)) );
 		ar( ::cereal::binary_data(&m_MSB, sizeof(m_MSB)) );
 	}
@@ -936,12 +958,96 @@ namespace cpu_int{
 		if( version > SerializedVersion() ) {
 			PALISADE_THROW(lbcrypto::deserialize_error, "serialized object version " + std::to_string(version) + " is from a later version of the library");
 		}
+		if( version == 1 ) {
+			uint32_t limbs[V1Limbs()];
+			ar( ::cereal::make_nvp("v", limbs) );
+			ar( ::cereal::make_nvp("m", m_MSB) );
+			SetFromV1Limbs(limbs);
+			return;
+		}
+		if( version != 2 )
+			LoadLayout(ar);
 		ar( ::cereal::make_nvp("v", m_value) );
 		ar( ::cereal::make_nvp("m", m_MSB) );
 	}
 
 	std::string SerializedObjectName() const { return "CPUInteger"; }
-	static uint32_t	SerializedVersion() { return 1; }
+	// version 3 stores BITLENGTH and the limb width, then the integral_dtype limbs as they are in memory;
+	// version 2 stored the limbs only, and version 1 stored 32-bit limbs. Versions 1 and 2 carry no length,
+	// so they can only be read as written with the BITLENGTH of this build. Archives written where the
+	// version is not registered carry version 0 and are read as the current layout
+	static uint32_t	SerializedVersion() { return 3; }
+
+	/**
+	 * Writes BITLENGTH and the limb width, which fix the in-memory layout that version 3 serializations store
+	 */
+	template <class Archive>
+	static void SaveLayout( Archive & ar ) {
+		uint32_t bitLength = BITLENGTH;
+		uint32_t limbBits = m_uintBitLength;
+		ar( ::cereal::make_nvp("b", bitLength) );
+		ar( ::cereal::make_nvp("w", limbBits) );
+	}
+
+	/**
+	 * Reads what SaveLayout wrote
+	 * @throw deserialize_error if the archive was written by a build with another BITLENGTH or limb width
+	 */
+	template <class Archive>
+	static void LoadLayout( Archive & ar ) {
+		uint32_t bitLength, limbBits;
+		ar( ::cereal::make_nvp("b", bitLength) );
+		ar( ::cereal::make_nvp("w", limbBits) );
+		if( bitLength != BITLENGTH || limbBits != m_uintBitLength )
+			PALISADE_THROW(lbcrypto::deserialize_error, "BigInteger serialized with BigIntegerBitLength " + std::to_string(bitLength)
+					+ " and " + std::to_string(limbBits) + "-bit limbs cannot be read by a build with "
+					+ std::to_string(BITLENGTH) + " and " + std::to_string(m_uintBitLength) + "-bit limbs");
+	}
+
+	/**
+	 * Number of 32-bit limbs in a version 1 serialization of this BigInteger
+	 */
+	static constexpr usint V1Limbs() { return (BITLENGTH+31)/32; }
+
+	/**
+	 * Size in bytes of the version 1 in-memory image of this BigInteger, as dumped by version 1 of BigVector:
+	 * the 32-bit limbs, most significant first, followed by the MSB and padding
+	 */
+	static constexpr size_t V1ImageSize() { return (4*V1Limbs() + sizeof(usshort) + 3) & ~size_t(3); }
+
+	/**
+	 * Sets the value from a version 1 in-memory image
+	 * @param image pointer to V1ImageSize() bytes
+	 */
+	void SetValueFromV1Image(const uint8_t *image) {
+		uint32_t limbs[V1Limbs()];
+		memcpy(limbs, image, sizeof(limbs));
+		memcpy(&m_MSB, image + sizeof(limbs), sizeof(m_MSB));
+		SetFromV1Limbs(limbs);
+	}
+
+    private:
+	/**
+	* Long division of this value by b, which must be nonzero and not larger than this value.
+	* @param b is the divisor.
+	* @param quotient receives the quotient unless it is null.
+	* @param remainder receives the remainder unless it is null; it may be this value.
+	*/
+	void Divide(const BigInteger& b, BigInteger* quotient, BigInteger* remainder) const;
+
+	// repacks 32-bit limbs, most significant first, into m_value; m_MSB must already be set
+	void SetFromV1Limbs(const uint32_t *limbs) {
+		if( m_uintBitLength < 32 )
+			PALISADE_THROW(lbcrypto::deserialize_error, "version 1 BigInteger serializations need limbs of at least 32 bits");
+		memset(m_value, 0, sizeof(m_value));
+		for( usint j = 0; j < V1Limbs(); j++ ) {
+			uint_type word = limbs[V1Limbs()-1-j];
+			if( word == 0 )
+				continue;
+			usint bit = 32*j;
+			m_value[m_nSize-1-bit/m_uintBitLength] |= word << (bit%m_uintBitLength);
+		}
+	}
 
     protected:
     
@@ -1035,19 +1141,6 @@ namespace cpu_int{
 		* @return the decimal value.
 		*/
 		static uint_type UintInBinaryToDecimal(uschar *a);
-
-		/**
-		* function that mutiplies by 2 to the binary array.
-		* @param a is a pointer to the binary array.
-		*/
-		static void double_bitVal(uschar *a);
-
-		/**
-		* function that adds bit b to the binary array.
-		* @param a is a pointer to the binary array.
-		* @param b is a bit value to be added.
-		*/
-		static void add_bitVal(uschar* a,uschar b);
 	};
 
 	extern template class BigInteger<integral_dtype,BigIntegerBitLength>;
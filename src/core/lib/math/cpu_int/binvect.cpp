@@ -34,6 +34,9 @@
 #include "../nbtheory.h"
 #include "../../utils/debug.h"
 
+//largest modulus for which the element-wise vector product uses Montgomery multiplication
+#define MontgomeryVectorMaxBits 512
+
 
 namespace cpu_int {
 
@@ -391,25 +394,30 @@ Our implementation makes the modulo operation essentially equivalent to two mult
 with a single multiplication. The interleaved version of modular multiplication for this case is listed in Algorithm 6 of the source. 
 This algorithm would most like give the biggest improvement but it sets constraints on moduli.
 
+Barrett reduction is only used for even moduli. Odd moduli use Montgomery multiplication, which works on the limbs of the
+modulus only: b is moved into the Montgomery domain once, after which each element costs a single Montgomery multiplication.
+
 */
 template<class IntegerType>
 BigVectorImpl<IntegerType> BigVectorImpl<IntegerType>::ModMul(const IntegerType &b) const{
 
 	BigVectorImpl ans(*this);
-
-	//Precompute the Barrett mu parameter
-	IntegerType mu = lbcrypto::ComputeMu<IntegerType>(m_modulus);
-
-	for(usint i=0;i<this->m_length;i++){
-		ans.m_data[i].ModBarrettMulInPlace(b,this->m_modulus,mu);
-	}
-
+	ans.ModMulEq(b);
 	return ans;
 }
 
 template<class IntegerType>
 const BigVectorImpl<IntegerType>& BigVectorImpl<IntegerType>::ModMulEq(const IntegerType &b) {
 
+	if (m_modulus.GetBitAtIndex(1) == 1) {
+		auto mInv = IntegerType::ComputeMontgomeryInverse(m_modulus);
+		IntegerType bR(b);
+		bR.ModMulMontgomeryInPlace(IntegerType::ComputeMontgomeryR2(m_modulus), m_modulus, mInv);
+
+		IntegerType::ModMulMontgomeryBlock(this->m_data, &bR, 0, this->m_length, this->m_modulus, mInv, NULL);
+		return *this;
+	}
+
 	//Precompute the Barrett mu parameter
 	IntegerType mu = lbcrypto::ComputeMu<IntegerType>(m_modulus);
 
@@ -548,6 +556,10 @@ Our implementation makes the modulo operation essentially equivalent to two mult
 with a single multiplication. The interleaved version of modular multiplication for this case is listed in Algorithm 6 of the source. 
 This algorithm would most like give the biggest improvement but it sets constraints on moduli.
 
+For odd moduli up to MontgomeryVectorMaxBits each element costs two Montgomery multiplications instead: the first gives
+a*b*R^{-1}, and the second, by R^2, removes the factor R^{-1}. Above that size one Barrett product is cheaper than two
+Montgomery products.
+
 */
 template<class IntegerType>
 BigVectorImpl<IntegerType> BigVectorImpl<IntegerType>::ModMul(const BigVectorImpl &b) const{
@@ -557,13 +569,7 @@ BigVectorImpl<IntegerType> BigVectorImpl<IntegerType>::ModMul(const BigVectorImp
 	}
 
 	BigVectorImpl ans(*this);
-
-	//Precompute the Barrett mu parameter
-	IntegerType mu = lbcrypto::ComputeMu<IntegerType>(this->GetModulus());
-
-	for(usint i=0;i<ans.m_length;i++){
-		ans.m_data[i].ModBarrettMulInPlace(b.m_data[i],this->m_modulus,mu);
-	}
+	ans.ModMulEq(b);
 	return ans;
 }
 
@@ -574,6 +580,14 @@ const BigVectorImpl<IntegerType>& BigVectorImpl<IntegerType>::ModMulEq(const Big
         throw std::logic_error("ModMul called on BigVectorImpl's with different parameters.");
 	}
 
+	if (m_modulus.GetBitAtIndex(1) == 1 && m_modulus.GetMSB() <= MontgomeryVectorMaxBits) {
+		auto mInv = IntegerType::ComputeMontgomeryInverse(m_modulus);
+		IntegerType r2 = IntegerType::ComputeMontgomeryR2(m_modulus);
+
+		IntegerType::ModMulMontgomeryBlock(this->m_data, b.m_data, 1, this->m_length, this->m_modulus, mInv, &r2);
+		return *this;
+	}
+
 	//Precompute the Barrett mu parameter
 	IntegerType mu = lbcrypto::ComputeMu<IntegerType>(this->GetModulus());
 
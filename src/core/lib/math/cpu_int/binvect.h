@@ -467,6 +467,7 @@ public:
 	{
 		ar( ::cereal::make_nvp("m", m_modulus) );
 		ar( ::cereal::make_nvp("l", m_length) );
+		IntegerType::SaveLayout(ar);
 		ar( ::cereal::binary_data(m_data, sizeof(IntegerType)*m_length) );
 	}
 
@@ -490,6 +491,16 @@ public:
 		ar( ::cereal::make_nvp("m", m_modulus) );
 		ar( ::cereal::make_nvp("l", m_length) );
 		m_data = new IntegerType[m_length] ();
+		if( version == 1 ) {
+			// version 1 dumped BigIntegers with 32-bit limbs
+			std::vector<uint8_t> images(IntegerType::V1ImageSize()*m_length);
+			ar( ::cereal::binary_data(images.data(), images.size()) );
+			for( size_t i=0; i< m_length; i++ )
+				m_data[i].SetValueFromV1Image(&images[i*IntegerType::V1ImageSize()]);
+			return;
+		}
+		if( version != 2 )
+			IntegerType::LoadLayout(ar);
 		ar( ::cereal::binary_data(m_data, sizeof(IntegerType)*m_length) );
 	}
 
@@ -508,7 +519,8 @@ public:
 	}
 
 	std::string SerializedObjectName() const { return "CPUInteger"; }
-	static uint32_t	SerializedVersion() { return 1; }
+	// as for BigInteger; binary serializations dump the BigIntegers as they are in memory, after their layout
+	static uint32_t	SerializedVersion() { return 3; }
 
 private:
 	//m_data is a pointer to the vector
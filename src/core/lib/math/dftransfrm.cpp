@@ -25,11 +25,170 @@
  */
 
 #include "dftransfrm.h"
+#include <atomic>
 
 namespace lbcrypto {
 
+namespace {
+
+/**
+* Precomputed tables for power-of-two transforms of one size. Plans are built
+* once per size and never modified afterwards, so they are shared between
+* threads without locking.
+*/
+struct FFTPlan {
+	explicit FFTPlan(usint n);
+
+	usint n;
+	usint logn;
+	// bit-reversed index for every position
+	std::vector<usint> bitReverse;
+	// real and imaginary parts of w^k = e^{2 pi i k/n}, k < n/2
+	std::vector<double> cosTable;
+	std::vector<double> sinTable;
+	// real and imaginary parts of z^j = e^{pi i j/n}, j < n, for the negacyclic twist
+	std::vector<double> twistCos;
+	std::vector<double> twistSin;
+};
+
+FFTPlan::FFTPlan(usint n) : n(n), logn(0), bitReverse(n), cosTable(n/2), sinTable(n/2), twistCos(n), twistSin(n) {
+	while ((1U << logn) < n)
+		logn++;
+
+	for (usint i = 0; i < n; i++)
+		bitReverse[i] = (logn == 0) ? 0 : ReverseBits(i, 32) >> (32 - logn);
+	for (usint k = 0; k < n / 2; k++) {
+		cosTable[k] = cos(2 * M_PI * k / n);
+		sinTable[k] = sin(2 * M_PI * k / n);
+	}
+	for (usint j = 0; j < n; j++) {
+		twistCos[j] = cos(M_PI * j / n);
+		twistSin[j] = sin(M_PI * j / n);
+	}
+}
+
+// one slot per power of two; a plan is published with compare-and-swap and lives until exit
+const usint LOGN_MAX = 32;
+
+struct FFTPlanCache {
+	std::atomic<const FFTPlan*> plans[LOGN_MAX];
+
+	FFTPlanCache() {
+		for (usint i = 0; i < LOGN_MAX; i++)
+			plans[i].store(nullptr);
+	}
+
+	~FFTPlanCache() {
+		for (usint i = 0; i < LOGN_MAX; i++)
+			delete plans[i].load();
+	}
+};
+
+FFTPlanCache planCache;
+
+const FFTPlan& GetPlan(usint n) {
+	if (n == 0 || (n & (n - 1)) != 0)
+		PALISADE_THROW(math_error, "FFT size must be a power of two");
+
+	usint logn = 0;
+	while ((1U << logn) < n)
+		logn++;
+
+	const FFTPlan *plan = planCache.plans[logn].load(std::memory_order_acquire);
+	if (plan == nullptr) {
+		const FFTPlan *fresh = new FFTPlan(n);
+		if (planCache.plans[logn].compare_exchange_strong(plan, fresh, std::memory_order_acq_rel))
+			plan = fresh;
+		else
+			delete fresh; // another thread published the same plan first
+	}
+	return *plan;
+}
+
+/**
+* In-place cyclic transform a_k <- sum_j a_j w^{sign*jk} of the bit-reversed input,
+* with w = e^{2 pi i/n}. Pairs of radix-2 stages are fused into radix-4 butterflies;
+* a single radix-2 stage goes first when log2(n) is odd. Real and imaginary parts
+* are handled explicitly to avoid the NaN-handling paths of std::complex multiplication.
+*/
+void TransformBitReversed(const FFTPlan &plan, double *x, bool negativeSign) {
+	const usint n = plan.n;
+	const double s = negativeSign ? -1.0 : 1.0;
+	const double *wr = plan.cosTable.data();
+	const double *wi = plan.sinTable.data();
+
+	usint q = 1;
+	if (plan.logn % 2 == 1) {
+		for (usint i = 0; i < n; i += 2) {
+			double ar = x[2*i], ai = x[2*i+1];
+			double br = x[2*i+2], bi = x[2*i+3];
+			x[2*i] = ar + br;
+			x[2*i+1] = ai + bi;
+			x[2*i+2] = ar - br;
+			x[2*i+3] = ai - bi;
+		}
+		q = 2;
+	}
+
+	// combine four transforms of size q into one of size 4q
+	for (; q < n; q *= 4) {
+		const usint step = n / (4 * q);
+		for (usint i = 0; i < n; i += 4 * q) {
+			double *x0 = x + 2 * i;
+			double *x1 = x0 + 2 * q;
+			double *x2 = x1 + 2 * q;
+			double *x3 = x2 + 2 * q;
+			for (usint j = 0; j < q; j++) {
+				// twiddles w_{4q}^j and w_{2q}^j
+				const double w1r = wr[j*step], w1i = s * wi[j*step];
+				const double w2r = wr[2*j*step], w2i = s * wi[2*j*step];
+
+				// radix-2 stage of size 2q
+				double tr = x1[2*j] * w2r - x1[2*j+1] * w2i;
+				double ti = x1[2*j] * w2i + x1[2*j+1] * w2r;
+				const double y0r = x0[2*j] + tr, y0i = x0[2*j+1] + ti;
+				const double y1r = x0[2*j] - tr, y1i = x0[2*j+1] - ti;
+
+				tr = x3[2*j] * w2r - x3[2*j+1] * w2i;
+				ti = x3[2*j] * w2i + x3[2*j+1] * w2r;
+				const double y2r = x2[2*j] + tr, y2i = x2[2*j+1] + ti;
+				const double y3r = x2[2*j] - tr, y3i = x2[2*j+1] - ti;
+
+				// radix-2 stage of size 4q; w_{4q}^{j+q} = w_{4q}^j * (s i)
+				const double z2r = y2r * w1r - y2i * w1i;
+				const double z2i = y2r * w1i + y2i * w1r;
+				const double u3r = y3r * w1r - y3i * w1i;
+				const double u3i = y3r * w1i + y3i * w1r;
+				const double z3r = -s * u3i;
+				const double z3i = s * u3r;
+
+				x0[2*j] = y0r + z2r;
+				x0[2*j+1] = y0i + z2i;
+				x2[2*j] = y0r - z2r;
+				x2[2*j+1] = y0i - z2i;
+				x1[2*j] = y1r + z3r;
+				x1[2*j+1] = y1i + z3i;
+				x3[2*j] = y1r - z3r;
+				x3[2*j+1] = y1i - z3i;
+			}
+		}
+	}
+}
+
+// bit-reversal permutation without twist
+void BitReverse(const FFTPlan &plan, std::complex<double> *a) {
+	for (usint i = 0; i < plan.n; i++) {
+		usint j = plan.bitReverse[i];
+		if (j > i)
+			std::swap(a[i], a[j]);
+	}
+}
+
+}
+
 std::complex<double>* DiscreteFourierTransform::rootOfUnityTable = 0;
 
+// FFT plans are immutable and shared between threads, so they are not released here
 void DiscreteFourierTransform::Reset() {
 	if (rootOfUnityTable) {
 		delete[] rootOfUnityTable;
@@ -47,67 +206,11 @@ void DiscreteFourierTransform::PreComputeTable(uint32_t s) {
 }
 
 std::vector<std::complex<double>> DiscreteFourierTransform::FFTForwardTransform(std::vector<std::complex<double>> & A) {
-	usint m = A.size();
 	std::vector<std::complex<double>> B(A);
-	usint l = floor(log2(m));
-
-	static usint maxMCached (65536);
-	static usint LOGM_MAX(16);
-	static std::vector<usint> cachedM(LOGM_MAX, 0);
-	static std::vector<std::vector<double>> cosTable(LOGM_MAX);
-	static std::vector<std::vector<double>> sinTable(LOGM_MAX);;
-
-#pragma omp critical
-	if( m != cachedM[l] ) {
-		if (m>maxMCached){
-			//need to grow cachedM and the tables
-			cachedM.resize(l);
-			cosTable.resize(l);
-			sinTable.resize(l);
-			maxMCached = m;
-		}
-		//std::cout<<"miss m "<<m<<" != M "<<cachedM[l]<<std::endl;
-		cachedM[l] = m;
-
-		sinTable[l].resize(m/2);
-		cosTable[l].resize(m/2);
-		for (usint i = 0; i < m / 2; i++) {
-			cosTable[l][i] = cos(2 * M_PI * i / m);
-			sinTable[l][i] = sin(2 * M_PI * i / m);
-		}
+	const FFTPlan &plan = GetPlan(B.size());
 
-	}
-
-	// Bit-reversed addressing permutation
-	for (usint i = 0; i < m; i++) {
-		usint j = ReverseBits(i,32) >> (32-l);
-		if (j > i) {
-			double temp = B[i].real();
-			B[i].real( B[j].real() );
-			B[j].real( temp );
-			temp = B[i].imag();
-			B[i].imag( B[j].imag() );
-			B[j].imag( temp );
-		}
-	}
-
-	// Cooley-Tukey decimation-in-time radix-2 FFT
-	for (usint size = 2; size <= m; size *= 2) {
-		usint halfsize = size / 2;
-		usint tablestep = m / size;
-		for (usint i = 0; i < m; i += size) {
-			for (usint j = i, k = 0; j < i + halfsize; j++, k += tablestep) {
-				double tpre =  B[j+halfsize].real() * cosTable[l][k] + B[j+halfsize].imag() * sinTable[l][k];
-				double tpim = -B[j+halfsize].real() * sinTable[l][k] + B[j+halfsize].imag() * cosTable[l][k];
-				B[j + halfsize].real( B[j].real() - tpre );
-				B[j + halfsize].imag( B[j].imag() - tpim );
-				B[j].real( B[j].real() + tpre );
-				B[j].imag( B[j].imag() + tpim );
-			}
-		}
-		if (size == m)  // Prevent overflow in 'size *= 2'
-			break;
-	}
+	BitReverse(plan, B.data());
+	TransformBitReversed(plan, reinterpret_cast<double*>(B.data()), true);
 
 	return B;
 }
@@ -123,41 +226,58 @@ std::vector<std::complex<double>> DiscreteFourierTransform::FFTInverseTransform(
 }
 
 std::vector<std::complex<double>> DiscreteFourierTransform::ForwardTransform(std::vector<std::complex<double>> A) {
-	int n = A.size();
-	A.resize(2 * n);
-	for (int i = 0;i < n;i++) {
-		A[n + i] = 0;
-		//A.push_back(0);
-	}
-	// if (rootOfUnityTable == NULL) {
-	// 	PreComputeTable(2 * n);
-	// }
-	std::vector<std::complex<double>> dft = FFTForwardTransform(A);
-	std::vector<std::complex<double>> dftRemainder(dft.size()/2);
-	size_t k = 0;
-	for (int i = dft.size() - 1;i > 0;i--) {
-		if (i % 2 != 0) {
-			dftRemainder[k] = dft[i];
-			k++;
-			//dftRemainder.push_back(dft[i]);
-		}
-	}
-	return dftRemainder;
+	ForwardTransformInPlace(A);
+	return A;
 }
 
 std::vector<std::complex<double>> DiscreteFourierTransform::InverseTransform(std::vector<std::complex<double>> A) {
-	size_t n = A.size();
-	std::vector<std::complex<double>> dft(2*n);
-	for (size_t i = 0; i < n; i++) {
-		dft[2*i] = 0;
-		dft[2 * i + 1] = A[i];
+	InverseTransformInPlace(A);
+	return A;
+}
+
+// Evaluation at z^{2k+1}, z = e^{pi i/n}: sum_j (a_j z^j) w^{jk} with w = z^2,
+// i.e., a cyclic transform of the twisted coefficients
+void DiscreteFourierTransform::ForwardTransformInPlace(std::vector<std::complex<double>>& A) {
+	const FFTPlan &plan = GetPlan(A.size());
+	double *x = reinterpret_cast<double*>(A.data());
+	const double *tr = plan.twistCos.data();
+	const double *ti = plan.twistSin.data();
+
+	// twist and permute in one pass
+	for (usint i = 0; i < plan.n; i++) {
+		usint j = plan.bitReverse[i];
+		if (j < i)
+			continue;
+		double ar = x[2*i] * tr[i] - x[2*i+1] * ti[i];
+		double ai = x[2*i] * ti[i] + x[2*i+1] * tr[i];
+		if (j > i) {
+			x[2*i] = x[2*j] * tr[j] - x[2*j+1] * ti[j];
+			x[2*i+1] = x[2*j] * ti[j] + x[2*j+1] * tr[j];
+		}
+		x[2*j] = ar;
+		x[2*j+1] = ai;
 	}
-	std::vector<std::complex<double>> invDft = FFTInverseTransform(dft);
-	std::vector<std::complex<double>> invDftRemainder(invDft.size() / 2);
-	for (size_t i = 0;i<invDft.size() / 2;i++) {
-		invDftRemainder[i] = invDft[i];
+
+	TransformBitReversed(plan, x, false);
+}
+
+// a_j = (1/n) z^{-j} sum_k A_k w^{-jk}
+void DiscreteFourierTransform::InverseTransformInPlace(std::vector<std::complex<double>>& A) {
+	const FFTPlan &plan = GetPlan(A.size());
+	double *x = reinterpret_cast<double*>(A.data());
+
+	BitReverse(plan, A.data());
+	TransformBitReversed(plan, x, true);
+
+	const double *tr = plan.twistCos.data();
+	const double *ti = plan.twistSin.data();
+	const double scale = 1.0 / plan.n;
+	for (usint j = 0; j < plan.n; j++) {
+		double ar = x[2*j] * tr[j] + x[2*j+1] * ti[j];
+		double ai = x[2*j+1] * tr[j] - x[2*j] * ti[j];
+		x[2*j] = ar * scale;
+		x[2*j+1] = ai * scale;
 	}
-	return invDftRemainder;
 }
 
 }//namespace ends here
@@ -82,6 +82,25 @@ namespace lbcrypto {
 		*/
 		static std::vector<std::complex<double>> InverseTransform(std::vector<std::complex<double>> A);
 
+		/**
+		* In-place negacyclic forward transform. Evaluates the polynomial with coefficients A
+		* at the primitive 2n-th roots of unity, in the same order as ForwardTransform.
+		* The twist by powers of a 2n-th root of unity is fused with the bit-reversal pass,
+		* and the butterflies are radix-4.
+		*
+		* @param A holds the coefficients on input and the evaluations on output;
+		* its size n must be a power of two.
+		*/
+		static void ForwardTransformInPlace(std::vector<std::complex<double>>& A);
+
+		/**
+		* In-place negacyclic inverse transform; inverse of ForwardTransformInPlace.
+		*
+		* @param A holds the evaluations on input and the coefficients on output;
+		* its size n must be a power of two.
+		*/
+		static void InverseTransformInPlace(std::vector<std::complex<double>>& A);
+
 		/**
 		* Reset cached values for the transform to empty.
 		*/
@@ -72,6 +72,12 @@ public:
 #endif
 		}
 
+#if !defined(FIXED_SEED)
+		// threads that were not in the team above, such as ones started with std::thread, seed their own
+		if (!m_prng)
+			m_prng.reset(new std::mt19937(std::chrono::high_resolution_clock::now().time_since_epoch().count()+std::hash<std::thread::id>{}(std::this_thread::get_id())));
+#endif
+
 		return *m_prng;
 
 	}
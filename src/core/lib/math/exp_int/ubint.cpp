@@ -31,6 +31,7 @@
 #define _SECURE_SCL 0 // to speed up VS
 #include "../backend.h"
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include "time.h"
@@ -39,9 +40,179 @@
 #include "../../utils/debug.h"
 
 #define LimbReserveHint 4  // hint for reservation of limbs
+#define KaratsubaThreshold 32  // operands with fewer limbs than this are multiplied with Comba's method
 
 namespace exp_int {
 
+// Kernels on little-endian limb arrays used by Times, ModMul and ModExp.
+
+// r[0..na+nb) = a*b by product scanning (Comba): each output limb is accumulated in a
+// three-limb column sum, so every output limb is written exactly once
+template<typename limb_t>
+static void MulComba(limb_t* r, const limb_t* a, size_t na, const limb_t* b, size_t nb) {
+	typedef typename DoubleDataType<limb_t>::T Dlimb_t;
+	const usint bits = sizeof(limb_t)*8;
+	limb_t c0 = 0, c1 = 0, c2 = 0;
+	for (size_t k = 0; k < na+nb-1; k++) {
+		size_t i = k < nb ? 0 : k-nb+1;
+		size_t iEnd = k < na ? k : na-1;
+		for (; i <= iEnd; i++) {
+			Dlimb_t p = (Dlimb_t)a[i]*b[k-i];
+			Dlimb_t t = (Dlimb_t)c0 + (limb_t)p;
+			c0 = (limb_t)t;
+			t = (Dlimb_t)c1 + (limb_t)(p>>bits) + (limb_t)(t>>bits);
+			c1 = (limb_t)t;
+			c2 += (limb_t)(t>>bits);
+		}
+		r[k] = c0;
+		c0 = c1;
+		c1 = c2;
+		c2 = 0;
+	}
+	r[na+nb-1] = c0;
+}
+
+// r[0..n) += a[0..na), propagating the carry through r; returns the carry out of r
+template<typename limb_t>
+static limb_t AddLimbsTo(limb_t* r, size_t n, const limb_t* a, size_t na) {
+	typedef typename DoubleDataType<limb_t>::T Dlimb_t;
+	const usint bits = sizeof(limb_t)*8;
+	limb_t c = 0;
+	size_t i = 0;
+	for (; i < na; i++) {
+		Dlimb_t t = (Dlimb_t)r[i] + a[i] + c;
+		r[i] = (limb_t)t;
+		c = (limb_t)(t>>bits);
+	}
+	for (; c && i < n; i++) {
+		c = ++r[i] == 0;
+	}
+	return c;
+}
+
+// r[0..n) -= a[0..na), propagating the borrow through r; returns the borrow out of r
+template<typename limb_t>
+static limb_t SubLimbsFrom(limb_t* r, size_t n, const limb_t* a, size_t na) {
+	limb_t borrow = 0;
+	size_t i = 0;
+	for (; i < na; i++) {
+		limb_t ri = r[i];
+		limb_t d = ri - a[i] - borrow;
+		borrow = (ri < a[i]) || (ri == a[i] && borrow);
+		r[i] = d;
+	}
+	for (; borrow && i < n; i++) {
+		borrow = r[i]-- == 0;
+	}
+	return borrow;
+}
+
+template<typename limb_t>
+static void MulLimbs(limb_t* r, const limb_t* a, size_t na, const limb_t* b, size_t nb);
+
+// r[0..2n) = a*b for n-limb operands by one level of Karatsuba splitting:
+// a*b = z2*B^2h + (z1-z2-z0)*B^h + z0 with z1 = (a0+a1)*(b0+b1)
+template<typename limb_t>
+static void MulKaratsuba(limb_t* r, const limb_t* a, const limb_t* b, size_t n) {
+	size_t h = n/2;
+	size_t hh = n-h;
+
+	MulLimbs(r, a, h, b, h);
+	MulLimbs(r+2*h, a+h, hh, b+h, hh);
+
+	std::vector<limb_t> buf(4*(hh+1));
+	limb_t* sa = &buf[0];
+	limb_t* sb = sa+hh+1;
+	limb_t* z1 = sb+hh+1;
+	std::copy(a+h, a+n, sa);
+	sa[hh] = AddLimbsTo(sa, hh, a, h);
+	std::copy(b+h, b+n, sb);
+	sb[hh] = AddLimbsTo(sb, hh, b, h);
+
+	size_t ns = (sa[hh] || sb[hh]) ? hh+1 : hh;
+	MulLimbs(z1, sa, ns, sb, ns);
+	SubLimbsFrom(z1, 2*ns, r, 2*h);
+	SubLimbsFrom(z1, 2*ns, r+2*h, 2*hh);
+
+	// the middle term is below B^(n+1), so its top limbs beyond r are zero
+	size_t nz = std::min(2*ns, 2*n-h);
+	AddLimbsTo(r+h, 2*n-h, z1, nz);
+}
+
+// r[0..na+nb) = a*b, choosing Comba for short operands and Karatsuba for long ones;
+// operands of very different lengths are multiplied in balanced slices
+template<typename limb_t>
+static void MulLimbs(limb_t* r, const limb_t* a, size_t na, const limb_t* b, size_t nb) {
+	if (na < nb) {
+		std::swap(a, b);
+		std::swap(na, nb);
+	}
+	if (nb < KaratsubaThreshold) {
+		MulComba(r, a, na, b, nb);
+		return;
+	}
+	if (na == nb) {
+		MulKaratsuba(r, a, b, na);
+		return;
+	}
+
+	std::fill(r, r+na+nb, 0);
+	std::vector<limb_t> part(2*nb);
+	for (size_t off = 0; off < na; off += nb) {
+		size_t len = std::min(nb, na-off);
+		MulLimbs(&part[0], a+off, len, b, nb);
+		AddLimbsTo(r+off, na+nb-off, &part[0], len+nb);
+	}
+}
+
+// Montgomery product r = a*b/B^n mod m of n-limb values below m (CIOS method), using the
+// scratch t of n+2 limbs; r may alias a or b. mInv is -1/m[0] mod B.
+template<typename limb_t>
+static void MontMul(limb_t* r, const limb_t* a, const limb_t* b, const limb_t* m, size_t n, limb_t mInv, limb_t* t) {
+	typedef typename DoubleDataType<limb_t>::T Dlimb_t;
+	const usint bits = sizeof(limb_t)*8;
+	std::fill(t, t+n+2, 0);
+	for (size_t i = 0; i < n; i++) {
+		Dlimb_t s;
+		limb_t c = 0;
+		for (size_t j = 0; j < n; j++) {
+			s = (Dlimb_t)a[j]*b[i] + t[j] + c;
+			t[j] = (limb_t)s;
+			c = (limb_t)(s>>bits);
+		}
+		s = (Dlimb_t)t[n] + c;
+		t[n] = (limb_t)s;
+		t[n+1] = (limb_t)(s>>bits);
+
+		limb_t q = t[0]*mInv;
+		s = (Dlimb_t)q*m[0] + t[0];
+		c = (limb_t)(s>>bits);
+		for (size_t j = 1; j < n; j++) {
+			s = (Dlimb_t)q*m[j] + t[j] + c;
+			t[j-1] = (limb_t)s;
+			c = (limb_t)(s>>bits);
+		}
+		s = (Dlimb_t)t[n] + c;
+		t[n-1] = (limb_t)s;
+		t[n] = t[n+1] + (limb_t)(s>>bits);
+	}
+
+	// t < 2m, so one conditional subtraction reduces it
+	bool geq = t[n] != 0;
+	if (!geq) {
+		geq = true;
+		for (size_t j = n; j-- > 0;) {
+			if (t[j] != m[j]) {
+				geq = t[j] > m[j];
+				break;
+			}
+		}
+	}
+	if (geq)
+		SubLimbsFrom(t, n+1, m, n);
+	std::copy(t, t+n, r);
+}
+
 //MOST REQUIRED STATIC CONSTANTS INITIALIZATION
 
 //constant static member variable initialization of m_uintBitLength which is equal to number of bits in the unit data type
@@ -1000,12 +1171,10 @@ const ubint<limb_t>& ubint<limb_t>::MinusEq(const ubint& b) {
 }
 
 /** Multiply operation:
- *  Algorithm used is usual school book shift and add after multiplication, except for that radix is 2^m_bitLength.
+ *  Comba's product scanning for operands below KaratsubaThreshold limbs, Karatsuba's method above it.
  */
 template<typename limb_t>
 ubint<limb_t> ubint<limb_t>::Times(const ubint& b) const{
-	DEBUG_FLAG(false);
-	DEBUG("Times");
 
 	ubint ans(0);
 	//check for garbage initialized objects
@@ -1017,87 +1186,20 @@ ubint<limb_t> ubint<limb_t>::Times(const ubint& b) const{
 		return ubint(*this);
 
 	if(this->m_MSB==1)
-		return std::move(ubint(b)); //todo check this? don't think standard move is what we want.
-
-	//position of B in the array where the multiplication should start
-	//limb_t ceilLimb = b.m_value.size();
-	//Multiplication is done by getting a limb_t from b and multiplying it with *this
-	//after multiplication the result is shifted and added to the final answer
+		return ubint(b);
 
 	size_t nSize = this->m_value.size();
 	size_t bSize = b.m_value.size();
-	ubint tmpans;
-	ans.m_value.reserve(nSize+bSize);
-	tmpans.m_value.reserve(nSize+1);
-
-	for(size_t i= 0;i< bSize;++i){
-		DEBUG("i "<<i);
-		//ubint tmp2;
-		//////
-		tmpans.m_value.clear(); //make sure there are no limbs to start.
-		Dlimb_t limbb(b.m_value[i]);
-
-		//position in the array to start multiplication
-		//
-		//variable to capture the overflow
-		Dlimb_t temp=0;
-		//overflow value
-		limb_t ofl=0;
-
-
-		DEBUG("mibl A:"<<this->ToString() );
-		//DEBUG("mibl B:"<<limbb );
-		DEBUG("ans.size() now " <<ans.m_value.size());
-		DEBUGEXP(ans.GetInternalRepresentation());
-
-		usint ix= 0;
-		while (ix<i){
-			tmpans.m_value.push_back(0); //equivalent of << shift
-			//could use insert
-			++ix;
-		}
-
-		for(auto itr: m_value){
-			DEBUG("mullimb i"<<i);
-			temp = ((Dlimb_t)itr*(Dlimb_t)limbb) + ofl;
-			//DEBUG("temp "<<temp); //todo fix when ostream<< works for 128 bit
-
-			tmpans.m_value.push_back((limb_t)temp);
-			ofl = temp>>m_limbBitLength;
-			DEBUG("ans.size() now " <<ans.m_value.size());
-			DEBUGEXP(tmpans.GetInternalRepresentation());
-		}
-		//check if there is any final overflow
-		if(ofl){
-			DEBUG("mullimb ofl "<<ofl);
-			tmpans.m_value.push_back(ofl);
-		}
-
-		//usint nSize = m_value.size();
-		tmpans.m_state = INITIALIZED;
-		tmpans.SetMSB();
-		DEBUG("ans.size() final " <<ans.m_value.size());
-		DEBUGEXP(tmpans.GetInternalRepresentation());
-		DEBUG("mibl ans "<<ans.ToString());
-		/////
-
-		//ans += tmpans<<=(i)*m_limbBitLength;
-		ans += tmpans;
-		//ans += (this->MulIntegerByLimb(b.m_value[i]))<<=(i)*m_limbBitLength;
-		// usint tmp1 = (i)*m_limbBitLength;
-		// DEBUG("tmp1 "<<tmp1);
-		// tmp2 = (this->MulIntegerByLimb(b.m_value[i])) <<= tmp1;
-		// DEBUG("tmp2 "<<tmp2.ToString());
-		// ans += tmp2;
-
-		DEBUG("ans now "<<ans.ToString());
-	}
+	ans.m_value.resize(nSize+bSize);
+	MulLimbs(&ans.m_value[0], &this->m_value[0], nSize, &b.m_value[0], bSize);
 
+	ans.NormalizeLimbs();
+	ans.SetMSB();
 	return ans;
 }
 
 /** Multiply operation:
- *  Algorithm used is usual school book shift and add after multiplication, except for that radix is 2^m_bitLength.
+ *  See Times.
  */
 template<typename limb_t>
 const ubint<limb_t>& ubint<limb_t>::TimesEq(const ubint& b) {
@@ -2302,85 +2404,13 @@ const ubint<limb_t>& ubint<limb_t>::ModSubEq(const ubint& b, const ubint& modulu
 template<typename limb_t>
 ubint<limb_t> ubint<limb_t>::ModMul(const ubint& b, const ubint& modulus) const{
 
-	ubint a(*this);
-	DEBUG_FLAG(false);
-	DEBUG("ModMul");
-
-	ubint ans(0);
 	//check for garbage initialized objects
-	if(b.m_MSB==0 || b.m_state==GARBAGE || a.m_state==GARBAGE || a.m_MSB==0){
-		return ans;
+	if(b.m_MSB==0 || b.m_state==GARBAGE || this->m_state==GARBAGE || this->m_MSB==0){
+		return ubint(0);
 	}
-	//check for trivial conditions
-	if(b.m_MSB==1)
-		return a;
-
-	if(a.m_MSB==1)
-		return b;
-
-	//position of B in the array where the multiplication should start
-	//limb_t ceilLimb = b.m_value.size();
-	//Multiplication is done by getting a limb_t from b and multiplying it with *this
-	//after multiplication the result is shifted and added to the final answer
-
-	size_t nSize = a.m_value.size();
-	size_t bSize = b.m_value.size();
-	ubint tmpans;
-	ans.m_value.reserve(nSize+bSize);
-	tmpans.m_value.reserve(nSize+bSize);
-
-	for(size_t i= 0;i< bSize;++i){
-		DEBUG("i "<<i);
-		tmpans.m_value.clear(); //make sure there are no limbs to start.
-		Dlimb_t limbb(b.m_value[i]);
-
-		//variable to capture the overflow
-		Dlimb_t temp=0;
-		//overflow value
-		limb_t ofl=0;
-
-		DEBUG("mibl A:"<<a.ToString() );
-		// DEBUG("mibl B:"<<limbb );
-		DEBUG("ans.size() now " <<ans.m_value.size());
-		DEBUGEXP(ans.GetInternalRepresentation());
-
-		usint ix= 0;
-		while (ix<i){
-			tmpans.m_value.push_back(0); //equivalent of << shift
-			//could use insert
-			++ix;
-		}
-
-		for(auto itr: a.m_value){
-			DEBUG("mullimb i"<<i);
-			temp = ((Dlimb_t)itr*(Dlimb_t)limbb) + ofl;
-
-			tmpans.m_value.push_back((limb_t)temp);
-			ofl = temp>>a.m_limbBitLength;
-			DEBUG("ans.size() now " <<ans.m_value.size());
-			DEBUGEXP(tmpans.GetInternalRepresentation());
-
-		}
-		//check if there is any final overflow
-		if(ofl){
-			DEBUG("mullimb ofl "<<ofl);
-			tmpans.m_value.push_back(ofl);
-		}
-
-		//usint nSize = m_value.size();
-		tmpans.m_state = INITIALIZED;
-		tmpans.SetMSB();
-		DEBUG("ans.size() final " <<ans.m_value.size());
-		DEBUGEXP(tmpans.GetInternalRepresentation());
-
-		DEBUG("mibl ans "<<ans.ToString());
 
-		//      ans += (tmpans<<=(i)*a.m_limbitLength);
-		ans += tmpans;
-		ans = ans.Mod(modulus);
-		DEBUG("ans now "<<ans.ToString());
-	}
-	return ans;
+	//one reduction of the full product instead of one per limb of b
+	return this->Times(b).Mod(modulus);
 }
 
 // FIXME make this skip the mod
@@ -2511,8 +2541,10 @@ ubint<limb_t> ubint<limb_t>::ModBarrett(const ubint& modulus, const ubint mu_arr
 }
 
 
-//Modular Exponentiation using Square and Multiply Algorithm
-//reference:http://guan.cse.nsysu.edu.tw/note/expn.pdf
+//Modular Exponentiation
+//Odd moduli use a Montgomery ladder over Montgomery products: every exponent bit costs one product and one
+//square on fixed-size limb arrays, with no division inside the loop.
+//Even moduli use the Square and Multiply Algorithm, reference:http://guan.cse.nsysu.edu.tw/note/expn.pdf
 template<typename limb_t>
 ubint<limb_t> ubint<limb_t>::ModExp(const ubint& b, const ubint& modulus) const{
 	DEBUG_FLAG(false);
@@ -2528,6 +2560,48 @@ ubint<limb_t> ubint<limb_t>::ModExp(const ubint& b, const ubint& modulus) const{
 	ubint mid = this->Mod(modulus);
 	DEBUG("mid: "<<mid.ToString());
 
+	if( (modulus.m_value[0]&1) && modulus.m_MSB > 1 ) {
+		size_t n = modulus.m_value.size();
+		const limb_t* m = &modulus.m_value[0];
+
+		//mInv = -1/m mod 2^m_limbBitLength by Newton iteration; each step doubles the correct low bits
+		limb_t inv = m[0];
+		for( usint bitsOk = 3; bitsOk < m_limbBitLength; bitsOk *= 2 )
+			inv *= (limb_t)2 - m[0]*inv;
+		limb_t mInv = (limb_t)0 - inv;
+
+		//Montgomery forms x*2^(n*m_limbBitLength) mod modulus of 1 and of the base
+		ubint oneM = (ubint(1) << (n*m_limbBitLength)).Mod(modulus);
+		ubint baseM = (mid << (n*m_limbBitLength)).Mod(modulus);
+
+		std::vector<limb_t> r0(n, 0), r1(n, 0), tmp(n+2);
+		std::copy(oneM.m_value.begin(), oneM.m_value.end(), r0.begin());
+		std::copy(baseM.m_value.begin(), baseM.m_value.end(), r1.begin());
+
+		//ladder invariant: r1 = r0*base
+		for( usint i = b.m_MSB; i-- > 0; ) {
+			if( (b.m_value[i/m_limbBitLength] >> (i%m_limbBitLength)) & 1 ) {
+				MontMul(&r0[0], &r0[0], &r1[0], m, n, mInv, &tmp[0]);
+				MontMul(&r1[0], &r1[0], &r1[0], m, n, mInv, &tmp[0]);
+			} else {
+				MontMul(&r1[0], &r0[0], &r1[0], m, n, mInv, &tmp[0]);
+				MontMul(&r0[0], &r0[0], &r0[0], m, n, mInv, &tmp[0]);
+			}
+		}
+
+		//leave the Montgomery domain by multiplying with 1
+		std::vector<limb_t> one(n, 0);
+		one[0] = 1;
+		MontMul(&r0[0], &r0[0], &one[0], m, n, mInv, &tmp[0]);
+
+		ubint product;
+		product.m_value.assign(r0.begin(), r0.end());
+		product.NormalizeLimbs();
+		product.SetMSB();
+		DEBUG("Modexp montgomery ladder, time ms "<<TOC_MS(t));
+		return product;
+	}
+
 	//product calculates the running product of mod values
 	ubint product(1);
 
@@ -2535,7 +2609,6 @@ ubint<limb_t> ubint<limb_t>::ModExp(const ubint& b, const ubint& modulus) const{
 	ubint Exp(b);
 
 	unsigned int loops =0;
-#if 1
 	while(true){
 
 		//product is multiplied only if lsb bitvalue is 1
@@ -2562,30 +2635,6 @@ ubint<limb_t> ubint<limb_t>::ModExp(const ubint& b, const ubint& modulus) const{
 		//std::cout<<"."<<std::flush;
 		loops++;
 	}
-#else
-	while(true){
-
-		//product is multiplied only if lsb bitvalue is 1
-		if((Exp.m_value[0]&1)==1){
-			product = product.ModMul(mid,modulus);
-		}
-
-		//DEBUG("product "<<product);
-		//divide by 2 and check even to odd to find bit value
-		Exp >>=1;
-		if(Exp==0)break;
-
-		//DEBUG("Exp "<<Exp);
-
-		//mid calculates mid^2%q
-
-		mid = (mid.ModMul(mid,modulus));
-		//DEBUG("mid: "<<mid);
-		//std::cout<<"."<<std::flush;
-		loops++;
-	}
-
-#endif
 
 	//std::cout<<std::endl;
 	DEBUG("Modexp "<<loops<<" loops, time ms "<<TOC_MS(t));
@@ -133,118 +133,251 @@ Matrix<Element> Matrix<Element>::Transpose() const {
     return result;
 }
 
-// YSP The signature of this method needs to be changed in the future
-// Laplace's formula is used to find the determinant
-// Complexity is O(d!), where d is the dimension
-// The determinant of a matrix is expressed in terms of its minors
-// recursive implementation
-// There are O(d^3) decomposition algorithms that can be implemented to support larger dimensions.
-// Examples include the LU decomposition, the QR decomposition or 
-// the Cholesky decomposition(for positive definite matrices).
+// Characteristic polynomial det(xI - A) = x^d + c[0] x^{d-1} + ... + c[d-1]
+// computed with the Samuelson-Berkowitz algorithm. No divisions are used, so
+// this works over any ring, including ciphertexts. The leading coefficient 1
+// is implicit so that no unit element needs to be constructed.
+// Complexity is O(d^4); the matrix-vector products run in parallel over rows.
 template<class Element>
-void Matrix<Element>::Determinant(Element *determinant) const {
-	if (rows != cols) 
-		throw invalid_argument("Supported only for square matrix");
-	//auto determinant = *allocZero();
-	if (rows < 1)
-		throw invalid_argument("Dimension should be at least one");
-	else if (rows == 1)
-		*determinant = data[0][0];
-	else if (rows == 2)
-		*determinant = data[0][0] * (data[1][1]) - data[1][0] * (data[0][1]);
-	else
-	{
-		size_t j1, j2;
-		size_t n = rows;
-
-		Matrix<Element> result(allocZero, rows - 1, cols - 1);
-
-		// for each column in sub-matrix
-		for (j1 = 0; j1 < n; j1++) {
-
-			// build sub-matrix with minor elements excluded
-			for (size_t i = 1; i < n; i++) {
-				j2 = 0;               // start at first sum-matrix column position
-				// loop to copy source matrix less one column
-				for (size_t j = 0; j < n; j++) {
-					if (j == j1) continue; // don't copy the minor column element
-
-					result.data[i-1][j2] = data[i][j];  // copy source element into new sub-matrix
-											 // i-1 because new sub-matrix is one row
-											 // (and column) smaller with excluded minors
-					j2++;                  // move to next sub-matrix column position
-				}
+static std::vector<Element> CharPolyBerkowitz(const std::vector<std::vector<Element>>& a,
+		const std::function<Element(void)>& allocZero) {
+	size_t n = a.size();
+
+	// characteristic polynomial of the bottom-right 1x1 submatrix
+	std::vector<Element> c;
+	c.push_back(a[n-1][n-1]);
+	c[0] = -c[0];
+
+	// grow the bottom-right submatrix one row/column at a time
+	for (size_t k = n - 1; k-- > 0; ) {
+		size_t m = n - k - 1;
+
+		// u[0] = a_kk, u[j+1] = R * A1^j * C, where R is the rest of row k,
+		// C is the rest of column k and A1 is the previous submatrix
+		std::vector<Element> u;
+		u.push_back(a[k][k]);
+
+		std::vector<Element> w;
+		for (size_t l = 0; l < m; l++)
+			w.push_back(a[k+1+l][k]);
+
+		for (size_t j = 0; j < m; j++) {
+			Element q(allocZero());
+			for (size_t l = 0; l < m; l++)
+				q += a[k][k+1+l] * w[l];
+			u.push_back(q);
+
+			if (j + 1 < m) {
+				std::vector<Element> next;
+				for (size_t r = 0; r < m; r++)
+					next.push_back(allocZero());
+#pragma omp parallel for
+				for (size_t r = 0; r < m; r++)
+					for (size_t l = 0; l < m; l++)
+						next[r] += a[k+1+r][k+1+l] * w[l];
+				w = std::move(next);
 			}
+		}
 
-			auto tempDeterminant( allocZero() );
-			result.Determinant(&tempDeterminant);
-
-			if (j1 % 2 == 0)
-				*determinant = *determinant + (data[0][j1]) * tempDeterminant;
+		// multiply by the lower-triangular Toeplitz matrix built from (1, -u)
+		std::vector<Element> cNew;
+		for (size_t i = 0; i < m + 1; i++)
+			cNew.push_back(allocZero());
+#pragma omp parallel for
+		for (size_t i = 0; i < m + 1; i++) {
+			Element sum(allocZero());
+			sum += u[i];
+			for (size_t j = 0; j < i; j++)
+				sum += u[i-j-1] * c[j];
+			if (i < m)
+				cNew[i] = c[i] - sum;
 			else
-				*determinant = *determinant - (data[0][j1]) * tempDeterminant;
+				cNew[i] = -sum;
+		}
+		c = std::move(cNew);
+	}
+
+	return c;
+}
 
-			//if (j1 % 2 == 0)
-			//	determinant = determinant + (*data[0][j1]) * result.Determinant();
-			//else
-			//	determinant = determinant - (*data[0][j1]) * result.Determinant();
+// Division-free determinant: det(A) = (-1)^d c[d-1]
+template<class Element>
+static void DeterminantImpl(const Matrix<Element>& m, Element *determinant, std::false_type) {
+	std::vector<Element> c = CharPolyBerkowitz(m.GetData(), m.GetAllocator());
+	*determinant = std::move(c.back());
+	if (m.GetRows() % 2 == 1)
+		*determinant = -(*determinant);
+}
 
+// Fraction-free Gaussian elimination (Bareiss); every division is exact for
+// integers, and all intermediate values are minors of the input matrix.
+// Complexity is O(d^3)
+template<class Element>
+static void DeterminantImpl(const Matrix<Element>& m, Element *determinant, std::true_type) {
+	std::vector<std::vector<Element>> a(m.GetData());
+	size_t n = a.size();
+	Element prev(1);
+	bool negate = false;
+
+	for (size_t k = 0; k < n; k++) {
+		size_t pivot = k;
+		for (size_t i = k + 1; i < n; i++)
+			if (std::abs(a[i][k]) > std::abs(a[pivot][k]))
+				pivot = i;
+		if (a[pivot][k] == Element(0)) {
+			*determinant = Element(0);
+			return;
 		}
+		if (pivot != k) {
+			std::swap(a[pivot], a[k]);
+			negate = !negate;
+		}
+
+#pragma omp parallel for
+		for (size_t i = k + 1; i < n; i++)
+			for (size_t j = k + 1; j < n; j++)
+				a[i][j] = (a[k][k] * a[i][j] - a[i][k] * a[k][j]) / prev;
+
+		prev = a[k][k];
 	}
-	//return determinant;
-	return;
+
+	*determinant = negate ? -a[n-1][n-1] : a[n-1][n-1];
 }
 
-// The cofactor matrix is the matrix of determinants of the minors A_{ij} multiplied by -1^{i+j}
-// The determinant subroutine is used
+// Division-free adjugate from the Cayley-Hamilton theorem:
+// adj(A) = (-1)^{d-1} (A^{d-1} + c[0] A^{d-2} + ... + c[d-2] I),
+// evaluated by Horner's rule with d-2 matrix products
 template<class Element>
-Matrix<Element> Matrix<Element>::CofactorMatrix() const {
-	
-	if (rows != cols)
-		throw invalid_argument("Supported only for square matrix");
-
-	size_t ii, jj, iNew, jNew;
+static void AdjugateImpl(const Matrix<Element>& m, Matrix<Element> *adj, Element *determinant, std::false_type) {
+	size_t n = m.GetRows();
+	if (n < 2)
+		throw invalid_argument("Dimension should be at least two");
+
+	std::vector<Element> c = CharPolyBerkowitz(m.GetData(), m.GetAllocator());
+
+	Matrix<Element> b(m);
+	for (size_t i = 0; i < n; i++)
+		b(i, i) += c[0];
+	for (size_t k = 1; k + 1 < n; k++) {
+		b = m.Mult(b);
+		for (size_t i = 0; i < n; i++)
+			b(i, i) += c[k];
+	}
 
-	size_t n = rows;
+	if (n % 2 == 0) {
+		for (size_t i = 0; i < n; i++)
+			for (size_t j = 0; j < n; j++)
+				b(i, j) = -b(i, j);
+	}
+	*adj = std::move(b);
 
-	Matrix<Element> result(allocZero, rows, cols);
+	*determinant = std::move(c.back());
+	if (n % 2 == 1)
+		*determinant = -(*determinant);
+}
 
-	for (size_t j = 0; j<n; j++) {
+// Fraction-free Gauss-Jordan elimination on [A | I]. It ends with
+// [det(PA) I | det(PA) (PA)^{-1} P], where P is the row permutation, so the
+// right half is the adjugate up to the sign of P. Complexity is O(d^3).
+// Singular matrices fall back to the division-free algorithm.
+template<class Element>
+static void AdjugateImpl(const Matrix<Element>& m, Matrix<Element> *adj, Element *determinant, std::true_type) {
+	size_t n = m.GetRows();
+	if (n == 1) {
+		(*adj)(0, 0) = Element(1);
+		*determinant = m(0, 0);
+		return;
+	}
 
-		for (size_t i = 0; i<n; i++) {
+	std::vector<std::vector<Element>> a(n, std::vector<Element>(2*n, Element(0)));
+	for (size_t i = 0; i < n; i++) {
+		for (size_t j = 0; j < n; j++)
+			a[i][j] = m(i, j);
+		a[i][n+i] = Element(1);
+	}
 
-			Matrix<Element> c(allocZero, rows - 1, cols - 1);
+	Element prev(1);
+	bool negate = false;
+
+	for (size_t k = 0; k < n; k++) {
+		size_t pivot = k;
+		for (size_t i = k + 1; i < n; i++)
+			if (std::abs(a[i][k]) > std::abs(a[pivot][k]))
+				pivot = i;
+		if (a[pivot][k] == Element(0)) {
+			AdjugateImpl(m, adj, determinant, std::false_type());
+			return;
+		}
+		if (pivot != k) {
+			std::swap(a[pivot], a[k]);
+			negate = !negate;
+		}
 
-			/* Form the adjoint a_ij */
-			iNew = 0;
-			for (ii = 0; ii<n; ii++) {
-				if (ii == i)
+#pragma omp parallel for
+		for (size_t i = 0; i < n; i++) {
+			if (i == k)
+				continue;
+			Element factor = a[i][k];
+			for (size_t j = 0; j < 2*n; j++) {
+				if (j == k)
 					continue;
-				jNew = 0;
-				for (jj = 0; jj<n; jj++) {
-					if (jj == j)
-						continue;
-					c.data[iNew][jNew] = data[ii][jj];
-					jNew++;
-				}
-				iNew++;
+				a[i][j] = (a[k][k] * a[i][j] - factor * a[k][j]) / prev;
 			}
-
-			/* Calculate the determinant */
-			Element determinant( allocZero() );
-			c.Determinant(&determinant);
-			Element negDeterminant = -determinant;
-
-			/* Fill in the elements of the cofactor */
-			if ((i + j) % 2 == 0)
-				result.data[i][j] = determinant;
-			else
-				result.data[i][j] = negDeterminant;
+			a[i][k] = Element(0);
 		}
+
+		prev = a[k][k];
 	}
 
+	for (size_t i = 0; i < n; i++)
+		for (size_t j = 0; j < n; j++)
+			(*adj)(i, j) = negate ? -a[i][n+j] : a[i][n+j];
+
+	*determinant = negate ? -prev : prev;
+}
+
+// YSP The signature of this method needs to be changed in the future
+// Signed integral and floating-point types use fraction-free Gaussian
+// elimination, O(d^3); everything else uses the Berkowitz algorithm, O(d^4).
+// Both replace the earlier Laplace expansion, which was O(d!).
+template<class Element>
+void Matrix<Element>::Determinant(Element *determinant) const {
+	if (rows != cols) 
+		throw invalid_argument("Supported only for square matrix");
+	if (rows < 1)
+		throw invalid_argument("Dimension should be at least one");
+	else if (rows == 1)
+		*determinant = data[0][0];
+	else if (rows == 2)
+		*determinant = data[0][0] * (data[1][1]) - data[1][0] * (data[0][1]);
+	else
+		DeterminantImpl(*this, determinant, std::integral_constant<bool, std::is_signed<Element>::value>());
+	return;
+}
+
+template<class Element>
+Matrix<Element> Matrix<Element>::Adjugate(Element *determinant) const {
+	if (rows != cols)
+		throw invalid_argument("Supported only for square matrix");
+	if (rows < 1)
+		throw invalid_argument("Dimension should be at least one");
+
+	Matrix<Element> result(allocZero, rows, cols);
+	Element det(allocZero());
+	AdjugateImpl(*this, &result, &det, std::integral_constant<bool, std::is_signed<Element>::value>());
+
+	// move, as copy assignment of some element types (e.g., ciphertexts) requires
+	// the destination to be allocated already
+	if (determinant != nullptr)
+		*determinant = std::move(det);
 	return result;
+}
 
+// The cofactor matrix is the matrix of determinants of the minors A_{ij} multiplied by -1^{i+j},
+// i.e., the transpose of the adjugate
+template<class Element>
+Matrix<Element> Matrix<Element>::CofactorMatrix() const {
+	return Adjugate().Transpose();
 }
 
 //  add rows to bottom of the matrix
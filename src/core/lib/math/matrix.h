@@ -501,13 +501,27 @@ public:
 
 	// YSP The signature of this method needs to be changed in the future
 	/**
-	 * Matrix determinant - found using Laplace formula with complexity O(d!), where d is the dimension
+	 * Matrix determinant. For signed integral and floating-point elements it is found
+	 * using fraction-free Gaussian elimination (Bareiss) with complexity O(d^3); for all
+	 * other elements (ring elements, ciphertexts) the division-free Berkowitz algorithm
+	 * is used, with complexity O(d^4), where d is the dimension
 	 *
 	 * @param *result where the result is stored
 	 */
 	void Determinant(Element *result) const;
 	//Element Determinant() const;
 
+	/**
+	 * Adjugate matrix - the transpose of the cofactor matrix, so that A * adj(A) = det(A) * I.
+	 * Uses fraction-free Gauss-Jordan elimination in O(d^3) when exact division is available
+	 * and the matrix is nonsingular; otherwise the Berkowitz characteristic polynomial
+	 * and the Cayley-Hamilton theorem are used, which needs only additions and multiplications
+	 *
+	 * @param *determinant if not null, the determinant is also stored here
+	 * @return the adjugate matrix for the given matrix
+	 */
+	Matrix<Element> Adjugate(Element *determinant = nullptr) const;
+
 	/**
 	 * Cofactor matrix - the matrix of determinants of the minors A_{ij} multiplied by -1^{i+j}
 	 *
@@ -33,6 +33,7 @@
 #include "../native_int/binvect.h"
 #include "../nbtheory.h"
 #include "../../utils/debug.h"
+#include "../../utils/palisadebase64.h"
 
 
 namespace native_int {
@@ -378,24 +379,7 @@ template<class IntegerType>
 NativeVector<IntegerType> NativeVector<IntegerType>::ModMul(const IntegerType &b) const{
 
 	NativeVector ans(*this);
-
-	IntegerType modulus = this->m_modulus;
-	IntegerType bLocal = b;
-
-	if (modulus.GetMSB() <= MAX_MODULUS_SIZE)
-	{
-		if (bLocal > modulus)
-			bLocal.ModEq(modulus);
-		IntegerType mu = modulus.ComputeMu();
-		for(usint i=0;i<this->m_data.size();i++)
-			ans.m_data[i].ModMulFastEqOptimized(bLocal,modulus,mu);
-	}
-	else
-	{
-		for(usint i=0;i<this->m_data.size();i++)
-			ans.m_data[i].ModMulFastEq(bLocal,modulus);
-	}
-
+	ans.ModMulEq(b);
 	return ans;
 
 }
@@ -403,22 +387,14 @@ NativeVector<IntegerType> NativeVector<IntegerType>::ModMul(const IntegerType &b
 template<class IntegerType>
 const NativeVector<IntegerType>& NativeVector<IntegerType>::ModMulEq(const IntegerType &b) {
 
-	IntegerType modulus = this->m_modulus;
 	IntegerType bLocal = b;
+	if (bLocal >= m_modulus)
+		bLocal.ModEq(m_modulus);
 
-	if (modulus.GetMSB() <= MAX_MODULUS_SIZE)
-	{
-		if (bLocal > modulus)
-			bLocal.ModEq(modulus);
-		IntegerType mu = modulus.ComputeMu();
-		for(usint i=0;i<this->m_data.size();i++)
-			this->m_data[i].ModMulFastEqOptimized(bLocal,modulus,mu);
-	}
-	else
-	{
-		for(usint i=0;i<this->m_data.size();i++)
-			this->m_data[i].ModMulFastEq(bLocal,modulus);
-	}
+	// the kernel for the class of the modulus is selected once for the whole vector
+	ModMulParams params(m_modulus);
+	NativeInt bPrecon = params.cls == MODULUS_64 ? 0 : bLocal.PrepModMulPreconOptimized(m_modulus).ConvertToInt();
+	GetModMulScalarFunc(params.cls)(this->m_data.data(), bLocal.ConvertToInt(), bPrecon, this->m_data.size(), params);
 
 	return *this;
 }
@@ -563,19 +539,8 @@ NativeVector<IntegerType> NativeVector<IntegerType>::ModMul(const NativeVector &
 	}
 
 	NativeVector ans(*this);
-	IntegerType modulus = this->m_modulus;
-
-	if (modulus.GetMSB() <= MAX_MODULUS_SIZE)
-	{
-		IntegerType mu = modulus.ComputeMu();
-		for(usint i=0;i<this->m_data.size();i++)
-			ans.m_data[i].ModMulFastEqOptimized(b[i],modulus,mu);
-	}
-	else
-	{
-		for(usint i=0;i<this->m_data.size();i++)
-			ans.m_data[i].ModMulFastEq(b[i],modulus);
-	}
+	ModMulParams params(m_modulus);
+	GetModMulVectorFunc(params.cls)(ans.m_data.data(), b.m_data.data(), ans.m_data.size(), params);
 
 	return ans;
 
@@ -588,19 +553,8 @@ const NativeVector<IntegerType>& NativeVector<IntegerType>::ModMulEq(const Nativ
         throw std::logic_error("ModMul called on NativeVector's with different parameters.");
 	}
 
-	IntegerType modulus = this->m_modulus;
-
-	if (modulus.GetMSB() <= MAX_MODULUS_SIZE)
-	{
-		IntegerType mu = modulus.ComputeMu();
-		for(usint i=0;i<this->m_data.size();i++)
-			this->m_data[i].ModMulFastEqOptimized(b[i],modulus,mu);
-	}
-	else
-	{
-		for(usint i=0;i<this->m_data.size();i++)
-			this->m_data[i].ModMulFastEq(b[i],modulus);
-	}
+	ModMulParams params(m_modulus);
+	GetModMulVectorFunc(params.cls)(this->m_data.data(), b.m_data.data(), this->m_data.size(), params);
 
 	return *this;
 }
@@ -634,6 +588,142 @@ NativeVector<IntegerType> NativeVector<IntegerType>::GetDigitAtIndexForBase(usin
 	return ans;
 }
 
+template<class IntegerType>
+uint8_t NativeVector<IntegerType>::PackedWidth(uint32_t droppedBits, uint8_t *dropped) const {
+	*dropped = 0;
+	uint64_t q = m_modulus.ConvertToInt();
+	if (q < 2)
+		return 0;
+
+	usint bits = lbcrypto::GetMSB64(q - 1);
+	if (bits == 0)
+		bits = 1;
+	// keep at least one bit of every entry
+	usint drop = std::min<usint>(droppedBits, bits - 1);
+	if (drop > 0)
+		bits = lbcrypto::GetMSB64(((q - 1) >> drop) + (((q - 1) >> (drop - 1)) & 1));
+	if (bits + drop >= 64)
+		return 0;
+
+	*dropped = (uint8_t)drop;
+	return (uint8_t)bits;
+}
+
+template<class IntegerType>
+std::vector<uint64_t> NativeVector<IntegerType>::PackBits(usint width, usint dropped) const {
+	size_t size = m_data.size();
+	std::vector<uint64_t> words((size*width + 63) / 64, 0);
+	size_t bit = 0;
+	for (size_t i = 0; i < size; i++, bit += width) {
+		uint64_t v = m_data[i].ConvertToInt();
+		// round to nearest
+		if (dropped > 0)
+			v = (v >> dropped) + ((v >> (dropped - 1)) & 1);
+		size_t w = bit >> 6;
+		usint offset = bit & 63;
+		words[w] |= v << offset;
+		if (offset + width > 64)
+			words[w + 1] |= v >> (64 - offset);
+	}
+	return words;
+}
+
+template<class IntegerType>
+void NativeVector<IntegerType>::UnpackBits(IntegerType *data, size_t size, const IntegerType& modulus, usint width, usint dropped) {
+	// the packer never uses a full word per field
+	if (width == 0 || width >= 64 || width + dropped > 64)
+		PALISADE_THROW(lbcrypto::deserialize_error, "invalid packed width in serialized NativeVector");
+	uint64_t mask = ((uint64_t)1 << width) - 1;
+	uint64_t q = modulus.ConvertToInt();
+	// field i ends at or before word i, so going backwards only overwrites
+	// words whose fields were already read
+	for (size_t i = size; i-- > 0; ) {
+		size_t bit = i*width;
+		size_t w = bit >> 6;
+		usint offset = bit & 63;
+		uint64_t v = data[w].ConvertToInt() >> offset;
+		if (offset + width > 64)
+			v |= data[w + 1].ConvertToInt() << (64 - offset);
+		v &= mask;
+		if (dropped > 0) {
+			v <<= dropped;
+			// rounding up the largest entries gives q or a bit more
+			if (v >= q)
+				v -= q;
+		}
+		if (v >= q)
+			PALISADE_THROW(lbcrypto::deserialize_error, "entry " + std::to_string(i) + " of serialized NativeVector is not reduced modulo "
+					+ std::to_string(q));
+		data[i] = IntegerType(v);
+	}
+}
+
+// blob header: length and modulus as 64-bit words, then the packed width and dropped bits
+static const size_t BlobHeaderSize = 18;
+
+static inline void PutLE64(uint8_t *p, uint64_t v) {
+	for (usint i = 0; i < 8; i++)
+		p[i] = (uint8_t)(v >> (8*i));
+}
+
+static inline uint64_t GetLE64(const uint8_t *p) {
+	uint64_t v = 0;
+	for (usint i = 0; i < 8; i++)
+		v |= (uint64_t)p[i] << (8*i);
+	return v;
+}
+
+template<class IntegerType>
+std::string NativeVector<IntegerType>::EncodeBlob(uint32_t droppedBits) const {
+	uint8_t dropped = 0;
+	uint8_t width = PackedWidth(droppedBits, &dropped);
+	size_t size = m_data.size();
+
+	std::vector<uint64_t> words;
+	if (width != 0)
+		words = PackBits(width, dropped);
+	size_t nwords = width == 0 ? size : words.size();
+
+	std::vector<uint8_t> bytes(BlobHeaderSize + nwords*8);
+	PutLE64(&bytes[0], size);
+	PutLE64(&bytes[8], m_modulus.ConvertToInt());
+	bytes[16] = width;
+	bytes[17] = dropped;
+	uint8_t *p = &bytes[BlobHeaderSize];
+	for (size_t i = 0; i < nwords; i++, p += 8)
+		PutLE64(p, width == 0 ? m_data[i].ConvertToInt() : words[i]);
+
+	return lbcrypto::Base64Encode(bytes.data(), bytes.size());
+}
+
+template<class IntegerType>
+void NativeVector<IntegerType>::DecodeBlob(const std::string& blob) {
+	std::vector<uint8_t> bytes;
+	if (!lbcrypto::Base64Decode(blob, &bytes) || bytes.size() < BlobHeaderSize || (bytes.size() - BlobHeaderSize) % 8 != 0)
+		PALISADE_THROW(lbcrypto::deserialize_error, "invalid blob in serialized NativeVector");
+
+	uint64_t size = GetLE64(&bytes[0]);
+	uint64_t modulus = GetLE64(&bytes[8]);
+	uint8_t width = bytes[16];
+	uint8_t dropped = bytes[17];
+	if (width >= 64 || width + dropped > 64)
+		PALISADE_THROW(lbcrypto::deserialize_error, "invalid packed width in serialized NativeVector");
+
+	// every entry takes at least one bit
+	uint64_t nwords = (bytes.size() - BlobHeaderSize) / 8;
+	if (size > nwords*64 || nwords != (width == 0 ? size : (size*width + 63) / 64))
+		PALISADE_THROW(lbcrypto::deserialize_error, "blob in serialized NativeVector has the wrong length");
+
+	m_modulus = modulus;
+	m_data.resize(size);
+	// packed words are read into the front of the vector and unpacked in place
+	const uint8_t *p = &bytes[BlobHeaderSize];
+	for (size_t i = 0; i < nwords; i++, p += 8)
+		m_data[i] = IntegerType(GetLE64(p));
+	if (size > 0 && width != 0)
+		UnpackBits(width, dropped);
+}
+
 template class NativeVector<NativeInteger>;
  
 } // namespace lbcrypto ends
@@ -32,9 +32,11 @@
 
 #include <iostream>
 #include <initializer_list>
+#include <cstring>
 
 #include "../interface.h"
 #include "../../utils/serializable.h"
+#include "../../utils/binarypacking.h"
 #include "../../utils/inttypes.h"
 
 
@@ -472,7 +474,8 @@ class NativeVector : public lbcrypto::BigVectorInterface<NativeVector<IntegerTyp
 	//component-wise multiplication
 
 	/**
-	 * Vector modulus multiplication.
+	 * Vector modulus multiplication. The kernel is specialized by the size of the modulus
+	 * (see modmul.h).
 	 *
 	 * @param &b is the vector to multiply.
 	 * @return is the result of the modulus multiplication operation.
@@ -480,7 +483,8 @@ class NativeVector : public lbcrypto::BigVectorInterface<NativeVector<IntegerTyp
 	NativeVector ModMul(const NativeVector &b) const;
 
 	/**
-	 * Vector modulus multiplication.
+	 * Vector modulus multiplication. The kernel is specialized by the size of the modulus
+	 * (see modmul.h).
 	 *
 	 * @param &b is the vector to multiply.
 	 * @return is the result of the modulus multiplication operation.
@@ -529,10 +533,25 @@ class NativeVector : public lbcrypto::BigVectorInterface<NativeVector<IntegerTyp
 	typename std::enable_if<!cereal::traits::is_text_archive<Archive>::value,void>::type
 	save( Archive & ar, std::uint32_t const version ) const
 	{
+		// width 0 means full 64-bit words
+		uint8_t width = 0;
+		uint8_t dropped = 0;
+		const lbcrypto::BinaryPacking &packing = lbcrypto::BinaryPacking::Current();
+		if( packing.compact )
+			width = PackedWidth(packing.lossy ? packing.droppedBits : 0, &dropped);
+
 		size_t size = m_data.size();
 		ar( size );
-		if( size > 0 )
-			ar( ::cereal::binary_data(m_data.data(), size*sizeof(IntegerType)) );
+		ar( width );
+		ar( dropped );
+		if( size > 0 ) {
+			if( width == 0 )
+				ar( ::cereal::binary_data(m_data.data(), size*sizeof(IntegerType)) );
+			else {
+				std::vector<uint64_t> words = PackBits(width, dropped);
+				ar( ::cereal::binary_data(words.data(), words.size()*sizeof(uint64_t)) );
+			}
+		}
 		ar( m_modulus );
 	}
 
@@ -540,6 +559,11 @@ class NativeVector : public lbcrypto::BigVectorInterface<NativeVector<IntegerTyp
 	typename std::enable_if<cereal::traits::is_text_archive<Archive>::value,void>::type
 	save( Archive & ar, std::uint32_t const version ) const
 	{
+		const lbcrypto::BinaryPacking &packing = lbcrypto::BinaryPacking::Current();
+		if( packing.textBlobs ) {
+			ar( ::cereal::make_nvp("b",EncodeBlob(packing.lossy ? packing.droppedBits : 0)) );
+			return;
+		}
 		ar( ::cereal::make_nvp("v",m_data) );
 		ar( ::cereal::make_nvp("m",m_modulus.ConvertToInt()) );
 	}
@@ -553,15 +577,24 @@ class NativeVector : public lbcrypto::BigVectorInterface<NativeVector<IntegerTyp
 		}
 		size_t size;
 		ar( size );
+		uint8_t width = 0;
+		uint8_t dropped = 0;
+		if( version > 1 ) {
+			ar( width );
+			ar( dropped );
+			if( width >= 64 || width + dropped > 64 ) {
+				PALISADE_THROW(lbcrypto::deserialize_error, "invalid packed width in serialized NativeVector");
+			}
+		}
 		m_data.resize(size);
+		// packed words are read into the front of the vector and unpacked in place
 		if( size > 0 ) {
-			IntegerType *data = (IntegerType *)malloc( size*sizeof(IntegerType) );
-			ar( ::cereal::binary_data(data, size*sizeof(IntegerType)) );
-			for( size_t i = 0; i<size; i++ )
-				m_data[i] = data[i];
-			free( data );
+			size_t bytes = width == 0 ? size*sizeof(IntegerType) : ((size*width + 63) / 64)*sizeof(uint64_t);
+			ar( ::cereal::binary_data(m_data.data(), bytes) );
 		}
 		ar( m_modulus );
+		if( size > 0 && width != 0 )
+			UnpackBits(width, dropped);
 	}
 
 	template <class Archive>
@@ -571,6 +604,14 @@ class NativeVector : public lbcrypto::BigVectorInterface<NativeVector<IntegerTyp
 		if( version > SerializedVersion() ) {
 			PALISADE_THROW(lbcrypto::deserialize_error, "serialized object version " + std::to_string(version) + " is from a later version of the library");
 		}
+		// a vector written as a blob has a single member, "b"
+		const char *name = ar.getNodeName();
+		if( name != nullptr && std::strcmp(name, "b") == 0 ) {
+			std::string blob;
+			ar( ::cereal::make_nvp("b",blob) );
+			DecodeBlob(blob);
+			return;
+		}
 		ar( ::cereal::make_nvp("v",m_data) );
 		uint64_t m;
 		ar( ::cereal::make_nvp("m",m) );
@@ -578,9 +619,52 @@ class NativeVector : public lbcrypto::BigVectorInterface<NativeVector<IntegerTyp
 	}
 
 	std::string SerializedObjectName() const { return "NativeVector"; }
-	static uint32_t	SerializedVersion() { return 1; }
+	static uint32_t	SerializedVersion() { return 2; }
+
+	/**
+	 * Packs the entries in width-bit fields of 64-bit words, low-order bits first, after rounding away
+	 * the low-order dropped bits of every entry
+	 * @param width bit width of a field; below 64
+	 * @param dropped number of low-order bits rounded away
+	 * @return the packed words
+	 */
+	std::vector<uint64_t> PackBits(usint width, usint dropped) const;
+
+	/**
+	 * Expands the fields written by PackBits, stored at the front of m_data, in place
+	 * @param width bit width of a field
+	 * @param dropped number of low-order bits that were rounded away
+	 * @throw deserialize_error if the width is not below 64 bits or an entry is not reduced modulo the modulus
+	 */
+	void UnpackBits(usint width, usint dropped) {
+		UnpackBits(m_data.data(), m_data.size(), m_modulus, width, dropped);
+	}
+
+	/**
+	 * Expands the fields written by PackBits, stored at the front of an array of entries, in place
+	 * @param data the entries, whose first words hold the packed fields
+	 * @param size number of entries
+	 * @param modulus modulus the entries are reduced by
+	 * @param width bit width of a field
+	 * @param dropped number of low-order bits that were rounded away
+	 * @throw deserialize_error if the width is not below 64 bits or an entry is not reduced modulo the modulus
+	 */
+	static void UnpackBits(IntegerType *data, size_t size, const IntegerType& modulus, usint width, usint dropped);
 
  private:
+	/**
+	 * Bit width of the entries in the compact format, or 0 when packing saves nothing
+	 * @param droppedBits requested number of low-order bits to round away
+	 * @param dropped number of bits actually dropped - output
+	 */
+	uint8_t PackedWidth(uint32_t droppedBits, uint8_t *dropped) const;
+
+	// base64 text of the length, modulus, packing and packed entries, in little-endian order
+	std::string EncodeBlob(uint32_t droppedBits) const;
+
+	// reads a vector from the text written by EncodeBlob
+	void DecodeBlob(const std::string& blob);
+
 	//m_data is a pointer to the vector
 
 #if BLOCK_VECTOR_ALLOCATION != 1
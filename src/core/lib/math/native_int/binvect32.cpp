@@ -0,0 +1,142 @@
+/*
+ * @file binvect32.cpp This file contains the vector of residues stored in 32-bit words.
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or other
+ * materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "../backend.h"
+#include "../native_int/binvect32.h"
+#include "../../utils/exception.h"
+
+namespace native_int {
+
+NativeVector32::NativeVector32(usint length, const NativeInteger& modulus)
+	: m_data(length, 0), m_modulus(modulus) {
+	if (modulus.GetMSB() > MaxModulusSize)
+		PALISADE_THROW(lbcrypto::math_error, "NativeVector32 supports moduli of at most "
+				+ std::to_string(MaxModulusSize) + " bits; the modulus has " + std::to_string(modulus.GetMSB()));
+}
+
+NativeVector32::NativeVector32(const NativeVector<NativeInteger>& vec)
+	: NativeVector32(vec.GetLength(), vec.GetModulus()) {
+	uint64_t q = m_modulus.ConvertToInt();
+	for (usint i = 0; i < m_data.size(); i++) {
+		uint64_t x = vec[i].ConvertToInt();
+		m_data[i] = (uint32_t)(x < q ? x : x % q);
+	}
+}
+
+NativeVector<NativeInteger> NativeVector32::ToNativeVector() const {
+	NativeVector<NativeInteger> ans(m_data.size(), m_modulus);
+	for (usint i = 0; i < m_data.size(); i++)
+		ans[i] = (uint64_t)m_data[i];
+	return ans;
+}
+
+void NativeVector32::CheckParameters(const NativeVector32& b, const std::string& op) const {
+	if (m_data.size() != b.m_data.size() || m_modulus != b.m_modulus)
+		PALISADE_THROW(lbcrypto::math_error, op + " called on NativeVector32's with different parameters.");
+}
+
+NativeVector32 NativeVector32::ModAdd(const NativeVector32& b) const {
+	NativeVector32 ans(*this);
+	ans.ModAddEq(b);
+	return ans;
+}
+
+const NativeVector32& NativeVector32::ModAddEq(const NativeVector32& b) {
+	CheckParameters(b, "ModAddEq");
+	// the sum of two residues is less than 2^32
+	uint32_t q = m_modulus.ConvertToInt();
+	uint32_t* a = m_data.data();
+	const uint32_t* y = b.m_data.data();
+	for (size_t i = 0; i < m_data.size(); i++) {
+		uint32_t r = a[i] + y[i];
+		a[i] = r >= q ? r - q : r;
+	}
+	return *this;
+}
+
+NativeVector32 NativeVector32::ModSub(const NativeVector32& b) const {
+	NativeVector32 ans(*this);
+	ans.ModSubEq(b);
+	return ans;
+}
+
+const NativeVector32& NativeVector32::ModSubEq(const NativeVector32& b) {
+	CheckParameters(b, "ModSubEq");
+	uint32_t q = m_modulus.ConvertToInt();
+	uint32_t* a = m_data.data();
+	const uint32_t* y = b.m_data.data();
+	for (size_t i = 0; i < m_data.size(); i++)
+		a[i] = a[i] >= y[i] ? a[i] - y[i] : a[i] + (q - y[i]);
+	return *this;
+}
+
+NativeVector32 NativeVector32::ModMul(const NativeVector32& b) const {
+	NativeVector32 ans(*this);
+	ans.ModMulEq(b);
+	return ans;
+}
+
+const NativeVector32& NativeVector32::ModMulEq(const NativeVector32& b) {
+	CheckParameters(b, "ModMulEq");
+	// the product of two residues fits in a word, so the kernel for moduli of at most 32 bits applies
+	ModMulParams params(m_modulus);
+	uint32_t* a = m_data.data();
+	const uint32_t* y = b.m_data.data();
+	for (size_t i = 0; i < m_data.size(); i++)
+		a[i] = (uint32_t)ModMulKernel<MODULUS_32>::Mul(a[i], y[i], params);
+	return *this;
+}
+
+NativeVector32 NativeVector32::ModMul(const NativeInteger& b) const {
+	NativeVector32 ans(*this);
+	ans.ModMulEq(b);
+	return ans;
+}
+
+const NativeVector32& NativeVector32::ModMulEq(const NativeInteger& b) {
+	// multiplication by a constant with the precomputation floor(b*2^32/q); the remainder
+	// is less than 2q, so it is computed modulo 2^32
+	uint64_t q = m_modulus.ConvertToInt();
+	uint64_t bLocal = b.ConvertToInt() % q;
+	uint64_t bPrecon = (bLocal << 32) / q;
+	uint32_t* a = m_data.data();
+	for (size_t i = 0; i < m_data.size(); i++) {
+		uint32_t r = (uint32_t)(a[i]*bLocal - (((uint64_t)a[i]*bPrecon) >> 32)*q);
+		a[i] = r >= q ? r - q : r;
+	}
+	return *this;
+}
+
+std::ostream& operator<<(std::ostream& os, const NativeVector32& ptr_obj) {
+	os << std::endl;
+	for (usint i = 0; i < ptr_obj.m_data.size(); i++)
+		os << ptr_obj.m_data[i] << std::endl;
+	os << "modulus: " << ptr_obj.m_modulus;
+	os << std::endl;
+	return os;
+}
+
+} // namespace native_int ends
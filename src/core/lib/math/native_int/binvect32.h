@@ -0,0 +1,190 @@
+/**
+ * @file binvect32.h This file contains the vector of residues stored in 32-bit words.
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or other
+ * materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/*
+ * NativeVector32 holds the residues of a tower whose modulus has at most 31 bits in
+ * 32-bit words, half the memory of a NativeVector. Products are computed in 64 bits,
+ * and sums of two residues do not overflow a word.
+ */
+
+#ifndef LBCRYPTO_MATH_NATIVE_BINVECT32_H
+#define LBCRYPTO_MATH_NATIVE_BINVECT32_H
+
+#include <iostream>
+#include <vector>
+
+#include "binvect.h"
+
+namespace native_int {
+
+/**
+ * @brief Vector of residues modulo a modulus of at most 31 bits, stored in 32-bit words
+ */
+class NativeVector32
+{
+public:
+	/**
+	 * The largest supported bit length of the modulus.
+	 */
+	static const usint MaxModulusSize = 31;
+
+	/**
+	 * Basic constructor.
+	 */
+	NativeVector32() : m_modulus(0) {}
+
+	/**
+	 * Basic constructor for specifying the length of the vector and the modulus.
+	 *
+	 * @param length is the length of the vector, in terms of the number of entries.
+	 * @param modulus is the modulus of the ring; it must have at most MaxModulusSize bits.
+	 */
+	NativeVector32(usint length, const NativeInteger& modulus);
+
+	/**
+	 * Constructor from a native vector, whose modulus must have at most MaxModulusSize bits.
+	 *
+	 * @param &vec the native vector to be converted.
+	 */
+	explicit NativeVector32(const NativeVector<NativeInteger>& vec);
+
+	/**
+	 * Converts the vector to a native vector.
+	 *
+	 * @return the native vector with the same entries and modulus.
+	 */
+	NativeVector<NativeInteger> ToNativeVector() const;
+
+	/**
+	 * Gets the length of the vector.
+	 *
+	 * @return the length of the vector.
+	 */
+	usint GetLength() const {
+		return m_data.size();
+	}
+
+	/**
+	 * Gets the modulus of the vector.
+	 *
+	 * @return the modulus.
+	 */
+	const NativeInteger& GetModulus() const {
+		return m_modulus;
+	}
+
+	uint32_t& operator[](size_t i) {
+		return m_data[i];
+	}
+
+	const uint32_t& operator[](size_t i) const {
+		return m_data[i];
+	}
+
+	bool operator==(const NativeVector32& b) const {
+		return m_modulus == b.m_modulus && m_data == b.m_data;
+	}
+
+	bool operator!=(const NativeVector32& b) const {
+		return !(*this == b);
+	}
+
+	/**
+	 * Vector modulus addition.
+	 *
+	 * @param &b is the vector to add.
+	 * @return is the result of the modulus addition operation.
+	 */
+	NativeVector32 ModAdd(const NativeVector32& b) const;
+
+	/**
+	 * Vector modulus addition, in place.
+	 *
+	 * @param &b is the vector to add.
+	 * @return is the result of the modulus addition operation.
+	 */
+	const NativeVector32& ModAddEq(const NativeVector32& b);
+
+	/**
+	 * Vector modulus subtraction.
+	 *
+	 * @param &b is the vector to subtract.
+	 * @return is the result of the modulus subtraction operation.
+	 */
+	NativeVector32 ModSub(const NativeVector32& b) const;
+
+	/**
+	 * Vector modulus subtraction, in place.
+	 *
+	 * @param &b is the vector to subtract.
+	 * @return is the result of the modulus subtraction operation.
+	 */
+	const NativeVector32& ModSubEq(const NativeVector32& b);
+
+	/**
+	 * Vector modulus multiplication.
+	 *
+	 * @param &b is the vector to multiply.
+	 * @return is the result of the modulus multiplication operation.
+	 */
+	NativeVector32 ModMul(const NativeVector32& b) const;
+
+	/**
+	 * Vector modulus multiplication, in place.
+	 *
+	 * @param &b is the vector to multiply.
+	 * @return is the result of the modulus multiplication operation.
+	 */
+	const NativeVector32& ModMulEq(const NativeVector32& b);
+
+	/**
+	 * Scalar modulus multiplication.
+	 *
+	 * @param &b is the scalar to multiply by.
+	 * @return is the result of the modulus multiplication operation.
+	 */
+	NativeVector32 ModMul(const NativeInteger& b) const;
+
+	/**
+	 * Scalar modulus multiplication, in place.
+	 *
+	 * @param &b is the scalar to multiply by.
+	 * @return is the result of the modulus multiplication operation.
+	 */
+	const NativeVector32& ModMulEq(const NativeInteger& b);
+
+	friend std::ostream& operator<<(std::ostream& os, const NativeVector32& ptr_obj);
+
+private:
+	// throws if the vectors do not have the same length and modulus
+	void CheckParameters(const NativeVector32& b, const std::string& op) const;
+
+	std::vector<uint32_t> m_data;
+	NativeInteger m_modulus;
+};
+
+} // namespace native_int ends
+
+#endif
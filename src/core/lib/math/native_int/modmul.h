@@ -0,0 +1,252 @@
+/**
+ * @file modmul.h This file contains modular multiplication kernels for native integers, specialized by the size of the modulus.
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or other
+ * materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/*
+ * The class of a modulus is determined once per vector (tower), and the kernels for that
+ * class are looked up in the function tables below. The loops inside the kernels are
+ * compiled separately for each class and carry no test on the size of the modulus.
+ */
+
+#ifndef LBCRYPTO_MATH_NATIVE_MODMUL_H
+#define LBCRYPTO_MATH_NATIVE_MODMUL_H
+
+#include "binint.h"
+
+namespace native_int {
+
+/**
+ * @brief Classes of native moduli with specialized modular multiplication
+ */
+enum ModulusClass {
+	MODULUS_32 = 0,		//!< q < 2^32: the product fits in a word
+	MODULUS_52,			//!< q < 2^52: the quotient is estimated in double precision
+	MODULUS_60,			//!< q < 2^MAX_MODULUS_SIZE: generalized Barrett reduction
+	MODULUS_64,			//!< larger moduli: double-word division
+	MODULUS_CLASSES
+};
+
+/**
+ * Returns the class of a modulus.
+ *
+ * @param &modulus the modulus.
+ * @return the class of the modulus.
+ */
+inline ModulusClass GetModulusClass(const NativeInteger& modulus) {
+	usint msb = modulus.GetMSB();
+	if (msb <= 32)
+		return MODULUS_32;
+	if (msb <= 52)
+		return MODULUS_52;
+	// the Barrett constant 2^(2n+3)/q does not fit in a word for q = 2^(n-1) with n = 60
+	NativeInt q = modulus.ConvertToInt();
+	if (msb < MAX_MODULUS_SIZE || (msb == MAX_MODULUS_SIZE && (q & (q - 1)) != 0))
+		return MODULUS_60;
+	return MODULUS_64;
+}
+
+/**
+ * @brief Constants of a modulus used by the specialized kernels
+ */
+struct ModMulParams {
+	NativeInt q;
+	NativeInt mu;		//!< floor((2^64-1)/q) for MODULUS_32, the generalized Barrett constant for MODULUS_60
+	double qInv;		//!< 1/q for MODULUS_52
+	usint n;			//!< the bit length of q
+	ModulusClass cls;
+
+	explicit ModMulParams(const NativeInteger& modulus)
+		: q(modulus.ConvertToInt()), mu(0), qInv(1.0/(double)q), n(modulus.GetMSB()), cls(GetModulusClass(modulus)) {
+		if (cls == MODULUS_32)
+			mu = ~(NativeInt)0 / q;
+		else if (cls == MODULUS_60)
+			mu = modulus.ComputeMu().ConvertToInt();
+	}
+};
+
+/**
+ * @brief Modular multiplication for one class of moduli. Both operands are less than q.
+ *
+ * Mul(a, b, params) returns a*b mod q.
+ * MulPrecon(a, b, bPrecon, q) returns a*b mod q, where bPrecon = floor(b*2^64/q) is
+ * computed by NativeInteger::PrepModMulPreconOptimized.
+ */
+template<ModulusClass C>
+struct ModMulKernel;
+
+template<>
+struct ModMulKernel<MODULUS_32> {
+	static inline NativeInt Mul(NativeInt a, NativeInt b, const ModMulParams& p) {
+		// the quotient estimated with mu is at most one too small
+		NativeInt x = a*b;
+		NativeInt r = x - NativeInteger::MultDHi(x, p.mu)*p.q;
+		return r >= p.q ? r - p.q : r;
+	}
+
+	static inline NativeInt MulPrecon(NativeInt a, NativeInt b, NativeInt bPrecon, NativeInt q) {
+		// the high word of bPrecon is floor(b*2^32/q), so the quotient needs no double-word product
+		NativeInt r = a*b - ((a*(bPrecon >> 32)) >> 32)*q;
+		return r >= q ? r - q : r;
+	}
+};
+
+template<>
+struct ModMulKernel<MODULUS_52> {
+	static inline NativeInt Mul(NativeInt a, NativeInt b, const ModMulParams& p) {
+		// the quotient is estimated to within 2, so the remainder computed modulo 2^64 lies in [-q, 3q)
+		NativeInt quot = (NativeInt)((double)a * (double)b * p.qInv);
+		SignedNativeInt r = (SignedNativeInt)(a*b - quot*p.q);
+		SignedNativeInt q = (SignedNativeInt)p.q;
+		r += (r >> 63) & q;
+		r -= r >= q ? q : 0;
+		r -= r >= q ? q : 0;
+		return (NativeInt)r;
+	}
+
+	static inline NativeInt MulPrecon(NativeInt a, NativeInt b, NativeInt bPrecon, NativeInt q) {
+		NativeInt r = a*b - NativeInteger::MultDHi(a, bPrecon)*q;
+		return r >= q ? r - q : r;
+	}
+};
+
+template<>
+struct ModMulKernel<MODULUS_60> {
+	static inline NativeInt Mul(NativeInt a, NativeInt b, const ModMulParams& p) {
+		// generalized Barrett reduction, as in NativeInteger::ModMulFastOptimized, with the
+		// remainder computed in a single word
+		typeD prod;
+		NativeInteger::MultD(a, b, prod);
+		NativeInt ql = NativeInteger::RShiftD(prod, p.n - 2);
+		NativeInt quot = (NativeInt)((DNativeInt(ql)*p.mu) >> (p.n + 5));
+		NativeInt r = prod.lo - quot*p.q;
+		return r >= p.q ? r - p.q : r;
+	}
+
+	static inline NativeInt MulPrecon(NativeInt a, NativeInt b, NativeInt bPrecon, NativeInt q) {
+		return ModMulKernel<MODULUS_52>::MulPrecon(a, b, bPrecon, q);
+	}
+};
+
+template<>
+struct ModMulKernel<MODULUS_64> {
+	static inline NativeInt Mul(NativeInt a, NativeInt b, const ModMulParams& p) {
+		return (NativeInt)((DNativeInt(a)*b) % p.q);
+	}
+
+	// no precomputation is made for these moduli
+	static inline NativeInt MulPrecon(NativeInt a, NativeInt b, NativeInt bPrecon, NativeInt q) {
+		return (NativeInt)((DNativeInt(a)*b) % q);
+	}
+};
+
+/**
+ * Element-wise modular multiplication a[i] = a[i]*b[i] mod q.
+ * Entries that are not reduced (e.g. after a change of modulus) are reduced first.
+ */
+template<ModulusClass C>
+void ModMulVectorKernel(NativeInteger* a, const NativeInteger* b, size_t size, const ModMulParams& p) {
+	for (size_t i = 0; i < size; i++) {
+		NativeInt x = a[i].ConvertToInt();
+		NativeInt y = b[i].ConvertToInt();
+		if (x >= p.q)
+			x %= p.q;
+		if (y >= p.q)
+			y %= p.q;
+		a[i] = ModMulKernel<C>::Mul(x, y, p);
+	}
+}
+
+/**
+ * Modular multiplication by a scalar a[i] = a[i]*b mod q, with b < q and bPrecon = floor(b*2^64/q).
+ * Entries that are not reduced are reduced first.
+ */
+template<ModulusClass C>
+void ModMulScalarKernel(NativeInteger* a, NativeInt b, NativeInt bPrecon, size_t size, const ModMulParams& p) {
+	for (size_t i = 0; i < size; i++) {
+		NativeInt x = a[i].ConvertToInt();
+		if (x >= p.q)
+			x %= p.q;
+		a[i] = ModMulKernel<C>::MulPrecon(x, b, bPrecon, p.q);
+	}
+}
+
+/**
+ * Butterflies of the iterative forward NTT of size n, on input already in bit-reversed order.
+ * Twiddle factor j of a stage is roots[j*ringDimensionFactor], with precomputations in precon.
+ */
+template<ModulusClass C>
+void NTTButterfliesKernel(NativeInteger* x, const NativeInteger* roots, const NativeInteger* precon,
+		usint size, usint ringDimensionFactor, NativeInt q) {
+	usint logn = lbcrypto::GetMSB64(size) - 1;
+	for (usint logm = 1; logm <= logn; logm++) {
+		usint half = 1 << (logm - 1);
+		usint stride = (1 << (1 + logn - logm)) * ringDimensionFactor;
+		for (usint j = 0; j < size; j += 2*half) {
+			for (usint i = 0; i < half; i++) {
+				NativeInt even = x[j + i].ConvertToInt();
+				NativeInt omegaFactor = ModMulKernel<C>::MulPrecon(x[j + i + half].ConvertToInt(),
+						roots[i*stride].ConvertToInt(), precon[i*stride].ConvertToInt(), q);
+				// even + omegaFactor mod q, without overflowing for q > 2^63
+				NativeInt complement = q - omegaFactor;
+				x[j + i] = even >= complement ? even - complement : even + omegaFactor;
+				x[j + i + half] = even >= omegaFactor ? even - omegaFactor : even + complement;
+			}
+		}
+	}
+}
+
+typedef void (*ModMulVectorFunc)(NativeInteger*, const NativeInteger*, size_t, const ModMulParams&);
+typedef void (*ModMulScalarFunc)(NativeInteger*, NativeInt, NativeInt, size_t, const ModMulParams&);
+typedef void (*NTTButterfliesFunc)(NativeInteger*, const NativeInteger*, const NativeInteger*, usint, usint, NativeInt);
+
+/**
+ * Function table lookup of the element-wise modular multiplication for a class of moduli.
+ */
+inline ModMulVectorFunc GetModMulVectorFunc(ModulusClass cls) {
+	static const ModMulVectorFunc table[MODULUS_CLASSES] = { ModMulVectorKernel<MODULUS_32>,
+			ModMulVectorKernel<MODULUS_52>, ModMulVectorKernel<MODULUS_60>, ModMulVectorKernel<MODULUS_64> };
+	return table[cls];
+}
+
+/**
+ * Function table lookup of the modular multiplication by a scalar for a class of moduli.
+ */
+inline ModMulScalarFunc GetModMulScalarFunc(ModulusClass cls) {
+	static const ModMulScalarFunc table[MODULUS_CLASSES] = { ModMulScalarKernel<MODULUS_32>,
+			ModMulScalarKernel<MODULUS_52>, ModMulScalarKernel<MODULUS_60>, ModMulScalarKernel<MODULUS_64> };
+	return table[cls];
+}
+
+/**
+ * Function table lookup of the NTT butterflies for a class of moduli.
+ */
+inline NTTButterfliesFunc GetNTTButterfliesFunc(ModulusClass cls) {
+	static const NTTButterfliesFunc table[MODULUS_CLASSES] = { NTTButterfliesKernel<MODULUS_32>,
+			NTTButterfliesKernel<MODULUS_52>, NTTButterfliesKernel<MODULUS_60>, NTTButterfliesKernel<MODULUS_64> };
+	return table[cls];
+}
+
+} // namespace native_int ends
+
+#endif
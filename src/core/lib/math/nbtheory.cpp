@@ -275,6 +275,9 @@ namespace lbcrypto {
 			std::string errMsg = "Please provide a primeModulus(q) and a cyclotomic number(m) satisfying the condition: (q-1)/m is an integer. The values of primeModulus = " + modulo.ToString() + " and m = " + std::to_string(m) + " do not satisfy this condition";
 			throw std::runtime_error(errMsg);
 		}
+		if (modulo.GetMSB() <= 64)
+			return IntType(RootOfUnity64(m, modulo.ConvertToInt()));
+
 		IntType result;
 		DEBUG("calling FindGenerator");
 		IntType gen = FindGenerator(modulo);
@@ -363,6 +366,24 @@ namespace lbcrypto {
 	template<typename IntType>
 	std::vector<IntType> RootsOfUnity(usint m, const std::vector<IntType> moduli) {
 		std::vector<IntType> rootsOfUnity(moduli.size());
+
+		// the 64-bit search is thread-safe; the generic one draws from the shared PRNG
+		bool native = true;
+		for (usint i = 0; i < moduli.size(); i++)
+			native = native && moduli[i].GetMSB() <= 64;
+
+		if (native) {
+			// exceptions cannot leave a parallel region, so a modulus that is not 1 mod m
+			// is reported by RootOfUnity before the parallel search
+			for (usint i = 0; i < moduli.size(); i++)
+				if ((moduli[i] - IntType(1)).Mod(IntType(m)) != IntType(0))
+					RootOfUnity(m, moduli[i]);
+#pragma omp parallel for
+			for (usint i = 0; i < moduli.size(); i++)
+				rootsOfUnity[i] = IntType(RootOfUnity64(m, moduli[i].ConvertToInt()));
+			return rootsOfUnity;
+		}
+
 		for (usint i = 0; i < moduli.size(); i++) {
 			rootsOfUnity[i] = RootOfUnity(m, moduli[i]);
 		}
@@ -404,6 +425,8 @@ namespace lbcrypto {
 			return false;
 		if (p == IntType(2) || p == IntType(3) || p == IntType(5))
 			return true;
+		if (p.GetMSB() <= 64)
+			return IsPrime64(p.ConvertToInt());
 
 		IntType d = p - IntType(1);
 		usint s = 0;
@@ -544,6 +567,12 @@ namespace lbcrypto {
 	template<typename IntType>
 	IntType NextPrime(const IntType &q, usint m) {
 
+		if (q.GetMSB() <= 64) {
+			uint64_t next = NextPrime64(q.ConvertToInt(), m);
+			if (next != 0)
+				return IntType(next);
+		}
+
 		IntType M(m);
 		IntType qOld(q), qNew(q);
 
@@ -560,6 +589,12 @@ namespace lbcrypto {
 	template<typename IntType>
 	IntType PreviousPrime(const IntType &q, usint m) {
 
+		if (q.GetMSB() <= 64) {
+			uint64_t previous = PreviousPrime64(q.ConvertToInt(), m);
+			if (previous != 0)
+				return IntType(previous);
+		}
+
 		IntType M(m);
 		IntType qNew = q - M;
 
@@ -272,6 +272,42 @@ namespace lbcrypto {
 	template<typename IntType>
 	IntType PreviousPrime(const IntType &q, usint cyclotomicOrder);
 
+	/**
+	* Deterministic Miller-Rabin primality test for 64-bit values, using Montgomery arithmetic.
+	* Used by MillerRabinPrimalityTest whenever the candidate fits in 64 bits.
+	*
+	* @param p the candidate prime to test.
+	* @return true if p is prime.
+	*/
+	bool IsPrime64(uint64_t p);
+
+	/**
+	* Finds the next prime q + k*m, k > 0. Candidates are tested in parallel batches.
+	*
+	* @param q is the number to start from (the number itself is not included)
+	* @param m is the step between candidates
+	* @return the next prime, or 0 if no prime is found below 2^64.
+	*/
+	uint64_t NextPrime64(uint64_t q, uint64_t m);
+
+	/**
+	* Finds the previous prime q - k*m, k > 0. Candidates are tested in parallel batches.
+	*
+	* @param q is the number to start from (the number itself is not included)
+	* @param m is the step between candidates
+	* @return the previous prime, or 0 if no prime is found above 1.
+	*/
+	uint64_t PreviousPrime64(uint64_t q, uint64_t m);
+
+	/**
+	* Finds the smallest primitive m-th root of unity modulo a 64-bit prime q = 1 mod m.
+	*
+	* @param m the order of the root.
+	* @param q the prime modulus.
+	* @return the smallest primitive m-th root of unity mod q.
+	*/
+	uint64_t RootOfUnity64(uint64_t m, uint64_t q);
+
 	/**
 	 * Multiplicative inverse for primitive unsigned integer data types
 	 *
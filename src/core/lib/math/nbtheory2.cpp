@@ -94,6 +94,198 @@ namespace lbcrypto {
 		return x1;
 	}
 
+	/*
+		Montgomery arithmetic modulo an odd 64-bit q, with R = 2^64. Values in the
+		Montgomery domain are kept below q.
+	*/
+	struct Montgomery64 {
+		uint64_t q;
+		uint64_t qInv;	// -q^{-1} mod 2^64
+		uint64_t one;	// R mod q
+		uint64_t r2;	// R^2 mod q
+
+		explicit Montgomery64(uint64_t modulus) : q(modulus) {
+			// Newton iteration x = x*(2 - q*x) doubles the number of correct low bits of q^{-1}
+			uint64_t x = q;
+			for (usint i = 0; i < 5; i++)
+				x *= 2 - q*x;
+			qInv = 0 - x;
+			one = (0 - q) % q;
+			r2 = (uint64_t)(((DoubleNativeInt)one * one) % q);
+		}
+
+		uint64_t Mul(uint64_t a, uint64_t b) const {
+			DoubleNativeInt t = (DoubleNativeInt)a * b;
+			uint64_t m = (uint64_t)t * qInv;
+			DoubleNativeInt u = (DoubleNativeInt)m * q;
+			// the low halves of t and u sum to 0 mod 2^64, with a carry unless both are 0
+			DoubleNativeInt r = (t >> 64) + (u >> 64) + ((uint64_t)t != 0);
+			return (uint64_t)(r >= q ? r - q : r);
+		}
+
+		uint64_t To(uint64_t a) const { return Mul(a % q, r2); }
+		uint64_t From(uint64_t a) const { return Mul(a, 1); }
+
+		uint64_t Exp(uint64_t a, uint64_t e) const {
+			uint64_t result = one;
+			while (e) {
+				if (e & 1)
+					result = Mul(result, a);
+				a = Mul(a, a);
+				e >>= 1;
+			}
+			return result;
+		}
+	};
+
+	/*
+		Deterministic Miller-Rabin test. The seven bases below, found by J. Sinclair, have no common
+		strong pseudoprime below 2^64.
+	*/
+	bool IsPrime64(uint64_t p)
+	{
+		static const uint64_t smallPrimes[] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37 };
+		static const uint64_t bases[] = { 2, 325, 9375, 28178, 450775, 9780504, 1795265022 };
+
+		if (p < 2)
+			return false;
+		for (uint64_t sp : smallPrimes) {
+			if (p == sp)
+				return true;
+			if (p % sp == 0)
+				return false;
+		}
+
+		uint64_t d = p - 1;
+		usint s = 0;
+		while ((d & 1) == 0) {
+			d >>= 1;
+			s++;
+		}
+
+		Montgomery64 mont(p);
+		uint64_t minusOne = p - mont.one;
+		for (uint64_t base : bases) {
+			uint64_t a = base % p;
+			if (a == 0)
+				continue;
+			uint64_t x = mont.Exp(mont.To(a), d);
+			if (x == mont.one || x == minusOne)
+				continue;
+			bool composite = true;
+			for (usint i = 1; i < s && composite; i++) {
+				x = mont.Mul(x, x);
+				if (x == minusOne)
+					composite = false;
+			}
+			if (composite)
+				return false;
+		}
+		return true;
+	}
+
+	// returns 0 if the candidates run past 2^64 - 1 before a prime is found
+	uint64_t NextPrime64(uint64_t q, uint64_t m)
+	{
+		// candidates are tested in parallel batches; the first prime of a batch wins
+		const usint batch = 4*omp_get_max_threads();
+		std::vector<char> prime(batch);
+		while (true) {
+			usint valid = 0;
+			while (valid < batch && (uint64_t)(valid + 1) <= (UINT64_MAX - q)/m)
+				valid++;
+#pragma omp parallel for
+			for (usint i = 0; i < valid; i++)
+				prime[i] = IsPrime64(q + (i + 1)*m);
+			for (usint i = 0; i < valid; i++)
+				if (prime[i])
+					return q + (i + 1)*m;
+			if (valid < batch)
+				return 0;
+			q += batch*m;
+		}
+	}
+
+	// returns 0 if the candidates run below 2 before a prime is found
+	uint64_t PreviousPrime64(uint64_t q, uint64_t m)
+	{
+		const usint batch = 4*omp_get_max_threads();
+		std::vector<char> prime(batch);
+		while (true) {
+			usint valid = 0;
+			while (valid < batch && q > 2 && (uint64_t)(valid + 1) <= (q - 2)/m)
+				valid++;
+#pragma omp parallel for
+			for (usint i = 0; i < valid; i++)
+				prime[i] = IsPrime64(q - (i + 1)*m);
+			for (usint i = 0; i < valid; i++)
+				if (prime[i])
+					return q - (i + 1)*m;
+			if (valid < batch)
+				return 0;
+			q -= batch*m;
+		}
+	}
+
+	/*
+		Finds the smallest primitive m-th root of unity modulo a prime q = 1 mod m. A candidate
+		r = x^((q-1)/m) has order exactly m iff r^(m/p) != 1 for every prime p dividing m, so only
+		m needs to be factored, not q-1. The smallest root is then found by walking the powers r^k
+		with k coprime to m.
+	*/
+	uint64_t RootOfUnity64(uint64_t m, uint64_t q)
+	{
+		std::vector<uint64_t> factors;
+		uint64_t rest = m;
+		for (uint64_t p = 2; p*p <= rest; p++) {
+			if (rest % p == 0) {
+				factors.push_back(p);
+				while (rest % p == 0)
+					rest /= p;
+			}
+		}
+		if (rest > 1)
+			factors.push_back(rest);
+
+		Montgomery64 mont(q);
+		uint64_t e = (q - 1)/m;
+		uint64_t root = mont.one;
+		for (uint64_t x = 2; x < q; x++) {
+			root = mont.Exp(mont.To(x), e);
+			bool primitive = true;
+			for (uint64_t p : factors) {
+				if (mont.Exp(root, m/p) == mont.one) {
+					primitive = false;
+					break;
+				}
+			}
+			if (primitive)
+				break;
+		}
+
+		// for power-of-two m only the odd powers are coprime to m
+		uint64_t stride = (factors.size() == 1 && factors[0] == 2) ? 2 : 1;
+		uint64_t step = mont.Exp(root, stride);
+		uint64_t minRoot = mont.From(root);
+		uint64_t power = root;
+		for (uint64_t k = 1 + stride; k < m; k += stride) {
+			power = mont.Mul(power, step);
+			bool coprime = true;
+			for (uint64_t p : factors) {
+				if (k % p == 0) {
+					coprime = false;
+					break;
+				}
+			}
+			if (coprime) {
+				uint64_t value = mont.From(power);
+				if (value < minRoot)
+					minRoot = value;
+			}
+		}
+		return minRoot;
+	}
+
 	uint64_t GetTotient(const uint64_t n) {
 
 		std::set<NativeInteger> factors;
@@ -434,8 +434,9 @@ void ChineseRemainderTransformFTT<VecType>::PreCompute(std::vector<IntType> &roo
 		//Precompute the Barrett mu parameter
 		IntType mu = ComputeMu<IntType>(currentMod);
 
-		if (m_rootOfUnityTableByModulus[moduliiChain[i]].GetLength() != 0 &&
-			m_rootOfUnityTableByModulus[moduliiChain[i]][0] == currentRoot)
+		// the tables start at the zeroth power, so the root itself is the second entry
+		if (m_rootOfUnityTableByModulus[moduliiChain[i]].GetLength() == CycloOrder / 2 &&
+			m_rootOfUnityTableByModulus[moduliiChain[i]][1] == currentRoot)
 			continue;
 
 		IntType x(1);
@@ -498,6 +499,18 @@ void ChineseRemainderTransformFTT<VecType>::PreCompute(std::vector<IntType> &roo
 	}
 }
 
+template<typename VecType>
+void ChineseRemainderTransformFTT<VecType>::SetPreComputed(const IntType &modulus, VecType rootOfUnityTable, VecType rootOfUnityInverseTable,
+		NativeVector preconTable, NativeVector inversePreconTable) {
+#pragma omp critical
+{
+	m_rootOfUnityTableByModulus[modulus] = std::move(rootOfUnityTable);
+	m_rootOfUnityInverseTableByModulus[modulus] = std::move(rootOfUnityInverseTable);
+	m_rootOfUnityPreconTableByModulus[modulus] = std::move(preconTable);
+	m_rootOfUnityInversePreconTableByModulus[modulus] = std::move(inversePreconTable);
+}
+}
+
 template<typename VecType>
 void ChineseRemainderTransformFTT<VecType>::Reset() {
 	m_rootOfUnityTableByModulus.clear();
@@ -47,6 +47,28 @@
 */
 namespace lbcrypto {
 
+	/**
+	* Butterflies of the iterative NTT for NativeVector, dispatched to the kernel for the class of the modulus.
+	*
+	* @param *result the bit-reversed input, overwritten by the transform.
+	* @param &rootOfUnityTable the root of unity table.
+	* @param &preconRootOfUnityTable precomputations for the root of unity table.
+	* @param ringDimensionFactor the stride into the tables.
+	*/
+	inline void NativeNTTButterflies(NativeVector& result, const NativeVector& rootOfUnityTable,
+			const NativeVector& preconRootOfUnityTable, usint ringDimensionFactor) {
+		native_int::ModulusClass cls = native_int::GetModulusClass(result.GetModulus());
+		native_int::GetNTTButterfliesFunc(cls)(&result[0], &rootOfUnityTable[0], &preconRootOfUnityTable[0],
+				result.GetLength(), ringDimensionFactor, result.GetModulus().ConvertToInt());
+	}
+
+	// lets the NativeInteger transform compile for other vector types; it is never called for them
+	template<typename VecType>
+	void NativeNTTButterflies(VecType& result, const VecType& rootOfUnityTable,
+			const NativeVector& preconRootOfUnityTable, usint ringDimensionFactor) {
+		PALISADE_THROW(math_error, "NativeNTTButterflies only works with NativeVector");
+	}
+
 	/**
 	* @brief Number Theoretic Transform implemetation
 	*/
@@ -192,10 +214,6 @@ namespace lbcrypto {
 			for (size_t i = 0; i < n; i++)
 			  (*result)[i]= element[ReverseBits(i, msb)];
 
-			IntType omegaFactor;
-			IntType butterflyPlus;
-			IntType butterflyMinus;
-
 			/*Ring dimension factor calculates the ratio between the cyclotomic order of the root of unity table
 				  that was generated originally and the cyclotomic order of the current VecType. The twiddle table
 				  for lower cyclotomic orders is smaller. This trick only works for powers of two cyclotomics.*/
@@ -203,133 +221,10 @@ namespace lbcrypto {
 
 			DEBUG("rootOfUnityTable.GetLength() " << rootOfUnityTable.GetLength());
 			DEBUG("cycloOrder " << cycloOrder);
-			//DEBUG("ringDimensionFactor " << ringDimensionFactor);
 			DEBUG("n " << n);
 
-			usint logn = log2(n);
-
-			if (modulus.GetMSB() < MAX_MODULUS_SIZE + 1)
-			{
-				for (usint logm = 1; logm <= logn; logm++)
-				{
-
-					// calculate the i indexes into the root table one time per loop
-					vector<usint> indexes(1 << (logm-1));
-					if (ringDimensionFactor == 1) 
-					{
-						for (usint i = 0; i < (usint)(1 << (logm-1)); i++) {
-							indexes[i] = (i << (1+logn-logm));
-						}
-					}
-					else
-					{
-						for (usint i = 0; i < (usint)(1 << (logm-1)); i++) {
-							indexes[i] = (i << (1+logn-logm)) * ringDimensionFactor;
-						}
-					}
-
-					for (usint j = 0; j<n; j = j + (1 << logm))
-					{
-						for (usint i = 0; i < (usint)(1 << (logm-1)); i++)
-						{
-							usint x = indexes[i];
-
-							IntType omega = rootOfUnityTable[x];
-							IntType preconOmega = preconRootOfUnityTable[x];
-
-							usint indexEven = j + i;
-							usint indexOdd = indexEven + (1 << (logm-1));
-
-							IntType oddVal = (*result)[indexOdd];
-
-							if (oddVal != IntType(0))
-							{
-								if (oddVal == IntType(1))
-									omegaFactor = omega;
-								else
-									omegaFactor = oddVal.ModMulPreconOptimized(omega,modulus,preconOmega);
-
-								butterflyPlus = (*result)[indexEven];
-								butterflyPlus += omegaFactor;
-								if (butterflyPlus >= modulus)
-									butterflyPlus -= modulus;
-
-								butterflyMinus = (*result)[indexEven];
-								if (butterflyMinus < omegaFactor)
-									butterflyMinus += modulus;
-								butterflyMinus -= omegaFactor;
-
-								(*result)[indexEven]= butterflyPlus;
-								(*result)[indexOdd]= butterflyMinus;
-
-							}
-							else
-								(*result)[indexOdd] = (*result)[indexEven];
-
-						}
-					}
-				}
-
-			}
-			else
-			{
-				for (usint logm = 1; logm <= logn; logm++)
-				{
-
-					// calculate the i indexes into the root table one time per loop
-					vector<usint> indexes(1 << (logm-1));
-					if (ringDimensionFactor == 1) 
-					{
-						for (usint i = 0; i < (usint)(1 << (logm-1)); i++) {
-							indexes[i] = (i << (1+logn-logm));
-						}
-					}
-					else
-					{
-						for (usint i = 0; i < (usint)(1 << (logm-1)); i++) {
-							indexes[i] = (i << (1+logn-logm)) * ringDimensionFactor;
-						}
-					}
-
-					for (usint j = 0; j<n; j = j + (1 << logm))
-					{
-						for (usint i = 0; i < (usint)(1 << (logm-1)); i++)
-						{
-							usint x = indexes[i];
-
-							IntType omega = rootOfUnityTable[x];
-
-							usint indexEven = j + i;
-							usint indexOdd = indexEven + (1 << (logm-1));
-							IntType oddVal = (*result)[indexOdd];
-
-							if (oddVal != IntType(0))
-							{
-								if (oddVal == IntType(1))
-									omegaFactor = omega;
-								else
-									omegaFactor = oddVal.ModMulFast(omega,modulus);
-
-								butterflyPlus = (*result)[indexEven];
-								butterflyPlus += omegaFactor;
-								if (butterflyPlus >= modulus)
-									butterflyPlus -= modulus;
-
-								butterflyMinus = (*result)[indexEven];
-								if ((*result)[indexEven] < omegaFactor)
-									butterflyMinus += modulus;
-								butterflyMinus -= omegaFactor;
-
-								(*result)[indexEven]= butterflyPlus;
-								(*result)[indexOdd]= butterflyMinus;
-
-							}
-							else
-								(*result)[indexOdd] = (*result)[indexEven];
-						}
-					}
-				}
-			}
+			// the butterflies run in a kernel specialized by the size of the modulus
+			NativeNTTButterflies(*result, rootOfUnityTable, preconRootOfUnityTable, ringDimensionFactor);
 
 		}
 		else
@@ -411,6 +306,19 @@ namespace lbcrypto {
 		*/
 		static void PreCompute(std::vector<IntType> &rootOfUnity, const usint CycloOrder, std::vector<IntType> &moduliiChain);
 
+		/**
+		* Install root of unity tables computed earlier, for instance ones read back from a
+		* PrecomputeCache file. Tables already held for the modulus are replaced.
+		*
+		* @param modulus is the modulus
+		* @param rootOfUnityTable the powers of the root of unity.
+		* @param rootOfUnityInverseTable the powers of its inverse.
+		* @param preconTable NTL-specific precomputations for rootOfUnityTable.
+		* @param inversePreconTable NTL-specific precomputations for rootOfUnityInverseTable.
+		*/
+		static void SetPreComputed(const IntType &modulus, VecType rootOfUnityTable, VecType rootOfUnityInverseTable,
+				NativeVector preconTable, NativeVector inversePreconTable);
+
 		/**
 		* Reset cached values for the transform to empty.
 		*/
@@ -0,0 +1,180 @@
+/*
+ * @file transfrm32.cpp This file contains the number theoretic transform of vectors of residues stored in 32-bit words.
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or other
+ * materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "transfrm32.h"
+#include "nbtheory.h"
+#include "../utils/utilities.h"
+
+namespace lbcrypto {
+
+std::map<ChineseRemainderTransformFTT32::TablesKey, ChineseRemainderTransformFTT32::Tables> ChineseRemainderTransformFTT32::m_tables;
+
+// a*w mod q for a, w < q < 2^31 and wPrecon = floor(w*2^32/q); the remainder before the
+// correction is less than 2q, so it is computed modulo 2^32
+static inline uint32_t ModMulPrecon32(uint32_t a, uint32_t w, uint32_t wPrecon, uint32_t q) {
+	uint32_t quot = (uint32_t)(((uint64_t)a * wPrecon) >> 32);
+	uint32_t r = a*w - quot*q;
+	return r >= q ? r - q : r;
+}
+
+// powers 1, w, ..., w^(n-1) of w modulo q, and their precomputations
+static void PowersTable32(uint64_t w, uint64_t q, usint n, std::vector<uint32_t>& table, std::vector<uint32_t>& precon) {
+	table.resize(n);
+	precon.resize(n);
+	uint64_t x = 1;
+	for (usint i = 0; i < n; i++) {
+		table[i] = (uint32_t)x;
+		precon[i] = (uint32_t)((x << 32) / q);
+		x = x * w % q;
+	}
+}
+
+// butterflies of the iterative transform of size n, on input in bit-reversed order; the twiddle
+// factors of a stage are every stride-th power of the root of unity of order 2n
+static void Butterflies32(uint32_t* x, const uint32_t* roots, const uint32_t* precon, usint n, uint32_t q) {
+	usint logn = GetMSB64(n) - 1;
+	for (usint logm = 1; logm <= logn; logm++) {
+		usint half = 1 << (logm - 1);
+		usint stride = 1 << (1 + logn - logm);
+		for (usint j = 0; j < n; j += 2*half) {
+			for (usint i = 0; i < half; i++) {
+				uint32_t even = x[j + i];
+				uint32_t omegaFactor = ModMulPrecon32(x[j + i + half], roots[i*stride], precon[i*stride], q);
+				uint32_t sum = even + omegaFactor;
+				x[j + i] = sum >= q ? sum - q : sum;
+				x[j + i + half] = even >= omegaFactor ? even - omegaFactor : even + (q - omegaFactor);
+			}
+		}
+	}
+}
+
+const ChineseRemainderTransformFTT32::Tables& ChineseRemainderTransformFTT32::GetTables(const NativeInteger& modulus,
+		const NativeInteger& rootOfUnity, usint CycloOrder) {
+	usint n = CycloOrder / 2;
+	uint64_t q = modulus.ConvertToInt();
+	TablesKey key(q, n, rootOfUnity.ConvertToInt());
+
+	// tables are only ever added, so a reference to a published entry stays valid until Reset
+	const Tables* tables = NULL;
+#pragma omp critical (ChineseRemainderTransformFTT32)
+	{
+		const auto mapSearch = m_tables.find(key);
+		if (mapSearch != m_tables.end())
+			tables = &mapSearch->second;
+		else {
+			Tables& t = m_tables[key];
+			PowersTable32(rootOfUnity.ConvertToInt(), q, n, t.roots, t.rootsPrecon);
+
+			NativeInteger rootOfUnityInverse = rootOfUnity.ModInverse(modulus);
+			PowersTable32(rootOfUnityInverse.ConvertToInt(), q, n, t.rootsInverse, t.rootsInversePrecon);
+
+			// the inverse transform ends with the multiplication by n^{-1} and the powers of the inverse root
+			uint64_t nInverse = NativeInteger(n).ModInverse(modulus).ConvertToInt();
+			t.scaledRootsInverse.resize(n);
+			t.scaledRootsInversePrecon.resize(n);
+			for (usint i = 0; i < n; i++) {
+				uint64_t x = nInverse * t.rootsInverse[i] % q;
+				t.scaledRootsInverse[i] = (uint32_t)x;
+				t.scaledRootsInversePrecon[i] = (uint32_t)((x << 32) / q);
+			}
+			tables = &t;
+		}
+	}
+	return *tables;
+}
+
+void ChineseRemainderTransformFTT32::ForwardTransform(const NativeVector32& element, const NativeInteger& rootOfUnity,
+		const usint CycloOrder, NativeVector32 *OpFFT) {
+	usint n = CycloOrder / 2;
+
+	if (OpFFT->GetLength() != n || element.GetLength() != n)
+		throw std::logic_error("Vector for ChineseRemainderTransformFTT32::ForwardTransform size must be == CyclotomicOrder/2");
+
+	if (rootOfUnity == NativeInteger(1) || rootOfUnity == NativeInteger(0)) {
+		*OpFFT = element;
+		return;
+	}
+
+	if (!IsPowerOfTwo(CycloOrder) || n < 2)
+		throw std::logic_error("CyclotomicOrder for ChineseRemainderTransformFTT32::ForwardTransform is not a power of two greater than 2");
+
+	const Tables& tables = GetTables(element.GetModulus(), rootOfUnity, CycloOrder);
+	uint32_t q = element.GetModulus().ConvertToInt();
+
+	NativeVector32 input(&element == OpFFT ? element : NativeVector32());
+	const NativeVector32& source = &element == OpFFT ? input : element;
+	if (OpFFT->GetModulus() != element.GetModulus())
+		*OpFFT = NativeVector32(n, element.GetModulus());
+
+	// the multiplication by the powers of the root of unity is merged with the bit reversal
+	usint msb = GetMSB64(n - 1);
+	for (usint i = 0; i < n; i++) {
+		usint r = ReverseBits(i, msb);
+		(*OpFFT)[i] = ModMulPrecon32(source[r], tables.roots[r], tables.rootsPrecon[r], q);
+	}
+
+	Butterflies32(&(*OpFFT)[0], tables.roots.data(), tables.rootsPrecon.data(), n, q);
+}
+
+void ChineseRemainderTransformFTT32::InverseTransform(const NativeVector32& element, const NativeInteger& rootOfUnity,
+		const usint CycloOrder, NativeVector32 *OpIFFT) {
+	usint n = CycloOrder / 2;
+
+	if (OpIFFT->GetLength() != n || element.GetLength() != n)
+		throw std::logic_error("Vector for ChineseRemainderTransformFTT32::InverseTransform size must be == CyclotomicOrder/2");
+
+	if (rootOfUnity == NativeInteger(1) || rootOfUnity == NativeInteger(0)) {
+		*OpIFFT = element;
+		return;
+	}
+
+	if (!IsPowerOfTwo(CycloOrder) || n < 2)
+		throw std::logic_error("CyclotomicOrder for ChineseRemainderTransformFTT32::InverseTransform is not a power of two greater than 2");
+
+	const Tables& tables = GetTables(element.GetModulus(), rootOfUnity, CycloOrder);
+	uint32_t q = element.GetModulus().ConvertToInt();
+
+	NativeVector32 input(&element == OpIFFT ? element : NativeVector32());
+	const NativeVector32& source = &element == OpIFFT ? input : element;
+	if (OpIFFT->GetModulus() != element.GetModulus())
+		*OpIFFT = NativeVector32(n, element.GetModulus());
+
+	usint msb = GetMSB64(n - 1);
+	for (usint i = 0; i < n; i++)
+		(*OpIFFT)[i] = source[ReverseBits(i, msb)];
+
+	Butterflies32(&(*OpIFFT)[0], tables.rootsInverse.data(), tables.rootsInversePrecon.data(), n, q);
+
+	for (usint i = 0; i < n; i++)
+		(*OpIFFT)[i] = ModMulPrecon32((*OpIFFT)[i], tables.scaledRootsInverse[i], tables.scaledRootsInversePrecon[i], q);
+}
+
+void ChineseRemainderTransformFTT32::Reset() {
+#pragma omp critical (ChineseRemainderTransformFTT32)
+	m_tables.clear();
+}
+
+} // namespace lbcrypto ends
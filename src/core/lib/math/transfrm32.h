@@ -0,0 +1,95 @@
+/**
+ * @file transfrm32.h This file contains the number theoretic transform of vectors of residues stored in 32-bit words.
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or other
+ * materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef LBCRYPTO_MATH_TRANSFRM32_H
+#define LBCRYPTO_MATH_TRANSFRM32_H
+
+#include <map>
+#include <tuple>
+#include <vector>
+
+#include "backend.h"
+
+namespace lbcrypto {
+
+	/**
+	* @brief Negacyclic transform of NativeVector32 for power-of-two cyclotomics.
+	*
+	* The transform computes the same values as ChineseRemainderTransformFTT<NativeVector>
+	* for the same root of unity, with tables of 32-bit words.
+	*/
+	class ChineseRemainderTransformFTT32
+	{
+	public:
+		/**
+		* Forward transform.
+		*
+		* @param &element is the element to perform the transform on.
+		* @param &rootOfUnity the primitive cyclotomic order-th root of unity modulo the modulus of the element.
+		* @param CycloOrder is the cyclotomic order.
+		* @param *transform is the output of the transform; its length is CycloOrder/2.
+		*/
+		static void ForwardTransform(const NativeVector32& element, const NativeInteger& rootOfUnity,
+				const usint CycloOrder, NativeVector32 *transform);
+
+		/**
+		* Inverse transform.
+		*
+		* @param &element is the element to perform the inverse transform on.
+		* @param &rootOfUnity the primitive cyclotomic order-th root of unity modulo the modulus of the element.
+		* @param CycloOrder is the cyclotomic order.
+		* @param *transform is the output of the inverse transform; its length is CycloOrder/2.
+		*/
+		static void InverseTransform(const NativeVector32& element, const NativeInteger& rootOfUnity,
+				const usint CycloOrder, NativeVector32 *transform);
+
+		/**
+		* Resets the cached tables; must not be called while a transform is running.
+		*/
+		static void Reset();
+
+	private:
+		// the powers of the root of unity and of its inverse, with their precomputations
+		// floor(w*2^32/q); the last inverse table includes the factor n^{-1}
+		struct Tables {
+			std::vector<uint32_t> roots;
+			std::vector<uint32_t> rootsPrecon;
+			std::vector<uint32_t> rootsInverse;
+			std::vector<uint32_t> rootsInversePrecon;
+			std::vector<uint32_t> scaledRootsInverse;
+			std::vector<uint32_t> scaledRootsInversePrecon;
+		};
+
+		static const Tables& GetTables(const NativeInteger& modulus, const NativeInteger& rootOfUnity, usint CycloOrder);
+
+		// tables by modulus, ring dimension and root of unity; entries are never replaced
+		typedef std::tuple<uint64_t, usint, uint64_t> TablesKey;
+		static std::map<TablesKey, Tables> m_tables;
+	};
+
+} // namespace lbcrypto ends
+
+#endif
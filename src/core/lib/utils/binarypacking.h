@@ -0,0 +1,71 @@
+/**
+ * @file binarypacking.h Packing options of the compact binary serialization.
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or other
+ * materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */ 
+
+#ifndef LBCRYPTO_BINARYPACKING_H
+#define LBCRYPTO_BINARYPACKING_H
+
+#include <cstdint>
+
+namespace lbcrypto {
+
+/**
+ * Packing requested for the archive being written on this thread. The COMPACT
+ * and JSONCOMPACT serializations set it up; the objects that can be packed read it.
+ */
+struct BinaryPacking {
+	// pack vectors to the bit length of their modulus
+	bool compact = false;
+	// low-order bits that may be dropped where lossy is set
+	uint32_t droppedBits = 0;
+	// set while writing an element that tolerates dropped bits
+	bool lossy = false;
+	// write vectors in text archives as base64 blobs of their packed binary form
+	bool textBlobs = false;
+
+	static BinaryPacking& Current() {
+		static thread_local BinaryPacking packing;
+		return packing;
+	}
+};
+
+/**
+ * Replaces the packing of this thread for the lifetime of the scope
+ */
+class BinaryPackingScope {
+public:
+	explicit BinaryPackingScope(const BinaryPacking& packing) : m_saved(BinaryPacking::Current()) {
+		BinaryPacking::Current() = packing;
+	}
+	~BinaryPackingScope() {
+		BinaryPacking::Current() = m_saved;
+	}
+private:
+	BinaryPacking m_saved;
+};
+
+}
+
+#endif
@@ -25,14 +25,59 @@
  */
 
 #include "hashutil.h"
+#include "../lattice/backend.h"
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
+#include <numeric>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PALISADE_HASH_SHANI
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
 
 namespace lbcrypto {
 
 #define RIGHT_ROT(x, n) (( x >> (n % (sizeof(x)*8) ) | ( x << ((sizeof(x)*8) - (n % (sizeof(x)*8))))))
 
-const uint32_t HashUtil::k_256[64] = { 0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+namespace {
+
+struct SHA256Traits {
+	typedef uint32_t Word;
+	static const size_t ROUNDS = 64;
+	static const size_t BLOCK_BYTES = 64;
+	static const size_t LENGTH_BYTES = 8;
+	static const size_t DIGEST_BYTES = 32;
+	// number of messages compressed in lockstep by HashBatch
+	static const size_t LANES = 8;
+	static const Word K[ROUNDS];
+	static const Word H0[8];
+
+	static Word BSIG0(Word x) { return RIGHT_ROT(x, 2) ^ RIGHT_ROT(x, 13) ^ RIGHT_ROT(x, 22); }
+	static Word BSIG1(Word x) { return RIGHT_ROT(x, 6) ^ RIGHT_ROT(x, 11) ^ RIGHT_ROT(x, 25); }
+	static Word SSIG0(Word x) { return RIGHT_ROT(x, 7) ^ RIGHT_ROT(x, 18) ^ (x >> 3); }
+	static Word SSIG1(Word x) { return RIGHT_ROT(x, 17) ^ RIGHT_ROT(x, 19) ^ (x >> 10); }
+};
+
+struct SHA512Traits {
+	typedef uint64_t Word;
+	static const size_t ROUNDS = 80;
+	static const size_t BLOCK_BYTES = 128;
+	static const size_t LENGTH_BYTES = 16;
+	static const size_t DIGEST_BYTES = 64;
+	static const size_t LANES = 4;
+	static const Word K[ROUNDS];
+	static const Word H0[8];
+
+	static Word BSIG0(Word x) { return RIGHT_ROT(x, 28) ^ RIGHT_ROT(x, 34) ^ RIGHT_ROT(x, 39); }
+	static Word BSIG1(Word x) { return RIGHT_ROT(x, 14) ^ RIGHT_ROT(x, 18) ^ RIGHT_ROT(x, 41); }
+	static Word SSIG0(Word x) { return RIGHT_ROT(x, 1) ^ RIGHT_ROT(x, 8) ^ (x >> 7); }
+	static Word SSIG1(Word x) { return RIGHT_ROT(x, 19) ^ RIGHT_ROT(x, 61) ^ (x >> 6); }
+};
+
+const uint32_t SHA256Traits::K[64] = { 0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
 	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
 	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
 	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
@@ -41,7 +86,10 @@ const uint32_t HashUtil::k_256[64] = { 0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b
 	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
 	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2 };
 
-const uint64_t HashUtil::k_512[80] = { 0x428a2f98d728ae22, 0x7137449123ef65cd, 0xb5c0fbcfec4d3b2f, 0xe9b5dba58189dbbc, 0x3956c25bf348b538,
+const uint32_t SHA256Traits::H0[8] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+	0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+
+const uint64_t SHA512Traits::K[80] = { 0x428a2f98d728ae22, 0x7137449123ef65cd, 0xb5c0fbcfec4d3b2f, 0xe9b5dba58189dbbc, 0x3956c25bf348b538,
 	0x59f111f1b605d019, 0x923f82a4af194f9b, 0xab1c5ed5da6d8118, 0xd807aa98a3030242, 0x12835b0145706fbe,
 	0x243185be4ee4b28c, 0x550c7dc3d5ffb4e2, 0x72be5d74f27b896f, 0x80deb1fe3b1696b1, 0x9bdc06a725c71235,
 	0xc19bf174cf692694, 0xe49b69c19ef14ad2, 0xefbe4786384f25e3, 0x0fc19dc68b8cd5b5, 0x240ca1cc77ac9c65,
@@ -58,279 +106,510 @@ const uint64_t HashUtil::k_512[80] = { 0x428a2f98d728ae22, 0x7137449123ef65cd, 0
 	0x113f9804bef90dae, 0x1b710b35131c471b, 0x28db77f523047d84, 0x32caab7b40c72493, 0x3c9ebe0a15c9bebc,
 	0x431d67c49c100d4c, 0x4cc5d4becb3e42b6, 0x597f299cfc657e2a, 0x5fcb6fab3ad6faec, 0x6c44198c4a475817 };
 
+const uint64_t SHA512Traits::H0[8] = { 0x6a09e667f3bcc908, 0xbb67ae8584caa73b, 0x3c6ef372fe94f82b, 0xa54ff53a5f1d36f1,
+	0x510e527fade682d1, 0x9b05688c2b3e6c1f, 0x1f83d9abfb41bd6b, 0x5be0cd19137e2179 };
 
-void HashUtil::SHA256(string message, vector<int64_t>& digest) {
-	
-	uint32_t h_256[8] = { 0x6a09e667,0xbb67ae85,0x3c6ef372,0xa54ff53a,0x510e527f,0x9b05688c,0x1f83d9ab,0x5be0cd19 };
-
-	uint64_t m_len = message.size() * 8;
-	uint16_t pad_len = 1;
-	while ((m_len + pad_len) % 512 != 448) {
-		pad_len++;
+/**
+ * Compresses one block for each of L independent messages. Word i of the state of
+ * lane l is h[i*L + l]. Every step loops over the lanes with no dependency between
+ * them, which lets the compiler keep the lanes in vector registers.
+ */
+template <class T, size_t L>
+void CompressLanes(typename T::Word *h, const uint8_t *const *block) {
+	typedef typename T::Word Word;
+	const size_t wordBytes = sizeof(Word);
+
+	Word w[T::ROUNDS][L];
+	for (size_t t = 0; t < 16; t++) {
+		for (size_t l = 0; l < L; l++) {
+			Word v = 0;
+			for (size_t b = 0; b < wordBytes; b++)
+				v = (v << 8) | block[l][t*wordBytes + b];
+			w[t][l] = v;
+		}
 	}
-	message.push_back(0);
-	for (int a = 0;a < (pad_len) / 8 - 1;a++) {
-		message.push_back(0);
+	for (size_t t = 16; t < T::ROUNDS; t++)
+		for (size_t l = 0; l < L; l++)
+			w[t][l] = T::SSIG1(w[t-2][l]) + w[t-7][l] + T::SSIG0(w[t-15][l]) + w[t-16][l];
+
+	Word a[L], b[L], c[L], d[L], e[L], f[L], g[L], hh[L];
+	for (size_t l = 0; l < L; l++) {
+		a[l] = h[0*L + l]; b[l] = h[1*L + l]; c[l] = h[2*L + l]; d[l] = h[3*L + l];
+		e[l] = h[4*L + l]; f[l] = h[5*L + l]; g[l] = h[6*L + l]; hh[l] = h[7*L + l];
 	}
-	message.push_back((uint8_t)((m_len & 0xff00000000000000) >> 56));
-	message.push_back((uint8_t)((m_len & 0x00ff000000000000) >> 48));
-	message.push_back((uint8_t)((m_len & 0x0000ff0000000000) >> 40));
-	message.push_back((uint8_t)((m_len & 0x000000ff00000000) >> 32));
-	message.push_back((uint8_t)((m_len & 0x00000000ff000000) >> 24));
-	message.push_back((uint8_t)((m_len & 0x0000000000ff0000) >> 16));
-	message.push_back((uint8_t)((m_len & 0x000000000000ff00) >> 8));
-	message.push_back((uint8_t)(m_len & 0x00000000000000ff));
-
-	for (size_t n = 0;n < (message.size() * 8) / 512; n++) {
-		uint32_t w[64];
-		short counter = 0;
-		for (size_t m = 64 * n;m < (64 * (n + 1));m += 4) {
-			w[counter] = ((uint32_t)message.at(m) << 24) ^ ((uint32_t)message.at(m + 1) << 16) ^ ((uint32_t)message.at(m + 2) << 8) ^ ((uint32_t)message.at(m + 3));
-			counter++;
-		}
-		for (int i = 16;i < 64;i++) {
-			uint32_t s0 = ((uint32_t)RIGHT_ROT(w[i - 15], 7)) ^ ((uint32_t)(RIGHT_ROT(w[i - 15], 18))) ^ ((uint32_t)(w[i - 15] >> 3));
-			uint32_t s1 = ((uint32_t)RIGHT_ROT(w[i - 2], 17)) ^ ((uint32_t)RIGHT_ROT(w[i - 2], 19)) ^ ((uint32_t)(w[i - 2] >> 10));
-			w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+
+	for (size_t t = 0; t < T::ROUNDS; t++) {
+		for (size_t l = 0; l < L; l++) {
+			Word t1 = hh[l] + T::BSIG1(e[l]) + ((e[l] & f[l]) ^ (~e[l] & g[l])) + T::K[t] + w[t][l];
+			Word t2 = T::BSIG0(a[l]) + ((a[l] & b[l]) ^ (a[l] & c[l]) ^ (b[l] & c[l]));
+			hh[l] = g[l];
+			g[l] = f[l];
+			f[l] = e[l];
+			e[l] = d[l] + t1;
+			d[l] = c[l];
+			c[l] = b[l];
+			b[l] = a[l];
+			a[l] = t1 + t2;
 		}
+	}
 
-		uint32_t a = h_256[0];
-		uint32_t b = h_256[1];
-		uint32_t c = h_256[2];
-		uint32_t d = h_256[3];
-		uint32_t e = h_256[4];
-		uint32_t f = h_256[5];
-		uint32_t g = h_256[6];
-		uint32_t h = h_256[7];
-
-		for (int i = 0; i < 64;i++) {
-			uint32_t S1 = ((uint32_t)RIGHT_ROT(e, 6)) ^ ((uint32_t)RIGHT_ROT(e, 11)) ^ ((uint32_t)RIGHT_ROT(e, 25));
-			uint32_t ch = (e & f) ^ ((~e) & g);
-			uint32_t temp1 = h + S1 + ch + k_256[i] + w[i];
-			uint32_t S0 = ((uint32_t)RIGHT_ROT(a, 2)) ^ ((uint32_t)RIGHT_ROT(a, 13)) ^ ((uint32_t)RIGHT_ROT(a, 22));
-			uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
-			uint32_t temp2 = S0 + maj;
-
-			h = g;
-			g = f;
-			f = e;
-			e = d + temp1;
-			d = c;
-			c = b;
-			b = a;
-			a = temp1 + temp2;
+	for (size_t l = 0; l < L; l++) {
+		h[0*L + l] += a[l]; h[1*L + l] += b[l]; h[2*L + l] += c[l]; h[3*L + l] += d[l];
+		h[4*L + l] += e[l]; h[5*L + l] += f[l]; h[6*L + l] += g[l]; h[7*L + l] += hh[l];
+	}
+}
 
+template <class Word>
+void StoreBigEndian(const Word *h, size_t stride, uint8_t *out) {
+	for (size_t i = 0; i < 8; i++)
+		for (size_t b = 0; b < sizeof(Word); b++)
+			out[i*sizeof(Word) + b] = (uint8_t)(h[i*stride] >> (8*(sizeof(Word) - 1 - b)));
+}
+
+#ifdef PALISADE_HASH_SHANI
+
+bool DetectSHANI() {
+	unsigned int eax, ebx, ecx, edx;
+	if (__get_cpuid_max(0, nullptr) < 7)
+		return false;
+	__cpuid(1, eax, ebx, ecx, edx);
+	bool sse = (ecx & bit_SSSE3) && (ecx & bit_SSE4_1);
+	__cpuid_count(7, 0, eax, ebx, ecx, edx);
+	return sse && (ebx & (1u << 29));
+}
+
+bool HasSHANI() {
+	static const bool has = DetectSHANI();
+	return has;
+}
+
+/**
+ * SHA-256 compression with the x86 SHA extensions; state is in the usual word order
+ */
+__attribute__((target("sha,sse4.1,ssse3")))
+void SHA256CompressNI(uint32_t *state, const uint8_t *data, size_t blocks) {
+	const __m128i MASK = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+	// the rounds instruction expects the state as ABEF and CDGH
+	__m128i tmp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[0]));
+	__m128i state1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[4]));
+	tmp = _mm_shuffle_epi32(tmp, 0xB1);
+	state1 = _mm_shuffle_epi32(state1, 0x1B);
+	__m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+	state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+	for (; blocks > 0; blocks--, data += 64) {
+		const __m128i abef = state0;
+		const __m128i cdgh = state1;
+
+		__m128i msg[4];
+		for (size_t j = 0; j < 4; j++)
+			msg[j] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16*j)), MASK);
+
+		for (size_t j = 0; j < 16; j++) {
+			__m128i cur;
+			if (j < 4) {
+				cur = msg[j];
+			} else {
+				// message schedule for words 4j..4j+3 from the previous four groups
+				cur = _mm_sha256msg1_epu32(msg[j % 4], msg[(j+1) % 4]);
+				cur = _mm_add_epi32(cur, _mm_alignr_epi8(msg[(j+3) % 4], msg[(j+2) % 4], 4));
+				cur = _mm_sha256msg2_epu32(cur, msg[(j+3) % 4]);
+				msg[j % 4] = cur;
+			}
+			__m128i k = _mm_add_epi32(cur, _mm_loadu_si128(reinterpret_cast<const __m128i*>(&SHA256Traits::K[4*j])));
+			state1 = _mm_sha256rnds2_epu32(state1, state0, k);
+			k = _mm_shuffle_epi32(k, 0x0E);
+			state0 = _mm_sha256rnds2_epu32(state0, state1, k);
 		}
 
-		h_256[0] += a;
-		h_256[1] += b;
-		h_256[2] += c;
-		h_256[3] += d;
-		h_256[4] += e;
-		h_256[5] += f;
-		h_256[6] += g;
-		h_256[7] += h;
+		state0 = _mm_add_epi32(state0, abef);
+		state1 = _mm_add_epi32(state1, cdgh);
 	}
 
-	
+	tmp = _mm_shuffle_epi32(state0, 0x1B);
+	state1 = _mm_shuffle_epi32(state1, 0xB1);
+	state0 = _mm_blend_epi16(tmp, state1, 0xF0);
+	state1 = _mm_alignr_epi8(state1, tmp, 8);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), state0);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), state1);
+}
 
-	for (int i = 0; i < 8; i++) {
-		digest.push_back((uint8_t)((h_256[i] & 0xff000000) >> 24));
-		digest.push_back((uint8_t)((h_256[i] & 0x00ff0000) >> 16));
-		digest.push_back((uint8_t)((h_256[i] & 0x0000ff00) >> 8));
-		digest.push_back((uint8_t)(h_256[i] & 0x000000ff));
-	}
+#else
 
-	return;
+bool HasSHANI() {
+	return false;
 }
 
-std::string
-HashUtil::HashString(std::string message) {
-	uint32_t h_256[8] = { 0x6a09e667,0xbb67ae85,0x3c6ef372,0xa54ff53a,0x510e527f,0x9b05688c,0x1f83d9ab,0x5be0cd19 };
+void SHA256CompressNI(uint32_t *, const uint8_t *, size_t) {}
 
-	uint64_t m_len = message.size() * 8;
-	uint16_t pad_len = 1;
-	while ((m_len + pad_len) % 512 != 448) {
-		pad_len++;
-	}
+#endif
 
-	message += (char)(0x80);
-	for (int a = 0;a < (pad_len) / 8 - 1;a++) {
-		message += (char)(0);
+void CompressBlocks(uint32_t *h, const uint8_t *data, size_t blocks) {
+	if (HasSHANI()) {
+		SHA256CompressNI(h, data, blocks);
+		return;
 	}
-	message += ((char)((m_len & 0xff00000000000000) >> 56));
-	message += ((char)((m_len & 0x00ff000000000000) >> 48));
-	message += ((char)((m_len & 0x0000ff0000000000) >> 40));
-	message += ((char)((m_len & 0x000000ff00000000) >> 32));
-	message += ((char)((m_len & 0x00000000ff000000) >> 24));
-	message += ((char)((m_len & 0x0000000000ff0000) >> 16));
-	message += ((char)((m_len & 0x000000000000ff00) >> 8));
-	message += ((char)(m_len & 0x00000000000000ff));
-
-	for (size_t n = 0;n < (message.size() * 8) / 512; n++) {
-		uint32_t w[64];
-		short counter = 0;
-		for (size_t m = 64 * n;m < (64 * (n + 1));m += 4) {
-			w[counter] = ((uint32_t)(message.at(m)&0xff) << 24) ^ ((uint32_t)(message.at(m + 1)&0xff) << 16) ^ ((uint32_t)(message.at(m + 2)&0xff) << 8) ^ ((uint32_t)(message.at(m + 3)&0xff));
-			counter++;
-		}
-		for (int i = 16;i < 64;i++) {
-			uint32_t s0 = ((uint32_t)RIGHT_ROT(w[i - 15], 7)) ^ ((uint32_t)(RIGHT_ROT(w[i - 15], 18))) ^ ((uint32_t)(w[i - 15] >> 3));
-			uint32_t s1 = ((uint32_t)RIGHT_ROT(w[i - 2], 17)) ^ ((uint32_t)RIGHT_ROT(w[i - 2], 19)) ^ ((uint32_t)(w[i - 2] >> 10));
-			w[i] = w[i - 16] + s0 + w[i - 7] + s1;
-		}
+	for (size_t i = 0; i < blocks; i++, data += SHA256Traits::BLOCK_BYTES)
+		CompressLanes<SHA256Traits, 1>(h, &data);
+}
 
-		uint32_t a = h_256[0];
-		uint32_t b = h_256[1];
-		uint32_t c = h_256[2];
-		uint32_t d = h_256[3];
-		uint32_t e = h_256[4];
-		uint32_t f = h_256[5];
-		uint32_t g = h_256[6];
-		uint32_t h = h_256[7];
-
-		for (int i = 0; i < 64;i++) {
-			uint32_t S1 = ((uint32_t)RIGHT_ROT(e, 6)) ^ ((uint32_t)RIGHT_ROT(e, 11)) ^ ((uint32_t)RIGHT_ROT(e, 25));
-			uint32_t ch = (e & f) ^ ((~e) & g);
-			uint32_t temp1 = h + S1 + ch + k_256[i] + w[i];
-			uint32_t S0 = ((uint32_t)RIGHT_ROT(a, 2)) ^ ((uint32_t)RIGHT_ROT(a, 13)) ^ ((uint32_t)RIGHT_ROT(a, 22));
-			uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
-			uint32_t temp2 = S0 + maj;
-
-			h = g;
-			g = f;
-			f = e;
-			e = d + temp1;
-			d = c;
-			c = b;
-			b = a;
-			a = temp1 + temp2;
+void CompressBlocks(uint64_t *h, const uint8_t *data, size_t blocks) {
+	for (size_t i = 0; i < blocks; i++, data += SHA512Traits::BLOCK_BYTES)
+		CompressLanes<SHA512Traits, 1>(h, &data);
+}
 
-		}
+/**
+ * Writes the padded tail of a message of totalLen bytes whose last partial block
+ * is tail[0..tailLen); returns the number of blocks written (one or two)
+ */
+template <class T>
+size_t PadTail(const uint8_t *tail, size_t tailLen, uint64_t totalLen, uint8_t *out) {
+	size_t blocks = (tailLen + 1 + T::LENGTH_BYTES + T::BLOCK_BYTES - 1) / T::BLOCK_BYTES;
+	size_t outLen = blocks * T::BLOCK_BYTES;
+	if (tailLen > 0)
+		memcpy(out, tail, tailLen);
+	out[tailLen] = 0x80;
+	memset(out + tailLen + 1, 0, outLen - tailLen - 1);
+	uint64_t bits = totalLen * 8;
+	for (size_t b = 0; b < 8; b++)
+		out[outLen - 1 - b] = (uint8_t)(bits >> (8*b));
+	return blocks;
+}
 
-		h_256[0] += a;
-		h_256[1] += b;
-		h_256[2] += c;
-		h_256[3] += d;
-		h_256[4] += e;
-		h_256[5] += f;
-		h_256[6] += g;
-		h_256[7] += h;
+/**
+ * Hashes up to T::LANES messages in lockstep; lanes whose message has run out keep
+ * their state while the longer messages are finished
+ */
+template <class T>
+void HashLanes(const string *const *messages, size_t count, uint8_t *digests) {
+	typedef typename T::Word Word;
+	const size_t L = T::LANES;
+
+	Word h[8*L];
+	Word saved[8*L];
+	for (size_t i = 0; i < 8; i++)
+		for (size_t l = 0; l < L; l++)
+			h[i*L + l] = T::H0[i];
+
+	uint8_t tail[L][2*T::BLOCK_BYTES];
+	size_t full[L];
+	size_t total[L];
+	size_t maxBlocks = 0;
+	for (size_t l = 0; l < L; l++) {
+		const string &m = *messages[l < count ? l : 0];
+		full[l] = m.size() / T::BLOCK_BYTES;
+		size_t tailLen = m.size() - full[l]*T::BLOCK_BYTES;
+		total[l] = full[l] + PadTail<T>(reinterpret_cast<const uint8_t*>(m.data()) + full[l]*T::BLOCK_BYTES,
+				tailLen, m.size(), tail[l]);
+		if (l >= count)
+			total[l] = 0;
+		maxBlocks = std::max(maxBlocks, total[l]);
 	}
 
-	std::stringstream s;
-	s.fill('0');
-	s << std::hex;
-	for( size_t ii=0; ii<8; ii++ )
-		s << std::setw(8) << h_256[ii];
+	const uint8_t *block[L];
+	for (size_t j = 0; j < maxBlocks; j++) {
+		bool idle = false;
+		for (size_t l = 0; l < L; l++) {
+			const string &m = *messages[l < count ? l : 0];
+			if (j < full[l])
+				block[l] = reinterpret_cast<const uint8_t*>(m.data()) + j*T::BLOCK_BYTES;
+			else if (j < total[l])
+				block[l] = tail[l] + (j - full[l])*T::BLOCK_BYTES;
+			else {
+				block[l] = tail[l];
+				idle = true;
+			}
+		}
+		if (idle)
+			memcpy(saved, h, sizeof(h));
+		CompressLanes<T, L>(h, block);
+		if (idle)
+			for (size_t l = 0; l < L; l++)
+				if (j >= total[l])
+					for (size_t i = 0; i < 8; i++)
+						h[i*L + l] = saved[i*L + l];
+	}
 
-	return s.str();
+	for (size_t l = 0; l < count; l++)
+		StoreBigEndian(h + l, L, digests + l*T::DIGEST_BYTES);
 }
 
-#if 0
-lbcrypto::BytePlaintextEncoding HashUtil::SHA512(lbcrypto::BytePlaintextEncoding message) {
-	
-	uint64_t h_512[8] = { 0x6a09e667f3bcc908, 0xbb67ae8584caa73b, 0x3c6ef372fe94f82b, 0xa54ff53a5f1d36f1,
-		0x510e527fade682d1, 0x9b05688c2b3e6c1f, 0x1f83d9abfb41bd6b, 0x5be0cd19137e2179 };
-
-	uint128_t m_len = message.size() * 8;
-	uint64_t m_len_first = message.size() / (0x2000000000000000);
-	uint64_t m_len_second = message.size()*8;
-	uint16_t pad_len = 1;
-	while ((m_len + pad_len) % 1024 != 896) {
-		pad_len++;
+/**
+ * SHA-256 in counter mode: the stream for a domain is SHA-256(seed || domain || counter)
+ * for counter = 0, 1, ...; SHA256Traits::LANES blocks are produced per refill
+ */
+class HashExpander {
+public:
+	HashExpander(const uint8_t *data, size_t len) : m_domain(0), m_counter(0), m_pos(sizeof(m_stream)) {
+		HashState state(SHA_256);
+		state.Update(data, len);
+		state.Finalize(m_seed);
+	}
+
+	void SetDomain(uint32_t domain) {
+		m_domain = domain;
+		m_counter = 0;
+		m_pos = sizeof(m_stream);
 	}
-	message.push_back(128);
-	for (int a = 0;a < (pad_len) / 8 - 1;a++) {
-		message.push_back(0);
+
+	uint8_t NextByte() {
+		if (m_pos == sizeof(m_stream))
+			Refill();
+		return m_stream[m_pos++];
 	}
 
-	message.push_back((uint8_t)((m_len_first & 0xff00000000000000) >> 56));
-	message.push_back((uint8_t)((m_len_first & 0x00ff000000000000) >> 48));
-	message.push_back((uint8_t)((m_len_first & 0x0000ff0000000000) >> 40));
-	message.push_back((uint8_t)((m_len_first & 0x000000ff00000000) >> 32));
-	message.push_back((uint8_t)((m_len_first & 0x00000000ff000000) >> 24));
-	message.push_back((uint8_t)((m_len_first & 0x0000000000ff0000) >> 16));
-	message.push_back((uint8_t)((m_len_first & 0x000000000000ff00) >> 8));
-	message.push_back((uint8_t)(m_len_first & 0x00000000000000ff));
-
-	message.push_back((uint8_t)((m_len_second & 0xff00000000000000) >> 56));
-	message.push_back((uint8_t)((m_len_second & 0x00ff000000000000) >> 48));
-	message.push_back((uint8_t)((m_len_second & 0x0000ff0000000000) >> 40));
-	message.push_back((uint8_t)((m_len_second & 0x000000ff00000000) >> 32));
-	message.push_back((uint8_t)((m_len_second & 0x00000000ff000000) >> 24));
-	message.push_back((uint8_t)((m_len_second & 0x0000000000ff0000) >> 16));
-	message.push_back((uint8_t)((m_len_second & 0x000000000000ff00) >> 8));
-	message.push_back((uint8_t)(m_len_second & 0x00000000000000ff));
-
-
-	for (int n = 0;n < (message.size() * 8) / 1024; n++) {
-		uint64_t w[80];
-		short counter = 0;
-		for (int m = 128 * n;m < (128 * (n + 1));m += 8) {
-			w[counter] = ((uint64_t)message.at(m) << 56) ^ ((uint64_t)message.at(m+1) << 48) ^ ((uint64_t)message.at(m+2) << 40) ^ ((uint64_t)message.at(m+3) << 32) ^ ((uint64_t)message.at(m+4) << 24) ^ ((uint64_t)message.at(m + 5) << 16) ^ ((uint64_t)message.at(m + 6) << 8) ^ ((uint64_t)message.at(m + 7));
-			counter++;
+private:
+	void Refill() {
+		const size_t L = SHA256Traits::LANES;
+		// seed, domain and counter fit in a single padded block
+		uint8_t blocks[L][SHA256Traits::BLOCK_BYTES];
+		const uint8_t *block[L];
+		for (size_t l = 0; l < L; l++, m_counter++) {
+			uint8_t input[sizeof(m_seed) + 8];
+			memcpy(input, m_seed, sizeof(m_seed));
+			for (size_t b = 0; b < 4; b++) {
+				input[sizeof(m_seed) + b] = (uint8_t)(m_domain >> (24 - 8*b));
+				input[sizeof(m_seed) + 4 + b] = (uint8_t)(m_counter >> (24 - 8*b));
+			}
+			PadTail<SHA256Traits>(input, sizeof(input), sizeof(input), blocks[l]);
+			block[l] = blocks[l];
 		}
-		for (int i = 16;i < 80;i++) {
-			uint64_t s0 = ((uint64_t)RIGHT_ROT(w[i - 15], 1)) ^ ((uint64_t)(RIGHT_ROT(w[i - 15], 8))) ^ ((uint64_t)(w[i - 15] >> 7));
-			uint64_t s1 = ((uint64_t)RIGHT_ROT(w[i - 2], 19)) ^ ((uint64_t)RIGHT_ROT(w[i - 2], 61)) ^ ((uint64_t)(w[i - 2] >> 6));
-			w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+
+		if (HasSHANI()) {
+			for (size_t l = 0; l < L; l++) {
+				uint32_t lane[8];
+				std::copy(SHA256Traits::H0, SHA256Traits::H0 + 8, lane);
+				SHA256CompressNI(lane, blocks[l], 1);
+				StoreBigEndian(lane, 1, m_stream + l*SHA256Traits::DIGEST_BYTES);
+			}
+		} else {
+			uint32_t h[8*L];
+			for (size_t i = 0; i < 8; i++)
+				for (size_t l = 0; l < L; l++)
+					h[i*L + l] = SHA256Traits::H0[i];
+			CompressLanes<SHA256Traits, L>(h, block);
+			for (size_t l = 0; l < L; l++)
+				StoreBigEndian(h + l, L, m_stream + l*SHA256Traits::DIGEST_BYTES);
 		}
+		m_pos = 0;
+	}
 
-		uint64_t a = h_512[0];
-		uint64_t b = h_512[1];
-		uint64_t c = h_512[2];
-		uint64_t d = h_512[3];
-		uint64_t e = h_512[4];
-		uint64_t f = h_512[5];
-		uint64_t g = h_512[6];
-		uint64_t h = h_512[7];
-
-		for (int i = 0; i < 80;i++) {
-			uint64_t S1 = ((uint64_t)RIGHT_ROT(e, 14)) ^ ((uint64_t)RIGHT_ROT(e, 18)) ^ ((uint64_t)RIGHT_ROT(e, 41));
-			uint64_t ch = (e & f) ^ ((~e) & g);
-			uint64_t temp1 = h + S1 + ch + k_512[i] + w[i];
-			uint64_t S0 = ((uint64_t)RIGHT_ROT(a, 28)) ^ ((uint64_t)RIGHT_ROT(a, 34)) ^ ((uint64_t)RIGHT_ROT(a, 39));
-			uint64_t maj = (a & b) ^ (a & c) ^ (b & c);
-			uint64_t temp2 = S0 + maj;
-
-			h = g;
-			g = f;
-			f = e;
-			e = d + temp1;
-			d = c;
-			c = b;
-			b = a;
-			a = temp1 + temp2;
+	uint8_t m_seed[SHA256Traits::DIGEST_BYTES];
+	uint32_t m_domain;
+	uint32_t m_counter;
+	uint8_t m_stream[SHA256Traits::LANES * SHA256Traits::DIGEST_BYTES];
+	size_t m_pos;
+};
 
+/**
+ * Uniform integer modulo q by rejection sampling over the bit length of q
+ */
+template <class IntType>
+IntType SampleUniform(HashExpander &stream, const IntType &q) {
+	usint bits = q.GetMSB();
+	size_t bytes = (bits + 7) / 8;
+	uint8_t topMask = (bits % 8 == 0) ? 0xff : (uint8_t)((1u << (bits % 8)) - 1);
+	while (true) {
+		IntType value;
+		if (bytes <= 8) {
+			uint64_t v = stream.NextByte() & topMask;
+			for (size_t b = 1; b < bytes; b++)
+				v = (v << 8) | stream.NextByte();
+			value = IntType(v);
+		} else {
+			value = IntType((uint64_t)(stream.NextByte() & topMask));
+			for (size_t b = 1; b < bytes; b++) {
+				value <<= 8;
+				value += IntType((uint64_t)stream.NextByte());
+			}
 		}
+		if (value < q)
+			return value;
+	}
+}
+
+template <class VecType>
+VecType SampleVector(HashExpander &stream, uint32_t domain, usint n, const typename VecType::Integer &q) {
+	VecType values(n, q);
+	stream.SetDomain(domain);
+	for (usint i = 0; i < n; i++)
+		values[i] = SampleUniform(stream, q);
+	return values;
+}
+
+template <class VecType>
+PolyImpl<VecType> SampleRing(HashExpander &stream, const shared_ptr<typename PolyImpl<VecType>::Params> params,
+		Format format, PolyImpl<VecType> *) {
+	PolyImpl<VecType> result(params, format, true);
+	result.SetValues(SampleVector<VecType>(stream, 0, params->GetRingDimension(), params->GetModulus()), format);
+	return result;
+}
+
+template <class VecType>
+DCRTPolyImpl<VecType> SampleRing(HashExpander &stream, const shared_ptr<typename DCRTPolyImpl<VecType>::Params> params,
+		Format format, DCRTPolyImpl<VecType> *) {
+	typedef typename DCRTPolyImpl<VecType>::PolyType PolyType;
+	DCRTPolyImpl<VecType> result(params, format, true);
+	const std::vector<shared_ptr<ILNativeParams>> &towers = params->GetParams();
+	for (size_t t = 0; t < towers.size(); t++) {
+		PolyType tower(towers[t], format, true);
+		tower.SetValues(SampleVector<NativeVector>(stream, t, towers[t]->GetRingDimension(), towers[t]->GetModulus()), format);
+		result.SetElementAtIndex(t, tower);
+	}
+	return result;
+}
 
-		h_512[0] += a;
-		h_512[1] += b;
-		h_512[2] += c;
-		h_512[3] += d;
-		h_512[4] += e;
-		h_512[5] += f;
-		h_512[6] += g;
-		h_512[7] += h;
+}
+
+HashState::HashState(HashAlgorithm algo) : m_algo(algo) {
+	if (algo != SHA_256 && algo != SHA_512)
+		throw std::logic_error("ERROR: Unknown Hash Algorithm");
+	Reset();
+}
+
+void HashState::Reset() {
+	std::copy(SHA256Traits::H0, SHA256Traits::H0 + 8, m_h256);
+	std::copy(SHA512Traits::H0, SHA512Traits::H0 + 8, m_h512);
+	m_buffered = 0;
+	m_length = 0;
+}
+
+void HashState::Update(const uint8_t *data, size_t len) {
+	if (len == 0)
+		return;
+
+	const size_t blockBytes = (m_algo == SHA_256) ? SHA256Traits::BLOCK_BYTES : SHA512Traits::BLOCK_BYTES;
+	m_length += len;
+
+	if (m_buffered > 0) {
+		size_t take = std::min(len, blockBytes - m_buffered);
+		memcpy(m_buffer + m_buffered, data, take);
+		m_buffered += take;
+		data += take;
+		len -= take;
+		if (m_buffered < blockBytes)
+			return;
+		if (m_algo == SHA_256)
+			CompressBlocks(m_h256, m_buffer, 1);
+		else
+			CompressBlocks(m_h512, m_buffer, 1);
+		m_buffered = 0;
+	}
+
+	size_t blocks = len / blockBytes;
+	if (blocks > 0) {
+		if (m_algo == SHA_256)
+			CompressBlocks(m_h256, data, blocks);
+		else
+			CompressBlocks(m_h512, data, blocks);
+		data += blocks * blockBytes;
+		len -= blocks * blockBytes;
 	}
 
+	if (len > 0) {
+		memcpy(m_buffer, data, len);
+		m_buffered = len;
+	}
+}
 
-	lbcrypto::BytePlaintextEncoding digest;
-	for (int i = 0; i < 8; i++) {
-		digest.push_back((uint8_t)((h_512[i] & 0xff00000000000000) >> 56));
-		digest.push_back((uint8_t)((h_512[i] & 0x00ff000000000000) >> 48));
-		digest.push_back((uint8_t)((h_512[i] & 0x0000ff0000000000) >> 40));
-		digest.push_back((uint8_t)((h_512[i] & 0x000000ff00000000) >> 32));
-		digest.push_back((uint8_t)((h_512[i] & 0x00000000ff000000) >> 24));
-		digest.push_back((uint8_t)((h_512[i] & 0x0000000000ff0000) >> 16));
-		digest.push_back((uint8_t)((h_512[i] & 0x000000000000ff00) >> 8));
-		digest.push_back((uint8_t)(h_512[i] & 0x00000000000000ff));
+void HashState::Finalize(uint8_t *digest) {
+	uint8_t tail[2 * SHA512Traits::BLOCK_BYTES];
+	if (m_algo == SHA_256) {
+		size_t blocks = PadTail<SHA256Traits>(m_buffer, m_buffered, m_length, tail);
+		CompressBlocks(m_h256, tail, blocks);
+		StoreBigEndian(m_h256, 1, digest);
+	} else {
+		size_t blocks = PadTail<SHA512Traits>(m_buffer, m_buffered, m_length, tail);
+		CompressBlocks(m_h512, tail, blocks);
+		StoreBigEndian(m_h512, 1, digest);
 	}
+	Reset();
+}
 
+vector<uint8_t> HashState::Finalize() {
+	vector<uint8_t> digest(GetDigestSize());
+	Finalize(digest.data());
 	return digest;
 }
-#endif
 
+void HashUtil::Hash(const string& message, HashAlgorithm algo, vector<int64_t>& digest) {
+	HashState state(algo);
+	state.Update(message);
+	vector<uint8_t> bytes = state.Finalize();
+	digest.insert(digest.end(), bytes.begin(), bytes.end());
+}
+
+void HashUtil::HashBatch(const vector<string>& messages, HashAlgorithm algo, vector<vector<int64_t>>& digests) {
+	if (algo != SHA_256 && algo != SHA_512)
+		throw std::logic_error("ERROR: Unknown Hash Algorithm");
+
+	const size_t count = messages.size();
+	digests.assign(count, vector<int64_t>());
+
+	// the SHA extensions beat the interleaved lanes on a single message
+	if (algo == SHA_256 && HasSHANI()) {
+#pragma omp parallel for schedule(dynamic, 16)
+		for (size_t i = 0; i < count; i++)
+			Hash(messages[i], algo, digests[i]);
+		return;
+	}
+
+	// messages of similar length share a pass so that few lanes idle
+	vector<size_t> order(count);
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&messages](size_t x, size_t y) {
+		return messages[x].size() < messages[y].size();
+	});
+
+	const size_t lanes = (algo == SHA_256) ? SHA256Traits::LANES : SHA512Traits::LANES;
+	const size_t digestBytes = (algo == SHA_256) ? SHA256Traits::DIGEST_BYTES : SHA512Traits::DIGEST_BYTES;
+	const size_t groups = (count + lanes - 1) / lanes;
+
+#pragma omp parallel for schedule(dynamic)
+	for (size_t g = 0; g < groups; g++) {
+		const string *group[SHA256Traits::LANES];
+		size_t n = std::min(lanes, count - g*lanes);
+		for (size_t l = 0; l < n; l++)
+			group[l] = &messages[order[g*lanes + l]];
+
+		uint8_t out[SHA256Traits::LANES * SHA256Traits::DIGEST_BYTES];
+		if (algo == SHA_256)
+			HashLanes<SHA256Traits>(group, n, out);
+		else
+			HashLanes<SHA512Traits>(group, n, out);
+
+		for (size_t l = 0; l < n; l++)
+			digests[order[g*lanes + l]].assign(out + l*digestBytes, out + (l+1)*digestBytes);
+	}
+}
+
+std::string HashUtil::HashString(const std::string& message) {
+	HashState state(SHA_256);
+	state.Update(message);
+	vector<uint8_t> digest = state.Finalize();
+
+	std::stringstream s;
+	s.fill('0');
+	for (size_t i = 0; i < digest.size(); i++)
+		s << std::hex << std::setw(2) << (unsigned int)digest[i];
+	return s.str();
+}
+
+template <class Element>
+Element HashUtil::HashToRing(const uint8_t *data, size_t len, const shared_ptr<typename Element::Params> params, Format format) {
+	HashExpander stream(data, len);
+	return SampleRing(stream, params, format, static_cast<Element*>(nullptr));
+}
+
+template NativePoly HashUtil::HashToRing<NativePoly>(const uint8_t *, size_t, const shared_ptr<NativePoly::Params>, Format);
+template M2Poly HashUtil::HashToRing<M2Poly>(const uint8_t *, size_t, const shared_ptr<M2Poly::Params>, Format);
+template M4Poly HashUtil::HashToRing<M4Poly>(const uint8_t *, size_t, const shared_ptr<M4Poly::Params>, Format);
+template M2DCRTPoly HashUtil::HashToRing<M2DCRTPoly>(const uint8_t *, size_t, const shared_ptr<M2DCRTPoly::Params>, Format);
+template M4DCRTPoly HashUtil::HashToRing<M4DCRTPoly>(const uint8_t *, size_t, const shared_ptr<M4DCRTPoly::Params>, Format);
+#ifdef WITH_NTL
+template M6Poly HashUtil::HashToRing<M6Poly>(const uint8_t *, size_t, const shared_ptr<M6Poly::Params>, Format);
+template M6DCRTPoly HashUtil::HashToRing<M6DCRTPoly>(const uint8_t *, size_t, const shared_ptr<M6DCRTPoly::Params>, Format);
+#endif
 
 }
@@ -30,39 +30,129 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <memory>
 #include <stdexcept>
+#include "inttypes.h"
 using std::string;
 using std::vector;
+using std::shared_ptr;
 
 namespace lbcrypto {
 
 enum HashAlgorithm { SHA_256 = 0, SHA_512 = 1 };
 
-class HashUtil {
+/**
+ * @brief Incremental SHA-256/SHA-512 computation. Complete blocks are compressed
+ * directly from the caller's buffer; only a trailing partial block is copied.
+ * SHA-256 uses the SHA extensions of x86 processors when they are available.
+ */
+class HashState {
 public:
-	static void Hash(string message, HashAlgorithm algo, vector<int64_t>& digest) {
-		switch (algo) {
-		case SHA_256:
-			SHA256(message, digest);
-			return;
-
-		case SHA_512:
-			// FIXME SHA512 disabled, returning SHA256 instead
-			SHA256(message, digest);
-			return;
-
-		default:
-			throw std::logic_error("ERROR: Unknown Hash Algorithm");
-		}
+	/**
+	 * @param algo the hash algorithm
+	 */
+	explicit HashState(HashAlgorithm algo = SHA_256);
+
+	/**
+	 * Start a new hash computation with the same algorithm
+	 */
+	void Reset();
+
+	/**
+	 * Absorb a span of bytes
+	 * @param data start of the bytes
+	 * @param len number of bytes
+	 */
+	void Update(const uint8_t *data, size_t len);
+
+	/**
+	 * Absorb the bytes of a string
+	 * @param message the bytes
+	 */
+	void Update(const string& message) {
+		Update(reinterpret_cast<const uint8_t*>(message.data()), message.size());
 	}
 
-	static std::string HashString(std::string message);
+	/**
+	 * Complete the computation and write the digest; the state is reset afterwards
+	 * @param digest output buffer of GetDigestSize() bytes
+	 */
+	void Finalize(uint8_t *digest);
+
+	/**
+	 * Complete the computation; the state is reset afterwards
+	 * @return the digest
+	 */
+	vector<uint8_t> Finalize();
+
+	/**
+	 * @return the digest size in bytes
+	 */
+	size_t GetDigestSize() const { return m_algo == SHA_256 ? 32 : 64; }
+
+	/**
+	 * @return the hash algorithm
+	 */
+	HashAlgorithm GetAlgorithm() const { return m_algo; }
 
 private:
-	static void SHA256(string message, vector<int64_t>& digest);
-	static void SHA512(string message, vector<int64_t>& digest);
-	static const uint32_t k_256[64];
-	static const uint64_t k_512[80];
+	HashAlgorithm m_algo;
+	uint32_t m_h256[8];
+	uint64_t m_h512[8];
+	// partial block not compressed yet
+	uint8_t m_buffer[128];
+	size_t m_buffered;
+	// total number of bytes absorbed
+	uint64_t m_length;
+};
+
+class HashUtil {
+public:
+	/**
+	 * Hash a message; one byte of the digest is appended to digest per entry
+	 * @param message the message
+	 * @param algo the hash algorithm
+	 * @param digest where the digest is appended
+	 */
+	static void Hash(const string& message, HashAlgorithm algo, vector<int64_t>& digest);
+
+	/**
+	 * Hash several messages at once. SHA-256 processes eight messages and SHA-512
+	 * four messages per pass, interleaved so that the compression loops can be
+	 * vectorized; groups of messages are hashed in parallel.
+	 * @param messages the messages
+	 * @param algo the hash algorithm
+	 * @param digests the digest of each message, in the format of Hash - output
+	 */
+	static void HashBatch(const vector<string>& messages, HashAlgorithm algo, vector<vector<int64_t>>& digests);
+
+	/**
+	 * @param message the message
+	 * @return the SHA-256 digest as a hexadecimal string
+	 */
+	static std::string HashString(const std::string& message);
+
+	/**
+	 * Hash a message to a ring element whose coefficients are uniform modulo each
+	 * (tower) modulus. The message digest seeds SHA-256 in counter mode, and every
+	 * coefficient is drawn by rejection sampling. Uniform values are uniform in both
+	 * representations, so no NTT is needed for EVALUATION format.
+	 * @param data start of the message bytes
+	 * @param len number of message bytes
+	 * @param params parameters of the ring element
+	 * @param format format of the result
+	 * @return the ring element
+	 */
+	template <class Element>
+	static Element HashToRing(const uint8_t *data, size_t len, const shared_ptr<typename Element::Params> params, Format format = EVALUATION);
+
+	/**
+	 * Hash a string to a ring element; see the byte-span version
+	 */
+	template <class Element>
+	static Element HashToRing(const string& message, const shared_ptr<typename Element::Params> params, Format format = EVALUATION) {
+		return HashToRing<Element>(reinterpret_cast<const uint8_t*>(message.data()), message.size(), params, format);
+	}
 };
 
 }
@@ -32,6 +32,8 @@ using std::vector;
 using std::unique_ptr;
 #include <iterator>
 #include <algorithm>
+#include <cstdlib>
+#include <new>
 
 namespace lbcrypto {
 
@@ -75,6 +77,56 @@ namespace lbcrypto {
 		}
 	}
 
+	/**
+	 * @brief STL allocator that returns storage aligned to Align bytes.
+	 * Used for flat buffers of residues that are streamed through
+	 * vectorized loops, where cache-line alignment matters.
+	 */
+	template<class T, size_t Align = 64>
+	class AlignedAllocator {
+	public:
+		typedef T value_type;
+		typedef T* pointer;
+		typedef const T* const_pointer;
+		typedef T& reference;
+		typedef const T& const_reference;
+		typedef size_t size_type;
+		typedef ptrdiff_t difference_type;
+
+		template<class U>
+		struct rebind { typedef AlignedAllocator<U, Align> other; };
+
+		AlignedAllocator() {}
+		template<class U>
+		AlignedAllocator(const AlignedAllocator<U, Align>&) {}
+
+		pointer allocate(size_type n) {
+			if( n == 0 )
+				return nullptr;
+			void *p = nullptr;
+#ifdef _WIN32
+			p = _aligned_malloc(n * sizeof(T), Align);
+#else
+			if( posix_memalign(&p, Align, n * sizeof(T)) != 0 )
+				p = nullptr;
+#endif
+			if( p == nullptr )
+				throw std::bad_alloc();
+			return static_cast<pointer>(p);
+		}
+
+		void deallocate(pointer p, size_type) {
+#ifdef _WIN32
+			_aligned_free(p);
+#else
+			free(p);
+#endif
+		}
+
+		bool operator==(const AlignedAllocator&) const { return true; }
+		bool operator!=(const AlignedAllocator&) const { return false; }
+	};
+
 } //end namespace
 
 #endif // LBCRYPTO_UTILS_MEMORY_H
@@ -30,4 +30,71 @@ namespace lbcrypto {
 
 const char to_base64_char[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 
+std::string Base64Encode(const uint8_t *data, size_t len) {
+	std::string text;
+	text.reserve(((len + 2) / 3) * 4);
+
+	size_t i = 0;
+	for( ; i + 3 <= len; i += 3 ) {
+		uint32_t v = (uint32_t(data[i]) << 16) | (uint32_t(data[i+1]) << 8) | data[i+2];
+		text.push_back(to_base64_char[v >> 18]);
+		text.push_back(to_base64_char[(v >> 12) & 0x3f]);
+		text.push_back(to_base64_char[(v >> 6) & 0x3f]);
+		text.push_back(to_base64_char[v & 0x3f]);
+	}
+	if( i < len ) {
+		uint32_t v = uint32_t(data[i]) << 16;
+		if( i + 1 < len )
+			v |= uint32_t(data[i+1]) << 8;
+		text.push_back(to_base64_char[v >> 18]);
+		text.push_back(to_base64_char[(v >> 12) & 0x3f]);
+		text.push_back(i + 1 < len ? to_base64_char[(v >> 6) & 0x3f] : '=');
+		text.push_back('=');
+	}
+	return text;
+}
+
+bool Base64Decode(const std::string& text, std::vector<uint8_t> *data) {
+	// value of every character, or 0xff for characters outside the alphabet
+	static const struct DecodeTable {
+		uint8_t value[256];
+		DecodeTable() {
+			for( int c = 0; c < 256; c++ )
+				value[c] = 0xff;
+			for( int v = 0; v < 64; v++ )
+				value[(unsigned char)to_base64_char[v]] = v;
+		}
+	} table;
+
+	data->clear();
+	size_t len = text.size();
+	if( len % 4 != 0 )
+		return false;
+	if( len == 0 )
+		return true;
+
+	size_t padding = text[len-1] == '=' ? (text[len-2] == '=' ? 2 : 1) : 0;
+	data->resize((len / 4) * 3 - padding);
+
+	const unsigned char *in = reinterpret_cast<const unsigned char *>(text.data());
+	uint8_t *out = data->data();
+	size_t n = 0;
+	for( size_t i = 0; i < len; i += 4 ) {
+		uint32_t v = 0;
+		size_t chars = (i + 4 == len) ? 4 - padding : 4;
+		for( size_t j = 0; j < 4; j++ ) {
+			uint8_t c = j < chars ? table.value[in[i+j]] : 0;
+			if( c == 0xff )
+				return false;
+			v = (v << 6) | c;
+		}
+		out[n++] = v >> 16;
+		if( chars > 2 )
+			out[n++] = (v >> 8) & 0xff;
+		if( chars > 3 )
+			out[n++] = v & 0xff;
+	}
+	return true;
+}
+
 } /* namespace lbcrypto */
@@ -30,6 +30,8 @@
 #include <cctype>
 #include <cstdint>
 #include <stdexcept>
+#include <string>
+#include <vector>
 
 namespace lbcrypto {
 
@@ -65,6 +67,23 @@ namespace lbcrypto {
 		return (m_value >> (index-6)) & 0x3f;
 	}
 
+	/**
+	 * Encode bytes as padded base64 text
+	 *
+	 * @param data - the bytes
+	 * @param len - their number
+	 * @return the text
+	 */
+	std::string Base64Encode(const uint8_t *data, size_t len);
+
+	/**
+	 * Decode padded base64 text
+	 *
+	 * @param text - the text
+	 * @param data - the decoded bytes - output
+	 * @return false if the text is not valid base64
+	 */
+	bool Base64Decode(const std::string& text, std::vector<uint8_t> *data);
 
 
 } /* namespace lbcrypto */
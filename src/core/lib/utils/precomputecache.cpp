@@ -0,0 +1,338 @@
+/**
+ * @file precomputecache.cpp -- Files that keep precomputed tables from one process to the next.
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or other
+ * materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "precomputecache.h"
+#include "hashutil.h"
+#include "../math/transfrm.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace lbcrypto {
+
+namespace {
+
+const char			PrecomputeCacheMagic[8] = { 'P', 'A', 'L', 'P', 'C', 'C', '0', '1' };
+const uint32_t		PrecomputeCacheVersion = 2;
+const uint32_t		PrecomputeCacheFixedHeader = 56;	// magic, version, key length, tables length, checksum
+const uint32_t		PrecomputeCacheSectionHeader = 16;	// element size, reserved, count
+const uint32_t		PrecomputeCacheChecksum = 32;
+
+static_assert(sizeof(NativeInteger) == sizeof(uint64_t), "PrecomputeCache copies tables as raw native words");
+
+uint64_t Align8(uint64_t n) {
+	return (n + 7) & ~uint64_t(7);
+}
+
+std::mutex& DirectoryMutex() {
+	static std::mutex m;
+	return m;
+}
+
+std::string& Directory() {
+	static std::string d;
+	return d;
+}
+
+void Checksum(const uint8_t *data, uint64_t length, uint8_t *digest) {
+	HashState h(SHA_256);
+	h.Update(data, length);
+	h.Finalize(digest);
+}
+
+}
+
+void PrecomputeTableWriter::Section(uint32_t elementSize, uint64_t count, const void *data) {
+	uint64_t start = m_bytes.size();
+	uint64_t length = elementSize*count;
+	m_bytes.resize(start + PrecomputeCacheSectionHeader + Align8(length));
+
+	uint8_t *p = &m_bytes[start];
+	uint32_t reserved = 0;
+	memcpy(p, &elementSize, sizeof(elementSize));
+	memcpy(p + 4, &reserved, sizeof(reserved));
+	memcpy(p + 8, &count, sizeof(count));
+	if( length )
+		memcpy(p + PrecomputeCacheSectionHeader, data, length);
+}
+
+void PrecomputeTableWriter::operator()(const NativeVector& v) {
+	(*this)(v.GetModulus().ConvertToInt());
+	if( v.GetLength() == 0 )
+		Section(sizeof(NativeInteger), 0, 0);
+	else
+		Section(sizeof(NativeInteger), v.GetLength(), &v[0]);
+}
+
+const uint8_t *PrecomputeTableReader::Section(uint32_t elementSize, uint64_t *count) {
+	if( uint64_t(m_end - m_pos) < PrecomputeCacheSectionHeader )
+		PALISADE_THROW(deserialize_error, "Precomputed table is truncated");
+
+	uint32_t size;
+	memcpy(&size, m_pos, sizeof(size));
+	memcpy(count, m_pos + 8, sizeof(*count));
+	if( size != elementSize )
+		PALISADE_THROW(deserialize_error, "Precomputed table does not hold values of the expected size");
+
+	const uint8_t *data = m_pos + PrecomputeCacheSectionHeader;
+	uint64_t avail = m_end - data;
+	if( *count > avail / elementSize || Align8(*count*elementSize) > avail )
+		PALISADE_THROW(deserialize_error, "Precomputed table is truncated");
+	m_pos = data + Align8(*count*elementSize);
+	return data;
+}
+
+void PrecomputeTableReader::operator()(NativeVector& v) {
+	uint64_t modulus;
+	(*this)(modulus);
+	uint64_t count;
+	const uint8_t *p = Section(sizeof(NativeInteger), &count);
+	v = NativeVector(count, NativeInteger(modulus));
+	if( count )
+		memcpy(static_cast<void *>(&v[0]), p, count*sizeof(NativeInteger));
+}
+
+void PrecomputeCache::SetDirectory(const std::string& directory) {
+	std::lock_guard<std::mutex> lock(DirectoryMutex());
+	Directory() = directory;
+}
+
+std::string PrecomputeCache::GetDirectory() {
+	std::lock_guard<std::mutex> lock(DirectoryMutex());
+	return Directory();
+}
+
+std::string PrecomputeCache::MakeKey(const std::string& name, usint cyclotomicOrder,
+		const std::vector<NativeInteger>& moduli, const std::vector<NativeInteger>& roots, uint64_t plaintextModulus) {
+	std::stringstream s;
+	s << name << " v" << PrecomputeCacheVersion << " m=" << cyclotomicOrder << " p=" << plaintextModulus << std::endl;
+	for( size_t i = 0; i < moduli.size(); i++ )
+		s << moduli[i] << " " << (i < roots.size() ? roots[i] : NativeInteger(0)) << std::endl;
+	return HashUtil::HashString(s.str());
+}
+
+std::string PrecomputeCache::GetFilename(const std::string& key) {
+	return GetDirectory() + "/" + key + ".pcc";
+}
+
+bool PrecomputeCache::Load(const std::string& key, PrecomputeTableReader *tables) {
+	if( !Enabled() )
+		return false;
+
+	const std::string filename = GetFilename(key);
+
+	std::shared_ptr<const uint8_t> file;
+	uint64_t size;
+#ifdef _WIN32
+	std::ifstream in(filename, std::ios::binary | std::ios::ate);
+	if( !in.is_open() )
+		return false;
+	size = in.tellg();
+	in.seekg(0);
+	uint8_t *copy = new uint8_t[size ? size : 1];
+	file.reset(copy, std::default_delete<uint8_t[]>());
+	if( !in.read(reinterpret_cast<char *>(copy), size) )
+		return false;
+#else
+	int fd = open(filename.c_str(), O_RDONLY);
+	if( fd < 0 )
+		return false;
+	struct stat st;
+	if( fstat(fd, &st) != 0 || st.st_size == 0 ) {
+		close(fd);
+		return false;
+	}
+	size = st.st_size;
+	void *base = mmap(0, size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if( base == MAP_FAILED )
+		return false;
+	file.reset(static_cast<const uint8_t *>(base), [size](const uint8_t *p) {
+		munmap(const_cast<uint8_t *>(p), size);
+	});
+#endif
+
+	const uint8_t *p = file.get();
+	if( size < PrecomputeCacheFixedHeader || memcmp(p, PrecomputeCacheMagic, sizeof(PrecomputeCacheMagic)) != 0 )
+		return false;
+
+	uint32_t version, keyLength;
+	uint64_t length;
+	memcpy(&version, p + 8, sizeof(version));
+	memcpy(&keyLength, p + 12, sizeof(keyLength));
+	memcpy(&length, p + 16, sizeof(length));
+	if( version != PrecomputeCacheVersion || keyLength != key.size() )
+		return false;
+
+	uint64_t start = Align8(PrecomputeCacheFixedHeader + uint64_t(keyLength));
+	if( start > size || length != size - start )
+		return false;
+	if( memcmp(p + PrecomputeCacheFixedHeader, key.data(), keyLength) != 0 )
+		return false;
+
+	uint8_t digest[PrecomputeCacheChecksum];
+	Checksum(p + start, length, digest);
+	if( memcmp(digest, p + 24, PrecomputeCacheChecksum) != 0 )
+		return false;
+
+	tables->m_file = file;
+	tables->m_pos = p + start;
+	tables->m_end = p + size;
+	return true;
+}
+
+bool PrecomputeCache::Store(const std::string& key, const PrecomputeTableWriter& tables) {
+	if( !Enabled() )
+		return false;
+
+	const std::string filename = GetFilename(key);
+	std::stringstream tmp;
+	tmp << filename << ".tmp." << std::this_thread::get_id() << "." << std::chrono::steady_clock::now().time_since_epoch().count();
+	const std::string tmpname = tmp.str();
+
+	const std::vector<uint8_t>& bytes = tables.GetBytes();
+	uint8_t header[PrecomputeCacheFixedHeader] = {};
+	uint32_t version = PrecomputeCacheVersion;
+	uint32_t keyLength = key.size();
+	uint64_t length = bytes.size();
+	memcpy(header, PrecomputeCacheMagic, sizeof(PrecomputeCacheMagic));
+	memcpy(header + 8, &version, sizeof(version));
+	memcpy(header + 12, &keyLength, sizeof(keyLength));
+	memcpy(header + 16, &length, sizeof(length));
+	Checksum(bytes.data(), bytes.size(), header + 24);
+
+	{
+		std::ofstream out(tmpname, std::ios::binary | std::ios::trunc);
+		if( !out.is_open() )
+			return false;
+		static const char zeros[8] = {};
+		out.write(reinterpret_cast<const char *>(header), sizeof(header));
+		out.write(key.data(), key.size());
+		out.write(zeros, Align8(PrecomputeCacheFixedHeader + key.size()) - (PrecomputeCacheFixedHeader + key.size()));
+		out.write(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+		if( !out.good() ) {
+			out.close();
+			std::remove(tmpname.c_str());
+			return false;
+		}
+	}
+
+#ifdef _WIN32
+	std::remove(filename.c_str());
+#endif
+	if( std::rename(tmpname.c_str(), filename.c_str()) != 0 ) {
+		std::remove(tmpname.c_str());
+		return false;
+	}
+	return true;
+}
+
+void PrecomputeCache::WriteNTTTables(PrecomputeTableWriter& tables, usint cyclotomicOrder,
+		const std::vector<NativeInteger>& moduli, const std::vector<NativeInteger>& roots) {
+	typedef ChineseRemainderTransformFTT<NativeVector> FTT;
+
+	if( moduli.size() != roots.size() )
+		PALISADE_THROW(config_error, "WriteNTTTables needs a root of unity for every modulus");
+
+	// the tables are keyed by modulus only, so they may have been built for another order or root;
+	// PreCompute builds them again in that case
+	std::vector<NativeInteger> q(moduli), r(roots);
+	FTT::PreCompute(r, cyclotomicOrder, q);
+
+	auto table = [cyclotomicOrder](const std::map<NativeInteger,NativeVector>& m, const NativeInteger& q) -> const NativeVector& {
+		auto found = m.find(q);
+		if( found == m.end() || found->second.GetLength() != cyclotomicOrder/2 )
+			PALISADE_THROW(config_error, "NTT tables for modulus " + q.ToString() + " are not for cyclotomic order "
+					+ std::to_string(cyclotomicOrder));
+		return found->second;
+	};
+
+	tables(uint64_t(moduli.size()));
+	for( size_t i = 0; i < moduli.size(); i++ ) {
+		const NativeVector& rootTable = table(FTT::m_rootOfUnityTableByModulus, moduli[i]);
+		if( cyclotomicOrder/2 > 1 && rootTable[1] != roots[i] )
+			PALISADE_THROW(config_error, "NTT tables for modulus " + moduli[i].ToString() + " are not for root " + roots[i].ToString());
+		tables(moduli[i].ConvertToInt());
+		tables(roots[i].ConvertToInt());
+		tables(uint64_t(cyclotomicOrder));
+		tables(rootTable);
+		tables(table(FTT::m_rootOfUnityInverseTableByModulus, moduli[i]));
+		tables(table(FTT::m_rootOfUnityPreconTableByModulus, moduli[i]));
+		tables(table(FTT::m_rootOfUnityInversePreconTableByModulus, moduli[i]));
+	}
+}
+
+void PrecomputeCache::ReadNTTTables(PrecomputeTableReader& tables, usint cyclotomicOrder) {
+	struct Entry {
+		uint64_t		q;
+		NativeVector	root, rootInverse, precon, inversePrecon;
+	};
+
+	uint64_t count;
+	tables(count);
+	std::vector<Entry> entries;
+	for( uint64_t i = 0; i < count; i++ ) {
+		Entry e;
+		uint64_t root, order;
+		tables(e.q);
+		tables(root);
+		tables(order);
+		tables(e.root);
+		tables(e.rootInverse);
+		tables(e.precon);
+		tables(e.inversePrecon);
+
+		// the tables start at the zeroth power of the root, and the inverse table at that of its inverse
+		NativeInteger q(e.q);
+		usint n = cyclotomicOrder/2;
+		bool valid = order == cyclotomicOrder && root < e.q;
+		for( const NativeVector *t : { &e.root, &e.rootInverse, &e.precon, &e.inversePrecon } )
+			valid = valid && t->GetLength() == n && t->GetModulus() == q;
+		valid = valid && n > 0 && e.root[0] == NativeInteger(1) && e.rootInverse[0] == NativeInteger(1);
+		if( valid && n > 1 )
+			valid = e.root[1] == NativeInteger(root) && e.root[1].ModMul(e.rootInverse[1], q) == NativeInteger(1);
+		if( !valid )
+			PALISADE_THROW(deserialize_error, "Precomputed NTT tables for modulus " + std::to_string(e.q)
+					+ " do not match their root of unity and cyclotomic order");
+		entries.push_back(std::move(e));
+	}
+
+	for( auto& e : entries )
+		ChineseRemainderTransformFTT<NativeVector>::SetPreComputed(NativeInteger(e.q), std::move(e.root), std::move(e.rootInverse),
+				std::move(e.precon), std::move(e.inversePrecon));
+}
+
+}
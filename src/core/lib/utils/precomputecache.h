@@ -0,0 +1,231 @@
+/**
+ * @file precomputecache.h -- Files that keep precomputed tables from one process to the next.
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or other
+ * materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef _SRC_LIB_UTILS_PRECOMPUTECACHE_H
+#define _SRC_LIB_UTILS_PRECOMPUTECACHE_H
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../math/backend.h"
+#include "exception.h"
+
+namespace lbcrypto {
+
+/**
+ * @brief PrecomputeTableWriter lays out precomputed tables for a PrecomputeCache file
+ *
+ * Each table becomes one section: the size of its elements, their count, then the elements
+ * in their in-memory representation, padded to eight bytes. A table of tables is written as
+ * its row count followed by one section per row. Tables are read back by a
+ * PrecomputeTableReader in the order they were written, so one function that applies a
+ * writer or a reader to every table in turn describes the layout for both directions.
+ */
+class PrecomputeTableWriter {
+public:
+	template<typename T>
+	void operator()(const T& v) { Section(sizeof(T), 1, &v); }
+
+	template<typename T>
+	void operator()(const std::vector<T>& v) { Section(sizeof(T), v.size(), v.data()); }
+
+	template<typename T>
+	void operator()(const std::vector<std::vector<T>>& v) {
+		(*this)(uint64_t(v.size()));
+		for( const auto& row : v )
+			(*this)(row);
+	}
+
+	void operator()(const NativeVector& v);
+
+	/**
+	 * @return the sections written so far
+	 */
+	const std::vector<uint8_t>& GetBytes() const { return m_bytes; }
+
+private:
+	void Section(uint32_t elementSize, uint64_t count, const void *data);
+
+	std::vector<uint8_t>	m_bytes;
+};
+
+/**
+ * @brief PrecomputeTableReader reads back the tables of a PrecomputeCache file
+ *
+ * The reader keeps the file mapped until it is destroyed; every table is copied out of
+ * the mapping. A section whose element size does not match the table it is read into
+ * throws deserialize_error.
+ */
+class PrecomputeTableReader {
+public:
+	PrecomputeTableReader() : m_pos(0), m_end(0) {}
+
+	template<typename T>
+	void operator()(T& v) {
+		uint64_t count;
+		const uint8_t *p = Section(sizeof(T), &count);
+		if( count != 1 )
+			PALISADE_THROW(deserialize_error, "Precomputed table holds more than one value");
+		memcpy(static_cast<void *>(&v), p, sizeof(T));
+	}
+
+	template<typename T>
+	void operator()(std::vector<T>& v) {
+		uint64_t count;
+		const uint8_t *p = Section(sizeof(T), &count);
+		v.resize(count);
+		if( count )
+			memcpy(static_cast<void *>(&v[0]), p, count*sizeof(T));
+	}
+
+	template<typename T>
+	void operator()(std::vector<std::vector<T>>& v) {
+		uint64_t rows;
+		(*this)(rows);
+		if( rows > uint64_t(m_end - m_pos) )
+			PALISADE_THROW(deserialize_error, "Precomputed table is truncated");
+		v.resize(rows);
+		for( auto& row : v )
+			(*this)(row);
+	}
+
+	void operator()(NativeVector& v);
+
+	/**
+	 * @return true once every table in the file has been read
+	 */
+	bool AtEnd() const { return m_pos == m_end; }
+
+private:
+	friend class PrecomputeCache;
+
+	const uint8_t *Section(uint32_t elementSize, uint64_t *count);
+
+	std::shared_ptr<const uint8_t>	m_file;	/*!< the mapping, or a copy of the file */
+	const uint8_t					*m_pos;
+	const uint8_t					*m_end;
+};
+
+/**
+ * @brief PrecomputeCache keeps tables that take long to compute, such as the CRT and NTT tables
+ * of a parameter set, in files, so that another process using the same parameters can read them
+ * instead of computing them again
+ *
+ * The cache is off until a directory is set. Every set of tables is stored in its own file, named
+ * after a key that digests everything the tables are computed from. A file holds the key and a
+ * SHA-256 checksum of the tables; a file with another key, a wrong checksum or an unknown
+ * format version is ignored, and the tables are computed and stored again. Files are written
+ * to a temporary name and renamed into place, so processes sharing the directory never see a
+ * partly written file.
+ *
+ * Tables are stored in host byte order and representation; a directory should only be shared
+ * between builds of the library for the same platform.
+ */
+class PrecomputeCache {
+public:
+	/**
+	 * Keep cache files in a directory, which must exist
+	 *
+	 * @param directory - the directory; an empty string turns the cache off
+	 */
+	static void SetDirectory(const std::string& directory);
+
+	/**
+	 * @return the cache directory; empty if the cache is off
+	 */
+	static std::string GetDirectory();
+
+	/**
+	 * @return true if a cache directory is set
+	 */
+	static bool Enabled() { return !GetDirectory().empty(); }
+
+	/**
+	 * Compute the key of a set of tables
+	 *
+	 * @param name - what the tables are; differs between kinds of tables over the same moduli
+	 * @param cyclotomicOrder - cyclotomic order of the ring
+	 * @param moduli - the moduli the tables are computed for
+	 * @param roots - their roots of unity
+	 * @param plaintextModulus - the plaintext modulus, or 0 if the tables do not depend on it
+	 * @return the key
+	 */
+	static std::string MakeKey(const std::string& name, usint cyclotomicOrder,
+			const std::vector<NativeInteger>& moduli, const std::vector<NativeInteger>& roots, uint64_t plaintextModulus);
+
+	/**
+	 * @param key - key of a set of tables
+	 * @return the file the tables are stored in
+	 */
+	static std::string GetFilename(const std::string& key);
+
+	/**
+	 * Open the tables stored for a key
+	 *
+	 * @param key - key of the tables
+	 * @param tables - reader positioned at the first table - output
+	 * @return false if the cache is off, or no valid file is stored for the key
+	 */
+	static bool Load(const std::string& key, PrecomputeTableReader *tables);
+
+	/**
+	 * Store tables for a key, replacing any file stored for it
+	 *
+	 * @param key - key of the tables
+	 * @param tables - the tables
+	 * @return false if the cache is off or the file could not be written
+	 */
+	static bool Store(const std::string& key, const PrecomputeTableWriter& tables);
+
+	/**
+	 * Add the NTT tables of ChineseRemainderTransformFTT<NativeVector> for some moduli, their roots
+	 * of unity and a cyclotomic order to a writer, with the roots and the order; the tables are
+	 * computed for them again if the tables in ChineseRemainderTransformFTT were built for others
+	 *
+	 * @param tables - the writer
+	 * @param cyclotomicOrder - the cyclotomic order
+	 * @param moduli - the moduli
+	 * @param roots - the roots of unity of the moduli
+	 */
+	static void WriteNTTTables(PrecomputeTableWriter& tables, usint cyclotomicOrder,
+			const std::vector<NativeInteger>& moduli, const std::vector<NativeInteger>& roots);
+
+	/**
+	 * Read tables added by WriteNTTTables and install them in ChineseRemainderTransformFTT<NativeVector>;
+	 * nothing is installed unless every table was written for the cyclotomic order and matches its root
+	 *
+	 * @param tables - the reader
+	 * @param cyclotomicOrder - the cyclotomic order the tables must be for
+	 * @throw deserialize_error if the tables are for another order or do not match their roots
+	 */
+	static void ReadNTTTables(PrecomputeTableReader& tables, usint cyclotomicOrder);
+};
+
+}
+
+#endif
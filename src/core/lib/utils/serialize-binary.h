@@ -73,6 +73,7 @@
 #endif
 
 #include "utils/serial.h"
+#include "utils/binarypacking.h"
 
 namespace lbcrypto {
 
@@ -129,6 +130,59 @@ inline static bool DeserializeFromFile(std::string filename, T& obj, const SerTy
 	return false;
 }
 
+/**
+ * Serialize an object in the compact binary format
+ * @param obj - object to serialize
+ * @param stream - Stream to serialize to
+ * @param sertype - COMPACT, with the number of bits to drop from ciphertexts
+ */
+template<typename T>
+inline static void
+Serialize(const T& obj, std::ostream& stream, const SerType::SERCOMPACT& st) {
+	BinaryPacking packing;
+	packing.compact = true;
+	packing.droppedBits = st.droppedBits;
+	BinaryPackingScope scope(packing);
+
+	cereal::PortableBinaryOutputArchive archive( stream );
+	archive( obj );
+}
+
+/**
+ * Deserialize an object written in the compact binary format; the packing is
+ * recorded in the stream, so this reads BINARY streams as well
+ * @param obj - object to deserialize into
+ * @param stream - Stream to deserialize from
+ * @param sertype - COMPACT
+ */
+template<typename T>
+inline static void
+Deserialize(T& obj, std::istream& stream, const SerType::SERCOMPACT& st) {
+	Deserialize(obj, stream, SerType::BINARY);
+}
+
+template <typename T>
+inline static bool SerializeToFile(std::string filename, const T& obj, const SerType::SERCOMPACT& sertype) {
+	std::ofstream file(filename, std::ios::out|std::ios::binary);
+	if( file.is_open() ) {
+		Serial::Serialize(obj, file, sertype);
+		file.close();
+		return true;
+	}
+	return false;
+}
+
+template <typename T>
+inline static bool DeserializeFromFile(std::string filename, T& obj, const SerType::SERCOMPACT& sertype) {
+	std::ifstream file(filename, std::ios::in|std::ios::binary);
+	if( file.is_open() ) {
+		Serial::Deserialize(obj, file, sertype);
+		file.close();
+		return true;
+	}
+	return false;
+}
+
 }
 
 }
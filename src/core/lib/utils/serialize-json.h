@@ -73,6 +73,7 @@
 #endif
 
 #include "utils/serial.h"
+#include "utils/binarypacking.h"
 
 namespace lbcrypto {
 
@@ -107,6 +108,60 @@ Deserialize(T& obj, std::istream& stream, const SerType::SERJSON& ser) {
 	archive( obj );
 }
 
+/**
+ * Serialize an object as JSON with base64 blobs for its residue vectors
+ * @param obj - object to serialize
+ * @param stream - Stream to serialize to
+ * @param sertype - JSONCOMPACT
+ */
+template<typename T>
+inline static void
+Serialize(const T& obj, std::ostream& stream, const SerType::SERJSONCOMPACT& st) {
+	BinaryPacking packing;
+	packing.compact = true;
+	packing.droppedBits = st.droppedBits;
+	packing.textBlobs = true;
+	BinaryPackingScope scope(packing);
+
+	cereal::JSONOutputArchive archive( stream );
+	archive( obj );
+}
+
+/**
+ * Deserialize an object written as JSONCOMPACT; every vector records how it was
+ * written, so this reads JSON streams as well
+ * @param obj - object to deserialize into
+ * @param stream - Stream to deserialize from
+ * @param sertype - JSONCOMPACT
+ */
+template<typename T>
+inline static void
+Deserialize(T& obj, std::istream& stream, const SerType::SERJSONCOMPACT& st) {
+	Deserialize(obj, stream, SerType::JSON);
+}
+
+template <typename T>
+inline static bool SerializeToFile(std::string filename, const T& obj, const SerType::SERJSONCOMPACT& sertype) {
+	std::ofstream file(filename, std::ios::out|std::ios::binary);
+	if( file.is_open() ) {
+		Serial::Serialize(obj, file, sertype);
+		file.close();
+		return true;
+	}
+	return false;
+}
+
+template <typename T>
+inline static bool DeserializeFromFile(std::string filename, T& obj, const SerType::SERJSONCOMPACT& sertype) {
+	std::ifstream file(filename, std::ios::in|std::ios::binary);
+	if( file.is_open() ) {
+		Serial::Deserialize(obj, file, sertype);
+		file.close();
+		return true;
+	}
+	return false;
+}
+
 template <typename T>
 inline static bool SerializeToFile(std::string filename, const T& obj, const SerType::SERJSON& sertype) {
 	std::ofstream file(filename, std::ios::out|std::ios::binary);
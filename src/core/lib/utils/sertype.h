@@ -27,6 +27,8 @@
 #ifndef LBCRYPTO_SERTYPE_H
 #define LBCRYPTO_SERTYPE_H
 
+#include <cstdint>
+
 namespace lbcrypto {
 
 namespace SerType {
@@ -41,6 +43,36 @@ namespace SerType {
 //		int	dummy;
 	};
 	static SERBINARY BINARY;
+
+	/**
+	 * Binary serialization that packs each residue vector to the bit length of its
+	 * modulus. droppedBits least-significant bits are also rounded away from the
+	 * elements of single-modulus ciphertexts, adding up to 2^(droppedBits-1) to each
+	 * of their coefficients. Decryption multiplies c1 by the secret key s, so the
+	 * error in the decrypted message is up to (1 + ||s||_1) * 2^(droppedBits-1) per
+	 * coefficient; for ternary keys ||s||_1 can be as large as the ring dimension n.
+	 * It is only for schemes that keep the message in the high-order bits (BFV) and
+	 * have the noise margin for that.
+	 */
+	class SERCOMPACT {
+	public:
+		explicit SERCOMPACT(uint32_t droppedBits = 0) : droppedBits(droppedBits) {}
+		uint32_t droppedBits;
+	};
+	static SERCOMPACT COMPACT;
+
+	/**
+	 * JSON serialization that keeps the structure of JSON for everything but the residue
+	 * vectors, which are written as base64 strings of their COMPACT binary form. This is
+	 * several times smaller and faster to parse than JSON arrays of numbers; droppedBits
+	 * is as for SERCOMPACT.
+	 */
+	class SERJSONCOMPACT {
+	public:
+		explicit SERJSONCOMPACT(uint32_t droppedBits = 0) : droppedBits(droppedBits) {}
+		uint32_t droppedBits;
+	};
+	static SERJSONCOMPACT JSONCOMPACT;
 }
 
 }
@@ -1008,6 +1008,29 @@ TEST_F(UTBinInt,big_modexp) {
 	RUN_BIG_BACKENDS_INT(big_modexp,"big_modexp")
 }
 
+template<typename T>
+void large_mul_modexp(const string& msg) {
+	// operands of 1214 to 1585 bits cross the limb counts where multiplication switches algorithms
+	T a = T(3).Exp(1000);
+	T b = T(3).Exp(766);
+	T prod = a*b;
+
+	EXPECT_EQ(T(3).Exp(1766), prod) << msg << " Failure testing large multiplication";
+	EXPECT_EQ(b, prod.DividedBy(a)) << msg << " Failure testing large multiplication quotient";
+	EXPECT_EQ(T(0), prod.Mod(a)) << msg << " Failure testing large multiplication remainder";
+
+	// Fermat's little theorem for the Mersenne prime 2^1279-1
+	T p = (T(1) << 1279) - T(1);
+	T base = T(7).Exp(400);
+	EXPECT_EQ(T(1), base.ModExp(p-T(1), p)) << msg << " Failure testing mod_exp by p-1";
+	EXPECT_EQ(base, base.ModExp(p, p)) << msg << " Failure testing mod_exp by p";
+	EXPECT_EQ(base.ModMul(base, p).ModMul(base, p), base.ModExp(T(3), p)) << msg << " Failure testing mod_exp by 3";
+}
+
+TEST_F(UTBinInt,large_mul_modexp) {
+	RUN_BIG_BACKENDS_INT(large_mul_modexp,"large_mul_modexp")
+}
+
 template<typename T>
 void power_2_modexp(const string& msg) {
 	T m("2");
@@ -1217,6 +1240,27 @@ TEST_F(UTBinInt,binString) {
 	RUN_ALL_BACKENDS_INT(binString,"binString")
 }
 
+template<typename T>
+void toString(const string& msg) {
+	EXPECT_EQ("0", T(0).ToString()) << msg;
+	EXPECT_EQ("1000000007", T("1000000007").ToString()) << msg;
+	EXPECT_EQ("1000000000000000001", T("1000000000000000001").ToString()) << msg;
+
+	// 2^200 spans several base-10^9 groups, some with leading zeros
+	T x(1);
+	x <<= 200;
+	EXPECT_EQ("1606938044258990275541962092341162602522202993782792835301376", x.ToString())
+	<< msg << " Failure testing ToString";
+
+	std::stringstream ss;
+	ss << x;
+	EXPECT_EQ(x.ToString(), ss.str()) << msg << " Failure testing operator<<";
+}
+
+TEST_F(UTBinInt,toString) {
+	RUN_BIG_BACKENDS_INT(toString,"toString")
+}
+
 template<typename T>
 void expNoMod(const string& msg) {
 
@@ -1302,6 +1346,9 @@ void GetInternalRepresentation(const string& msg) {
   //define what is correct based on math backend selected
   string correct("2 0 0 16");
 
+  if( typeid(T) == typeid(M2Integer) && sizeof(integral_dtype) == 8 )
+	  correct = "2 68719476736";
+
 #ifdef WITH_NTL
   if( typeid(T) == typeid(M6Integer) )
 	  correct = "2 68719476736";
@@ -1313,3 +1360,23 @@ void GetInternalRepresentation(const string& msg) {
 TEST_F(UTBinInt,GetInternalRepresentation) {
 	RUN_BIG_BACKENDS_INT(GetInternalRepresentation,"GetInternalRepresentation")
 }
+
+TEST_F(UTBinInt,M2_v1_image) {
+	// a version 1 image holds 32-bit limbs, most significant first, followed by the MSB
+	M2Integer expected("1234567890123456789012345678901234567890");
+	M2Integer x(expected);
+	std::vector<uint32_t> limbs(M2Integer::V1Limbs(), 0);
+	for( size_t i = limbs.size(); i-- > 0 && x > M2Integer(0); ) {
+		limbs[i] = (uint32_t)(x.Mod(M2Integer(uint64_t(1)<<32)).ConvertToInt());
+		x >>= 32;
+	}
+	std::vector<uint8_t> image(M2Integer::V1ImageSize(), 0);
+	memcpy(image.data(), limbs.data(), 4*limbs.size());
+	usshort msb = expected.GetMSB();
+	memcpy(image.data() + 4*limbs.size(), &msb, sizeof(msb));
+
+	M2Integer y;
+	y.SetValueFromV1Image(image.data());
+	EXPECT_EQ(expected, y);
+	EXPECT_EQ(expected.GetMSB(), y.GetMSB());
+}
@@ -29,6 +29,7 @@
 
 #include "include/gtest/gtest.h"
 #include <iostream>
+#include <random>
 
 #include "../lib/lattice/dcrtpoly.h"
 #include "math/backend.h"
@@ -360,6 +361,43 @@ TEST(UTBinVect,ModMulTest) {
 	RUN_BIG_BACKENDS(ModMulTest, "ModMulTest")
 }
 
+// multi-limb odd and even moduli, with entries at and above the modulus;
+// the vector results must match element-wise ModMul. The length spans more
+// than one block of the cpu_int block product and ends in a partial block
+template<typename V>
+void ModMulMultiLimbTest(const string& msg) {
+
+	typename V::Integer q127("170141183460469231731687303715884105727");	// 2^127 - 1
+	typename V::Integer q128("340282366920938463463374607431768211456");	// 2^128
+	typename V::Integer x("98765432109876543210987654321098765432");
+
+	for( const auto& q : { q127, q128 } ) {
+		V m(100,q), n(100,q);
+		for (usint i=0;i<100;i++){
+			m.at(i) = x * typename V::Integer(i+1);
+			n.at(i) = x + typename V::Integer(7*i);
+		}
+		m.at(4) = q - typename V::Integer(1);
+		n.at(5) = q;
+		m.at(99) = q;
+
+		V vecResult = m.ModMul(n);
+		V scalarResult = m.ModMul(x);
+		V eqResult(m);
+		eqResult.ModMulEq(n);
+
+		for (usint i=0;i<100;i++){
+			EXPECT_EQ (m.at(i).ModMul(n.at(i), q), vecResult.at(i)) << msg << " vector, q = " << q;
+			EXPECT_EQ (m.at(i).ModMul(x, q), scalarResult.at(i)) << msg << " scalar, q = " << q;
+			EXPECT_EQ (vecResult.at(i), eqResult.at(i)) << msg << " ModMulEq, q = " << q;
+		}
+	}
+}
+
+TEST(UTBinVect,ModMulMultiLimbTest) {
+	RUN_BIG_BACKENDS(ModMulMultiLimbTest, "ModMulMultiLimbTest")
+}
+
 /*--------------TESTING METHOD MODEXP FOR ALL CONDITIONS---------------------------*/
 
 /* 	The method "Mod Exp" operates on Big Vector m, BigIntegers n,q
@@ -576,3 +614,80 @@ void modmul_vector(const string& msg) {
 TEST(UTBinVect,modmul_vector) {
 	RUN_BIG_BACKENDS(modmul_vector, "modmul_vector")
 }
+
+// one modulus of each class with a specialized multiplication kernel, including the edge cases
+TEST(UTBinVect,native_modmul_modulus_classes) {
+	std::mt19937_64 gen(5);
+	vector<uint64_t> moduli = { 3, (1ULL<<32) - 5, (1ULL<<32) + 15, (1ULL<<52) - 47, (1ULL<<52) + 21,
+		(1ULL<<60) - 93, 1ULL<<59, (1ULL<<62) - 57, ~0ULL - 58 };
+
+	for (uint64_t q : moduli) {
+		NativeInteger modulus(q);
+		usint n = 256;
+		NativeVector a(n, modulus), b(n, modulus);
+		for (usint i = 0; i < n; i++) {
+			a[i] = gen() % q;
+			b[i] = gen() % q;
+		}
+		a[0] = q - 1;
+		b[0] = q - 1;
+		// an entry left unreduced, as after a change of modulus
+		if (q < (1ULL<<63))
+			a[1] += modulus;
+		NativeInteger scalar(q - 2);
+
+		NativeVector product = a.ModMul(b);
+		NativeVector scaled = a.ModMul(scalar);
+		NativeVector productEq(a);
+		productEq.ModMulEq(b);
+		NativeVector scaledEq(a);
+		scaledEq.ModMulEq(scalar);
+
+		for (usint i = 0; i < n; i++) {
+			uint64_t expected = (uint64_t)(DoubleNativeInt(a[i].ConvertToInt()) * b[i].ConvertToInt() % q);
+			EXPECT_EQ(expected, product[i].ConvertToInt()) << "modulus " << q << " index " << i;
+			EXPECT_EQ(expected, productEq[i].ConvertToInt()) << "modulus " << q << " index " << i;
+
+			expected = (uint64_t)(DoubleNativeInt(a[i].ConvertToInt()) * (q - 2) % q);
+			EXPECT_EQ(expected, scaled[i].ConvertToInt()) << "modulus " << q << " index " << i;
+			EXPECT_EQ(expected, scaledEq[i].ConvertToInt()) << "modulus " << q << " index " << i;
+		}
+	}
+}
+
+// the 32-bit tower type gives the same results as NativeVector
+TEST(UTBinVect,native_vector32) {
+	std::mt19937_64 gen(7);
+
+	vector<uint64_t> moduli = { 3, 65537, (1ULL<<30) - 35, (1ULL<<31) - 1 };
+
+	for (uint64_t q : moduli) {
+		NativeInteger modulus(q);
+		usint n = 256;
+		NativeVector a(n, modulus), b(n, modulus);
+		for (usint i = 0; i < n; i++) {
+			a[i] = gen() % q;
+			b[i] = gen() % q;
+		}
+		a[0] = q - 1;
+		b[0] = q - 1;
+		NativeInteger scalar(q - 2);
+
+		NativeVector32 a32(a), b32(b);
+		EXPECT_EQ(a, a32.ToNativeVector()) << "modulus " << q;
+		EXPECT_EQ(a.ModAdd(b), a32.ModAdd(b32).ToNativeVector()) << "modulus " << q;
+		EXPECT_EQ(a.ModSub(b), a32.ModSub(b32).ToNativeVector()) << "modulus " << q;
+		EXPECT_EQ(a.ModMul(b), a32.ModMul(b32).ToNativeVector()) << "modulus " << q;
+		EXPECT_EQ(a.ModMul(scalar), a32.ModMul(scalar).ToNativeVector()) << "modulus " << q;
+
+		NativeVector32 c32(a32);
+		c32.ModMulEq(b32);
+		c32.ModAddEq(a32);
+		c32.ModSubEq(b32);
+		EXPECT_EQ(a.ModMul(b).ModAdd(a).ModSub(b), c32.ToNativeVector()) << "modulus " << q;
+	}
+
+	NativeVector32 a32(4, NativeInteger(17)), b32(4, NativeInteger(19));
+	EXPECT_THROW(a32.ModAddEq(b32), lbcrypto::math_error) << "different moduli";
+	EXPECT_THROW(NativeVector32(4, NativeInteger((uint64_t)1 << 31)), lbcrypto::math_error) << "32-bit modulus";
+}
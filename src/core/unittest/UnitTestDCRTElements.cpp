@@ -673,6 +673,37 @@ TEST(UTDCRTPoly, DCRT_mod_ops_on_two_elements) {
 	RUN_BIG_DCRTPOLYS(DCRT_mod_ops_on_two_elements, "DCRT DCRT_mod_ops_on_two_elements");
 }
 
+template<typename Element>
+void DCRT_decryption_crt_interpolate(const string& msg) {
+
+	usint order = 64;
+	typename Element::DugType dug;
+	typename Element::DggType dgg(4);
+
+	for( usint nBits : { 24, 50, 60 } ) {
+		for( usint towersize : { 1, 3, 5 } ) {
+			shared_ptr<ILDCRTParams<typename Element::Integer>> params = GenerateDCRTParams<typename Element::Integer>(order, towersize, nBits);
+
+			for( PlaintextModulus p : { PlaintextModulus(2), PlaintextModulus(65537), PlaintextModulus((1ULL<<59) - 55) } ) {
+				Element uniform(dug, params, Format::COEFFICIENT);
+				EXPECT_EQ(uniform.CRTInterpolate().DecryptionCRTInterpolate(p), uniform.DecryptionCRTInterpolate(p))
+					<< msg << " Failure: uniform element, " << towersize << " towers of " << nBits << " bits, p = " << p;
+
+				// small values, negative ones included, decrypt to themselves mod p
+				Element small(dgg, params, Format::COEFFICIENT);
+				NativePoly expected = small.CRTInterpolate().DecryptionCRTInterpolate(p);
+				small.SwitchFormat();
+				EXPECT_EQ(expected, small.DecryptionCRTInterpolate(p))
+					<< msg << " Failure: small element in EVALUATION format, " << towersize << " towers of " << nBits << " bits, p = " << p;
+			}
+		}
+	}
+}
+
+TEST(UTDCRTPoly, DCRT_decryption_crt_interpolate) {
+	RUN_BIG_DCRTPOLYS(DCRT_decryption_crt_interpolate, "decryption CRT interpolate");
+}
+
 // only need to try this with one
 void testDCRTPolyConstructorNegative(std::vector<NativePoly> &towers) {
 	DCRTPoly expectException(towers);
@@ -30,6 +30,7 @@
 #define PROFILE
 #include "include/gtest/gtest.h"
 #include <iostream>
+#include <limits>
 
 #include "../lib/lattice/dcrtpoly.h"
 #include "math/backend.h"
@@ -160,6 +161,62 @@ TEST_F(UTEncoding,packed_int_ptxt_encoding_negative) {
 	EXPECT_EQ( se.GetPackedValue(), vectorOfInts1 ) << "packed int";
 }
 
+TEST_F(UTEncoding,packed_int_ptxt_encoding_threads) {
+	usint m = 2048;
+	PlaintextModulus p = 65537;
+	NativeInteger modulusQ = FirstPrime<NativeInteger>(50, m);
+	NativeInteger rootQ = RootOfUnity<NativeInteger>(m, modulusQ);
+
+	shared_ptr<ILNativeParams> lp(new ILNativeParams(m, modulusQ, rootQ));
+	// no SetParams: every thread finds the plan through the encoding params it shares with the others
+	EncodingParams ep(new EncodingParamsImpl(p));
+
+	const int count = 32;
+	vector<vector<int64_t>> values(count);
+	vector<vector<int64_t>> decoded(count);
+	for( int t = 0; t < count; t++ )
+		for( usint i = 0; i < m/2; i++ )
+			values[t].push_back( int64_t((i*31 + t*7) % p) - int64_t(p/2) );
+
+#pragma omp parallel for
+	for( int t = 0; t < count; t++ ) {
+		PackedEncoding	se(lp, ep, values[t]);
+		se.Encode();
+		se.Decode();
+		decoded[t] = se.GetPackedValue();
+	}
+
+	for( int t = 0; t < count; t++ )
+		EXPECT_EQ( decoded[t], values[t] ) << "packed int from thread " << t;
+
+	auto plan = ep->GetPackedEncodingPlan();
+	ASSERT_TRUE( bool(plan) ) << "plan was not kept in the encoding params";
+	EXPECT_EQ( plan->GetCyclotomicOrder(), m );
+	EXPECT_EQ( plan->GetPlaintextModulus(), NativeInteger(p) );
+}
+
+TEST_F(UTEncoding,packed_int_ptxt_encoding_plan_checks) {
+	usint m = 2048;
+	PackedEncodingPlan::Clear();
+
+	// the generator reported for m is the one of the plan built last, whatever the map order of the moduli
+	EncodingParams ep1(new EncodingParamsImpl(12289, 0, 3));
+	EncodingParams ep2(new EncodingParamsImpl(65537, 0, 5));
+	PackedEncodingPlan::Get(m, *ep1);
+	auto plan = PackedEncodingPlan::Get(m, *ep2);
+	EXPECT_EQ( 5U, PackedEncodingPlan::GetAutomorphismGenerator(m) );
+	EXPECT_EQ( 0U, PackedEncodingPlan::GetAutomorphismGenerator(2*m) );
+
+	NativeVector coefficients;
+	std::vector<int64_t> slots = { 1, -2, std::numeric_limits<int64_t>::min() };
+	EXPECT_THROW( plan->Pack(slots, &coefficients), std::logic_error ) << "most negative slot value";
+	slots[2] = -65536;
+	plan->Pack(slots, &coefficients);
+	EXPECT_EQ( m/2, coefficients.GetLength() );
+
+	PackedEncodingPlan::Clear();
+}
+
 TEST_F(UTEncoding,packed_int_ptxt_encoding_DCRTPoly_prime_cyclotomics) {
 
 	usint init_size = 3;
@@ -421,3 +421,26 @@ TEST(UTField2n, evaluation_coefficient) {
 	}
 	DiscreteFourierTransform::Reset();
 }
+
+//TEST FOR FORMAT CHANGE AGAINST DIRECT EVALUATION AT THE PRIMITIVE 2N-TH ROOTS OF UNITY, FOR ODD AND EVEN LOG2(N)
+TEST(UTField2n, switch_format_sizes) {
+	for (size_t n = 1; n <= 512; n *= 2) {
+		Field2n a(n, COEFFICIENT, true);
+		for (size_t j = 0; j < n; j++)
+			a.at(j) = std::complex<double>((double)((7 * j + 3) % 11) - 5, (double)((5 * j) % 3));
+
+		Field2n b(a);
+		b.SwitchFormat();
+		EXPECT_EQ(EVALUATION, b.GetFormat());
+		for (size_t k = 0; k < n; k++) {
+			std::complex<double> expected(0, 0);
+			for (size_t j = 0; j < n; j++)
+				expected += a.at(j) * std::polar(1.0, M_PI * (double)(j * (2 * k + 1)) / n);
+			EXPECT_LE(std::abs(b.at(k) - expected), pow(10, -9)) << "n = " << n << ", k = " << k;
+		}
+
+		b.SwitchFormat();
+		for (size_t j = 0; j < n; j++)
+			EXPECT_LE(std::abs(b.at(j) - a.at(j)), pow(10, -9)) << "n = " << n << ", j = " << j;
+	}
+}
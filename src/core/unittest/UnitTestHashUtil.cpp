@@ -0,0 +1,164 @@
+/*
+ * @file 
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or other
+ * materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+ /*
+This code exercises the hash utilities of the PALISADE lattice encryption library.
+*/
+
+#include "include/gtest/gtest.h"
+#include <iostream>
+#include <vector>
+#include <sstream>
+#include <iomanip>
+
+#include "math/backend.h"
+#include "lattice/backend.h"
+#include "utils/hashutil.h"
+#include "utils/parmfactory.h"
+#include "lattice/elemparamfactory.h"
+
+using namespace lbcrypto;
+
+static string ToHex(const vector<int64_t>& digest) {
+	std::stringstream s;
+	s.fill('0');
+	for (size_t i = 0; i < digest.size(); i++)
+		s << std::hex << std::setw(2) << digest[i];
+	return s.str();
+}
+
+static string HashHex(const string& message, HashAlgorithm algo) {
+	vector<int64_t> digest;
+	HashUtil::Hash(message, algo, digest);
+	return ToHex(digest);
+}
+
+TEST(UTHashUtil, known_digests) {
+	EXPECT_EQ("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855", HashHex("", SHA_256));
+	EXPECT_EQ("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad", HashHex("abc", SHA_256));
+	EXPECT_EQ("248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1",
+		HashHex("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", SHA_256));
+	EXPECT_EQ("ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a"
+		"2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f", HashHex("abc", SHA_512));
+	EXPECT_EQ("8e959b75dae313da8cf4f72814fc143f8f7779c6eb9f7fa17299aeadb6889018"
+		"501d289e4900f7e4331b99dec4b5433ac7d329eeb6dd26545e96e55b874be909",
+		HashHex("abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmno"
+			"ijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu", SHA_512));
+	EXPECT_EQ("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad", HashUtil::HashString("abc"));
+}
+
+TEST(UTHashUtil, streaming) {
+	string message;
+	for (size_t i = 0; i < 1000; i++)
+		message.push_back((char)(i * 7 + 3));
+
+	for (HashAlgorithm algo : { SHA_256, SHA_512 }) {
+		vector<int64_t> expected;
+		HashUtil::Hash(message, algo, expected);
+
+		// uneven pieces straddle the block boundaries
+		HashState state(algo);
+		size_t pos = 0;
+		for (size_t piece = 1; pos < message.size(); piece = piece * 3 + 1) {
+			size_t len = std::min(piece, message.size() - pos);
+			state.Update(reinterpret_cast<const uint8_t*>(message.data()) + pos, len);
+			pos += len;
+		}
+		vector<uint8_t> digest = state.Finalize();
+		EXPECT_EQ(expected, vector<int64_t>(digest.begin(), digest.end())) << "algorithm " << algo;
+
+		// the state is reset by Finalize
+		state.Update(message);
+		digest = state.Finalize();
+		EXPECT_EQ(expected, vector<int64_t>(digest.begin(), digest.end())) << "algorithm " << algo;
+	}
+}
+
+TEST(UTHashUtil, batch) {
+	// lengths around the padding boundaries of both algorithms, in mixed order
+	vector<string> messages;
+	for (size_t len : { 0, 300, 55, 56, 64, 1, 111, 112, 128, 127, 1000, 63, 119, 200 })
+		messages.push_back(string(len, (char)('a' + len % 26)));
+
+	for (HashAlgorithm algo : { SHA_256, SHA_512 }) {
+		vector<vector<int64_t>> digests;
+		HashUtil::HashBatch(messages, algo, digests);
+		ASSERT_EQ(messages.size(), digests.size());
+		for (size_t i = 0; i < messages.size(); i++) {
+			vector<int64_t> expected;
+			HashUtil::Hash(messages[i], algo, expected);
+			EXPECT_EQ(expected, digests[i]) << "algorithm " << algo << " message " << i;
+		}
+	}
+}
+
+template<typename Element>
+void hash_to_ring(const shared_ptr<typename Element::Params> params) {
+	Element a = HashUtil::HashToRing<Element>("message", params);
+	Element b = HashUtil::HashToRing<Element>("message", params);
+	Element c = HashUtil::HashToRing<Element>("message2", params);
+
+	EXPECT_EQ(EVALUATION, a.GetFormat());
+	EXPECT_EQ(a, b) << "hash is not deterministic";
+	EXPECT_NE(a, c) << "different messages hash to the same element";
+
+	Element d = HashUtil::HashToRing<Element>("message", params, COEFFICIENT);
+	EXPECT_EQ(COEFFICIENT, d.GetFormat());
+	EXPECT_EQ(a.GetValues(), d.GetValues());
+}
+
+TEST(UTHashUtil, hash_to_ring_poly) {
+	usint m = 16;
+	NativeInteger q("7681");
+	shared_ptr<ILNativeParams> nparams(new ILNativeParams(m, q, RootOfUnity(m, q)));
+	hash_to_ring<NativePoly>(nparams);
+
+	NativePoly a = HashUtil::HashToRing<NativePoly>("message", nparams);
+	for (usint i = 0; i < a.GetLength(); i++)
+		EXPECT_LT(a[i], q);
+
+	shared_ptr<ILParams> params = ElemParamFactory::GenElemParams<ILParams>(m, 100);
+	hash_to_ring<Poly>(params);
+
+	Poly b = HashUtil::HashToRing<Poly>("message", params);
+	for (usint i = 0; i < b.GetLength(); i++)
+		EXPECT_LT(b[i], params->GetModulus());
+}
+
+TEST(UTHashUtil, hash_to_ring_dcrt) {
+	usint m = 16;
+	shared_ptr<ILDCRTParams<BigInteger>> params = GenerateDCRTParams<BigInteger>(m, 3, 30);
+
+	DCRTPoly a = HashUtil::HashToRing<DCRTPoly>("message", params);
+	DCRTPoly b = HashUtil::HashToRing<DCRTPoly>("message", params);
+	EXPECT_EQ(a, b);
+	for (usint t = 0; t < a.GetNumOfElements(); t++) {
+		const NativePoly &tower = a.GetElementAtIndex(t);
+		for (usint i = 0; i < tower.GetLength(); i++)
+			EXPECT_LT(tower[i], tower.GetModulus());
+	}
+	// the towers are sampled independently
+	EXPECT_NE(a.GetElementAtIndex(0).GetValues()[0], a.GetElementAtIndex(1).GetValues()[0]);
+}
@@ -40,6 +40,8 @@
 
 #include "math/matrix.h"
 #include "math/matrixstrassen.cpp"
+#include "lattice/slabmatrix.h"
+#include "utils/parmfactory.h"
 
 //using namespace std;
 using namespace lbcrypto;
@@ -219,6 +221,51 @@ TEST(UTMatrix,Poly_mult_square_matrix_caps){
 	RUN_ALL_POLYS(Poly_mult_square_matrix_caps,"Poly_mult_square_matrix_caps")
 }
 
+template<typename Element>
+void slab_matrix_ops(shared_ptr<typename Element::Params> params, const string& msg) {
+
+	auto zeroAlloc = Element::Allocator(params, EVALUATION);
+	auto uniformAlloc = Element::MakeDiscreteUniformAllocator(params, EVALUATION);
+
+	Matrix<Element> A(zeroAlloc, 3, 4, uniformAlloc);
+	Matrix<Element> B(zeroAlloc, 4, 2, uniformAlloc);
+	Matrix<Element> C(zeroAlloc, 3, 4, uniformAlloc);
+
+	SlabMatrix<Element> sA(A), sB(B), sC(C);
+
+	EXPECT_EQ(A, sA.ToMatrix()) << msg << " pack/unpack round trip failed";
+	EXPECT_EQ(A(1,2), sA(1,2).ToElement()) << msg << " entry view does not match";
+
+	EXPECT_EQ(A*B, (sA*sB).ToMatrix()) << msg << " multiplication failed";
+	EXPECT_EQ(A+C, (sA+sC).ToMatrix()) << msg << " addition failed";
+	EXPECT_EQ(A-C, (sA-sC).ToMatrix()) << msg << " subtraction failed";
+
+	Matrix<Element> Acoef(A);
+	Acoef.SwitchFormat();
+	SlabMatrix<Element> sAcoef(sA);
+	sAcoef.SwitchFormat();
+	EXPECT_EQ(COEFFICIENT, sAcoef.GetFormat()) << msg;
+	EXPECT_EQ(Acoef, sAcoef.ToMatrix()) << msg << " SwitchFormat failed";
+	sAcoef.SetFormat(EVALUATION);
+	EXPECT_EQ(sA, sAcoef) << msg << " SwitchFormat round trip failed";
+
+	sA(0,0) = B(0,0);
+	EXPECT_EQ(B(0,0), sA.GetElement(0,0)) << msg << " SetElement failed";
+}
+
+TEST(UTMatrix, slab_matrix_native) {
+	usint m = 16;
+	NativeInteger modulus("67108913");
+	NativeInteger rootOfUnity("61564");
+	shared_ptr<ILNativeParams> params( new ILNativeParams(m, modulus, rootOfUnity) );
+	slab_matrix_ops<NativePoly>(params, "Native");
+}
+
+TEST(UTMatrix, slab_matrix_dcrt) {
+	auto params = GenerateDCRTParams<BigInteger>(16, 3, 28);
+	slab_matrix_ops<DCRTPoly>(params, "DCRTPoly");
+}
+
 inline void expect_close(double a, double b) {
 	EXPECT_LE(fabs(a - b), 10e-8);
 }
@@ -396,3 +443,61 @@ TEST(UTMatrix, cofactorMatrix) {
 	EXPECT_EQ(r, m.CofactorMatrix());
 
 }
+
+// Checks that A * adj(A) = det(A) * I for the fraction-free elimination path,
+// including a matrix that needs row pivoting and a singular matrix
+TEST(UTMatrix, adjugate_int) {
+
+	const size_t d = 6;
+	Matrix<int64_t> m([]() { return 0; }, d, d);
+	for (size_t i = 0; i < d; i++)
+		for (size_t j = 0; j < d; j++)
+			m(i, j) = (int64_t)(((i+1)*(j+2)*(j+2) + 3*i*i + j) % 11) - 5;
+	m(0, 0) = 0;
+
+	int64_t determinant = 0;
+	Matrix<int64_t> adj = m.Adjugate(&determinant);
+
+	int64_t expected = 0;
+	m.Determinant(&expected);
+	EXPECT_EQ(expected, determinant);
+	EXPECT_EQ(484, determinant);
+	Matrix<int64_t> identity = Matrix<int64_t>([]() { return 0; }, d, d).Identity();
+	EXPECT_EQ(identity.ScalarMult(determinant), m * adj);
+	EXPECT_EQ(adj, m.CofactorMatrix().Transpose());
+
+	// duplicate a row to make the matrix singular; the adjugate is then of rank at most one
+	for (size_t j = 0; j < d; j++)
+		m(d-1, j) = m(0, j);
+	adj = m.Adjugate(&determinant);
+	EXPECT_EQ(0, determinant);
+	EXPECT_EQ(Matrix<int64_t>([]() { return 0; }, d, d), m * adj);
+
+}
+
+// Checks the division-free path on ring elements: A * adj(A) = det(A) * I mod q
+template<typename Element>
+void adjugate_ring(const string& msg) {
+
+	const size_t d = 4;
+	Matrix<Element> m(fastIL2nAlloc<Element>(), d, d, fastUniformIL2nAlloc<Element>());
+
+	Element determinant = fastIL2nAlloc<Element>()();
+	Matrix<Element> adj = m.Adjugate(&determinant);
+
+	Element expected = fastIL2nAlloc<Element>()();
+	m.Determinant(&expected);
+	EXPECT_EQ(expected, determinant) << msg;
+
+	Matrix<Element> product = m * adj;
+	for (size_t i = 0; i < d; i++)
+		for (size_t j = 0; j < d; j++)
+			if (i == j)
+				EXPECT_EQ(determinant, product(i, j)) << msg;
+			else
+				EXPECT_EQ(fastIL2nAlloc<Element>()(), product(i, j)) << msg;
+}
+
+TEST(UTMatrix, adjugate_ring) {
+	RUN_ALL_POLYS(adjugate_ring, "adjugate_ring")
+}
@@ -127,6 +127,74 @@ TEST(UTNbTheory, method_miller_rabin_primality) {
 	RUN_ALL_BACKENDS_INT(method_miller_rabin_primality, "method_miller_rabin_primality")
 }
 
+template<typename T>
+void method_miller_rabin_pseudoprimes(const string& msg) {
+	// Carmichael number
+	EXPECT_FALSE(lbcrypto::MillerRabinPrimalityTest(T("561"))) << msg;
+	// strong pseudoprime to bases 2, 3, 5 and 7
+	EXPECT_FALSE(lbcrypto::MillerRabinPrimalityTest(T("3215031751"))) << msg;
+	// strong pseudoprime to all prime bases up to 37
+	EXPECT_FALSE(lbcrypto::MillerRabinPrimalityTest(T("318665857834031151167461"))) << msg;
+	// strong pseudoprime to all prime bases up to 23
+	EXPECT_FALSE(lbcrypto::MillerRabinPrimalityTest(T("3825123056546413051"))) << msg;
+	EXPECT_FALSE(lbcrypto::MillerRabinPrimalityTest(T("18446744073709551615"))) << msg;
+
+	EXPECT_TRUE(lbcrypto::MillerRabinPrimalityTest(T("2305843009213693951"))) << msg;
+	// largest prime below 2^64
+	EXPECT_TRUE(lbcrypto::MillerRabinPrimalityTest(T("18446744073709551557"))) << msg;
+}
+
+TEST(UTNbTheory, method_miller_rabin_pseudoprimes) {
+	RUN_BIG_BACKENDS_INT(method_miller_rabin_pseudoprimes, "method_miller_rabin_pseudoprimes")
+}
+
+TEST(UTNbTheory, native_prime_search) {
+	EXPECT_TRUE(IsPrime64(18446744073709551557ULL));
+	EXPECT_FALSE(IsPrime64(3825123056546413051ULL));
+
+	// the search runs in batches; the first prime must win over later ones in the batch
+	uint64_t m = 1 << 17;
+	uint64_t q = FirstPrime<NativeInteger>(50, m).ConvertToInt();
+	for (usint i = 0; i < 10; i++) {
+		uint64_t next = NextPrime64(q, m);
+		for (uint64_t c = q + m; c < next; c += m)
+			EXPECT_FALSE(IsPrime64(c)) << c;
+		EXPECT_TRUE(IsPrime64(next));
+		EXPECT_EQ(q, PreviousPrime64(next, m));
+		q = next;
+	}
+
+	// no prime lies above the largest 64-bit prime, and none of the form 7 - 6k above 1
+	EXPECT_EQ(0ULL, NextPrime64(18446744073709551557ULL, 2));
+	EXPECT_EQ(0ULL, PreviousPrime64(7, 6));
+}
+
+template<typename T>
+void method_root_of_unity_is_smallest(const string& msg) {
+	usint m = 32;
+	T q("17729");
+	T root = lbcrypto::RootOfUnity<T>(m, q);
+
+	// the smallest x of order exactly m
+	T expected(0);
+	for (T x(2); x < q; x += T(1)) {
+		if (x.ModExp(T(m), q) == T(1) && x.ModExp(T(m/2), q) != T(1)) {
+			expected = x;
+			break;
+		}
+	}
+	EXPECT_EQ(expected, root) << msg;
+
+	vector<T> moduli = { T("17729"), T("8353"), T("65537") };
+	vector<T> roots = lbcrypto::RootsOfUnity<T>(m, moduli);
+	for (size_t i = 0; i < moduli.size(); i++)
+		EXPECT_EQ(lbcrypto::RootOfUnity<T>(m, moduli[i]), roots[i]) << msg;
+}
+
+TEST(UTNbTheory, method_root_of_unity_is_smallest) {
+	RUN_ALL_BACKENDS_INT(method_root_of_unity_is_smallest, "method_root_of_unity_is_smallest")
+}
+
 // TEST CASE FOR FACTORIZATION
 
 template<typename Element>
@@ -42,6 +42,7 @@
 
 #include "utils/serialize-binary.h"
 #include "utils/serialize-json.h"
+#include "utils/palisadebase64.h"
 
 using namespace std;
 using namespace lbcrypto;
@@ -101,6 +102,46 @@ TEST(UTSer,hugeint){
 	RUN_BIG_BACKENDS_INT(hugeint,"hugeint")
 }
 
+TEST(UTSer,m2_layout_test) {
+	M2Integer val("371828316732191777888912");
+	M2Vector vec(4, M2Integer(uint64_t(1)<<40));
+	vec[1] = M2Integer(12345);
+
+	// the limbs are stored as they are in memory, after the bit length and limb width of the build
+	uint32_t layout[2] = { BigIntegerBitLength, 8*sizeof(integral_dtype) };
+	const string header((const char *)layout, sizeof(layout));
+	auto otherBuild = [&header](const string& good) {
+		string bad = good;
+		size_t at = bad.rfind(header);
+		EXPECT_NE(at, string::npos);
+		if( at != string::npos )
+			bad[at] ^= 1;
+		return bad;
+	};
+
+	stringstream s;
+	Serial::Serialize(val, s, SerType::BINARY);
+	stringstream s1(otherBuild(s.str()));
+	M2Integer valDeser;
+	EXPECT_THROW(Serial::Deserialize(valDeser, s1, SerType::BINARY), deserialize_error) << "integer from another bit length";
+
+	s.str("");
+	Serial::Serialize(vec, s, SerType::BINARY);
+	stringstream s2(otherBuild(s.str()));
+	M2Vector vecDeser;
+	EXPECT_THROW(Serial::Deserialize(vecDeser, s2, SerType::BINARY), deserialize_error) << "vector from another bit length";
+
+	s.str("");
+	Serial::Serialize(val, s, SerType::JSON);
+	string json = s.str();
+	const string bits = "\"b\": " + std::to_string(BigIntegerBitLength);
+	size_t at = json.find(bits);
+	ASSERT_NE(at, string::npos);
+	json.replace(at, bits.size(), "\"b\": " + std::to_string(BigIntegerBitLength + 64));
+	stringstream s3(json);
+	EXPECT_THROW(Serial::Deserialize(valDeser, s3, SerType::JSON), deserialize_error) << "json integer from another bit length";
+}
+
 template<typename V>
 void vector_of_bigint(const string& msg) {
 	DEBUG_FLAG(false);
@@ -243,6 +284,147 @@ TEST(UTSer,ildcrtpoly_test) {
 	RUN_BIG_DCRTPOLYS(ildcrtpoly_test, "ildcrtpoly_test")
 }
 
+template<typename Element>
+void ildcrtpoly_compact_test(const string& msg) {
+	auto p = GenerateDCRTParams<typename Element::Integer>(1024, 5, 30);
+	typename Element::DugType dug;
+	Element vec(dug, p);
+
+	stringstream binary;
+	Serial::Serialize(vec, binary, SerType::BINARY);
+
+	stringstream compact;
+	Serial::Serialize(vec, compact, SerType::COMPACT);
+	EXPECT_LT(compact.str().size(), binary.str().size()/2 + 1024) << msg << " towers are not packed";
+
+	Element deser;
+	Serial::Deserialize(deser, compact, SerType::COMPACT);
+	EXPECT_EQ(vec, deser) << msg << " compact ser/deser fails";
+
+	// dropped bits only apply to ciphertext elements
+	compact.str("");
+	Serial::Serialize(vec, compact, SerType::SERCOMPACT(8));
+	Serial::Deserialize(deser, compact, SerType::COMPACT);
+	EXPECT_EQ(vec, deser) << msg << " compact ser/deser outside a ciphertext is lossy";
+}
+
+TEST(UTSer,ildcrtpoly_compact_test) {
+	RUN_BIG_DCRTPOLYS(ildcrtpoly_compact_test, "ildcrtpoly_compact_test")
+}
+
+TEST(UTSer,nativevector_compact_test) {
+	// moduli of the width extremes, and lengths that do not fill the last word
+	for( uint64_t q : { (uint64_t)2, (uint64_t)7681, ((uint64_t)1<<40) + 1, ((uint64_t)1<<59) - 55 } ) {
+		for( usint n : { 1, 3, 100, 1024 } ) {
+			NativeVector vec(n, q);
+			for( usint i = 0; i < n; i++ )
+				vec[i] = ((uint64_t)i * 0x9e3779b97f4a7c15ULL) % q;
+			vec[0] = q - 1;
+
+			stringstream s;
+			NativeVector deser;
+			Serial::Serialize(vec, s, SerType::COMPACT);
+			Serial::Deserialize(deser, s, SerType::COMPACT);
+			EXPECT_EQ(vec, deser) << "modulus " << q << " length " << n;
+
+			// COMPACT reads plain binary streams too
+			s.str("");
+			Serial::Serialize(vec, s, SerType::BINARY);
+			Serial::Deserialize(deser, s, SerType::COMPACT);
+			EXPECT_EQ(vec, deser) << "modulus " << q << " length " << n;
+		}
+	}
+}
+
+TEST(UTSer,base64_test) {
+	// the RFC 4648 test vectors
+	const char *plain[] = { "", "f", "fo", "foo", "foob", "fooba", "foobar" };
+	const char *encoded[] = { "", "Zg==", "Zm8=", "Zm9v", "Zm9vYg==", "Zm9vYmE=", "Zm9vYmFy" };
+	for( size_t i = 0; i < 7; i++ ) {
+		string p(plain[i]);
+		EXPECT_EQ(encoded[i], Base64Encode(reinterpret_cast<const uint8_t *>(p.data()), p.size()));
+
+		vector<uint8_t> decoded;
+		EXPECT_TRUE(Base64Decode(encoded[i], &decoded));
+		EXPECT_EQ(p, string(decoded.begin(), decoded.end()));
+	}
+
+	vector<uint8_t> decoded;
+	EXPECT_FALSE(Base64Decode("Zm9", &decoded)) << "unpadded text decoded";
+	EXPECT_FALSE(Base64Decode("Zm9v!A==", &decoded)) << "invalid character decoded";
+	EXPECT_FALSE(Base64Decode("Zg==Zm9v", &decoded)) << "padding inside the text decoded";
+}
+
+TEST(UTSer,nativevector_jsoncompact_test) {
+	for( uint64_t q : { (uint64_t)2, (uint64_t)7681, ((uint64_t)1<<40) + 1, ((uint64_t)1<<59) - 55 } ) {
+		for( usint n : { 1, 3, 100, 1024 } ) {
+			NativeVector vec(n, q);
+			for( usint i = 0; i < n; i++ )
+				vec[i] = ((uint64_t)i * 0x9e3779b97f4a7c15ULL) % q;
+			vec[0] = q - 1;
+
+			stringstream json, s;
+			NativeVector deser;
+			Serial::Serialize(vec, json, SerType::JSON);
+			Serial::Serialize(vec, s, SerType::JSONCOMPACT);
+			if( n >= 100 ) {
+				EXPECT_LT(s.str().size(), json.str().size()/2) << "modulus " << q << " length " << n;
+			}
+			Serial::Deserialize(deser, s, SerType::JSONCOMPACT);
+			EXPECT_EQ(vec, deser) << "modulus " << q << " length " << n;
+
+			// JSON reads JSONCOMPACT streams, and the other way round
+			s.seekg(0);
+			Serial::Deserialize(deser, s, SerType::JSON);
+			EXPECT_EQ(vec, deser) << "modulus " << q << " length " << n;
+			Serial::Deserialize(deser, json, SerType::JSONCOMPACT);
+			EXPECT_EQ(vec, deser) << "modulus " << q << " length " << n;
+		}
+	}
+
+	// the structure around the vectors is still JSON
+	auto p = GenerateDCRTParams<BigInteger>(1024, 3, 30);
+	DCRTPoly::DugType dug;
+	DCRTPoly poly(dug, p);
+	stringstream s;
+	Serial::Serialize(poly, s, SerType::JSONCOMPACT);
+	EXPECT_NE(s.str().find("\"b\""), string::npos);
+	DCRTPoly deser;
+	Serial::Deserialize(deser, s, SerType::JSONCOMPACT);
+	EXPECT_EQ(poly, deser) << "dcrtpoly json compact ser/deser fails";
+}
+
+TEST(UTSer,nativevector_compact_corrupt_test) {
+	uint64_t q = 7681;
+	NativeVector vec(5, q);
+	for( usint i = 0; i < 5; i++ )
+		vec[i] = q - 1 - i;
+
+	stringstream s;
+	Serial::Serialize(vec, s, SerType::COMPACT);
+	const string good = s.str();
+
+	// the length, then the packed width and dropped bits, then the packed words
+	const string header = string("\x05\0\0\0\0\0\0\0", 8) + string("\x0d\0", 2);
+	size_t at = good.find(header);
+	ASSERT_NE(at, string::npos);
+	size_t width = at + 8;
+	size_t words = at + header.size();
+
+	NativeVector deser;
+	string bad = good;
+	bad[width] = 64;
+	stringstream s1(bad);
+	EXPECT_THROW(Serial::Deserialize(deser, s1, SerType::COMPACT), deserialize_error) << "64-bit packed width";
+
+	// 13-bit fields of all ones decode to 8191, which is not reduced modulo 7681
+	bad = good;
+	for( size_t i = words; i < words + 16; i++ )
+		bad[i] = (char)0xff;
+	stringstream s2(bad);
+	EXPECT_THROW(Serial::Deserialize(deser, s2, SerType::COMPACT), deserialize_error) << "unreduced entry";
+}
+
 ////////////////////////////////////////////////////////////
 template<typename V>
 void serialize_matrix_bigint(const string& msg) {
@@ -34,6 +34,7 @@
 #include "math/backend.h"
 #include "../lib/math/transfrm.h"
 #include "../lib/math/transfrm.cpp"
+#include "../lib/math/transfrm32.h"
 #include "utils/inttypes.h"
 #include "lattice/ilparams.h"
 #include "lattice/ildcrtparams.h"
@@ -92,6 +93,86 @@ TEST(UTTransform, CRT_polynomial_mult) {
 	RUN_ALL_BACKENDS(CRT_polynomial_mult, "CRT_polynomial_mult")
 }
 
+// the native transform and vector product run in kernels specialized by the size of the modulus;
+// one modulus of each class is checked against a schoolbook negacyclic product
+TEST(UTTransform, CRT_polynomial_mult_native_modulus_classes) {
+	usint cycloOrder = 128;
+	usint n = cycloOrder / 2;
+	std::mt19937_64 gen(3);
+
+	for (usint bits : { 30, 50, 60, 62 }) {
+		NativeInteger modulus = FirstPrime<NativeInteger>(bits, cycloOrder);
+		NativeInteger root = RootOfUnity<NativeInteger>(cycloOrder, modulus);
+		uint64_t q = modulus.ConvertToInt();
+
+		NativeVector a(n, modulus), b(n, modulus);
+		for (usint i = 0; i < n; i++) {
+			a[i] = gen() % q;
+			b[i] = gen() % q;
+		}
+
+		NativeVector expected(n, modulus);
+		for (usint i = 0; i < n; i++) {
+			for (usint j = 0; j < n; j++) {
+				NativeInteger prod((uint64_t)(DoubleNativeInt(a[i].ConvertToInt()) * b[j].ConvertToInt() % q));
+				if (i + j < n)
+					expected[i + j].ModAddFastEq(prod, modulus);
+				else
+					expected[i + j - n].ModSubFastEq(prod, modulus);
+			}
+		}
+
+		NativeVector A(n), B(n), c(n);
+		ChineseRemainderTransformFTT<NativeVector>::ForwardTransform(a, root, cycloOrder, &A);
+		ChineseRemainderTransformFTT<NativeVector>::ForwardTransform(b, root, cycloOrder, &B);
+		ChineseRemainderTransformFTT<NativeVector>::InverseTransform(A*B, root, cycloOrder, &c);
+
+		EXPECT_EQ(expected, c) << bits << "-bit modulus";
+	}
+}
+
+// the transform of the 32-bit tower type gives the same values as the native transform
+TEST(UTTransform, CRT_FTT_native_vector32) {
+	usint cycloOrder = 2048;
+	usint n = cycloOrder / 2;
+	std::mt19937_64 gen(11);
+
+	for (usint bits : { 20, 29, 30 }) {
+		NativeInteger modulus = FirstPrime<NativeInteger>(bits, cycloOrder);
+		NativeInteger root = RootOfUnity<NativeInteger>(cycloOrder, modulus);
+
+		NativeVector x(n, modulus);
+		for (usint i = 0; i < n; i++)
+			x[i] = gen() % modulus.ConvertToInt();
+
+		NativeVector X(n);
+		ChineseRemainderTransformFTT<NativeVector>::ForwardTransform(x, root, cycloOrder, &X);
+
+		NativeVector32 x32(x), X32(n, modulus), xx32(n, modulus);
+		ChineseRemainderTransformFTT32::ForwardTransform(x32, root, cycloOrder, &X32);
+		EXPECT_EQ(X, X32.ToNativeVector()) << bits << "-bit modulus";
+
+		ChineseRemainderTransformFTT32::InverseTransform(X32, root, cycloOrder, &xx32);
+		EXPECT_EQ(x32, xx32) << bits << "-bit modulus";
+
+		// another root for the same modulus and ring dimension gets its own tables, also when the
+		// transforms run at the same time
+		NativeInteger root3 = root.ModExp(3, modulus);
+		NativeVector X3(n);
+		ChineseRemainderTransformFTT<NativeVector>::ForwardTransform(x, root3, cycloOrder, &X3);
+		vector<NativeVector32> Y32(8, NativeVector32(n, modulus));
+#pragma omp parallel for
+		for (usint i = 0; i < Y32.size(); i++)
+			ChineseRemainderTransformFTT32::ForwardTransform(x32, i % 2 ? root3 : root, cycloOrder, &Y32[i]);
+		for (usint i = 0; i < Y32.size(); i++)
+			EXPECT_EQ(i % 2 ? X3 : X, Y32[i].ToNativeVector()) << bits << "-bit modulus, transform " << i;
+
+		// in place
+		ChineseRemainderTransformFTT32::ForwardTransform(x32, root, cycloOrder, &x32);
+		EXPECT_EQ(X32, x32) << bits << "-bit modulus";
+	}
+}
+
 // TEST CASE TO TEST POLYNOMIAL MULTIPLICATION IN ARBITRARY CYCLOTOMIC FILED USING CHINESE REMAINDER THEOREM
 
 template<typename V>
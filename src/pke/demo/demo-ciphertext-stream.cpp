@@ -0,0 +1,95 @@
+/*
+ * @file demo-ciphertext-stream.cpp - writes an encrypted dataset to a ciphertext stream and reads it back
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or other
+ * materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <cstdio>
+#include <iostream>
+
+#include "palisade.h"
+#include "ciphertextstream.h"
+#include "utils/debug.h"
+
+using namespace std;
+using namespace lbcrypto;
+
+int main(int argc, char *argv[])
+{
+	size_t count = 1000;
+	if( argc > 1 )
+		count = atoi(argv[1]);
+	const string filename = "demo-ciphertext-stream.bin";
+
+	CryptoContext<DCRTPoly> cc = CryptoContextFactory<DCRTPoly>::genCryptoContextBFVrns(
+			65537, HEStd_128_classic, 3.2, 0, 2, 0, OPTIMIZED);
+	cc->Enable(ENCRYPTION);
+	cc->Enable(SHE);
+
+	LPKeyPair<DCRTPoly> kp = cc->KeyGen();
+
+	cout << "Encrypting and writing " << count << " ciphertexts to " << filename << endl;
+	TimeVar t;
+	double timeWrite = 0;
+	{
+		CiphertextStreamWriter<DCRTPoly> writer(cc, filename);
+		for( size_t i = 0; i < count; i++ ) {
+			vector<int64_t> row = { int64_t(i), int64_t(i % 7), int64_t(i % 13) };
+			auto ct = cc->Encrypt(kp.publicKey, cc->MakePackedPlaintext(row));
+			TIC(t);
+			writer.Write(ct);
+			timeWrite += TOC_US(t);
+		}
+		TIC(t);
+		writer.Close();
+		timeWrite += TOC_US(t);
+	}
+	cout << "Write time: " << timeWrite/1000 << " ms" << endl;
+
+	// read the whole dataset in order, summing it homomorphically; the prefetch thread reads
+	// frames ahead while the ciphertexts are decoded, and ct is decoded in place each time
+	CiphertextStreamReader<DCRTPoly> reader(cc, filename, 8);
+	Ciphertext<DCRTPoly> ct, sum;
+	double timeRead = 0;
+	TIC(t);
+	while( reader.Read(ct) ) {
+		timeRead += TOC_US(t);
+		sum = sum ? cc->EvalAdd(sum, ct) : ct;
+		TIC(t);
+	}
+	cout << "Sequential read time: " << timeRead/1000 << " ms for " << reader.GetCount() << " ciphertexts" << endl;
+
+	Plaintext result;
+	cc->Decrypt(kp.secretKey, sum, &result);
+	result->SetLength(3);
+	cout << "Sum of all rows: " << result << endl;
+
+	// random access through the index
+	size_t middle = count/2;
+	cc->Decrypt(kp.secretKey, reader.ReadAt(middle), &result);
+	result->SetLength(3);
+	cout << "Row " << middle << ": " << result << endl;
+
+	std::remove(filename.c_str());
+	return 0;
+}
@@ -338,6 +338,27 @@ bool LPAlgorithmParamsGenBFV<Element>::ParamsGen(shared_ptr<LPCryptoParameters<E
 //makeSparse is not used by this scheme
 template <class Element>
 LPKeyPair<Element> LPAlgorithmBFV<Element>::KeyGen(CryptoContext<Element> cc, bool makeSparse)
+{
+	typename Element::DugType dug;
+
+	//Generate the element "a" of the public key
+	return GenerateKeyPair(cc, Element(dug, cc->GetCryptoParameters()->GetElementParams(), Format::EVALUATION));
+}
+
+template <class Element>
+LPKeyPair<Element> LPAlgorithmBFV<Element>::KeyGenSeeded(CryptoContext<Element> cc)
+{
+	std::vector<uint8_t> seed = ElementSeed::Generate();
+
+	//The element "a" of the public key is expanded from the seed
+	LPKeyPair<Element> kp = GenerateKeyPair(cc, ElementSeed::Expand<Element>(seed, cc->GetCryptoParameters()->GetElementParams()));
+	kp.publicKey->SetSeed(seed);
+
+	return kp;
+}
+
+template <class Element>
+LPKeyPair<Element> LPAlgorithmBFV<Element>::GenerateKeyPair(CryptoContext<Element> cc, Element a) const
 {
 
 	LPKeyPair<Element>	kp( new LPPublicKeyImpl<Element>(cc), new LPPrivateKeyImpl<Element>(cc) );
@@ -347,12 +368,8 @@ LPKeyPair<Element> LPAlgorithmBFV<Element>::KeyGen(CryptoContext<Element> cc, bo
 	const shared_ptr<typename Element::Params> elementParams = cryptoParams->GetElementParams();
 
 	const typename Element::DggType &dgg = cryptoParams->GetDiscreteGaussianGenerator();
-	typename Element::DugType dug;
 	typename Element::TugType tug;
 
-	//Generate the element "a" of the public key
-	Element a(dug, elementParams, Format::EVALUATION);
-
 	//Generate the secret key
 	Element s;
 
@@ -455,6 +472,36 @@ Ciphertext<Element> LPAlgorithmBFV<Element>::Encrypt(const LPPrivateKey<Element>
 	return ciphertext;
 }
 
+template <class Element>
+Ciphertext<Element> LPAlgorithmBFV<Element>::EncryptSeeded(const LPPrivateKey<Element> privateKey,
+		Element ptxt) const
+{
+	Ciphertext<Element> ciphertext( new CiphertextImpl<Element>(privateKey) );
+
+	const shared_ptr<LPCryptoParametersBFV<Element>> cryptoParams = std::dynamic_pointer_cast<LPCryptoParametersBFV<Element>>(privateKey->GetCryptoParameters());
+
+	const shared_ptr<typename Element::Params> elementParams = cryptoParams->GetElementParams();
+
+	ptxt.SwitchFormat();
+
+	const typename Element::DggType &dgg = cryptoParams->GetDiscreteGaussianGenerator();
+	const typename Element::Integer &delta = cryptoParams->GetDelta();
+
+	// c1 = -a is expanded from the seed, and c0 = a*s + e + delta*m
+	std::vector<uint8_t> seed = ElementSeed::Generate();
+	Element c1 = ElementSeed::Expand<Element>(seed, elementParams);
+	const Element &s = privateKey->GetPrivateElement();
+	Element e(dgg, elementParams, Format::EVALUATION);
+
+	Element c0(e + delta*ptxt);
+	c0 -= c1*s;
+
+	ciphertext->SetElements({ c0, c1 });
+	ciphertext->SetSeed(seed);
+
+	return ciphertext;
+}
+
 template <class Element>
 DecryptResult LPAlgorithmBFV<Element>::Decrypt(const LPPrivateKey<Element> privateKey,
 		ConstCiphertext<Element> ciphertext,
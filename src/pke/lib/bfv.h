@@ -414,6 +414,30 @@ namespace lbcrypto {
 		* @return key pair including the private and public key
 		*/
 		LPKeyPair<Element> KeyGen(CryptoContext<Element> cc, bool makeSparse=false);
+
+		/**
+		* Method for encrypting plaintext with private key into a seeded ciphertext using BFV.
+		*
+		* @param privateKey private key used for encryption.
+		* @param plaintext the plaintext input.
+		* @return ciphertext whose second element is expanded from its seed.
+		*/
+		virtual Ciphertext<Element> EncryptSeeded(const LPPrivateKey<Element> privateKey,
+				Element plaintext) const;
+
+		/**
+		* Function to generate a key pair whose public key element "a" is expanded from a seed.
+		*
+		* @param cc cryptocontext for the keys to be generated.
+		* @return key pair including the private and public key
+		*/
+		LPKeyPair<Element> KeyGenSeeded(CryptoContext<Element> cc);
+
+	private:
+		/**
+		* Generates a key pair for a given uniformly random public key element "a"
+		*/
+		LPKeyPair<Element> GenerateKeyPair(CryptoContext<Element> cc, Element a) const;
 	};
 
 	/**
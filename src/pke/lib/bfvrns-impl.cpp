@@ -26,6 +26,7 @@
 
 #include "cryptocontext.h"
 #include "bfvrns.cpp"
+#include "utils/precomputecache.h"
 
 namespace lbcrypto {
 
@@ -120,6 +121,16 @@ bool LPCryptoParametersBFVrns<NativePoly>::PrecomputeCRTTables(){
 	NONATIVEPOLY
 }
 
+template <>
+std::string LPCryptoParametersBFVrns<Poly>::GetCRTTablesKey() const {
+	NOPOLY
+}
+
+template <>
+std::string LPCryptoParametersBFVrns<NativePoly>::GetCRTTablesKey() const {
+	NONATIVEPOLY
+}
+
 template <>
 LPPublicKeyEncryptionSchemeBFVrns<Poly>::LPPublicKeyEncryptionSchemeBFVrns(){
 	NOPOLY
@@ -188,6 +199,34 @@ Ciphertext<NativePoly> LPAlgorithmBFVrns<NativePoly>::Encrypt(const LPPrivateKey
 	NONATIVEPOLY
 }
 
+template <>
+Ciphertext<Poly> LPAlgorithmBFVrns<Poly>::EncryptSeeded(const LPPrivateKey<Poly> privateKey,
+		Poly ptxt) const
+{
+	NOPOLY
+}
+
+template <>
+Ciphertext<NativePoly> LPAlgorithmBFVrns<NativePoly>::EncryptSeeded(const LPPrivateKey<NativePoly> privateKey,
+		NativePoly ptxt) const
+{
+	NONATIVEPOLY
+}
+
+template <>
+Ciphertext<Poly> LPAlgorithmBFVrns<Poly>::EncryptPacked(const LPPublicKey<Poly> publicKey,
+		const NativeVector &coefficients) const
+{
+	NOPOLY
+}
+
+template <>
+Ciphertext<NativePoly> LPAlgorithmBFVrns<NativePoly>::EncryptPacked(const LPPublicKey<NativePoly> publicKey,
+		const NativeVector &coefficients) const
+{
+	NONATIVEPOLY
+}
+
 template <>
 Ciphertext<Poly> LPAlgorithmSHEBFVrns<Poly>::EvalMult(ConstCiphertext<Poly> ciphertext1,
 	ConstCiphertext<Poly> ciphertext2) const {
@@ -291,6 +330,17 @@ template class LPAlgorithmParamsGenBFVrns<NativePoly>;
 #undef NOPOLY
 #undef NONATIVEPOLY
 
+template <>
+std::string LPCryptoParametersBFVrns<DCRTPoly>::GetCRTTablesKey() const {
+	vector<NativeInteger> moduli;
+	vector<NativeInteger> roots;
+	for (const auto& p : GetElementParams()->GetParams()) {
+		moduli.push_back(p->GetModulus());
+		roots.push_back(p->GetRootOfUnity());
+	}
+	return PrecomputeCache::MakeKey(SerializedObjectName(), GetElementParams()->GetCyclotomicOrder(), moduli, roots, GetPlaintextModulus());
+}
+
 // Precomputation of CRT tables encryption, decryption, and homomorphic multiplication
 template <>
 bool LPCryptoParametersBFVrns<DCRTPoly>::PrecomputeCRTTables(){
@@ -307,6 +357,35 @@ bool LPCryptoParametersBFVrns<DCRTPoly>::PrecomputeCRTTables(){
 		roots[i] = GetElementParams()->GetParams()[i]->GetRootOfUnity();
 	}
 
+	// use the tables stored by an earlier process with the same parameters, if there are any
+
+	const std::string cacheKey = PrecomputeCache::Enabled() ? GetCRTTablesKey() : std::string();
+	PrecomputeTableReader cached;
+	if (!cacheKey.empty() && PrecomputeCache::Load(cacheKey, &cached)) {
+		try {
+			vector<NativeInteger> moduliS;
+			vector<NativeInteger> rootsS;
+			cached(moduliS);
+			cached(rootsS);
+			PrecomputeCache::ReadNTTTables(cached, 2 * n);
+			TransferCRTTables(cached);
+
+			if (cached.AtEnd() && moduliS.size() == size + 1 && rootsS.size() == size + 1) {
+				vector<NativeInteger> moduliExpanded(moduli);
+				vector<NativeInteger> rootsExpanded(roots);
+				moduliExpanded.insert(moduliExpanded.end(), moduliS.begin(), moduliS.end());
+				rootsExpanded.insert(rootsExpanded.end(), rootsS.begin(), rootsS.end());
+
+				m_paramsS = shared_ptr<ILDCRTParams<BigInteger>>(new ILDCRTParams<BigInteger>(2 * n, moduliS, rootsS));
+				m_paramsQS = shared_ptr<ILDCRTParams<BigInteger>>(new ILDCRTParams<BigInteger>(2 * n, moduliExpanded, rootsExpanded));
+				return true;
+			}
+		}
+		catch (deserialize_error&) {
+			// computed again below
+		}
+	}
+
 	ChineseRemainderTransformFTT<NativeVector>::PreCompute(roots,2*n,moduli);
 
 	// computes the auxiliary CRT basis S=s1*s2*..sn used in homomorphic multiplication
@@ -314,17 +393,16 @@ bool LPCryptoParametersBFVrns<DCRTPoly>::PrecomputeCRTTables(){
 	size_t sizeS = size + 1;
 
 	vector<NativeInteger> moduliS(sizeS);
-	vector<NativeInteger> rootsS(sizeS);
 
 	moduliS[0] = NextPrime<NativeInteger>(moduli[size-1], 2 * n);
-	rootsS[0] = RootOfUnity<NativeInteger>(2 * n, moduliS[0]);
 
 	for (size_t i = 1; i < sizeS; i++)
 	{
 		moduliS[i] = NextPrime<NativeInteger>(moduliS[i-1], 2 * n);
-		rootsS[i] = RootOfUnity<NativeInteger>(2 * n, moduliS[i]);
 	}
 
+	vector<NativeInteger> rootsS = RootsOfUnity<NativeInteger>(2 * n, moduliS);
+
 	m_paramsS = shared_ptr<ILDCRTParams<BigInteger>>(new ILDCRTParams<BigInteger>(2 * n, moduliS, rootsS));
 
 	ChineseRemainderTransformFTT<NativeVector>::PreCompute(rootsS,2*n,moduliS);
@@ -556,6 +634,15 @@ bool LPCryptoParametersBFVrns<DCRTPoly>::PrecomputeCRTTables(){
 
 	m_CRTsModqiTable = sModqi;
 
+	if (!cacheKey.empty()) {
+		PrecomputeTableWriter tables;
+		tables(moduliS);
+		tables(rootsS);
+		PrecomputeCache::WriteNTTTables(tables, 2 * n, moduliExpanded, rootsExpanded);
+		TransferCRTTables(tables);
+		PrecomputeCache::Store(cacheKey, tables);
+	}
+
 	return true;
 
 }
@@ -774,20 +861,20 @@ bool LPAlgorithmParamsGenBFVrns<DCRTPoly>::ParamsGen(shared_ptr<LPCryptoParamete
 	size_t size = ext_double::to_long(ext_double::ceil((ext_double::ceil(ext_double::log(q)/(ExtendedDouble)log(2)) + ExtendedDouble(1.0)) / (ExtendedDouble)dcrtBits));
 
 	vector<NativeInteger> moduli(size);
-	vector<NativeInteger> roots(size);
 
 	//makes sure the first integer is less than 2^60-1 to take advantage of NTL optimizations
 	NativeInteger firstInteger = FirstPrime<NativeInteger>(dcrtBits, 2 * n);
 	firstInteger -= (int64_t)(2*n)*((int64_t)(1)<<(dcrtBits/3));
 	moduli[0] = NextPrime<NativeInteger>(firstInteger, 2 * n);
-	roots[0] = RootOfUnity<NativeInteger>(2 * n, moduli[0]);
 
 	for (size_t i = 1; i < size; i++)
 	{
 		moduli[i] = NextPrime<NativeInteger>(moduli[i-1], 2 * n);
-		roots[i] = RootOfUnity<NativeInteger>(2 * n, moduli[i]);
 	}
 
+	// the roots of unity are independent of each other and are found in parallel
+	vector<NativeInteger> roots = RootsOfUnity<NativeInteger>(2 * n, moduli);
+
 	shared_ptr<ILDCRTParams<BigInteger>> params(new ILDCRTParams<BigInteger>(2 * n, moduli, roots));
 
 	ChineseRemainderTransformFTT<NativeVector>::PreCompute(roots,2*n,moduli);
@@ -841,6 +928,98 @@ Ciphertext<DCRTPoly> LPAlgorithmBFVrns<DCRTPoly>::Encrypt(const LPPublicKey<DCRT
 	return ciphertext;
 }
 
+template <>
+Ciphertext<DCRTPoly> LPAlgorithmBFVrns<DCRTPoly>::EncryptPacked(const LPPublicKey<DCRTPoly> publicKey,
+		const NativeVector &coefficients) const
+{
+	Ciphertext<DCRTPoly> ciphertext( new CiphertextImpl<DCRTPoly>(publicKey) );
+
+	const shared_ptr<LPCryptoParametersBFVrns<DCRTPoly>> cryptoParams = std::dynamic_pointer_cast<LPCryptoParametersBFVrns<DCRTPoly>>(publicKey->GetCryptoParameters());
+
+	const shared_ptr<typename DCRTPoly::Params> elementParams = cryptoParams->GetElementParams();
+	const std::vector<std::shared_ptr<ILNativeParams>> &towerParams = elementParams->GetParams();
+
+	const usint n = elementParams->GetRingDimension();
+	if( coefficients.GetLength() != n )
+		PALISADE_THROW(math_error, "EncryptPacked expects " + std::to_string(n) + " plaintext coefficients");
+
+	const std::vector<NativeInteger> &deltaTable = cryptoParams->GetCRTDeltaTable();
+
+	const typename DCRTPoly::DggType &dgg = cryptoParams->GetDiscreteGaussianGenerator();
+	typename DCRTPoly::TugType tug;
+
+	const DCRTPoly &p0 = publicKey->GetPublicElements().at(0);
+	const DCRTPoly &p1 = publicKey->GetPublicElements().at(1);
+
+	DCRTPoly u;
+
+	//Supports both discrete Gaussian (RLWE) and ternary uniform distribution (OPTIMIZED) cases
+	if (cryptoParams->GetMode() == RLWE)
+		u = DCRTPoly(dgg, elementParams, Format::EVALUATION);
+	else
+		u = DCRTPoly(tug, elementParams, Format::EVALUATION);
+
+	// the noise of c0 is added to delta*m before the transform, which saves one NTT per tower
+	DCRTPoly e0(dgg, elementParams, Format::COEFFICIENT);
+	DCRTPoly e1(dgg, elementParams, Format::EVALUATION);
+
+	// the towers are filled in below
+	DCRTPoly c0(elementParams, Format::EVALUATION, false);
+	DCRTPoly c1(elementParams, Format::EVALUATION, false);
+
+	const NativeInteger p = cryptoParams->GetPlaintextModulus();
+	const NativeInteger half = p >> 1;
+
+#pragma omp parallel for
+	for( usint k = 0; k < towerParams.size(); k++ ) {
+		const NativeInteger &qk = towerParams[k]->GetModulus();
+		const NativeInteger shift = qk - p;
+		const NativeInteger &delta = deltaTable[k];
+		const NativeInteger deltaPrecon = delta.PrepModMulPreconOptimized(qk);
+		const NativeInteger mu = qk.ComputeMu();
+
+		// lift the coefficients, centered at p/2, scale them by delta and add the noise
+		const NativeVector &e0k = e0.GetElementAtIndex(k).GetValues();
+		NativeVector scaled(n, qk);
+		for( usint i = 0; i < n; i++ ) {
+			const NativeInteger &c = coefficients[i];
+			scaled[i] = (c > half ? c + shift : c).ModMulPreconOptimized(delta, qk, deltaPrecon);
+			scaled[i].ModAddFastEq(e0k[i], qk);
+		}
+
+		NativePoly m(towerParams[k], Format::COEFFICIENT);
+		m.SetValues(std::move(scaled), Format::COEFFICIENT);
+		m.SwitchFormat();
+
+		const NativeVector &mk = m.GetValues();
+		const NativeVector &p0k = p0.GetElementAtIndex(k).GetValues();
+		const NativeVector &p1k = p1.GetElementAtIndex(k).GetValues();
+		const NativeVector &uk = u.GetElementAtIndex(k).GetValues();
+		const NativeVector &e1k = e1.GetElementAtIndex(k).GetValues();
+
+		NativeVector c0k(n, qk);
+		NativeVector c1k(n, qk);
+		for( usint i = 0; i < n; i++ ) {
+			c0k[i] = p0k[i].ModMulFastOptimized(uk[i], qk, mu);
+			c0k[i].ModAddFastEq(mk[i], qk);
+			c1k[i] = p1k[i].ModMulFastOptimized(uk[i], qk, mu);
+			c1k[i].ModAddFastEq(e1k[i], qk);
+		}
+
+		c0.ElementAtIndex(k).SetValues(std::move(c0k), Format::EVALUATION);
+		c1.ElementAtIndex(k).SetValues(std::move(c1k), Format::EVALUATION);
+	}
+
+	// an initializer list would copy both elements
+	std::vector<DCRTPoly> elements;
+	elements.reserve(2);
+	elements.push_back(std::move(c0));
+	elements.push_back(std::move(c1));
+	ciphertext->SetElements(std::move(elements));
+
+	return ciphertext;
+}
+
 template <>
 DecryptResult LPAlgorithmBFVrns<DCRTPoly>::Decrypt(const LPPrivateKey<DCRTPoly> privateKey,
 		ConstCiphertext<DCRTPoly> ciphertext,
@@ -924,6 +1103,38 @@ Ciphertext<DCRTPoly> LPAlgorithmBFVrns<DCRTPoly>::Encrypt(const LPPrivateKey<DCR
 	return ciphertext;
 }
 
+template <>
+Ciphertext<DCRTPoly> LPAlgorithmBFVrns<DCRTPoly>::EncryptSeeded(const LPPrivateKey<DCRTPoly> privateKey,
+		DCRTPoly ptxt) const
+{
+	Ciphertext<DCRTPoly> ciphertext( new CiphertextImpl<DCRTPoly>(privateKey) );
+
+	const shared_ptr<LPCryptoParametersBFVrns<DCRTPoly>> cryptoParams =
+			std::dynamic_pointer_cast<LPCryptoParametersBFVrns<DCRTPoly>>(privateKey->GetCryptoParameters());
+
+	const shared_ptr<typename DCRTPoly::Params> elementParams = cryptoParams->GetElementParams();
+
+	ptxt.SwitchFormat();
+
+	const typename DCRTPoly::DggType &dgg = cryptoParams->GetDiscreteGaussianGenerator();
+
+	const std::vector<NativeInteger> &deltaTable = cryptoParams->GetCRTDeltaTable();
+
+	// c1 = -a is expanded from the seed, and c0 = a*s + e + delta*m
+	std::vector<uint8_t> seed = ElementSeed::Generate();
+	DCRTPoly c1 = ElementSeed::Expand<DCRTPoly>(seed, elementParams);
+	const DCRTPoly &s = privateKey->GetPrivateElement();
+	DCRTPoly e(dgg, elementParams, Format::EVALUATION);
+
+	DCRTPoly c0(e + ptxt.Times(deltaTable));
+	c0 -= c1*s;
+
+	ciphertext->SetElements({ c0, c1 });
+	ciphertext->SetSeed(seed);
+
+	return ciphertext;
+}
+
 template <>
 Ciphertext<DCRTPoly> LPAlgorithmSHEBFVrns<DCRTPoly>::EvalAdd(ConstCiphertext<DCRTPoly> ciphertext,
 		ConstPlaintext plaintext) const{
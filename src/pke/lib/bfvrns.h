@@ -149,6 +149,13 @@ namespace lbcrypto {
 			*/
 			bool PrecomputeCRTTables();
 
+			/**
+			* Gets the key under which PrecomputeCRTTables keeps its tables in the PrecomputeCache
+			*
+			* @return the key
+			*/
+			std::string GetCRTTablesKey() const;
+
 			/**
 			* Gets Auxiliary CRT basis S=s1*s2*..sn used in homomorphic multiplication
 			*
@@ -331,6 +338,30 @@ namespace lbcrypto {
 
 		private:
 
+			// Applies a PrecomputeTableWriter or PrecomputeTableReader to every table
+			// of PrecomputeCRTTables except the auxiliary bases, in a fixed order
+			template <class Tables>
+			void TransferCRTTables(Tables &tables) {
+				tables(m_qModulimu);
+				tables(m_sModulimu);
+				tables(m_CRTDecryptionFloatTable);
+				tables(m_CRTDecryptionExtFloatTable);
+				tables(m_CRTDecryptionQuadFloatTable);
+				tables(m_CRTDecryptionIntTable);
+				tables(m_CRTDecryptionIntPreconTable);
+				tables(m_CRTDeltaTable);
+				tables(m_CRTInverseTable);
+				tables(m_CRTInversePreconTable);
+				tables(m_CRTqDivqiModsiTable);
+				tables(m_CRTqModsiTable);
+				tables(m_CRTMultIntTable);
+				tables(m_CRTMultFloatTable);
+				tables(m_CRTSInverseTable);
+				tables(m_CRTSInversePreconTable);
+				tables(m_CRTsDivsiModqiTable);
+				tables(m_CRTsModqiTable);
+			}
+
 			// Auxiliary CRT basis S=s1*s2*..sn used in homomorphic multiplication
 			shared_ptr<ILDCRTParams<BigInteger>> m_paramsS;
 
@@ -449,6 +480,18 @@ namespace lbcrypto {
 		Ciphertext<Element> Encrypt(const LPPublicKey<Element> publicKey,
 			Element plaintext) const;
 
+		/**
+		* Method for encrypting the coefficients of a packed plaintext using BFVrns, fusing the lifting of the
+		* coefficients to the towers, their scaling by delta, the NTT and the addition to the public-key
+		* products into one pass per tower.
+		*
+		* @param publicKey public key used for encryption.
+		* @param coefficients the plaintext coefficients, in [0, p).
+		* @return ciphertext which results from encryption.
+		*/
+		Ciphertext<Element> EncryptPacked(const LPPublicKey<Element> publicKey,
+			const NativeVector &coefficients) const;
+
 		/**
 		* Method for encrypting plaintext with private key using BFVrns.
 		*
@@ -460,6 +503,16 @@ namespace lbcrypto {
 		Ciphertext<Element> Encrypt(const LPPrivateKey<Element> privateKey,
 			Element plaintext) const;
 
+		/**
+		* Method for encrypting plaintext with private key into a seeded ciphertext using BFVrns.
+		*
+		* @param privateKey private key used for encryption.
+		* @param plaintext the plaintext input.
+		* @return ciphertext whose second element is expanded from its seed.
+		*/
+		Ciphertext<Element> EncryptSeeded(const LPPrivateKey<Element> privateKey,
+			Element plaintext) const;
+
 		/**
 		* Method for decrypting using BFVrns. See the class description for citations on where the algorithms were
 	 	* taken from.
@@ -26,6 +26,7 @@
 
 #include "cryptocontext.h"
 #include "bfvrnsB.cpp"
+#include "utils/precomputecache.h"
 
 //#define USE_KARATSUBA
 
@@ -122,6 +123,16 @@ bool LPCryptoParametersBFVrnsB<NativePoly>::PrecomputeCRTTables(){
 	NONATIVEPOLY
 }
 
+template <>
+std::string LPCryptoParametersBFVrnsB<Poly>::GetCRTTablesKey() const {
+	NOPOLY
+}
+
+template <>
+std::string LPCryptoParametersBFVrnsB<NativePoly>::GetCRTTablesKey() const {
+	NONATIVEPOLY
+}
+
 template <>
 LPPublicKeyEncryptionSchemeBFVrnsB<Poly>::LPPublicKeyEncryptionSchemeBFVrnsB(){
 	NOPOLY
@@ -190,6 +201,34 @@ Ciphertext<NativePoly> LPAlgorithmBFVrnsB<NativePoly>::Encrypt(const LPPrivateKe
 	NONATIVEPOLY
 }
 
+template <>
+Ciphertext<Poly> LPAlgorithmBFVrnsB<Poly>::EncryptSeeded(const LPPrivateKey<Poly> privateKey,
+		Poly ptxt) const
+{
+	NOPOLY
+}
+
+template <>
+Ciphertext<NativePoly> LPAlgorithmBFVrnsB<NativePoly>::EncryptSeeded(const LPPrivateKey<NativePoly> privateKey,
+		NativePoly ptxt) const
+{
+	NONATIVEPOLY
+}
+
+template <>
+Ciphertext<Poly> LPAlgorithmBFVrnsB<Poly>::EncryptPacked(const LPPublicKey<Poly> publicKey,
+		const NativeVector &coefficients) const
+{
+	NOPOLY
+}
+
+template <>
+Ciphertext<NativePoly> LPAlgorithmBFVrnsB<NativePoly>::EncryptPacked(const LPPublicKey<NativePoly> publicKey,
+		const NativeVector &coefficients) const
+{
+	NONATIVEPOLY
+}
+
 template <>
 Ciphertext<Poly> LPAlgorithmSHEBFVrnsB<Poly>::EvalMult(ConstCiphertext<Poly> ciphertext1,
 	ConstCiphertext<Poly> ciphertext2) const {
@@ -291,6 +330,17 @@ template class LPAlgorithmParamsGenBFVrnsB<NativePoly>;
 #undef NOPOLY
 #undef NONATIVEPOLY
 
+template <>
+std::string LPCryptoParametersBFVrnsB<DCRTPoly>::GetCRTTablesKey() const {
+	vector<NativeInteger> moduli;
+	vector<NativeInteger> roots;
+	for (const auto& p : GetElementParams()->GetParams()) {
+		moduli.push_back(p->GetModulus());
+		roots.push_back(p->GetRootOfUnity());
+	}
+	return PrecomputeCache::MakeKey(SerializedObjectName(), GetElementParams()->GetCyclotomicOrder(), moduli, roots, GetPlaintextModulus());
+}
+
 // Precomputation of CRT tables encryption, decryption, and homomorphic multiplication
 template <>
 bool LPCryptoParametersBFVrnsB<DCRTPoly>::PrecomputeCRTTables(){
@@ -300,6 +350,25 @@ bool LPCryptoParametersBFVrnsB<DCRTPoly>::PrecomputeCRTTables(){
 	size_t size = GetElementParams()->GetParams().size();
 	auto n = GetElementParams()->GetRingDimension();
 
+	// use the tables stored by an earlier process with the same parameters, if there are any
+
+	const std::string cacheKey = PrecomputeCache::Enabled() ? GetCRTTablesKey() : std::string();
+	PrecomputeTableReader cached;
+	if (!cacheKey.empty() && PrecomputeCache::Load(cacheKey, &cached)) {
+		try {
+			PrecomputeCache::ReadNTTTables(cached, 2 * n);
+			TransferCRTTables(cached);
+
+			if (cached.AtEnd() && m_numq == size && m_BskRoots.size() == m_BskModuli.size()) {
+				m_paramsBsk = shared_ptr<ILDCRTParams<BigInteger>>(new ILDCRTParams<BigInteger>(2 * n, m_BskModuli, m_BskRoots));
+				return true;
+			}
+		}
+		catch (deserialize_error&) {
+			// computed again below
+		}
+	}
+
 	vector<NativeInteger> moduli(size);
 	vector<NativeInteger> roots(size);
 
@@ -357,15 +426,15 @@ bool LPCryptoParametersBFVrnsB<DCRTPoly>::PrecomputeCRTTables(){
 	BigInteger B = 1;
 	BigInteger maxConvolutionValue = BigInteger(4) * BigInteger(n) * q * q * t;
 
+	m_BModuli.clear();
+	m_BskRoots.clear();
 	m_BModuli.push_back( NextPrime<NativeInteger>(m_mtilde, 2 * n) );
-	m_BskRoots.push_back( RootOfUnity<NativeInteger>(2 * n, m_BModuli[0]) );
 	B = B * BigInteger(m_BModuli[0]);
 
 	int i = 1; // we already added one prime
 	while ( q*B < maxConvolutionValue )
 	{
 		m_BModuli.push_back( NextPrime<NativeInteger>(m_BModuli[i-1], 2 * n) );
-		m_BskRoots.push_back( RootOfUnity<NativeInteger>(2 * n, m_BModuli[i]) );
 
 		B = B * BigInteger(m_BModuli[i]);
 		i++;
@@ -375,10 +444,10 @@ bool LPCryptoParametersBFVrnsB<DCRTPoly>::PrecomputeCRTTables(){
 
 	// find msk
 	m_msk = NextPrime<NativeInteger>(m_BModuli[m_numB-1], 2 * n);
-	m_BskRoots.push_back( RootOfUnity<NativeInteger>(2 * n, m_msk) );
 
 	m_BskModuli = m_BModuli;
 	m_BskModuli.push_back( m_msk );
+	m_BskRoots = RootsOfUnity<NativeInteger>(2 * n, m_BskModuli);
 
 	m_BskmtildeModuli = m_BskModuli;
 
@@ -603,6 +672,18 @@ bool LPCryptoParametersBFVrnsB<DCRTPoly>::PrecomputeCRTTables(){
 		m_tgammaqDivqiModqiPreconTable[i] = m_tgammaqDivqiModqiTable[i].PrepModMulPreconOptimized( moduli[i] );
 	}
 
+	if (!cacheKey.empty()) {
+		vector<NativeInteger> nttModuli(moduli);
+		nttModuli.insert(nttModuli.end(), m_BskModuli.begin(), m_BskModuli.end());
+		vector<NativeInteger> nttRoots(roots);
+		nttRoots.insert(nttRoots.end(), m_BskRoots.begin(), m_BskRoots.end());
+
+		PrecomputeTableWriter tables;
+		PrecomputeCache::WriteNTTTables(tables, 2 * n, nttModuli, nttRoots);
+		TransferCRTTables(tables);
+		PrecomputeCache::Store(cacheKey, tables);
+	}
+
 	return true;
 }
 
@@ -821,20 +902,20 @@ bool LPAlgorithmParamsGenBFVrnsB<DCRTPoly>::ParamsGen(shared_ptr<LPCryptoParamet
 	size_t size = ext_double::to_long(ext_double::ceil((ext_double::ceil(ext_double::log(q)/(ExtendedDouble)log(2)) + ExtendedDouble(1.0)) / (ExtendedDouble)dcrtBits));
 
 	vector<NativeInteger> moduli(size);
-	vector<NativeInteger> roots(size);
 
 	//makes sure the first integer is less than 2^60-1 to take advantage of NTL optimizations
 	NativeInteger firstInteger = FirstPrime<NativeInteger>(dcrtBits, 2 * n);
 	firstInteger -= (int64_t)(2*n)*((int64_t)(1)<<(dcrtBits/3));
 	moduli[0] = NextPrime<NativeInteger>(firstInteger, 2 * n);
-	roots[0] = RootOfUnity<NativeInteger>(2 * n, moduli[0]);
 
 	for (size_t i = 1; i < size; i++)
 	{
 		moduli[i] = NextPrime<NativeInteger>(moduli[i-1], 2 * n);
-		roots[i] = RootOfUnity<NativeInteger>(2 * n, moduli[i]);
 	}
 
+	// the roots of unity are independent of each other and are found in parallel
+	vector<NativeInteger> roots = RootsOfUnity<NativeInteger>(2 * n, moduli);
+
 	shared_ptr<ILDCRTParams<BigInteger>> params(new ILDCRTParams<BigInteger>(2 * n, moduli, roots));
 
 	ChineseRemainderTransformFTT<NativeVector>::PreCompute(roots,2*n,moduli);
@@ -889,6 +970,98 @@ Ciphertext<DCRTPoly> LPAlgorithmBFVrnsB<DCRTPoly>::Encrypt(const LPPublicKey<DCR
 	return ciphertext;
 }
 
+template <>
+Ciphertext<DCRTPoly> LPAlgorithmBFVrnsB<DCRTPoly>::EncryptPacked(const LPPublicKey<DCRTPoly> publicKey,
+		const NativeVector &coefficients) const
+{
+	Ciphertext<DCRTPoly> ciphertext( new CiphertextImpl<DCRTPoly>(publicKey) );
+
+	const shared_ptr<LPCryptoParametersBFVrnsB<DCRTPoly>> cryptoParams = std::dynamic_pointer_cast<LPCryptoParametersBFVrnsB<DCRTPoly>>(publicKey->GetCryptoParameters());
+
+	const shared_ptr<typename DCRTPoly::Params> elementParams = cryptoParams->GetElementParams();
+	const std::vector<std::shared_ptr<ILNativeParams>> &towerParams = elementParams->GetParams();
+
+	const usint n = elementParams->GetRingDimension();
+	if( coefficients.GetLength() != n )
+		PALISADE_THROW(math_error, "EncryptPacked expects " + std::to_string(n) + " plaintext coefficients");
+
+	const std::vector<NativeInteger> &deltaTable = cryptoParams->GetCRTDeltaTable();
+
+	const typename DCRTPoly::DggType &dgg = cryptoParams->GetDiscreteGaussianGenerator();
+	typename DCRTPoly::TugType tug;
+
+	const DCRTPoly &p0 = publicKey->GetPublicElements().at(0);
+	const DCRTPoly &p1 = publicKey->GetPublicElements().at(1);
+
+	DCRTPoly u;
+
+	//Supports both discrete Gaussian (RLWE) and ternary uniform distribution (OPTIMIZED) cases
+	if (cryptoParams->GetMode() == RLWE)
+		u = DCRTPoly(dgg, elementParams, Format::EVALUATION);
+	else
+		u = DCRTPoly(tug, elementParams, Format::EVALUATION);
+
+	// the noise of c0 is added to delta*m before the transform, which saves one NTT per tower
+	DCRTPoly e0(dgg, elementParams, Format::COEFFICIENT);
+	DCRTPoly e1(dgg, elementParams, Format::EVALUATION);
+
+	// the towers are filled in below
+	DCRTPoly c0(elementParams, Format::EVALUATION, false);
+	DCRTPoly c1(elementParams, Format::EVALUATION, false);
+
+	const NativeInteger p = cryptoParams->GetPlaintextModulus();
+	const NativeInteger half = p >> 1;
+
+#pragma omp parallel for
+	for( usint k = 0; k < towerParams.size(); k++ ) {
+		const NativeInteger &qk = towerParams[k]->GetModulus();
+		const NativeInteger shift = qk - p;
+		const NativeInteger &delta = deltaTable[k];
+		const NativeInteger deltaPrecon = delta.PrepModMulPreconOptimized(qk);
+		const NativeInteger mu = qk.ComputeMu();
+
+		// lift the coefficients, centered at p/2, scale them by delta and add the noise
+		const NativeVector &e0k = e0.GetElementAtIndex(k).GetValues();
+		NativeVector scaled(n, qk);
+		for( usint i = 0; i < n; i++ ) {
+			const NativeInteger &c = coefficients[i];
+			scaled[i] = (c > half ? c + shift : c).ModMulPreconOptimized(delta, qk, deltaPrecon);
+			scaled[i].ModAddFastEq(e0k[i], qk);
+		}
+
+		NativePoly m(towerParams[k], Format::COEFFICIENT);
+		m.SetValues(std::move(scaled), Format::COEFFICIENT);
+		m.SwitchFormat();
+
+		const NativeVector &mk = m.GetValues();
+		const NativeVector &p0k = p0.GetElementAtIndex(k).GetValues();
+		const NativeVector &p1k = p1.GetElementAtIndex(k).GetValues();
+		const NativeVector &uk = u.GetElementAtIndex(k).GetValues();
+		const NativeVector &e1k = e1.GetElementAtIndex(k).GetValues();
+
+		NativeVector c0k(n, qk);
+		NativeVector c1k(n, qk);
+		for( usint i = 0; i < n; i++ ) {
+			c0k[i] = p0k[i].ModMulFastOptimized(uk[i], qk, mu);
+			c0k[i].ModAddFastEq(mk[i], qk);
+			c1k[i] = p1k[i].ModMulFastOptimized(uk[i], qk, mu);
+			c1k[i].ModAddFastEq(e1k[i], qk);
+		}
+
+		c0.ElementAtIndex(k).SetValues(std::move(c0k), Format::EVALUATION);
+		c1.ElementAtIndex(k).SetValues(std::move(c1k), Format::EVALUATION);
+	}
+
+	// an initializer list would copy both elements
+	std::vector<DCRTPoly> elements;
+	elements.reserve(2);
+	elements.push_back(std::move(c0));
+	elements.push_back(std::move(c1));
+	ciphertext->SetElements(std::move(elements));
+
+	return ciphertext;
+}
+
  template <>
 DecryptResult LPAlgorithmBFVrnsB<DCRTPoly>::Decrypt(const LPPrivateKey<DCRTPoly> privateKey,
 		ConstCiphertext<DCRTPoly> ciphertext,
@@ -990,6 +1163,38 @@ Ciphertext<DCRTPoly> LPAlgorithmBFVrnsB<DCRTPoly>::Encrypt(const LPPrivateKey<DC
 	return ciphertext;
 }
 
+template <>
+Ciphertext<DCRTPoly> LPAlgorithmBFVrnsB<DCRTPoly>::EncryptSeeded(const LPPrivateKey<DCRTPoly> privateKey,
+		DCRTPoly ptxt) const
+{
+	Ciphertext<DCRTPoly> ciphertext( new CiphertextImpl<DCRTPoly>(privateKey) );
+
+	const shared_ptr<LPCryptoParametersBFVrnsB<DCRTPoly>> cryptoParams =
+			std::dynamic_pointer_cast<LPCryptoParametersBFVrnsB<DCRTPoly>>(privateKey->GetCryptoParameters());
+
+	const shared_ptr<typename DCRTPoly::Params> elementParams = cryptoParams->GetElementParams();
+
+	ptxt.SwitchFormat();
+
+	const typename DCRTPoly::DggType &dgg = cryptoParams->GetDiscreteGaussianGenerator();
+
+	const std::vector<NativeInteger> &deltaTable = cryptoParams->GetCRTDeltaTable();
+
+	// c1 = -a is expanded from the seed, and c0 = a*s + e + delta*m
+	std::vector<uint8_t> seed = ElementSeed::Generate();
+	DCRTPoly c1 = ElementSeed::Expand<DCRTPoly>(seed, elementParams);
+	const DCRTPoly &s = privateKey->GetPrivateElement();
+	DCRTPoly e(dgg, elementParams, Format::EVALUATION);
+
+	DCRTPoly c0(e + ptxt.Times(deltaTable));
+	c0 -= c1*s;
+
+	ciphertext->SetElements({ c0, c1 });
+	ciphertext->SetSeed(seed);
+
+	return ciphertext;
+}
+
 template <>
 Ciphertext<DCRTPoly> LPAlgorithmSHEBFVrnsB<DCRTPoly>::EvalAdd(ConstCiphertext<DCRTPoly> ciphertext,
 		ConstPlaintext plaintext) const{
@@ -149,6 +149,13 @@ namespace lbcrypto {
 			*/
 			bool PrecomputeCRTTables();
 
+			/**
+			* Gets the key under which PrecomputeCRTTables keeps its tables in the PrecomputeCache
+			*
+			* @return the key
+			*/
+			std::string GetCRTTablesKey() const;
+
 			/**
 			* == operator to compare to this instance of LPCryptoParametersBFVrnsB object.
 			*
@@ -275,6 +282,56 @@ namespace lbcrypto {
 
 		private:
 
+			// Applies a PrecomputeTableWriter or PrecomputeTableReader to every table
+			// of PrecomputeCRTTables except m_paramsBsk, in a fixed order
+			template <class Tables>
+			void TransferCRTTables(Tables &tables) {
+				tables(m_CRTDeltaTable);
+				tables(m_numq);
+				tables(m_numB);
+				tables(m_mtilde);
+				tables(m_msk);
+				tables(m_qModuli);
+				tables(m_qModulimu);
+				tables(m_BModuli);
+				tables(m_BskRoots);
+				tables(m_BskModuli);
+				tables(m_BskModulimu);
+				tables(m_BskmtildeModuli);
+				tables(m_BskmtildeModulimu);
+				tables(m_qDivqiModqiTable);
+				tables(m_tqDivqiModqiTable);
+				tables(m_tqDivqiModqiPreconTable);
+				tables(m_qDivqiModBskmtildeTable);
+				tables(m_mtildeqDivqiTable);
+				tables(m_mtildeqDivqiPreconTable);
+				tables(m_negqInvModmtilde);
+				tables(m_negqInvModmtildePrecon);
+				tables(m_qModBskiTable);
+				tables(m_qModBskiPreconTable);
+				tables(m_mtildeInvModBskiTable);
+				tables(m_mtildeInvModBskiPreconTable);
+				tables(m_qInvModBskiTable);
+				tables(m_qInvModBskiPreconTable);
+				tables(m_BDivBiModBiTable);
+				tables(m_BDivBiModBiPreconTable);
+				tables(m_BDivBiModqTable);
+				tables(m_BDivBiModmskTable);
+				tables(m_BInvModmsk);
+				tables(m_BInvModmskPrecon);
+				tables(m_BModqiTable);
+				tables(m_BModqiPreconTable);
+				tables(m_gamma);
+				tables(m_gammaInvModt);
+				tables(m_gammaInvModtPrecon);
+				tables(m_negqInvModtgammaTable);
+				tables(m_negqInvModtgammaPreconTable);
+				tables(m_qDivqiModtgammaTable);
+				tables(m_qDivqiModtgammaPreconTable);
+				tables(m_tgammaqDivqiModqiTable);
+				tables(m_tgammaqDivqiModqiPreconTable);
+			}
+
 			// Stores a precomputed table of floor(Q/p) mod qi
 			std::vector<NativeInteger> m_CRTDeltaTable;
 
@@ -439,6 +496,18 @@ namespace lbcrypto {
 		Ciphertext<Element> Encrypt(const LPPublicKey<Element> publicKey,
 			Element plaintext) const;
 
+		/**
+		* Method for encrypting the coefficients of a packed plaintext using BFVrnsB, fusing the lifting of the
+		* coefficients to the towers, their scaling by delta, the NTT and the addition to the public-key
+		* products into one pass per tower.
+		*
+		* @param publicKey public key used for encryption.
+		* @param coefficients the plaintext coefficients, in [0, p).
+		* @return ciphertext which results from encryption.
+		*/
+		Ciphertext<Element> EncryptPacked(const LPPublicKey<Element> publicKey,
+			const NativeVector &coefficients) const;
+
 		/**
 		* Method for encrypting plaintext with private key using BFVrnsB.
 		*
@@ -450,6 +519,16 @@ namespace lbcrypto {
 		Ciphertext<Element> Encrypt(const LPPrivateKey<Element> privateKey,
 			Element plaintext) const;
 
+		/**
+		* Method for encrypting plaintext with private key into a seeded ciphertext using BFVrnsB.
+		*
+		* @param privateKey private key used for encryption.
+		* @param plaintext the plaintext input.
+		* @return ciphertext whose second element is expanded from its seed.
+		*/
+		Ciphertext<Element> EncryptSeeded(const LPPrivateKey<Element> privateKey,
+			Element plaintext) const;
+
 		/**
 		* Method for decrypting using BFVrnsB. See the class description for citations on where the algorithms were
 	 	* taken from.
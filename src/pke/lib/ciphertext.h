@@ -72,12 +72,14 @@ class CiphertextImpl;
 		*/
 		CiphertextImpl(const CiphertextImpl<Element> &ciphertext) : CryptoObject<Element>(ciphertext) {
 			m_elements = ciphertext.m_elements;
+			m_seed = ciphertext.m_seed;
 			m_depth = ciphertext.m_depth;
 			encodingType = ciphertext.encodingType;
 		}
 
 		CiphertextImpl(Ciphertext<Element> ciphertext) : CryptoObject<Element>(*ciphertext) {
 			m_elements = ciphertext->m_elements;
+			m_seed = ciphertext->m_seed;
 			m_depth = ciphertext->m_depth;
 			encodingType = ciphertext->encodingType;
 		}
@@ -87,18 +89,21 @@ class CiphertextImpl;
 		*/
 		CiphertextImpl(CiphertextImpl<Element> &&ciphertext) : CryptoObject<Element>(ciphertext) {
 			m_elements = std::move(ciphertext.m_elements);
+			m_seed = std::move(ciphertext.m_seed);
 			m_depth = std::move(ciphertext.m_depth);
 			encodingType = std::move(ciphertext.encodingType);
 		}
 
 		CiphertextImpl(Ciphertext<Element> &&ciphertext) : CryptoObject<Element>(*ciphertext) {
 			m_elements = std::move(ciphertext->m_elements);
+			m_seed = std::move(ciphertext->m_seed);
 			m_depth = std::move(ciphertext->m_depth);
 			encodingType = std::move(ciphertext->encodingType);
 		}
 
 		Ciphertext<Element> CloneEmpty() const {
 			Ciphertext<Element> ct( new CiphertextImpl<Element>(this->GetCryptoContext(), this->GetKeyTag(), this->GetEncodingType()) );
+			ct->keyHandle.store(this->keyHandle.load(std::memory_order_relaxed), std::memory_order_relaxed);
 			return ct;
 		}
 
@@ -129,6 +134,7 @@ class CiphertextImpl;
 			if (this != &rhs) {
 				CryptoObject<Element>::operator=(rhs);
 				this->m_elements = rhs.m_elements;
+				this->m_seed = rhs.m_seed;
 				this->m_depth = rhs.m_depth;
 				this->encodingType = rhs.encodingType;
 			}
@@ -146,6 +152,7 @@ class CiphertextImpl;
 			if (this != &rhs) {
 				CryptoObject<Element>::operator=(rhs);
 				this->m_elements = std::move(rhs.m_elements);
+				this->m_seed = std::move(rhs.m_seed);
 				this->m_depth = std::move(rhs.m_depth);
 				this->encodingType = std::move(rhs.encodingType);
 			}
@@ -173,12 +180,20 @@ class CiphertextImpl;
 		*/
 		const std::vector<Element> &GetElements() const { return m_elements; }
 
+		/**
+		* GetMutableElements: get writable access to all of the ring elements in the CiphertextImpl;
+		* the ciphertext is no longer seeded. Reads should use GetElements, which keeps the seed.
+		* @return vector of ring elements
+		*/
+		std::vector<Element> &GetMutableElements() { m_seed.clear(); return m_elements; }
+
 		/**
 		* SetElement - sets the ring element for the cases that use only one element in the vector
 		* this method will throw an exception if it's ever called in cases with other than 1 element
 		* @param &element is a polynomial ring element.
 		*/
 		void SetElement(const Element &element) {
+			m_seed.clear();
 			if (m_elements.size() == 0)
 				m_elements.push_back(element);
 			else if (m_elements.size() == 1)
@@ -192,14 +207,29 @@ class CiphertextImpl;
 		*
 		* @param &element is a polynomial ring element.
 		*/
-		void SetElements(const std::vector<Element> &elements) { m_elements = elements; }
+		void SetElements(const std::vector<Element> &elements) { m_elements = elements; m_seed.clear(); }
 
 		/**
 		* Sets the data elements by std::move.
 		*
 		* @param &&element is a polynomial ring element.
 		*/
-		void SetElements(const std::vector<Element> &&elements) { m_elements = std::move(elements); }
+		void SetElements(std::vector<Element> &&elements) { m_elements = std::move(elements); m_seed.clear(); }
+
+		/**
+		* GetSeed: get the seed that the last element was expanded from
+		* @return the seed; empty if the ciphertext is not seeded
+		*/
+		const std::vector<uint8_t> &GetSeed() const { return m_seed; }
+
+		/**
+		* SetSeed: mark the ciphertext as seeded; its last element must be ElementSeed::Expand
+		* of the seed. A seeded ciphertext is serialized with the seed in place of that element.
+		* Setting the elements or writing to them through GetMutableElements afterwards drops the seed.
+		*
+		* @param &seed the seed
+		*/
+		void SetSeed(const std::vector<uint8_t> &seed) { m_seed = seed; }
 
 		/**
 		* Get the depth of the ciphertext.
@@ -260,9 +290,23 @@ class CiphertextImpl;
 		void save( Archive & ar, std::uint32_t const version ) const
 		{
 		    ar( ::cereal::base_class<CryptoObject<Element>>( this ) );
-			ar( ::cereal::make_nvp("v", m_elements) );
+			{
+				// the elements are where the COMPACT format may drop low-order bits
+				BinaryPacking packing = BinaryPacking::Current();
+				packing.lossy = packing.droppedBits > 0;
+				BinaryPackingScope scope(packing);
+				if( m_seed.empty() ) {
+					ar( ::cereal::make_nvp("v", m_elements) );
+				}
+				else {
+					// the last element is expanded from the seed when the ciphertext is loaded
+					std::vector<Element> v(m_elements.begin(), m_elements.end() - 1);
+					ar( ::cereal::make_nvp("v", v) );
+				}
+			}
 			ar( ::cereal::make_nvp("d", m_depth) );
 			ar( ::cereal::make_nvp("e", encodingType) );
+			ar( ::cereal::make_nvp("s", m_seed) );
 		}
 
 		template <class Archive>
@@ -275,10 +319,19 @@ class CiphertextImpl;
 			ar( ::cereal::make_nvp("v", m_elements) );
 			ar( ::cereal::make_nvp("d", m_depth) );
 			ar( ::cereal::make_nvp("e", encodingType) );
+			m_seed.clear();
+			if( version >= 2 ) {
+				ar( ::cereal::make_nvp("s", m_seed) );
+				if( !m_seed.empty() ) {
+					if( !this->GetCryptoContext() )
+						PALISADE_THROW(deserialize_error, "seeded ciphertext has no crypto context to expand its seed with");
+					m_elements.push_back( ElementSeed::Expand<Element>(m_seed, this->GetCryptoParameters()->GetElementParams()) );
+				}
+			}
 		}
 
 		std::string SerializedObjectName() const { return "Ciphertext"; }
-		static uint32_t	SerializedVersion() { return 1; }
+		static uint32_t	SerializedVersion() { return 2; }
 
 	private:
 
@@ -286,6 +339,7 @@ class CiphertextImpl;
 		//BigInteger m_norm;
 
 		std::vector<Element> m_elements;		/*!< vector of ring elements for this Ciphertext */
+		std::vector<uint8_t> m_seed;			/*!< seed of the last element, if the ciphertext is seeded */
 		size_t m_depth; // holds the multiplicative depth of the ciphertext.
 		PlaintextEncodings	encodingType;	/*!< how was this Ciphertext encoded? */
 	};
@@ -0,0 +1,451 @@
+/*
+ * @file ciphertextstream.cpp -- Framed files of many ciphertexts, written and read one at a time.
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @section LICENSE
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or other
+ * materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ciphertextstream.h"
+#include "nativetowers.h"
+
+#include <cstring>
+#include <limits>
+
+namespace lbcrypto {
+
+namespace {
+
+const char			CiphertextStreamMagic[8] = { 'P', 'A', 'L', 'C', 'T', 'S', '0', '1' };
+const char			CiphertextIndexMagic[8] = { 'P', 'A', 'L', 'C', 'T', 'I', 'D', 'X' };
+const uint32_t		CiphertextStreamVersion = 1;
+const uint64_t		EndOfFrames = std::numeric_limits<uint64_t>::max();
+const uint64_t		IndexTrailer = 2*sizeof(uint64_t) + sizeof(CiphertextIndexMagic);	// count, index offset, magic
+
+static_assert(sizeof(NativeInteger) == sizeof(uint64_t), "CiphertextStreamReader expands towers in place from raw native words");
+
+// bits needed for a residue mod q
+usint TowerWidth(uint64_t q) {
+	usint width = q < 2 ? 1 : GetMSB64(q - 1);
+	return width == 0 ? 1 : width;
+}
+
+size_t TowerWords(usint n, usint width) {
+	return (size_t(n)*width + 63) / 64;
+}
+
+// reads n bytes of a stream into buf
+bool ReadBytes(std::istream& is, std::vector<uint8_t>& buf, size_t n) {
+	buf.resize(n);
+	return bool(is.read(reinterpret_cast<char *>(buf.data()), n));
+}
+
+}
+
+template<typename Element>
+CiphertextStreamWriter<Element>::CiphertextStreamWriter(const CryptoContext<Element> cc, const string& filename)
+	: m_cc(cc), m_filename(filename), m_pos(0) {
+	if( !cc )
+		PALISADE_THROW(config_error, "CiphertextStreamWriter needs a context");
+
+	m_os.open(filename, std::ios::binary | std::ios::trunc);
+	if( !m_os.is_open() )
+		PALISADE_THROW(config_error, "Cannot open " + filename + " for writing");
+
+	const string fp = cc->GetFingerprint();
+	StoreWriter w(m_os);
+	w.Bytes(CiphertextStreamMagic, sizeof(CiphertextStreamMagic));
+	w.Word<uint32_t>(CiphertextStreamVersion);
+	w.Word<uint32_t>(fp.size());
+	w.Bytes(fp.data(), fp.size());
+	m_pos = sizeof(CiphertextStreamMagic) + 2*sizeof(uint32_t) + fp.size();
+}
+
+template<typename Element>
+CiphertextStreamWriter<Element>::~CiphertextStreamWriter() {
+	try {
+		Close();
+	} catch( ... ) {}
+}
+
+template<typename Element>
+void CiphertextStreamWriter<Element>::Write(ConstCiphertext<Element> ciphertext) {
+	if( !m_os.is_open() )
+		PALISADE_THROW(config_error, "CiphertextStreamWriter for " + m_filename + " is closed");
+	if( ciphertext == NULL || ciphertext->GetCryptoContext() != m_cc )
+		PALISADE_THROW(config_error, "Ciphertext passed to CiphertextStreamWriter was not generated with its context");
+
+	const auto& elements = ciphertext->GetElements();
+	if( elements.empty() )
+		PALISADE_THROW(config_error, "Cannot write an empty ciphertext");
+	auto towers = NativeTowers(elements[0]);
+	usint ringDim = towers[0]->GetLength();
+
+	// the frame length is known up front, so the towers are packed straight into the file
+	const string& tag = ciphertext->GetKeyTag();
+	std::vector<usint> widths;
+	uint64_t elementBytes = 0;
+	for( const auto t : towers ) {
+		widths.push_back(TowerWidth(t->GetModulus().ConvertToInt()));
+		elementBytes += TowerWords(ringDim, widths.back())*sizeof(uint64_t);
+	}
+	for( const auto& el : elements ) {
+		if( NativeTowers(el).size() != towers.size() || el.GetFormat() != elements[0].GetFormat() )
+			PALISADE_THROW(config_error, "Elements of a ciphertext must share their towers and format");
+	}
+	uint64_t length = 7*sizeof(uint32_t) + sizeof(uint64_t) + tag.size() +
+			towers.size()*sizeof(uint64_t) + elements.size()*elementBytes;
+
+	StoreWriter w(m_os);
+	w.Word<uint64_t>(length);
+	w.Word<uint32_t>(tag.size());
+	w.Bytes(tag.data(), tag.size());
+	w.Word<uint32_t>(ciphertext->GetEncodingType());
+	w.Word<uint32_t>(0);
+	w.Word<uint64_t>(ciphertext->GetDepth());
+	w.Word<uint32_t>(elements.size());
+	w.Word<uint32_t>(towers.size());
+	w.Word<uint32_t>(ringDim);
+	w.Word<uint32_t>(elements[0].GetFormat());
+	for( const auto t : towers )
+		w.Word<uint64_t>(t->GetModulus().ConvertToInt());
+
+	for( const auto& el : elements ) {
+		auto et = NativeTowers(el);
+		for( size_t t = 0; t < et.size(); t++ ) {
+			std::vector<uint64_t> words = et[t]->GetValues().PackBits(widths[t], 0);
+			w.Bytes(words.data(), words.size()*sizeof(uint64_t));
+		}
+	}
+
+	m_offsets.push_back(m_pos);
+	m_pos += sizeof(uint64_t) + length;
+	if( !m_os.good() )
+		PALISADE_THROW(config_error, "Error writing " + m_filename);
+}
+
+template<typename Element>
+void CiphertextStreamWriter<Element>::Close() {
+	if( !m_os.is_open() )
+		return;
+
+	StoreWriter w(m_os);
+	w.Word<uint64_t>(EndOfFrames);
+	uint64_t indexOffset = m_pos + sizeof(uint64_t);
+	for( auto o : m_offsets )
+		w.Word<uint64_t>(o);
+	w.Word<uint64_t>(m_offsets.size());
+	w.Word<uint64_t>(indexOffset);
+	w.Bytes(CiphertextIndexMagic, sizeof(CiphertextIndexMagic));
+	bool ok = m_os.good();
+	m_os.close();
+	if( !ok )
+		PALISADE_THROW(config_error, "Error writing " + m_filename);
+}
+
+template<typename Element>
+CiphertextStreamReader<Element>::CiphertextStreamReader(const CryptoContext<Element> cc, const string& filename, size_t prefetch)
+	: m_cc(cc), m_filename(filename), m_indexed(false), m_dataEnd(0), m_prefetch(prefetch),
+	  m_done(false), m_stop(false) {
+	if( !cc )
+		PALISADE_THROW(config_error, "CiphertextStreamReader needs a context");
+
+	m_is.open(filename, std::ios::binary);
+	if( !m_is.is_open() )
+		PALISADE_THROW(config_error, "Cannot open " + filename);
+
+	// no length read from the file is trusted beyond the size of the file
+	m_is.seekg(0, std::ios::end);
+	uint64_t size = m_is.tellg();
+	m_is.seekg(0);
+
+	std::vector<uint8_t> buf;
+	const uint64_t fixedHeader = sizeof(CiphertextStreamMagic) + 2*sizeof(uint32_t);
+	if( !ReadBytes(m_is, buf, fixedHeader) ||
+			memcmp(buf.data(), CiphertextStreamMagic, sizeof(CiphertextStreamMagic)) != 0 )
+		PALISADE_THROW(deserialize_error, filename + " is not a ciphertext stream");
+	StoreReader h(buf.data() + sizeof(CiphertextStreamMagic), 2*sizeof(uint32_t), "Ciphertext stream");
+	if( h.Word<uint32_t>() != CiphertextStreamVersion )
+		PALISADE_THROW(deserialize_error, "Unsupported ciphertext stream version in " + filename);
+	uint32_t fpLength = h.Word<uint32_t>();
+	if( fpLength > size - fixedHeader || !ReadBytes(m_is, buf, fpLength) )
+		PALISADE_THROW(deserialize_error, filename + " is truncated");
+	if( string(buf.begin(), buf.end()) != cc->GetFingerprint() )
+		PALISADE_THROW(config_error, "Ciphertext stream " + filename + " was not written for this context");
+	uint64_t dataStart = fixedHeader + fpLength;
+
+	// the index is optional: a stream that was never closed can still be read in order
+	m_dataEnd = size;
+	if( size >= dataStart + sizeof(uint64_t) + IndexTrailer ) {
+		m_is.seekg(size - IndexTrailer);
+		if( ReadBytes(m_is, buf, IndexTrailer) ) {
+			StoreReader t(buf.data(), IndexTrailer, "Ciphertext stream index");
+			uint64_t count = t.Word<uint64_t>();
+			uint64_t indexOffset = t.Word<uint64_t>();
+			if( memcmp(t.Bytes(sizeof(CiphertextIndexMagic)), CiphertextIndexMagic, sizeof(CiphertextIndexMagic)) == 0 &&
+					indexOffset >= dataStart + sizeof(uint64_t) && indexOffset <= size - IndexTrailer &&
+					(size - IndexTrailer - indexOffset) / sizeof(uint64_t) == count &&
+					(size - IndexTrailer - indexOffset) % sizeof(uint64_t) == 0 ) {
+				m_offsets.resize(count);
+				m_is.seekg(indexOffset);
+				if( count == 0 || m_is.read(reinterpret_cast<char *>(m_offsets.data()), count*sizeof(uint64_t)) ) {
+					m_indexed = true;
+					m_dataEnd = indexOffset - sizeof(uint64_t);
+					for( auto o : m_offsets )
+						if( o < dataStart || o >= m_dataEnd )
+							PALISADE_THROW(deserialize_error, "Index of ciphertext stream " + filename + " is corrupt");
+				}
+				else
+					m_offsets.clear();
+			}
+		}
+	}
+	m_is.clear();
+	m_is.seekg(dataStart);
+
+	if( m_prefetch > 0 )
+		StartPrefetch();
+}
+
+template<typename Element>
+CiphertextStreamReader<Element>::~CiphertextStreamReader() {
+	StopPrefetch();
+}
+
+template<typename Element>
+size_t CiphertextStreamReader<Element>::GetCount() const {
+	if( !m_indexed )
+		PALISADE_THROW(config_error, "Ciphertext stream " + m_filename + " has no index");
+	return m_offsets.size();
+}
+
+template<typename Element>
+bool CiphertextStreamReader<Element>::ReadFrame(std::vector<uint8_t>& frame) {
+	uint64_t pos = m_is.tellg();
+	if( pos >= m_dataEnd )
+		return false;
+
+	uint64_t length;
+	if( !m_is.read(reinterpret_cast<char *>(&length), sizeof(length)) || length == EndOfFrames )
+		return false;
+	// the frame must fit in what is left of the frames before it is allocated
+	uint64_t available = m_dataEnd - pos > sizeof(length) ? m_dataEnd - pos - sizeof(length) : 0;
+	if( length > available || !ReadBytes(m_is, frame, length) )
+		PALISADE_THROW(deserialize_error, "Ciphertext stream " + m_filename + " is truncated");
+	return true;
+}
+
+template<typename Element>
+void CiphertextStreamReader<Element>::Prefetch() {
+	while( true ) {
+		std::vector<uint8_t> frame;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_cv.wait(lock, [this] { return m_stop || m_ready.size() < m_prefetch; });
+			if( m_stop )
+				return;
+			if( !m_free.empty() ) {
+				frame = std::move(m_free.back());
+				m_free.pop_back();
+			}
+		}
+
+		bool more;
+		try {
+			more = ReadFrame(frame);
+		} catch( ... ) {
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_error = std::current_exception();
+			m_done = true;
+			m_cv.notify_all();
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if( !more ) {
+			m_done = true;
+			m_cv.notify_all();
+			return;
+		}
+		m_ready.push_back(std::move(frame));
+		m_cv.notify_all();
+	}
+}
+
+template<typename Element>
+void CiphertextStreamReader<Element>::StartPrefetch() {
+	m_thread = std::thread(&CiphertextStreamReader<Element>::Prefetch, this);
+}
+
+template<typename Element>
+void CiphertextStreamReader<Element>::StopPrefetch() {
+	if( !m_thread.joinable() )
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_cv.notify_all();
+	m_thread.join();
+
+	for( auto& f : m_ready )
+		m_free.push_back(std::move(f));
+	m_ready.clear();
+	m_stop = false;
+	m_done = false;
+	m_error = nullptr;
+}
+
+template<typename Element>
+bool CiphertextStreamReader<Element>::Read(Ciphertext<Element>& ciphertext) {
+	if( m_prefetch == 0 ) {
+		if( !ReadFrame(m_frame) )
+			return false;
+		Decode(m_frame, ciphertext);
+		return true;
+	}
+
+	std::vector<uint8_t> frame;
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_cv.wait(lock, [this] { return !m_ready.empty() || m_done; });
+		if( m_ready.empty() ) {
+			if( m_error )
+				std::rethrow_exception(m_error);
+			return false;
+		}
+		frame = std::move(m_ready.front());
+		m_ready.pop_front();
+	}
+	m_cv.notify_all();
+
+	Decode(frame, ciphertext);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_free.push_back(std::move(frame));
+	return true;
+}
+
+template<typename Element>
+void CiphertextStreamReader<Element>::Seek(size_t i) {
+	if( !m_indexed )
+		PALISADE_THROW(config_error, "Ciphertext stream " + m_filename + " has no index");
+	if( i > m_offsets.size() )
+		PALISADE_THROW(config_error, "Position " + std::to_string(i) + " is past the end of " + m_filename);
+
+	StopPrefetch();
+	m_is.clear();
+	m_is.seekg(i == m_offsets.size() ? m_dataEnd : m_offsets[i]);
+	if( m_prefetch > 0 )
+		StartPrefetch();
+}
+
+template<typename Element>
+Ciphertext<Element> CiphertextStreamReader<Element>::ReadAt(size_t i) {
+	Seek(i);
+	Ciphertext<Element> ciphertext;
+	if( !Read(ciphertext) )
+		PALISADE_THROW(config_error, "Position " + std::to_string(i) + " is past the end of " + m_filename);
+	return ciphertext;
+}
+
+template<typename Element>
+void CiphertextStreamReader<Element>::Decode(const std::vector<uint8_t>& frame, Ciphertext<Element>& ciphertext) const {
+	StoreReader r(frame.data(), frame.size(), "Ciphertext frame");
+
+	uint32_t tagLength = r.Word<uint32_t>();
+	string tag(reinterpret_cast<const char *>(r.Bytes(tagLength)), tagLength);
+	PlaintextEncodings encoding = PlaintextEncodings(r.Word<uint32_t>());
+	r.Word<uint32_t>();
+	uint64_t depth = r.Word<uint64_t>();
+	uint32_t numElements = r.Word<uint32_t>();
+	uint32_t numTowers = r.Word<uint32_t>();
+	uint32_t ringDim = r.Word<uint32_t>();
+	Format format = Format(r.Word<uint32_t>());
+
+	if( ringDim != m_cc->GetRingDimension() )
+		PALISADE_THROW(deserialize_error, "Ciphertext frame does not match the ring dimension of the context");
+
+	// the counts are checked against the context and the frame before anything is allocated
+	if( numTowers == 0 || numTowers > NativeTowerCount(*m_cc->GetElementParams()) )
+		PALISADE_THROW(deserialize_error, "Ciphertext frame does not match the towers of the context");
+	std::vector<uint64_t> moduli(numTowers);
+	std::vector<usint> widths(numTowers);
+	uint64_t elementBytes = 0;
+	for( usint t = 0; t < numTowers; t++ ) {
+		moduli[t] = r.Word<uint64_t>();
+		widths[t] = TowerWidth(moduli[t]);
+		elementBytes += TowerWords(ringDim, widths[t])*sizeof(uint64_t);
+	}
+	if( numElements == 0 || r.Remaining() / elementBytes != numElements || r.Remaining() % elementBytes != 0 )
+		PALISADE_THROW(deserialize_error, "Ciphertext frame has the wrong length for its elements");
+
+	auto sameShape = [&](const Element& e) {
+		if( e.GetFormat() != format )
+			return false;
+		auto towers = NativeTowers(e);
+		if( towers.size() != numTowers )
+			return false;
+		for( usint t = 0; t < numTowers; t++ )
+			if( towers[t]->GetModulus().ConvertToInt() != moduli[t] )
+				return false;
+		return true;
+	};
+
+	// decode in place when the caller handed back a ciphertext nobody else can see
+	bool reuse = ciphertext && ciphertext.use_count() == 1 && ciphertext->GetCryptoContext() == m_cc &&
+			ciphertext->GetElements().size() == numElements;
+	for( uint32_t e = 0; reuse && e < numElements; e++ )
+		reuse = sameShape(ciphertext->GetElements()[e]);
+
+	if( reuse ) {
+		ciphertext->SetKeyTag(tag);
+		ciphertext->SetEncodingType(encoding);
+	}
+	else {
+		ciphertext = std::make_shared<CiphertextImpl<Element>>(m_cc, tag, encoding);
+		auto& elements = ciphertext->GetMutableElements();
+		elements.reserve(numElements);
+		for( uint32_t e = 0; e < numElements; e++ ) {
+			elements.emplace_back(m_cc->GetElementParams(), format, true);
+			DropNativeTowers(elements.back(), numTowers);
+			if( !sameShape(elements.back()) )
+				PALISADE_THROW(deserialize_error, "Ciphertext frame does not match the towers of the context");
+		}
+	}
+	ciphertext->SetDepth(depth);
+
+	// the packed words are copied to the front of each tower and expanded in place; UnpackBits
+	// rejects residues that are not reduced modulo the tower modulus
+	for( auto& el : ciphertext->GetMutableElements() ) {
+		auto towers = MutableNativeTowers(el);
+		for( usint t = 0; t < numTowers; t++ ) {
+			NativePoly& tower = *towers[t];
+			size_t bytes = TowerWords(ringDim, widths[t])*sizeof(uint64_t);
+			memcpy(static_cast<void *>(&tower[0]), r.Bytes(bytes), bytes);
+			NativeVector::UnpackBits(&tower[0], ringDim, tower.GetModulus(), widths[t], 0);
+		}
+	}
+}
+
+}
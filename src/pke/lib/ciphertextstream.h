@@ -0,0 +1,174 @@
+/**
+ * @file ciphertextstream.h -- Framed files of many ciphertexts, written and read one at a time.
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or other
+ * materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef SRC_PKE_LIB_CIPHERTEXTSTREAM_H_
+#define SRC_PKE_LIB_CIPHERTEXTSTREAM_H_
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cryptocontext.h"
+
+namespace lbcrypto {
+
+/**
+ * @brief CiphertextStreamWriter writes ciphertexts to a file one at a time
+ *
+ * The file starts with a header holding the fingerprint of the context, followed by one
+ * length-prefixed frame per ciphertext. In a frame every tower is bit-packed to the width
+ * of its modulus. Close writes an index of the frame offsets, which a reader uses for
+ * random access; a file without one can still be read in order.
+ *
+ * Only ciphertexts over native-word elements (NativePoly and DCRTPoly) can be written.
+ */
+template<typename Element>
+class CiphertextStreamWriter {
+public:
+	/**
+	 * @param cc - context of the ciphertexts that will be written
+	 * @param filename - file to create
+	 */
+	CiphertextStreamWriter(const CryptoContext<Element> cc, const string& filename);
+
+	~CiphertextStreamWriter();
+
+	CiphertextStreamWriter(const CiphertextStreamWriter&) = delete;
+	CiphertextStreamWriter& operator=(const CiphertextStreamWriter&) = delete;
+
+	/**
+	 * Append a ciphertext
+	 * @param ciphertext
+	 */
+	void Write(ConstCiphertext<Element> ciphertext);
+
+	/**
+	 * Write the index and close the file; called by the destructor if needed
+	 */
+	void Close();
+
+	/**
+	 * @return number of ciphertexts written so far
+	 */
+	size_t GetCount() const { return m_offsets.size(); }
+
+private:
+	CryptoContext<Element>	m_cc;
+	string					m_filename;
+	std::ofstream			m_os;
+	uint64_t				m_pos;
+	std::vector<uint64_t>	m_offsets;
+};
+
+/**
+ * @brief CiphertextStreamReader reads a file written by CiphertextStreamWriter
+ *
+ * Ciphertexts are read in order with Read, or by position with ReadAt if the file has an
+ * index. With prefetch enabled a background thread reads frames ahead of the caller into a
+ * pool of buffers, so decoding overlaps with I/O. Passing Read a ciphertext that nobody
+ * else holds and that has the same shape as the next one decodes into its existing
+ * elements, so reading a dataset in a loop does not allocate.
+ */
+template<typename Element>
+class CiphertextStreamReader {
+public:
+	/**
+	 * @param cc - context to read the ciphertexts into; must match the fingerprint in the file
+	 * @param filename - file to open
+	 * @param prefetch - number of frames read ahead in the background; 0 reads on demand
+	 */
+	CiphertextStreamReader(const CryptoContext<Element> cc, const string& filename, size_t prefetch = 0);
+
+	~CiphertextStreamReader();
+
+	CiphertextStreamReader(const CiphertextStreamReader&) = delete;
+	CiphertextStreamReader& operator=(const CiphertextStreamReader&) = delete;
+
+	/**
+	 * Read the next ciphertext
+	 *
+	 * @param ciphertext - result; reused in place when possible
+	 * @return false at the end of the stream
+	 */
+	bool Read(Ciphertext<Element>& ciphertext);
+
+	/**
+	 * Read the ciphertext at a position; following calls to Read continue from there
+	 *
+	 * @param i - position in the stream
+	 * @return the ciphertext
+	 */
+	Ciphertext<Element> ReadAt(size_t i);
+
+	/**
+	 * Position the stream so that the next Read returns ciphertext i
+	 * @param i
+	 */
+	void Seek(size_t i);
+
+	/**
+	 * @return true if the file has an index, allowing Seek, ReadAt and GetCount
+	 */
+	bool HasIndex() const { return m_indexed; }
+
+	/**
+	 * @return number of ciphertexts in the file
+	 */
+	size_t GetCount() const;
+
+private:
+	bool ReadFrame(std::vector<uint8_t>& frame);
+	void Decode(const std::vector<uint8_t>& frame, Ciphertext<Element>& ciphertext) const;
+	void StartPrefetch();
+	void StopPrefetch();
+	void Prefetch();
+
+	CryptoContext<Element>				m_cc;
+	string								m_filename;
+	std::ifstream						m_is;
+	bool								m_indexed;
+	uint64_t							m_dataEnd;
+	std::vector<uint64_t>				m_offsets;
+
+	size_t								m_prefetch;
+	std::thread							m_thread;
+	std::mutex							m_mutex;
+	std::condition_variable				m_cv;
+	std::deque<std::vector<uint8_t>>	m_ready;	/*!< frames read ahead, in order */
+	std::vector<std::vector<uint8_t>>	m_free;		/*!< buffers to reuse */
+	bool								m_done;		/*!< no more frames will be read ahead */
+	bool								m_stop;
+	std::exception_ptr					m_error;
+	std::vector<uint8_t>				m_frame;	/*!< used when reading on demand */
+};
+
+}
+
+#endif /* SRC_PKE_LIB_CIPHERTEXTSTREAM_H_ */
@@ -26,18 +26,25 @@
 
 #include "cryptocontext.cpp"
 #include "cryptocontextfactory.cpp"
+#include "evalkeystore.cpp"
 
 namespace lbcrypto {
 template class CryptoContextFactory<Poly>;
 template class CryptoContextImpl<Poly>;
 template class CryptoObject<Poly>;
+template class EvalKeyStore<Poly>;
+template class EvalKeyBundle<Poly>;
 
 template class CryptoContextFactory<NativePoly>;
 template class CryptoContextImpl<NativePoly>;
 template class CryptoObject<NativePoly>;
+template class EvalKeyStore<NativePoly>;
+template class EvalKeyBundle<NativePoly>;
 
 template class CryptoContextFactory<DCRTPoly>;
 template class CryptoContextImpl<DCRTPoly>;
 template class CryptoObject<DCRTPoly>;
+template class EvalKeyStore<DCRTPoly>;
+template class EvalKeyBundle<DCRTPoly>;
 
 }
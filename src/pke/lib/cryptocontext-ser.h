@@ -38,6 +38,9 @@ extern template class lbcrypto::CryptoContextImpl<lbcrypto::DCRTPoly>;
 CEREAL_CLASS_VERSION( lbcrypto::CryptoContextImpl<lbcrypto::Poly>, lbcrypto::CryptoContextImpl<lbcrypto::Poly>::SerializedVersion() );
 CEREAL_CLASS_VERSION( lbcrypto::CryptoContextImpl<lbcrypto::NativePoly>, lbcrypto::CryptoContextImpl<lbcrypto::NativePoly>::SerializedVersion() );
 CEREAL_CLASS_VERSION( lbcrypto::CryptoContextImpl<lbcrypto::DCRTPoly>, lbcrypto::CryptoContextImpl<lbcrypto::DCRTPoly>::SerializedVersion() );
+CEREAL_CLASS_VERSION( lbcrypto::CryptoObject<lbcrypto::Poly>, lbcrypto::CryptoObject<lbcrypto::Poly>::SerializedVersion() );
+CEREAL_CLASS_VERSION( lbcrypto::CryptoObject<lbcrypto::NativePoly>, lbcrypto::CryptoObject<lbcrypto::NativePoly>::SerializedVersion() );
+CEREAL_CLASS_VERSION( lbcrypto::CryptoObject<lbcrypto::DCRTPoly>, lbcrypto::CryptoObject<lbcrypto::DCRTPoly>::SerializedVersion() );
 
 // the routines below are only instantiated if the user includes the appropriate serialize-*.h file
 
@@ -27,17 +27,96 @@
 
 #include "cryptocontext.h"
 #include "utils/serial.h"
+#include <limits>
+#include <iomanip>
 
 namespace lbcrypto {
 
 template <typename Element>
-std::map<string,std::vector<LPEvalKey<Element>>>					CryptoContextImpl<Element>::evalMultKeyMap;
+string CryptoContextImpl<Element>::ComputeFingerprint(const shared_ptr<LPCryptoParameters<Element>> params,
+		const shared_ptr<LPPublicKeyEncryptionScheme<Element>> scheme) {
+	if( !params || !scheme )
+		PALISADE_THROW(config_error, "Cannot fingerprint a context without parameters and scheme");
+
+	// the printed parameters cover every member that operator== compares; doubles
+	// are printed with enough digits to tell apart any two distinct values
+	std::stringstream s;
+	s << std::setprecision(std::numeric_limits<double>::max_digits10);
+	s << params->SerializedObjectName() << " " << scheme->SerializedObjectName() << std::endl;
+	s << *params;
+	return HashUtil::HashString(s.str());
+}
 
 template <typename Element>
-std::map<string,shared_ptr<std::map<usint,LPEvalKey<Element>>>>	CryptoContextImpl<Element>::evalSumKeyMap;
+vector<Plaintext> CryptoContextImpl<Element>::MakePackedPlaintexts(const vector<vector<int64_t>>& values) const {
+
+	vector<Plaintext> plaintexts(values.size());
+	string error;
+
+	// every plaintext shares the encoding params, and the packing plan they keep, so the threads only read it
+#pragma omp parallel for schedule(dynamic)
+	for( size_t i = 0; i < values.size(); i++ ) {
+		try {
+			plaintexts[i] = PlaintextFactory::MakePlaintext( Packed, this->GetElementParams(), this->GetEncodingParams(), values[i] );
+		}
+		catch( const std::exception& e ) {
+#pragma omp critical
+			{
+				if( error.empty() )
+					error = e.what();
+			}
+		}
+	}
+	if( !error.empty() )
+		throw std::logic_error(error);
+
+	return plaintexts;
+}
 
 template <typename Element>
-std::map<string,shared_ptr<std::map<usint,LPEvalKey<Element>>>>	CryptoContextImpl<Element>::evalAutomorphismKeyMap;
+vector<Ciphertext<Element>> CryptoContextImpl<Element>::EncryptPacked(const LPPublicKey<Element> publicKey,
+		const vector<vector<int64_t>>& values) const {
+
+	if( publicKey == NULL || Mismatched(publicKey->GetCryptoContext()) )
+		throw std::logic_error("key passed to EncryptPacked was not generated with this crypto context");
+
+	TimeVar t;
+	if( doTiming ) TIC(t);
+
+	const shared_ptr<const PackedEncodingPlan> plan = PackedEncoding::GetPlan(GetCyclotomicOrder(), GetEncodingParams());
+
+	vector<Ciphertext<Element>> ciphertexts(values.size());
+	string error;
+
+#pragma omp parallel
+	{
+		// each thread packs into the same buffer for all of its rows
+		NativeVector coefficients;
+
+#pragma omp for schedule(dynamic)
+		for( size_t i = 0; i < values.size(); i++ ) {
+			try {
+				plan->Pack(values[i], &coefficients);
+				ciphertexts[i] = GetEncryptionAlgorithm()->EncryptPacked(publicKey, coefficients);
+				ciphertexts[i]->SetEncodingType( Packed );
+			}
+			catch( const std::exception& e ) {
+#pragma omp critical
+				{
+					if( error.empty() )
+						error = e.what();
+				}
+			}
+		}
+	}
+	if( !error.empty() )
+		throw std::logic_error(error);
+
+	if( doTiming ) {
+		timeSamples->push_back( TimingInfo(OpEncryptPub, TOC_US(t)) );
+	}
+	return ciphertexts;
+}
 
 template <typename Element>
 void CryptoContextImpl<Element>::EvalMultKeyGen(const LPPrivateKey<Element> key) {
@@ -54,7 +133,7 @@ void CryptoContextImpl<Element>::EvalMultKeyGen(const LPPrivateKey<Element> key)
 		timeSamples->push_back( TimingInfo(OpEvalMultKeyGen, currentDateTime() - start) );
 	}
 
-	evalMultKeyMap[ k->GetKeyTag() ] = { k };
+	evalMultKeyCache.Put( k->GetKeyTag(), std::make_shared<std::vector<LPEvalKey<Element>>>(1, k) );
 }
 
 template <typename Element>
@@ -72,25 +151,39 @@ void CryptoContextImpl<Element>::EvalMultKeysGen(const LPPrivateKey<Element> key
 		timeSamples->push_back( TimingInfo(OpEvalMultKeyGen, currentDateTime() - start) );
 	}
 
-	evalMultKeyMap[ evalKeys[0]->GetKeyTag() ] = evalKeys;
+	evalMultKeyCache.Put( evalKeys[0]->GetKeyTag(), std::make_shared<std::vector<LPEvalKey<Element>>>(evalKeys) );
+}
+
+template <typename Element>
+shared_ptr<const vector<LPEvalKey<Element>>> CryptoContextImpl<Element>::GetEvalMultKeyVectorPtr(const string& keyID) {
+	KeyTagTable::Handle handle = KeyTagTable::Find(keyID);
+	for( const auto& cc : CryptoContextFactory<Element>::GetAllContexts() ) {
+		auto ek = cc->evalMultKeyCache.Get(handle);
+		if( ek )
+			return ek;
+	}
+	throw std::logic_error("You need to use EvalMultKeyGen so that you have an EvalMultKey available for this ID");
 }
 
 template <typename Element>
 const vector<LPEvalKey<Element>>& CryptoContextImpl<Element>::GetEvalMultKeyVector(const string& keyID) {
-	auto ekv = evalMultKeyMap.find(keyID);
-	if( ekv == evalMultKeyMap.end() )
-		throw std::logic_error("You need to use EvalMultKeyGen so that you have an EvalMultKey available for this ID");
-	return ekv->second;
+	// the context's cache keeps the keys alive until they are cleared
+	return *GetEvalMultKeyVectorPtr(keyID);
 }
 
 template <typename Element>
-const std::map<string,std::vector<LPEvalKey<Element>>>& CryptoContextImpl<Element>::GetAllEvalMultKeys() {
-	return evalMultKeyMap;
+std::map<string,std::vector<LPEvalKey<Element>>> CryptoContextImpl<Element>::GetAllEvalMultKeys() {
+	std::map<string,std::vector<LPEvalKey<Element>>> all;
+	for( const auto& cc : CryptoContextFactory<Element>::GetAllContexts() )
+		for( const auto& k : cc->evalMultKeyCache.GetAll() )
+			all[ (*k.second)[0]->GetKeyTag() ] = *k.second;
+	return all;
 }
 
 template <typename Element>
 void CryptoContextImpl<Element>::ClearEvalMultKeys() {
-	evalMultKeyMap.clear();
+	for( const auto& cc : CryptoContextFactory<Element>::GetAllContexts() )
+		cc->evalMultKeyCache.Clear();
 }
 
 /**
@@ -99,9 +192,11 @@ void CryptoContextImpl<Element>::ClearEvalMultKeys() {
  */
 template <typename Element>
 void CryptoContextImpl<Element>::ClearEvalMultKeys(const string& id) {
-	auto kd = evalMultKeyMap.find(id);
-	if( kd != evalMultKeyMap.end() )
-		evalMultKeyMap.erase(kd);
+	KeyTagTable::Handle handle = KeyTagTable::Find(id);
+	if( handle == KeyTagTable::NoHandle )
+		return;
+	for( const auto& cc : CryptoContextFactory<Element>::GetAllContexts() )
+		cc->evalMultKeyCache.Erase(handle);
 }
 
 /**
@@ -110,18 +205,14 @@ void CryptoContextImpl<Element>::ClearEvalMultKeys(const string& id) {
  */
 template <typename Element>
 void CryptoContextImpl<Element>::ClearEvalMultKeys(const CryptoContext<Element> cc) {
-	for( auto it = evalMultKeyMap.begin(); it != evalMultKeyMap.end(); ) {
-		if( it->second[0]->GetCryptoContext() == cc ) {
-			it = evalMultKeyMap.erase(it);
-		}
-		else
-			++it;
-	}
+	if( cc )
+		cc->evalMultKeyCache.Clear();
 }
 
 template <typename Element>
 void CryptoContextImpl<Element>::InsertEvalMultKey(const std::vector<LPEvalKey<Element>>& vectorToInsert) {
-	evalMultKeyMap[ vectorToInsert[0]->GetKeyTag() ] = vectorToInsert;
+	vectorToInsert[0]->GetCryptoContext()->evalMultKeyCache.Put( vectorToInsert[0]->GetKeyTag(),
+			std::make_shared<std::vector<LPEvalKey<Element>>>(vectorToInsert) );
 }
 
 template <typename Element>
@@ -144,58 +235,69 @@ void CryptoContextImpl<Element>::EvalSumKeyGen(
 	if( doTiming ) {
 		timeSamples->push_back( TimingInfo(OpEvalSumKeyGen, currentDateTime() - start) );
 	}
-	evalSumKeyMap[privateKey->GetKeyTag()] = evalKeys;
+	evalSumKeyCache.Put( privateKey->GetKeyTag(), evalKeys );
+}
+
+template <typename Element>
+shared_ptr<const std::map<usint, LPEvalKey<Element>>> CryptoContextImpl<Element>::GetEvalSumKeyMapPtr(const string& keyID) {
+	KeyTagTable::Handle handle = KeyTagTable::Find(keyID);
+	for( const auto& cc : CryptoContextFactory<Element>::GetAllContexts() ) {
+		auto ek = cc->evalSumKeyCache.Get(handle);
+		if( ek )
+			return ek;
+	}
+	throw std::logic_error("You need to use EvalSumKeyGen so that you have EvalSumKeys available for this ID");
 }
 
 template <typename Element>
 const std::map<usint, LPEvalKey<Element>>& CryptoContextImpl<Element>::GetEvalSumKeyMap(const string& keyID) {
-	auto ekv = evalSumKeyMap.find(keyID);
-	if( ekv == evalSumKeyMap.end() )
-		throw std::logic_error("You need to use EvalSumKeyGen so that you have EvalSumKeys available for this ID");
-	return *ekv->second;
+	// the context's cache keeps the keys alive until they are cleared
+	return *GetEvalSumKeyMapPtr(keyID);
 }
 
 template <typename Element>
-const std::map<string,shared_ptr<std::map<usint, LPEvalKey<Element>>>>& CryptoContextImpl<Element>::GetAllEvalSumKeys() {
-	return evalSumKeyMap;
+std::map<string,shared_ptr<std::map<usint, LPEvalKey<Element>>>> CryptoContextImpl<Element>::GetAllEvalSumKeys() {
+	std::map<string,shared_ptr<std::map<usint, LPEvalKey<Element>>>> all;
+	for( const auto& cc : CryptoContextFactory<Element>::GetAllContexts() )
+		for( const auto& k : cc->evalSumKeyCache.GetAll() )
+			all[ k.second->begin()->second->GetKeyTag() ] = k.second;
+	return all;
 }
 
 template <typename Element>
 void CryptoContextImpl<Element>::ClearEvalSumKeys() {
-	evalSumKeyMap.clear();
+	for( const auto& cc : CryptoContextFactory<Element>::GetAllContexts() )
+		cc->evalSumKeyCache.Clear();
 }
 
 /**
- * ClearEvalMultKeys - flush EvalMultKey cache for a given id
+ * ClearEvalSumKeys - flush EvalSumKey cache for a given id
  * @param id
  */
 template <typename Element>
 void CryptoContextImpl<Element>::ClearEvalSumKeys(const string& id) {
-	auto kd = evalSumKeyMap.find(id);
-	if( kd != evalSumKeyMap.end() )
-		evalSumKeyMap.erase(kd);
+	KeyTagTable::Handle handle = KeyTagTable::Find(id);
+	if( handle == KeyTagTable::NoHandle )
+		return;
+	for( const auto& cc : CryptoContextFactory<Element>::GetAllContexts() )
+		cc->evalSumKeyCache.Erase(handle);
 }
 
 /**
- * ClearEvalMultKeys - flush EvalMultKey cache for a given context
+ * ClearEvalSumKeys - flush EvalSumKey cache for a given context
  * @param cc
  */
 template <typename Element>
 void CryptoContextImpl<Element>::ClearEvalSumKeys(const CryptoContext<Element> cc) {
-	for( auto it = evalSumKeyMap.begin(); it != evalSumKeyMap.end(); ) {
-		if( it->second->begin()->second->GetCryptoContext() == cc ) {
-			it = evalSumKeyMap.erase(it);
-		}
-		else
-			++it;
-	}
+	if( cc )
+		cc->evalSumKeyCache.Clear();
 }
 
 template <typename Element>
 void CryptoContextImpl<Element>::InsertEvalSumKey(const shared_ptr<std::map<usint,LPEvalKey<Element>>> mapToInsert) {
 	// find the tag
 	auto onekey = mapToInsert->begin();
-	evalSumKeyMap[ onekey->second->GetKeyTag() ] = mapToInsert;
+	onekey->second->GetCryptoContext()->evalSumKeyCache.Put( onekey->second->GetKeyTag(), mapToInsert );
 }
 
 template <typename Element>
@@ -218,25 +320,41 @@ void CryptoContextImpl<Element>::EvalAtIndexKeyGen(const LPPrivateKey<Element> p
 		timeSamples->push_back( TimingInfo(OpEvalAtIndexKeyGen, currentDateTime() - start) );
 	}
 
-	evalAutomorphismKeyMap[privateKey->GetKeyTag()] = evalKeys;
+	evalAutomorphismKeyCache.Put( privateKey->GetKeyTag(), evalKeys );
+}
+
+template <typename Element>
+shared_ptr<const std::map<usint, LPEvalKey<Element>>> CryptoContextImpl<Element>::GetEvalAutomorphismKeyMapPtr(const string& keyID) {
+	KeyTagTable::Handle handle = KeyTagTable::Find(keyID);
+	for( const auto& cc : CryptoContextFactory<Element>::GetAllContexts() ) {
+		auto ek = cc->evalAutomorphismKeyCache.Get(handle);
+		if( ek )
+			return ek;
+	}
+	throw std::logic_error("You need to use EvalAutomorphismKeyGen so that you have EvalAutomorphismKeys available for this ID");
 }
 
 template <typename Element>
 const std::map<usint, LPEvalKey<Element>>& CryptoContextImpl<Element>::GetEvalAutomorphismKeyMap(const string& keyID) {
-	auto ekv = evalAutomorphismKeyMap.find(keyID);
-	if( ekv == evalAutomorphismKeyMap.end() )
-		throw std::logic_error("You need to use EvalAutomorphismKeyGen so that you have EvalAutomorphismKeys available for this ID");
-	return *ekv->second;
+	// the context's cache keeps the keys alive until they are cleared
+	return *GetEvalAutomorphismKeyMapPtr(keyID);
 }
 
 template <typename Element>
-const std::map<string,shared_ptr<std::map<usint, LPEvalKey<Element>>>>& CryptoContextImpl<Element>::GetAllEvalAutomorphismKeys() {
-	return evalAutomorphismKeyMap;
+std::map<string,shared_ptr<std::map<usint, LPEvalKey<Element>>>> CryptoContextImpl<Element>::GetAllEvalAutomorphismKeys() {
+	std::map<string,shared_ptr<std::map<usint, LPEvalKey<Element>>>> all;
+	for( const auto& cc : CryptoContextFactory<Element>::GetAllContexts() )
+		for( const auto& k : cc->evalAutomorphismKeyCache.GetAll() )
+			all[ k.second->begin()->second->GetKeyTag() ] = k.second;
+	return all;
 }
 
 template <typename Element>
 void CryptoContextImpl<Element>::ClearEvalAutomorphismKeys() {
-	evalAutomorphismKeyMap.clear();
+	for( const auto& cc : CryptoContextFactory<Element>::GetAllContexts() ) {
+		cc->evalAutomorphismKeyCache.Clear();
+		cc->evalAutomorphismKeyStoreCache.Clear();
+	}
 }
 
 /**
@@ -245,9 +363,13 @@ void CryptoContextImpl<Element>::ClearEvalAutomorphismKeys() {
  */
 template <typename Element>
 void CryptoContextImpl<Element>::ClearEvalAutomorphismKeys(const string& id) {
-	auto kd = evalAutomorphismKeyMap.find(id);
-	if( kd != evalAutomorphismKeyMap.end() )
-		evalAutomorphismKeyMap.erase(kd);
+	KeyTagTable::Handle handle = KeyTagTable::Find(id);
+	if( handle == KeyTagTable::NoHandle )
+		return;
+	for( const auto& cc : CryptoContextFactory<Element>::GetAllContexts() ) {
+		cc->evalAutomorphismKeyCache.Erase(handle);
+		cc->evalAutomorphismKeyStoreCache.Erase(handle);
+	}
 }
 
 /**
@@ -256,12 +378,9 @@ void CryptoContextImpl<Element>::ClearEvalAutomorphismKeys(const string& id) {
  */
 template <typename Element>
 void CryptoContextImpl<Element>::ClearEvalAutomorphismKeys(const CryptoContext<Element> cc) {
-	for( auto it = evalAutomorphismKeyMap.begin(); it != evalAutomorphismKeyMap.end(); ) {
-		if( it->second->begin()->second->GetCryptoContext() == cc ) {
-			it = evalAutomorphismKeyMap.erase(it);
-		}
-		else
-			++it;
+	if( cc ) {
+		cc->evalAutomorphismKeyCache.Clear();
+		cc->evalAutomorphismKeyStoreCache.Clear();
 	}
 }
 
@@ -269,7 +388,102 @@ template <typename Element>
 void CryptoContextImpl<Element>::InsertEvalAutomorphismKey(const shared_ptr<std::map<usint,LPEvalKey<Element>>> mapToInsert) {
 	// find the tag
 	auto onekey = mapToInsert->begin();
-	evalAutomorphismKeyMap[ onekey->second->GetKeyTag() ] = mapToInsert;
+	onekey->second->GetCryptoContext()->evalAutomorphismKeyCache.Put( onekey->second->GetKeyTag(), mapToInsert );
+}
+
+template <typename Element>
+bool CryptoContextImpl<Element>::SerializeEvalAutomorphismKeyStore(const string& filename, const string& id) {
+	auto all = GetAllEvalAutomorphismKeys();
+	auto k = all.find(id);
+	if( k == all.end() )
+		return false; // no such id
+
+	EvalKeyStore<Element>::Write(filename, *k->second);
+	return true;
+}
+
+template <typename Element>
+shared_ptr<EvalKeyStore<Element>> CryptoContextImpl<Element>::LoadEvalAutomorphismKeyStore(const string& filename, size_t maxResidentKeys) {
+	auto store = std::make_shared<EvalKeyStore<Element>>(CryptoContextFactory<Element>::GetContextForPointer(this), filename, maxResidentKeys);
+	evalAutomorphismKeyStoreCache.Put( store->GetKeyTag(), store );
+	return store;
+}
+
+template <typename Element>
+shared_ptr<EvalKeyStore<Element>> CryptoContextImpl<Element>::GetEvalAutomorphismKeyStore(const string& id) {
+	KeyTagTable::Handle handle = KeyTagTable::Find(id);
+	for( const auto& cc : CryptoContextFactory<Element>::GetAllContexts() ) {
+		auto ks = cc->evalAutomorphismKeyStoreCache.Get(handle);
+		if( ks )
+			return ks;
+	}
+	return shared_ptr<EvalKeyStore<Element>>();
+}
+
+template <typename Element>
+bool CryptoContextImpl<Element>::SerializeEvalKeyBundle(std::ostream& ser, const CryptoContext<Element> cc, const string& id) {
+	if( !cc )
+		return false;
+
+	EvalKeyBundle<Element> bundle;
+	auto wanted = [&id](const string& tag) { return id.length() == 0 || tag == id; };
+	for( const auto& k : cc->evalMultKeyCache.GetAll() ) {
+		const string tag = (*k.second)[0]->GetKeyTag();
+		if( wanted(tag) )
+			bundle.multKeys[tag] = *k.second;
+	}
+	for( const auto& k : cc->evalSumKeyCache.GetAll() ) {
+		const string tag = k.second->begin()->second->GetKeyTag();
+		if( wanted(tag) )
+			bundle.sumKeys[tag] = *k.second;
+	}
+	for( const auto& k : cc->evalAutomorphismKeyCache.GetAll() ) {
+		const string tag = k.second->begin()->second->GetKeyTag();
+		if( wanted(tag) )
+			bundle.automorphismKeys[tag] = *k.second;
+	}
+
+	if( bundle.Empty() )
+		return false;
+
+	bundle.Write(ser, cc);
+	return true;
+}
+
+template <typename Element>
+bool CryptoContextImpl<Element>::DeserializeEvalKeyBundle(std::istream& ser, const CryptoContext<Element> cc) {
+	EvalKeyBundle<Element> bundle;
+	bundle.Read(ser, cc);
+
+	for( auto& k : bundle.multKeys )
+		cc->evalMultKeyCache.Put( k.first, std::make_shared<std::vector<LPEvalKey<Element>>>(std::move(k.second)) );
+	for( auto& k : bundle.sumKeys )
+		cc->evalSumKeyCache.Put( k.first, std::make_shared<std::map<usint,LPEvalKey<Element>>>(std::move(k.second)) );
+	for( auto& k : bundle.automorphismKeys )
+		cc->evalAutomorphismKeyCache.Put( k.first, std::make_shared<std::map<usint,LPEvalKey<Element>>>(std::move(k.second)) );
+
+	return true;
+}
+
+template <typename Element>
+Ciphertext<Element> CryptoContextImpl<Element>::EvalAutomorphism(ConstCiphertext<Element> ciphertext, usint i) const {
+
+	if( ciphertext == NULL || Mismatched(ciphertext->GetCryptoContext()) )
+		throw std::logic_error("Information passed to EvalAutomorphism was not generated with this crypto context");
+
+	KeyTagTable::Handle handle = ciphertext->GetKeyHandle();
+	auto ekv = evalAutomorphismKeyCache.Get(handle);
+	if( ekv )
+		return EvalAutomorphism(ciphertext, i, *ekv);
+
+	auto ks = evalAutomorphismKeyStoreCache.Get(handle);
+	if( !ks )
+		throw std::logic_error("You need to use EvalAutomorphismKeyGen so that you have EvalAutomorphismKeys available for this ID");
+
+	// the scheme looks the key up by index, so hand it just the one key read from the store
+	std::map<usint, LPEvalKey<Element>> evalKeys;
+	evalKeys[i] = ks->GetKey(i);
+	return EvalAutomorphism(ciphertext, i, evalKeys);
 }
 
 /**
@@ -278,21 +492,19 @@ void CryptoContextImpl<Element>::InsertEvalAutomorphismKey(const shared_ptr<std:
 template <typename Element>
 template <typename ST>
 bool CryptoContextImpl<Element>::SerializeEvalMultKey(std::ostream& ser, const ST& sertype, const string id) {
-	decltype(evalMultKeyMap)	*smap;
-	decltype(evalMultKeyMap)	omap;
+	auto omap = GetAllEvalMultKeys();
 
-	if( id.length() == 0 )
-		smap = &evalMultKeyMap;
-	else {
-		auto k = evalMultKeyMap.find(id);
+	if( id.length() != 0 ) {
+		auto k = omap.find(id);
 
-		if( k == evalMultKeyMap.end() )
+		if( k == omap.end() )
 			return false; // no such id
 
-		smap = &omap;
-		omap[ k->first ] = k->second;
+		auto one = *k;
+		omap.clear();
+		omap.insert(one);
 	}
-	Serial::Serialize(*smap, ser, sertype);
+	Serial::Serialize(omap, ser, sertype);
 	return true;
 }
 
@@ -304,12 +516,9 @@ template <typename Element>
 template <typename ST>
 bool CryptoContextImpl<Element>::SerializeEvalMultKey(std::ostream& ser, const ST& sertype, const CryptoContext<Element> cc) {
 
-	decltype(evalMultKeyMap) omap;
-	for( const auto& k : evalMultKeyMap ) {
-		if( k.second[0]->GetCryptoContext() == cc ) {
-			omap[k.first] = k.second;
-		}
-	}
+	std::map<string,std::vector<LPEvalKey<Element>>> omap;
+	for( const auto& k : cc->evalMultKeyCache.GetAll() )
+		omap[ (*k.second)[0]->GetKeyTag() ] = *k.second;
 
 	if( omap.size() == 0 )
 		return false;
@@ -322,16 +531,15 @@ template <typename Element>
 template <typename ST>
 bool CryptoContextImpl<Element>::DeserializeEvalMultKey(std::istream& ser, const ST& sertype) {
 
-	decltype(evalMultKeyMap) evalMultKeys;
+	std::map<string,std::vector<LPEvalKey<Element>>> evalMultKeys;
 
 	Serial::Deserialize(evalMultKeys, ser, sertype);
 
 	// The deserialize call created any contexts that needed to be created.... so all we need to do
-	// is put the keys into the maps for their context
+	// is put the keys into the caches for their context
 
-	for( auto k : evalMultKeys ) {
-
-		evalMultKeyMap[ k.first ] = k.second;
+	for( const auto& k : evalMultKeys ) {
+		InsertEvalMultKey(k.second);
 	}
 
 	return true;
@@ -343,20 +551,19 @@ bool CryptoContextImpl<Element>::DeserializeEvalMultKey(std::istream& ser, const
 template <typename Element>
 template <typename ST>
 bool CryptoContextImpl<Element>::SerializeEvalSumKey(std::ostream& ser, const ST& sertype, string id) {
-	decltype(evalSumKeyMap)*	smap;
-	decltype(evalSumKeyMap)		omap;
-	if( id.length() == 0 )
-		smap = &evalSumKeyMap;
-	else {
-		auto k = evalSumKeyMap.find(id);
-
-		if( k == evalSumKeyMap.end() )
+	auto omap = GetAllEvalSumKeys();
+
+	if( id.length() != 0 ) {
+		auto k = omap.find(id);
+
+		if( k == omap.end() )
 			return false; // no such id
 
-		smap = &omap;
-		omap[ k->first ] = k->second;
+		auto one = *k;
+		omap.clear();
+		omap.insert(one);
 	}
-	Serial::Serialize(*smap, ser, sertype);
+	Serial::Serialize(omap, ser, sertype);
 	return true;
 }
 
@@ -368,12 +575,9 @@ template <typename Element>
 template <typename ST>
 bool CryptoContextImpl<Element>::SerializeEvalSumKey(std::ostream& ser, const ST& sertype, const CryptoContext<Element> cc) {
 
-	decltype(evalSumKeyMap) omap;
-	for( const auto& k : evalSumKeyMap ) {
-		if( k.second->begin()->second->GetCryptoContext() == cc ) {
-			omap[k.first] = k.second;
-		}
-	}
+	std::map<string,shared_ptr<std::map<usint,LPEvalKey<Element>>>> omap;
+	for( const auto& k : cc->evalSumKeyCache.GetAll() )
+		omap[ k.second->begin()->second->GetKeyTag() ] = k.second;
 
 	if( omap.size() == 0 )
 		return false;
@@ -386,15 +590,15 @@ template <typename Element>
 template <typename ST>
 bool CryptoContextImpl<Element>::DeserializeEvalSumKey(std::istream& ser, const ST& sertype) {
 
-	decltype(evalSumKeyMap) evalSumKeys;
+	std::map<string,shared_ptr<std::map<usint,LPEvalKey<Element>>>> evalSumKeys;
 
 	Serial::Deserialize(evalSumKeys, ser, sertype);
 
 	// The deserialize call created any contexts that needed to be created.... so all we need to do
-	// is put the keys into the maps for their context
+	// is put the keys into the caches for their context
 
-	for( auto k : evalSumKeys ) {
-		evalSumKeyMap[ k.first ] = k.second;
+	for( const auto& k : evalSumKeys ) {
+		InsertEvalSumKey(k.second);
 	}
 
 	return true;
@@ -406,10 +610,10 @@ Ciphertext<Element> CryptoContextImpl<Element>::EvalSum(ConstCiphertext<Element>
 	if( ciphertext == NULL || Mismatched(ciphertext->GetCryptoContext()) )
 		throw std::logic_error("Information passed to EvalSum was not generated with this crypto context");
 
-	auto evalSumKeys = CryptoContextImpl<Element>::GetEvalSumKeyMap(ciphertext->GetKeyTag());
+	auto evalSumKeys = FindEvalSumKeys(ciphertext->GetKeyHandle());
 	double start = 0;
 	if( doTiming ) start = currentDateTime();
-	auto rv = GetEncryptionAlgorithm()->EvalSum(ciphertext, batchSize, evalSumKeys);
+	auto rv = GetEncryptionAlgorithm()->EvalSum(ciphertext, batchSize, *evalSumKeys);
 	if( doTiming ) {
 		timeSamples->push_back( TimingInfo(OpEvalSum, currentDateTime() - start) );
 	}
@@ -419,20 +623,19 @@ Ciphertext<Element> CryptoContextImpl<Element>::EvalSum(ConstCiphertext<Element>
 template <typename Element>
 template <typename ST>
 bool CryptoContextImpl<Element>::SerializeEvalAutomorphismKey(std::ostream& ser, const ST& sertype, string id) {
-	decltype(evalAutomorphismKeyMap)*	smap;
-	decltype(evalAutomorphismKeyMap)		omap;
-	if( id.length() == 0 )
-		smap = &evalAutomorphismKeyMap;
-	else {
-		auto k = evalAutomorphismKeyMap.find(id);
-
-		if( k == evalAutomorphismKeyMap.end() )
+	auto omap = GetAllEvalAutomorphismKeys();
+
+	if( id.length() != 0 ) {
+		auto k = omap.find(id);
+
+		if( k == omap.end() )
 			return false; // no such id
 
-		smap = &omap;
-		omap[ k->first ] = k->second;
+		auto one = *k;
+		omap.clear();
+		omap.insert(one);
 	}
-	Serial::Serialize(*smap, ser, sertype);
+	Serial::Serialize(omap, ser, sertype);
 	return true;
 }
 
@@ -440,12 +643,9 @@ template <typename Element>
 template <typename ST>
 bool CryptoContextImpl<Element>::SerializeEvalAutomorphismKey(std::ostream& ser, const ST& sertype, const CryptoContext<Element> cc) {
 
-	decltype(evalAutomorphismKeyMap) omap;
-	for( const auto& k : evalAutomorphismKeyMap ) {
-		if( k.second->begin()->second->GetCryptoContext() == cc ) {
-			omap[k.first] = k.second;
-		}
-	}
+	std::map<string,shared_ptr<std::map<usint,LPEvalKey<Element>>>> omap;
+	for( const auto& k : cc->evalAutomorphismKeyCache.GetAll() )
+		omap[ k.second->begin()->second->GetKeyTag() ] = k.second;
 
 	if( omap.size() == 0 )
 		return false;
@@ -458,15 +658,15 @@ template <typename Element>
 template <typename ST>
 bool CryptoContextImpl<Element>::DeserializeEvalAutomorphismKey(std::istream& ser, const ST& sertype) {
 
-	decltype(evalAutomorphismKeyMap) evalSumKeys;
+	std::map<string,shared_ptr<std::map<usint,LPEvalKey<Element>>>> evalAutomorphismKeys;
 
-	Serial::Deserialize(evalSumKeys, ser, sertype);
+	Serial::Deserialize(evalAutomorphismKeys, ser, sertype);
 
 	// The deserialize call created any contexts that needed to be created.... so all we need to do
-	// is put the keys into the maps for their context
+	// is put the keys into the caches for their context
 
-	for( auto k : evalSumKeys ) {
-		evalAutomorphismKeyMap[ k.first ] = k.second;
+	for( const auto& k : evalAutomorphismKeys ) {
+		InsertEvalAutomorphismKey(k.second);
 	}
 
 	return true;
@@ -478,10 +678,24 @@ Ciphertext<Element> CryptoContextImpl<Element>::EvalAtIndex(ConstCiphertext<Elem
 	if( ciphertext == NULL || Mismatched(ciphertext->GetCryptoContext()) )
 		throw std::logic_error("Information passed to EvalAtIndex was not generated with this crypto context");
 
-	auto evalAutomorphismKeys = CryptoContextImpl<Element>::GetEvalAutomorphismKeyMap(ciphertext->GetKeyTag());
+	KeyTagTable::Handle handle = ciphertext->GetKeyHandle();
+	auto evalAutomorphismKeys = evalAutomorphismKeyCache.Get(handle);
+	std::map<usint, LPEvalKey<Element>> storedKeys;
+	if( !evalAutomorphismKeys ) {
+		auto ks = evalAutomorphismKeyStoreCache.Get(handle);
+		if( ks ) {
+			// the scheme looks the key up by automorphism index, so hand it just the one key read from the store
+			usint autoIndex = LPSHEAlgorithm<Element>::FindAutomorphismIndex(ciphertext, index);
+			storedKeys[autoIndex] = ks->GetKey(autoIndex);
+		}
+		else
+			evalAutomorphismKeys = FindEvalAutomorphismKeys(handle);
+	}
+	const auto& evalKeys = evalAutomorphismKeys ? *evalAutomorphismKeys : storedKeys;
+
 	double start = 0;
 	if( doTiming ) start = currentDateTime();
-	auto rv = GetEncryptionAlgorithm()->EvalAtIndex(ciphertext, index, evalAutomorphismKeys);
+	auto rv = GetEncryptionAlgorithm()->EvalAtIndex(ciphertext, index, evalKeys);
 	if( doTiming ) {
 		timeSamples->push_back( TimingInfo(OpEvalAtIndex, currentDateTime() - start) );
 	}
@@ -494,10 +708,10 @@ Ciphertext<Element> CryptoContextImpl<Element>::EvalMerge(const vector<Ciphertex
 	if( ciphertextVector[0] == NULL || Mismatched(ciphertextVector[0]->GetCryptoContext()) )
 		throw std::logic_error("Information passed to EvalMerge was not generated with this crypto context");
 
-	auto evalAutomorphismKeys = CryptoContextImpl<Element>::GetEvalAutomorphismKeyMap(ciphertextVector[0]->GetKeyTag());
+	auto evalAutomorphismKeys = FindEvalAutomorphismKeys(ciphertextVector[0]->GetKeyHandle());
 	double start = 0;
 	if( doTiming ) start = currentDateTime();
-	auto rv = GetEncryptionAlgorithm()->EvalMerge(ciphertextVector, evalAutomorphismKeys);
+	auto rv = GetEncryptionAlgorithm()->EvalMerge(ciphertextVector, *evalAutomorphismKeys);
 	if( doTiming ) {
 		timeSamples->push_back( TimingInfo(OpEvalMerge, currentDateTime() - start) );
 	}
@@ -511,12 +725,12 @@ Ciphertext<Element> CryptoContextImpl<Element>::EvalInnerProduct(ConstCiphertext
 			Mismatched(ct1->GetCryptoContext()) )
 		throw std::logic_error("Information passed to EvalInnerProduct was not generated with this crypto context");
 
-	auto evalSumKeys = CryptoContextImpl<Element>::GetEvalSumKeyMap(ct1->GetKeyTag());
-	auto ek = GetEvalMultKeyVector(ct1->GetKeyTag());
+	auto evalSumKeys = FindEvalSumKeys(ct1->GetKeyHandle());
+	auto ek = FindEvalMultKeys(ct1->GetKeyHandle());
 
 	double start = 0;
 	if( doTiming ) start = currentDateTime();
-	auto rv = GetEncryptionAlgorithm()->EvalInnerProduct(ct1, ct2, batchSize, evalSumKeys, ek[0]);
+	auto rv = GetEncryptionAlgorithm()->EvalInnerProduct(ct1, ct2, batchSize, *evalSumKeys, (*ek)[0]);
 	if( doTiming ) {
 		timeSamples->push_back( TimingInfo(OpEvalInnerProduct, currentDateTime() - start) );
 	}
@@ -529,11 +743,11 @@ Ciphertext<Element> CryptoContextImpl<Element>::EvalInnerProduct(ConstCiphertext
 	if( ct1 == NULL || ct2 == NULL || Mismatched(ct1->GetCryptoContext()) )
 		throw std::logic_error("Information passed to EvalInnerProduct was not generated with this crypto context");
 
-	auto evalSumKeys = CryptoContextImpl<Element>::GetEvalSumKeyMap(ct1->GetKeyTag());
+	auto evalSumKeys = FindEvalSumKeys(ct1->GetKeyHandle());
 
 	double start = 0;
 	if( doTiming ) start = currentDateTime();
-	auto rv = GetEncryptionAlgorithm()->EvalInnerProduct(ct1, ct2, batchSize, evalSumKeys);
+	auto rv = GetEncryptionAlgorithm()->EvalInnerProduct(ct1, ct2, batchSize, *evalSumKeys);
 	if( doTiming ) {
 		timeSamples->push_back( TimingInfo(OpEvalInnerProduct, currentDateTime() - start) );
 	}
@@ -548,12 +762,12 @@ CryptoContextImpl<Element>::EvalCrossCorrelation(const shared_ptr<Matrix<Rationa
 
 	//need to add exception handling
 
-	auto evalSumKeys = CryptoContextImpl<Element>::GetEvalSumKeyMap((*x)(0,0).GetNumerator()->GetKeyTag());
-	auto ek = GetEvalMultKeyVector((*x)(0,0).GetNumerator()->GetKeyTag());
+	auto evalSumKeys = FindEvalSumKeys((*x)(0,0).GetNumerator()->GetKeyHandle());
+	auto ek = FindEvalMultKeys((*x)(0,0).GetNumerator()->GetKeyHandle());
 
 	double start = 0;
 	if( doTiming ) start = currentDateTime();
-	auto rv = GetEncryptionAlgorithm()->EvalCrossCorrelation(x, y, batchSize, indexStart, length, evalSumKeys, ek[0]);
+	auto rv = GetEncryptionAlgorithm()->EvalCrossCorrelation(x, y, batchSize, indexStart, length, *evalSumKeys, (*ek)[0]);
 	if( doTiming ) {
 		timeSamples->push_back( TimingInfo(OpEvalCrossCorrelation, currentDateTime() - start) );
 	}
@@ -567,12 +781,12 @@ CryptoContextImpl<Element>::EvalLinRegressBatched(const shared_ptr<Matrix<Ration
 		{
 	//need to add exception handling
 
-	auto evalSumKeys = CryptoContextImpl<Element>::GetEvalSumKeyMap((*x)(0,0).GetNumerator()->GetKeyTag());
-	auto ek = GetEvalMultKeyVector((*x)(0,0).GetNumerator()->GetKeyTag());
+	auto evalSumKeys = FindEvalSumKeys((*x)(0,0).GetNumerator()->GetKeyHandle());
+	auto ek = FindEvalMultKeys((*x)(0,0).GetNumerator()->GetKeyHandle());
 
 	double start = 0;
 	if( doTiming ) start = currentDateTime();
-	auto rv = GetEncryptionAlgorithm()->EvalLinRegressBatched(x, y, batchSize, evalSumKeys, ek[0]);
+	auto rv = GetEncryptionAlgorithm()->EvalLinRegressBatched(x, y, batchSize, *evalSumKeys, (*ek)[0]);
 	if( doTiming ) {
 		timeSamples->push_back( TimingInfo(OpEvalLinRegressionBatched, currentDateTime() - start) );
 	}
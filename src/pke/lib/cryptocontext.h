@@ -29,9 +29,13 @@
 #ifndef SRC_DEMO_PRE_CRYPTOCONTEXT_H_
 #define SRC_DEMO_PRE_CRYPTOCONTEXT_H_
 
+#include <mutex>
+
 #include "palisade.h"
 #include "cryptocontexthelper.h"
 #include "cryptotiming.h"
+#include "evalkeystore.h"
+#include "evalkeycache.h"
 
 namespace lbcrypto {
 
@@ -65,13 +69,43 @@ private:
 	shared_ptr<LPCryptoParameters<Element>>				params;			/*!< crypto parameters used for this context */
 	shared_ptr<LPPublicKeyEncryptionScheme<Element>>	scheme;			/*!< algorithm used; accesses all crypto methods */
 
-	static std::map<string,std::vector<LPEvalKey<Element>>>					evalMultKeyMap;	/*!< cached evalmult keys, by secret key UID */
-	static std::map<string,shared_ptr<std::map<usint,LPEvalKey<Element>>>>	evalSumKeyMap;	/*!< cached evalsum keys, by secret key UID */
-	static std::map<string,shared_ptr<std::map<usint,LPEvalKey<Element>>>>	evalAutomorphismKeyMap;	/*!< cached evalautomorphism keys, by secret key UID */
+	EvalKeyCache<std::vector<LPEvalKey<Element>>>		evalMultKeyCache;	/*!< evalmult keys for this context, by key tag handle */
+	EvalKeyCache<std::map<usint,LPEvalKey<Element>>>	evalSumKeyCache;	/*!< evalsum keys for this context, by key tag handle */
+	EvalKeyCache<std::map<usint,LPEvalKey<Element>>>	evalAutomorphismKeyCache;	/*!< evalautomorphism keys for this context, by key tag handle */
+	EvalKeyCache<EvalKeyStore<Element>>					evalAutomorphismKeyStoreCache;	/*!< on-disk evalautomorphism keys for this context, by key tag handle */
 
 	bool doTiming;
 	vector<TimingInfo>* timeSamples;
 
+	string fingerprint;		/*!< fingerprint of params and scheme, set when the factory registers the context */
+	std::weak_ptr<CryptoContextImpl<Element>> self;	/*!< set when the factory registers the context */
+
+	/**
+	 * FindEvalMultKeys - this context's evalmult keys for a key tag handle; does not lock
+	 * @param handle - from CryptoObject::GetKeyHandle
+	 * @return the keys; throws if there are none
+	 */
+	shared_ptr<std::vector<LPEvalKey<Element>>> FindEvalMultKeys(KeyTagTable::Handle handle) const {
+		auto ek = evalMultKeyCache.Get(handle);
+		if( !ek )
+			throw std::logic_error("You need to use EvalMultKeyGen so that you have an EvalMultKey available for this ID");
+		return ek;
+	}
+
+	shared_ptr<std::map<usint,LPEvalKey<Element>>> FindEvalSumKeys(KeyTagTable::Handle handle) const {
+		auto ek = evalSumKeyCache.Get(handle);
+		if( !ek )
+			throw std::logic_error("You need to use EvalSumKeyGen so that you have EvalSumKeys available for this ID");
+		return ek;
+	}
+
+	shared_ptr<std::map<usint,LPEvalKey<Element>>> FindEvalAutomorphismKeys(KeyTagTable::Handle handle) const {
+		auto ek = evalAutomorphismKeyCache.Get(handle);
+		if( !ek )
+			throw std::logic_error("You need to use EvalAutomorphismKeyGen so that you have EvalAutomorphismKeys available for this ID");
+		return ek;
+	}
+
 	/**
 	 * TypeCheck makes sure that an operation between two ciphertexts is permitted
 	 * @param a
@@ -197,6 +231,7 @@ public:
 		scheme = c.scheme;
 		doTiming = c.doTiming;
 		timeSamples = c.timeSamples;
+		fingerprint = c.fingerprint;
 	}
 
 	/**
@@ -209,6 +244,7 @@ public:
 		scheme = rhs.scheme;
 		doTiming = rhs.doTiming;
 		timeSamples = rhs.timeSamples;
+		fingerprint = rhs.fingerprint;
 		return *this;
 	}
 
@@ -217,6 +253,24 @@ public:
 	 */
 	operator bool() const { return bool(params) && bool(scheme); }
 
+	/**
+	 * ComputeFingerprint - digest of a parameter set and scheme. Contexts that compare
+	 * equal have the same fingerprint, in any process built from the same sources
+	 * @param params - crypto parameters
+	 * @param scheme - encryption scheme
+	 * @return SHA-256 digest of the parameters and scheme, in hexadecimal
+	 */
+	static string ComputeFingerprint(const shared_ptr<LPCryptoParameters<Element>> params,
+			const shared_ptr<LPPublicKeyEncryptionScheme<Element>> scheme);
+
+	/**
+	 * GetFingerprint - fingerprint of this context's parameters and scheme
+	 * @return SHA-256 digest in hexadecimal
+	 */
+	string GetFingerprint() const {
+		return fingerprint.empty() ? ComputeFingerprint(params, scheme) : fingerprint;
+	}
+
 	/**
 	 * Private methods to compare two contexts; this is only used internally and is not generally available
 	 * @param a - operand 1
@@ -472,6 +526,55 @@ public:
 	 */
 	static void InsertEvalAutomorphismKey(const shared_ptr<std::map<usint,LPEvalKey<Element>>> mapToInsert);
 
+	/**
+	 * SerializeEvalAutomorphismKeyStore - write the EvalAuto keys for an id to a key store file
+	 * that can be loaded one key at a time with LoadEvalAutomorphismKeyStore
+	 *
+	 * @param filename - file to write
+	 * @param id - key tag of the keys to write
+	 * @return false if there are no keys for the id
+	 */
+	static bool SerializeEvalAutomorphismKeyStore(const string& filename, const string& id);
+
+	/**
+	 * LoadEvalAutomorphismKeyStore - open a key store file written by SerializeEvalAutomorphismKeyStore
+	 * Only the index is read; EvalAtIndex and EvalAutomorphism read each key the first time it is used.
+	 * Keys in the EvalAuto key cache for the same id take precedence over the store.
+	 *
+	 * @param filename - file to open
+	 * @param maxResidentKeys - most keys kept in memory at once; 0 means no limit
+	 * @return the store
+	 */
+	shared_ptr<EvalKeyStore<Element>> LoadEvalAutomorphismKeyStore(const string& filename, size_t maxResidentKeys = 0);
+
+	/**
+	 * GetEvalAutomorphismKeyStore - the key store loaded for an id
+	 * @param id
+	 * @return the store, or null if none was loaded
+	 */
+	static shared_ptr<EvalKeyStore<Element>> GetEvalAutomorphismKeyStore(const string& id);
+
+	/**
+	 * SerializeEvalKeyBundle - write the EvalMult, EvalSum and EvalAuto keys of a context as an
+	 * EvalKeyBundle, which DeserializeEvalKeyBundle can decode in parallel
+	 *
+	 * @param ser - stream to write to
+	 * @param cc - context whose keys are written
+	 * @param id - key tag of the keys to write; empty string means all keys of the context
+	 * @return false if there are no keys to write
+	 */
+	static bool SerializeEvalKeyBundle(std::ostream& ser, const CryptoContext<Element> cc, const string& id = "");
+
+	/**
+	 * DeserializeEvalKeyBundle - read an EvalKeyBundle into the key caches of a context; the keys
+	 * are decoded in parallel and moved into the caches, replacing any keys with the same tag
+	 *
+	 * @param ser - stream to read from
+	 * @param cc - context the bundle was written for
+	 * @return true on success
+	 */
+	static bool DeserializeEvalKeyBundle(std::istream& ser, const CryptoContext<Element> cc);
+
 
 	// TURN FEATURES ON
 	/**
@@ -553,6 +656,21 @@ public:
 		return r;
 	}
 
+	/**
+	* KeyGenSeeded generates a key pair whose public key is serialized with a 32-byte seed
+	* in place of its uniformly random element, about half the size of a KeyGen public key
+	* @return a public/secret key pair
+	*/
+	LPKeyPair<Element> KeyGenSeeded() {
+		TimeVar t;
+		if( doTiming ) TIC(t);
+		auto r = GetEncryptionAlgorithm()->KeyGenSeeded(CryptoContextFactory<Element>::GetContextForPointer(this));
+		if( doTiming ) {
+			timeSamples->push_back( TimingInfo(OpKeyGen, TOC_US(t)) );
+		}
+		return r;
+	}
+
 	/**
 	* KeyGen generates a Multiparty key pair using this algorithm's KeyGen method from two keys
 	* @param pk first public key used to coordinate the creation of later public keys.
@@ -770,17 +888,28 @@ public:
 	void EvalMultKeysGen(const LPPrivateKey<Element> key);
 
 	/**
-	 * GetEvalMultKeyVector fetches the eval mult keys for a given KeyID
+	 * GetEvalMultKeyVectorPtr fetches the eval mult keys for a given KeyID, from whichever registered
+	 * context holds them. Evaluations look keys up in their own context without going through here.
+	 * The keys stay valid for as long as the pointer is held, even if they are cleared from the context
+	 * @param keyID
+	 * @return key vector from ID
+	 */
+	static shared_ptr<const vector<LPEvalKey<Element>>> GetEvalMultKeyVectorPtr(const string& keyID);
+
+	/**
+	 * GetEvalMultKeyVector fetches the eval mult keys for a given KeyID. Not thread-safe: the reference
+	 * dangles if the keys are cleared while it is in use; use GetEvalMultKeyVectorPtr
 	 * @param keyID
 	 * @return key vector from ID
 	 */
-	static const vector<LPEvalKey<Element>>& GetEvalMultKeyVector(const string& keyID);
+	static const vector<LPEvalKey<Element>>& GetEvalMultKeyVector(const string& keyID)
+			__attribute__ ((deprecated("not thread-safe, use GetEvalMultKeyVectorPtr")));
 
 	/**
 	 * GetEvalMultKeys
-	 * @return map of all the keys
+	 * @return map of all the keys held by registered contexts
 	 */
-	static const std::map<string,std::vector<LPEvalKey<Element>>>& GetAllEvalMultKeys();
+	static std::map<string,std::vector<LPEvalKey<Element>>> GetAllEvalMultKeys();
 
 	/**
 	* KeySwitchGen creates a key that can be used with the PALISADE KeySwitch operation
@@ -839,6 +968,47 @@ public:
 		return ciphertext;
 	}
 
+	/**
+	 * Encrypt a vector of slot values with a public key, as Encrypt of MakePackedPlaintext would, but
+	 * without making the plaintext: the values are packed once, and the scheme lifts, scales and
+	 * transforms them tower by tower as it adds them to the encryption of zero.
+	 * Supported by BFVrns and BFVrnsB.
+	 * @param publicKey
+	 * @param values - the slot values
+	 * @return ciphertext
+	 */
+	Ciphertext<Element> EncryptPacked(
+			const LPPublicKey<Element> publicKey,
+			const vector<int64_t>& values) const
+	{
+		if( publicKey == NULL || Mismatched(publicKey->GetCryptoContext()) )
+			throw std::logic_error("key passed to EncryptPacked was not generated with this crypto context");
+
+		TimeVar t;
+		if( doTiming ) TIC(t);
+
+		NativeVector coefficients;
+		PackedEncoding::GetPlan(GetCyclotomicOrder(), GetEncodingParams())->Pack(values, &coefficients);
+
+		Ciphertext<Element> ciphertext = GetEncryptionAlgorithm()->EncryptPacked(publicKey, coefficients);
+		ciphertext->SetEncodingType( Packed );
+
+		if( doTiming ) {
+			timeSamples->push_back( TimingInfo(OpEncryptPub, TOC_US(t)) );
+		}
+		return ciphertext;
+	}
+
+	/**
+	 * Encrypt several vectors of slot values with a public key, in parallel; see EncryptPacked
+	 * @param publicKey
+	 * @param values - one vector of slot values per ciphertext
+	 * @return ciphertexts, in the order of values
+	 */
+	vector<Ciphertext<Element>> EncryptPacked(
+			const LPPublicKey<Element> publicKey,
+			const vector<vector<int64_t>>& values) const;
+
 	/**
 	 * Encrypt a plaintext using a given private key
 	 * @param privateKey
@@ -868,6 +1038,39 @@ public:
 		}
 		return ciphertext;
 	}
+
+	/**
+	 * Encrypt a plaintext using a given private key into a seeded ciphertext, which is
+	 * serialized with a 32-byte seed in place of its uniformly random element and so is
+	 * about half the size of an Encrypt ciphertext; it is expanded again when loaded.
+	 * The ciphertext stays seeded until its elements are changed.
+	 * @param privateKey
+	 * @param plaintext
+	 * @return ciphertext (or null on failure)
+	 */
+	Ciphertext<Element> EncryptSeeded(
+		const LPPrivateKey<Element> privateKey,
+		Plaintext plaintext) const
+	{
+		if( privateKey == NULL || Mismatched(privateKey->GetCryptoContext()) )
+			throw std::logic_error("key passed to EncryptSeeded was not generated with this crypto context");
+		if( plaintext == NULL )
+			throw std::logic_error("null plaintext passed to EncryptSeeded");
+
+		TimeVar t;
+		if( doTiming ) TIC(t);
+
+		Ciphertext<Element> ciphertext = GetEncryptionAlgorithm()->EncryptSeeded(privateKey, plaintext->GetElement<Element>());
+
+		if (ciphertext) {
+			ciphertext->SetEncodingType( plaintext->GetEncodingType() );
+		}
+
+		if( doTiming ) {
+			timeSamples->push_back( TimingInfo(OpEncryptPriv, TOC_US(t)) );
+		}
+		return ciphertext;
+	}
 	
 	/**
 	* Encrypt a matrix of Plaintext
@@ -1033,6 +1236,14 @@ public:
 		return p;
 	}
 
+	/**
+	 * MakePackedPlaintexts constructs a PackedEncoding in this context for each of several vectors,
+	 * encoding them in parallel
+	 * @param values
+	 * @return plaintexts, in the order of values
+	 */
+	vector<Plaintext> MakePackedPlaintexts(const vector<vector<int64_t>>& values) const;
+
 	/**
 	 * MakePlaintext static that takes a cc and calls the Plaintext Factory
 	 * @param encoding
@@ -1544,11 +1755,11 @@ public:
 	{
 		TypeCheck(ct1, ct2);
 
-		auto ek = GetEvalMultKeyVector(ct1->GetKeyTag());
+		auto ek = FindEvalMultKeys(ct1->GetKeyHandle());
 
 		TimeVar t;
 		if( doTiming ) TIC(t);
-		auto rv = GetEncryptionAlgorithm()->EvalMult(ct1, ct2, ek[0]);
+		auto rv = GetEncryptionAlgorithm()->EvalMult(ct1, ct2, (*ek)[0]);
 		if( doTiming ) {
 			timeSamples->push_back( TimingInfo(OpEvalMult, TOC_US(t)) );
 		}
@@ -1588,11 +1799,11 @@ public:
 	*/
 	Ciphertext<Element> EvalMultMany(const vector<Ciphertext<Element>>& ct) const{
 
-		const auto ek = GetEvalMultKeyVector(ct[0]->GetKeyTag());
+		const auto ek = FindEvalMultKeys(ct[0]->GetKeyHandle());
 
 		TimeVar t;
 		if( doTiming ) TIC(t);
-		auto rv = GetEncryptionAlgorithm()->EvalMultMany(ct, ek);
+		auto rv = GetEncryptionAlgorithm()->EvalMultMany(ct, *ek);
 		if( doTiming ) {
 			timeSamples->push_back( TimingInfo(OpEvalMultMany, TOC_US(t)) );
 		}
@@ -1611,11 +1822,11 @@ public:
 	*/
 	Ciphertext<Element> EvalMultAndRelinearize(ConstCiphertext<Element> ct1, ConstCiphertext<Element> ct2) const {
 
-		const auto ek = GetEvalMultKeyVector(ct1->GetKeyTag());
+		const auto ek = FindEvalMultKeys(ct1->GetKeyHandle());
 
 		TimeVar t;
 		if( doTiming ) TIC(t);
-		auto rv = GetEncryptionAlgorithm()->EvalMultAndRelinearize(ct1, ct2, ek);
+		auto rv = GetEncryptionAlgorithm()->EvalMultAndRelinearize(ct1, ct2, *ek);
 		if( doTiming ) {
 			timeSamples->push_back( TimingInfo(OpEvalMult, TOC_US(t)) );
 		}
@@ -1809,6 +2020,16 @@ public:
 		return rv;
 	}
 
+	/**
+	* Function for evaluating automorphism of ciphertext at index i, using the key for index i from
+	* the EvalAuto key cache or, failing that, from a key store loaded with LoadEvalAutomorphismKeyStore
+	*
+	* @param ciphertext the input ciphertext.
+	* @param i automorphism index
+	* @return resulting ciphertext
+	*/
+	Ciphertext<Element> EvalAutomorphism(ConstCiphertext<Element> ciphertext, usint i) const;
+
 	/**
 	* Generate automophism keys for a given private key; Uses the private key for encryption
 	*
@@ -1844,13 +2065,23 @@ public:
 		const LPPublicKey<Element> publicKey = nullptr);
 
 	/**
-	 * GetEvalSumKey  returns the map
+	 * GetEvalSumKeyMapPtr returns the map. The keys stay valid for as long as the pointer is held,
+	 * even if they are cleared from the context
+	 *
+	 * @return the EvalSum key map
+	 */
+	static shared_ptr<const std::map<usint, LPEvalKey<Element>>> GetEvalSumKeyMapPtr(const string& id);
+
+	/**
+	 * GetEvalSumKey  returns the map. Not thread-safe: the reference dangles if the keys are cleared
+	 * while it is in use; use GetEvalSumKeyMapPtr
 	 *
 	 * @return the EvalSum key map
 	 */
-	static const std::map<usint, LPEvalKey<Element>>& GetEvalSumKeyMap(const string& id);
+	static const std::map<usint, LPEvalKey<Element>>& GetEvalSumKeyMap(const string& id)
+			__attribute__ ((deprecated("not thread-safe, use GetEvalSumKeyMapPtr")));
 
-	static const std::map<string,shared_ptr<std::map<usint, LPEvalKey<Element>>>>& GetAllEvalSumKeys();
+	static std::map<string,shared_ptr<std::map<usint, LPEvalKey<Element>>>> GetAllEvalSumKeys();
 
 	/**
 	* Function for evaluating a sum of all components
@@ -1882,13 +2113,23 @@ public:
 	Ciphertext<Element> EvalMerge(const vector<Ciphertext<Element>> &ciphertextVector) const;
 
 	/**
-	 * GetEvalAutomorphismKey  returns the map
+	 * GetEvalAutomorphismKeyMapPtr returns the map. The keys stay valid for as long as the pointer
+	 * is held, even if they are cleared from the context
+	 *
+	 * @return the EvalAutomorphism key map
+	 */
+	static shared_ptr<const std::map<usint, LPEvalKey<Element>>> GetEvalAutomorphismKeyMapPtr(const string& id);
+
+	/**
+	 * GetEvalAutomorphismKey  returns the map. Not thread-safe: the reference dangles if the keys
+	 * are cleared while it is in use; use GetEvalAutomorphismKeyMapPtr
 	 *
 	 * @return the EvalAutomorphism key map
 	 */
-	static const std::map<usint, LPEvalKey<Element>>& GetEvalAutomorphismKeyMap(const string& id);
+	static const std::map<usint, LPEvalKey<Element>>& GetEvalAutomorphismKeyMap(const string& id)
+			__attribute__ ((deprecated("not thread-safe, use GetEvalAutomorphismKeyMapPtr")));
 
-	static const std::map<string,shared_ptr<std::map<usint, LPEvalKey<Element>>>>& GetAllEvalAutomorphismKeys();
+	static std::map<string,shared_ptr<std::map<usint, LPEvalKey<Element>>>> GetAllEvalAutomorphismKeys();
 
 	/**
 	* Moves i-th slot to slot 0
@@ -2116,11 +2357,11 @@ public:
 				Mismatched(ciphertext1->GetCryptoContext()) )
 			throw std::logic_error("Ciphertexts passed to ComposedEvalMult were not generated with this crypto context");
 
-		auto ek = GetEvalMultKeyVector(ciphertext1->GetKeyTag());
+		auto ek = FindEvalMultKeys(ciphertext1->GetKeyHandle());
 
 		TimeVar t;
 		if( doTiming ) TIC(t);
-		auto rv = GetEncryptionAlgorithm()->ComposedEvalMult(ciphertext1, ciphertext2, ek[0]);
+		auto rv = GetEncryptionAlgorithm()->ComposedEvalMult(ciphertext1, ciphertext2, (*ek)[0]);
 		if( doTiming ) {
 			timeSamples->push_back( TimingInfo(OpComposedEvalMult, TOC_US(t)) );
 		}
@@ -2161,6 +2402,33 @@ public:
 	static uint32_t	SerializedVersion() { return 1; }
 };
 
+/**
+ * @brief ContextReferenceScope
+ *
+ * While an instance is alive, the CryptoObjects (keys, ciphertexts) serialized on this
+ * thread refer to their crypto context by fingerprint instead of embedding the whole
+ * context. The reader must already have the context, for instance from one full
+ * serialization of the context at the start of the stream or session.
+ */
+class ContextReferenceScope {
+public:
+	ContextReferenceScope() : saved(Flag()) { Flag() = true; }
+	~ContextReferenceScope() { Flag() = saved; }
+
+	/**
+	 * @return true if objects serialized on this thread refer to their context
+	 */
+	static bool IsActive() { return Flag(); }
+
+private:
+	static bool& Flag() {
+		static thread_local bool active = false;
+		return active;
+	}
+
+	bool saved;
+};
+
 /**
  * @brief CryptoObject
  *
@@ -2171,16 +2439,17 @@ class CryptoObject {
 protected:
 	CryptoContext<Element>	context;		/*!< crypto context this object belongs to */
 	string					keyTag;		/*!< tag used to find the evaluation key needed for SHE/FHE operations */
+	mutable std::atomic<KeyTagTable::Handle>	keyHandle;	/*!< keyTag interned by KeyTagTable, resolved when a key is looked up */
 
 public:
-	CryptoObject(CryptoContext<Element> cc = 0, const string& tag = "") : context(cc), keyTag(tag) {}
+	CryptoObject(CryptoContext<Element> cc = 0, const string& tag = "") : context(cc), keyTag(tag), keyHandle(KeyTagTable::NoHandle) {}
 
-	CryptoObject(const CryptoObject& rhs) {
+	CryptoObject(const CryptoObject& rhs) : keyHandle(rhs.keyHandle.load(std::memory_order_relaxed)) {
 		context = rhs.context;
 		keyTag = rhs.keyTag;
 	}
 
-	CryptoObject(const CryptoObject&& rhs) {
+	CryptoObject(const CryptoObject&& rhs) : keyHandle(rhs.keyHandle.load(std::memory_order_relaxed)) {
 		context = std::move(rhs.context);
 		keyTag = std::move(rhs.keyTag);
 	}
@@ -2190,12 +2459,14 @@ public:
 	const CryptoObject& operator=(const CryptoObject& rhs) {
 		this->context = rhs.context;
 		this->keyTag = rhs.keyTag;
+		this->keyHandle.store(rhs.keyHandle.load(std::memory_order_relaxed), std::memory_order_relaxed);
 		return *this;
 	}
 
 	const CryptoObject& operator=(const CryptoObject&& rhs) {
 		this->context = std::move(rhs.context);
 		this->keyTag = std::move(rhs.keyTag);
+		this->keyHandle.store(rhs.keyHandle.load(std::memory_order_relaxed), std::memory_order_relaxed);
 		return *this;
 	}
 
@@ -2212,12 +2483,37 @@ public:
 
 	const string GetKeyTag() const { return keyTag; }
 
-	void SetKeyTag(const string& tag) { keyTag = tag; }
+	void SetKeyTag(const string& tag) {
+		keyTag = tag;
+		keyHandle.store(KeyTagTable::NoHandle, std::memory_order_relaxed);
+	}
+
+	/**
+	 * GetKeyHandle - the interned key tag, used to look up evaluation keys without hashing the tag
+	 * @return handle, or KeyTagTable::NoHandle if no keys are cached for the tag
+	 */
+	KeyTagTable::Handle GetKeyHandle() const {
+		KeyTagTable::Handle h = keyHandle.load(std::memory_order_relaxed);
+		if( !KeyTagTable::IsLive(h) ) {
+			// the tag's slot was never resolved or was recycled since; racing threads resolve
+			// the same tag to the same handle, so either store is fine
+			h = KeyTagTable::Find(keyTag);
+			keyHandle.store(h, std::memory_order_relaxed);
+		}
+		return h;
+	}
 
 	template <class Archive>
 	void save( Archive & ar, std::uint32_t const version ) const
 	{
-		ar( ::cereal::make_nvp("cc", context) );
+		bool byReference = ContextReferenceScope::IsActive();
+		ar( ::cereal::make_nvp("r", byReference) );
+		if( byReference ) {
+			string fp = context->GetFingerprint();
+			ar( ::cereal::make_nvp("fp", fp) );
+		}
+		else
+			ar( ::cereal::make_nvp("cc", context) );
 		ar( ::cereal::make_nvp("kt", keyTag) );
 	}
 
@@ -2227,6 +2523,22 @@ public:
 		if( version > SerializedVersion() ) {
 			PALISADE_THROW(deserialize_error, "serialized object version " + std::to_string(version) + " is from a later version of the library");
 		}
+		bool byReference = false;
+		if( version > 1 )
+			ar( ::cereal::make_nvp("r", byReference) );
+
+		if( byReference ) {
+			string fp;
+			ar( ::cereal::make_nvp("fp", fp) );
+			ar( ::cereal::make_nvp("kt", keyTag) );
+
+			context = CryptoContextFactory<Element>::GetContextForFingerprint(fp);
+			if( !context ) {
+				PALISADE_THROW(deserialize_error, "serialized object refers to a crypto context that has not been loaded");
+			}
+			return;
+		}
+
 		ar( ::cereal::make_nvp("cc", context) );
 		ar( ::cereal::make_nvp("kt", keyTag) );
 
@@ -2234,7 +2546,7 @@ public:
 	}
 
 	std::string SerializedObjectName() const { return "CryptoObject"; }
-	static uint32_t	SerializedVersion() { return 1; }
+	static uint32_t	SerializedVersion() { return 2; }
 };
 
 /**
@@ -2245,22 +2557,63 @@ public:
 */
 template<typename Element>
 class CryptoContextFactory {
-	static vector<CryptoContext<Element>>		AllContexts;
+	// the registry of contexts, by fingerprint; split into shards with their own locks
+	// so that threads looking up different contexts do not contend
+	struct RegistryShard {
+		std::mutex												mutex;
+		std::unordered_map<string,CryptoContext<Element>>		contexts;
+	};
+	static const size_t		REGISTRY_SHARDS = 16;
+	static RegistryShard	Registry[REGISTRY_SHARDS];
+
+	static RegistryShard& ShardFor(const string& fingerprint) {
+		return Registry[ std::hash<string>()(fingerprint) % REGISTRY_SHARDS ];
+	}
 
 public:
+	/**
+	 * ReleaseAllContexts - drop every registered context; contexts still held elsewhere stay valid,
+	 * but the evaluation keys cached in them are cleared
+	 */
 	static void ReleaseAllContexts();
 
+	/**
+	 * ReleaseUnusedContexts - drop the registered contexts that nothing outside the registry holds;
+	 * a context with evaluation keys still cached in it counts as held
+	 * @return number of contexts dropped
+	 */
+	static size_t ReleaseUnusedContexts();
+
 	static int GetContextCount();
 
 	static CryptoContext<Element> GetSingleContext();
 
+	/**
+	 * GetContext - the registered context for a parameter set and scheme, created if there is none.
+	 * The lookup is by fingerprint, so its cost does not depend on how many contexts are registered.
+	 * @param params - crypto parameters
+	 * @param scheme - encryption scheme
+	 * @return the context
+	 */
 	static CryptoContext<Element> GetContext(
 			shared_ptr<LPCryptoParameters<Element>> params,
 			shared_ptr<LPPublicKeyEncryptionScheme<Element>> scheme);
 
+	/**
+	 * GetContextForPointer - the shared pointer that owns a context made by the factory
+	 * @param cc - context
+	 * @return the owning pointer, or null if the context was not made by the factory
+	 */
 	static CryptoContext<Element> GetContextForPointer(CryptoContextImpl<Element>* cc);
 
-	static const vector<CryptoContext<Element>>& GetAllContexts();
+	/**
+	 * GetContextForFingerprint - look up a registered context by the fingerprint of its parameters
+	 * @param fingerprint - result of CryptoContextImpl::GetFingerprint
+	 * @return the context, or null if no registered context has this fingerprint
+	 */
+	static CryptoContext<Element> GetContextForFingerprint(const string& fingerprint);
+
+	static vector<CryptoContext<Element>> GetAllContexts();
 
 	/**
 	* construct a PALISADE CryptoContextImpl for the BFV Scheme
@@ -31,25 +31,63 @@
 namespace lbcrypto {
 
 template <typename Element>
-vector<CryptoContext<Element>>	CryptoContextFactory<Element>::AllContexts;
+typename CryptoContextFactory<Element>::RegistryShard CryptoContextFactory<Element>::Registry[CryptoContextFactory<Element>::REGISTRY_SHARDS];
 
 template <typename Element>
 void
 CryptoContextFactory<Element>::ReleaseAllContexts() {
-	AllContexts.clear();
+	vector<CryptoContext<Element>> released;
+	for( auto& shard : Registry ) {
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		for( auto& c : shard.contexts )
+			released.push_back(c.second);
+		shard.contexts.clear();
+	}
+
+	// cached keys hold their context, so a released context would never be freed while they are cached
+	for( auto& cc : released ) {
+		cc->evalMultKeyCache.Clear();
+		cc->evalSumKeyCache.Clear();
+		cc->evalAutomorphismKeyCache.Clear();
+		cc->evalAutomorphismKeyStoreCache.Clear();
+	}
+}
+
+template <typename Element>
+size_t
+CryptoContextFactory<Element>::ReleaseUnusedContexts() {
+	size_t released = 0;
+	for( auto& shard : Registry ) {
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		for( auto it = shard.contexts.begin(); it != shard.contexts.end(); ) {
+			if( it->second.use_count() == 1 ) {
+				it = shard.contexts.erase(it);
+				released++;
+			}
+			else
+				++it;
+		}
+	}
+	return released;
 }
 
 template <typename Element>
 int
 CryptoContextFactory<Element>::GetContextCount() {
-	return AllContexts.size();
+	size_t count = 0;
+	for( auto& shard : Registry ) {
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		count += shard.contexts.size();
+	}
+	return count;
 }
 
 template <typename Element>
 CryptoContext<Element>
 CryptoContextFactory<Element>::GetSingleContext() {
-	if( GetContextCount() == 1 )
-		return AllContexts[0];
+	auto all = GetAllContexts();
+	if( all.size() == 1 )
+		return all[0];
 	throw std::logic_error("More than one context");
 }
 
@@ -59,15 +97,21 @@ CryptoContextFactory<Element>::GetContext(
 		shared_ptr<LPCryptoParameters<Element>> params,
 		shared_ptr<LPPublicKeyEncryptionScheme<Element>> scheme) {
 
-	for( CryptoContext<Element> cc : AllContexts ) {
-		if( *cc->GetEncryptionAlgorithm().get() == *scheme.get() &&
-				*cc->GetCryptoParameters().get() == *params.get() ) {
-			return cc;
-		}
-	}
+	string fingerprint = CryptoContextImpl<Element>::ComputeFingerprint(params,scheme);
+	auto& shard = ShardFor(fingerprint);
+
+	CryptoContext<Element> cc;
+	{
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		auto found = shard.contexts.find(fingerprint);
+		if( found != shard.contexts.end() )
+			return found->second;
 
-	CryptoContext<Element> cc(new CryptoContextImpl<Element>(params,scheme));
-	AllContexts.push_back(cc);
+		cc.reset(new CryptoContextImpl<Element>(params,scheme));
+		cc->fingerprint = fingerprint;
+		cc->self = cc;
+		shard.contexts[fingerprint] = cc;
+	}
 
     if( cc->GetEncodingParams()->GetPlaintextRootOfUnity() != 0 ) {
             PackedEncoding::SetParams(cc->GetCyclotomicOrder(), cc->GetEncodingParams());
@@ -80,15 +124,32 @@ template <typename Element>
 CryptoContext<Element>
 CryptoContextFactory<Element>::GetContextForPointer(
 		CryptoContextImpl<Element>* cc) {
-	for( CryptoContext<Element> ctx : AllContexts ) {
-		if( ctx.get() == cc )
-			return ctx;
-	}
-	return 0;
+	if( cc == 0 )
+		return 0;
+	return cc->self.lock();
+}
+
+template <typename Element>
+CryptoContext<Element>
+CryptoContextFactory<Element>::GetContextForFingerprint(const string& fingerprint) {
+	auto& shard = ShardFor(fingerprint);
+	std::lock_guard<std::mutex> lock(shard.mutex);
+	auto found = shard.contexts.find(fingerprint);
+	if( found == shard.contexts.end() )
+		return 0;
+	return found->second;
 }
 
 template <typename T>
-const vector<CryptoContext<T>>& CryptoContextFactory<T>::GetAllContexts() { return AllContexts; }
+vector<CryptoContext<T>> CryptoContextFactory<T>::GetAllContexts() {
+	vector<CryptoContext<T>> all;
+	for( auto& shard : Registry ) {
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		for( const auto& c : shard.contexts )
+			all.push_back(c.second);
+	}
+	return all;
+}
 
 // factory methods for the different schemes
 
@@ -0,0 +1,371 @@
+/**
+ * @file evalkeycache.h -- Thread-safe per-context cache of evaluation keys, indexed by interned key tags.
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or other
+ * materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef SRC_PKE_LIB_EVALKEYCACHE_H_
+#define SRC_PKE_LIB_EVALKEYCACHE_H_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "utils/exception.h"
+
+namespace lbcrypto {
+
+/**
+ * @brief KeyTagTable interns key tags (the unique IDs of secret keys) as integer handles
+ *
+ * A tag holds a slot for as long as some key cache has an entry for it; when the last entry
+ * is dropped the slot goes back on a free list and its generation is bumped. A handle is the
+ * slot in the low 32 bits and the generation in the high 32 bits, so a handle that an object
+ * remembered from before its tag's slot was recycled can be recognized as stale. Handle 0
+ * means "no handle".
+ */
+class KeyTagTable {
+public:
+	typedef uint64_t Handle;
+	enum : Handle { NoHandle = 0 };
+
+	static const uint32_t	SEGMENT_BITS = 10;
+	static const uint32_t	SEGMENT_MASK = (1 << SEGMENT_BITS) - 1;
+	static const uint32_t	MAX_SEGMENTS = 2048;
+	static const uint32_t	MAX_SLOTS = MAX_SEGMENTS << SEGMENT_BITS;	/*!< most tags that can have keys at the same time */
+
+	/**
+	 * Slot - the slot of a handle
+	 */
+	static uint32_t Slot(Handle handle) {
+		return (uint32_t)handle;
+	}
+
+	/**
+	 * Acquire - the handle for a tag, allocating a slot if no cache holds an entry for the tag;
+	 * each call must be balanced by a call to Release
+	 * @param tag
+	 * @return handle
+	 */
+	static Handle Acquire(const std::string& tag) {
+		State& st = GetState();
+		std::lock_guard<std::mutex> lock(st.mutex);
+		auto h = st.handles.find(tag);
+		if( h != st.handles.end() ) {
+			st.slots[Slot(h->second)].refs++;
+			return h->second;
+		}
+
+		uint32_t slot;
+		if( !st.freeSlots.empty() ) {
+			slot = st.freeSlots.back();
+			st.freeSlots.pop_back();
+		}
+		else {
+			if( st.slots.size() >= MAX_SLOTS )
+				PALISADE_THROW(not_available_error, "more than " + std::to_string(MAX_SLOTS) + " key tags have evaluation keys cached");
+			slot = st.slots.size();
+			st.slots.push_back(SlotInfo());
+			if( (slot & SEGMENT_MASK) == 0 )
+				st.generations[slot >> SEGMENT_BITS].store(new Segment(), std::memory_order_release);
+		}
+
+		Handle handle = (Handle(Generation(slot).load(std::memory_order_relaxed)) << 32) | slot;
+		st.slots[slot].tag = tag;
+		st.slots[slot].refs = 1;
+		st.handles[tag] = handle;
+		return handle;
+	}
+
+	/**
+	 * Release - drop a reference taken by Acquire; the last one frees the tag's slot
+	 * @param handle
+	 */
+	static void Release(Handle handle) {
+		State& st = GetState();
+		std::lock_guard<std::mutex> lock(st.mutex);
+		uint32_t slot = Slot(handle);
+		if( !IsLive(handle) || --st.slots[slot].refs > 0 )
+			return;
+
+		st.handles.erase(st.slots[slot].tag);
+		st.slots[slot].tag.clear();
+		uint32_t next = (uint32_t)(handle >> 32) + 1;
+		Generation(slot).store(next == 0 ? 1 : next, std::memory_order_release);
+		st.freeSlots.push_back(slot);
+	}
+
+	/**
+	 * Find - the handle for a tag, without allocating one
+	 * @param tag
+	 * @return handle, or NoHandle if no cache holds an entry for the tag
+	 */
+	static Handle Find(const std::string& tag) {
+		State& st = GetState();
+		std::lock_guard<std::mutex> lock(st.mutex);
+		auto h = st.handles.find(tag);
+		return h == st.handles.end() ? NoHandle : h->second;
+	}
+
+	/**
+	 * IsLive - whether a handle still stands for the tag it was issued for; does not lock
+	 * @param handle
+	 * @return false if the handle is NoHandle or its slot has been released since
+	 */
+	static bool IsLive(Handle handle) {
+		uint32_t slot = Slot(handle);
+		if( handle == NoHandle || slot >= MAX_SLOTS )
+			return false;
+		const Segment *seg = GetState().generations[slot >> SEGMENT_BITS].load(std::memory_order_acquire);
+		return seg != 0 && seg->generation[slot & SEGMENT_MASK].load(std::memory_order_acquire) == (uint32_t)(handle >> 32);
+	}
+
+private:
+	struct SlotInfo {
+		std::string	tag;
+		size_t		refs = 0;
+	};
+
+	// generations are read without the lock, so they live in segments that never move
+	struct Segment {
+		Segment() {
+			for( auto& g : generation )
+				g.store(1, std::memory_order_relaxed);
+		}
+		std::atomic<uint32_t>	generation[1 << SEGMENT_BITS];
+	};
+
+	struct State {
+		State() {
+			for( auto& g : generations )
+				g.store(0, std::memory_order_relaxed);
+		}
+		std::mutex								mutex;
+		std::unordered_map<std::string,Handle>	handles;
+		std::vector<SlotInfo>					slots;
+		std::vector<uint32_t>					freeSlots;
+		std::atomic<Segment*>					generations[MAX_SEGMENTS];
+	};
+
+	// never destroyed, since the caches of static crypto contexts release their handles at exit
+	static State& GetState() {
+		static State *state = new State();
+		return *state;
+	}
+
+	// the segment of a slot that has been allocated
+	static std::atomic<uint32_t>& Generation(uint32_t slot) {
+		return GetState().generations[slot >> SEGMENT_BITS].load(std::memory_order_relaxed)->generation[slot & SEGMENT_MASK];
+	}
+};
+
+/**
+ * @brief EvalKeyCache holds one kind of evaluation key for a crypto context, by key tag handle
+ *
+ * Lookups index a two-level table by the handle's slot and never take the cache's locks, so
+ * evaluations are not held up while keys for other tags are being inserted or evicted. Entries
+ * are published and read through the atomic shared_ptr operations; a reader keeps the entry it
+ * got alive, so evicting a key while an evaluation is using it is safe. Each entry records the
+ * full handle it was stored under, so a stale handle for a recycled slot misses.
+ *
+ * The cache holds a KeyTagTable reference for every entry. Writers are serialized per shard
+ * (slot modulo the shard count); each shard also remembers which of its slots are occupied,
+ * so that the cache can be enumerated and cleared.
+ */
+template<typename Value>
+class EvalKeyCache {
+public:
+	typedef std::shared_ptr<Value> Entry;
+	typedef KeyTagTable::Handle Handle;
+
+	EvalKeyCache() {
+		for( auto& s : segments )
+			s.store(0, std::memory_order_relaxed);
+	}
+
+	~EvalKeyCache() {
+		Clear();
+		for( auto& s : segments )
+			delete s.load(std::memory_order_relaxed);
+	}
+
+	EvalKeyCache(const EvalKeyCache&) = delete;
+	EvalKeyCache& operator=(const EvalKeyCache&) = delete;
+
+	/**
+	 * Get - the entry for a handle; does not lock
+	 * @param handle
+	 * @return the entry, or an empty pointer if there is none
+	 */
+	Entry Get(Handle handle) const {
+		uint32_t slot = KeyTagTable::Slot(handle);
+		if( handle == KeyTagTable::NoHandle || slot >= KeyTagTable::MAX_SLOTS )
+			return Entry();
+		const Segment *seg = segments[slot >> KeyTagTable::SEGMENT_BITS].load(std::memory_order_acquire);
+		if( seg == 0 )
+			return Entry();
+		NodePtr node = std::atomic_load(&seg->slots[slot & KeyTagTable::SEGMENT_MASK]);
+		return node && node->handle == handle ? node->value : Entry();
+	}
+
+	/**
+	 * Put - set the entry for a tag, replacing any entry that is there
+	 * @param tag
+	 * @param value
+	 */
+	void Put(const std::string& tag, const Entry& value) {
+		Handle handle = KeyTagTable::Acquire(tag);
+		uint32_t slot = KeyTagTable::Slot(handle);
+		NodePtr node = std::make_shared<const Node>(handle, value);
+
+		NodePtr old;
+		{
+			Shard& s = shards[slot % SHARDS];
+			std::lock_guard<std::mutex> lock(s.mutex);
+			old = std::atomic_exchange(&SegmentFor(slot)->slots[slot & KeyTagTable::SEGMENT_MASK], node);
+			s.occupied.insert(slot);
+		}
+		// an entry in the slot holds the slot, so it was stored under the same handle
+		if( old )
+			KeyTagTable::Release(handle);
+	}
+
+	/**
+	 * Erase - drop the entry for a handle
+	 * @param handle
+	 * @return the entry that was dropped, or an empty pointer if there was none
+	 */
+	Entry Erase(Handle handle) {
+		uint32_t slot = KeyTagTable::Slot(handle);
+		if( handle == KeyTagTable::NoHandle || slot >= KeyTagTable::MAX_SLOTS )
+			return Entry();
+
+		NodePtr node;
+		{
+			Shard& s = shards[slot % SHARDS];
+			std::lock_guard<std::mutex> lock(s.mutex);
+			if( s.occupied.count(slot) == 0 )
+				return Entry();
+			NodePtr& p = SegmentFor(slot)->slots[slot & KeyTagTable::SEGMENT_MASK];
+			node = std::atomic_load(&p);
+			if( node->handle != handle )
+				return Entry();
+			std::atomic_store(&p, NodePtr());
+			s.occupied.erase(slot);
+		}
+		KeyTagTable::Release(handle);
+		return node->value;
+	}
+
+	/**
+	 * Clear - drop every entry
+	 */
+	void Clear() {
+		std::vector<Handle> dropped;
+		for( auto& s : shards ) {
+			std::lock_guard<std::mutex> lock(s.mutex);
+			for( auto slot : s.occupied ) {
+				NodePtr& p = SegmentFor(slot)->slots[slot & KeyTagTable::SEGMENT_MASK];
+				dropped.push_back( std::atomic_load(&p)->handle );
+				std::atomic_store(&p, NodePtr());
+			}
+			s.occupied.clear();
+		}
+		for( auto h : dropped )
+			KeyTagTable::Release(h);
+	}
+
+	/**
+	 * GetAll - a snapshot of every entry
+	 * @return handles and entries
+	 */
+	std::vector<std::pair<Handle,Entry>> GetAll() const {
+		std::vector<std::pair<Handle,Entry>> all;
+		for( auto& s : shards ) {
+			std::lock_guard<std::mutex> lock(s.mutex);
+			for( auto slot : s.occupied ) {
+				const Segment *seg = segments[slot >> KeyTagTable::SEGMENT_BITS].load(std::memory_order_acquire);
+				NodePtr node = std::atomic_load(&seg->slots[slot & KeyTagTable::SEGMENT_MASK]);
+				all.push_back( std::make_pair(node->handle, node->value) );
+			}
+		}
+		return all;
+	}
+
+	/**
+	 * Size - number of entries
+	 */
+	size_t Size() const {
+		size_t n = 0;
+		for( auto& s : shards ) {
+			std::lock_guard<std::mutex> lock(s.mutex);
+			n += s.occupied.size();
+		}
+		return n;
+	}
+
+private:
+	static const size_t		SHARDS = 16;
+
+	struct Node {
+		Node(Handle h, const Entry& v) : handle(h), value(v) {}
+		const Handle	handle;
+		const Entry		value;
+	};
+	typedef std::shared_ptr<const Node> NodePtr;
+
+	struct Segment {
+		NodePtr	slots[1 << KeyTagTable::SEGMENT_BITS];
+	};
+
+	struct Shard {
+		mutable std::mutex				mutex;
+		std::unordered_set<uint32_t>	occupied;
+	};
+
+	// segments are allocated the first time a slot in them is written, and only freed with the cache
+	Segment *SegmentFor(uint32_t slot) {
+		std::atomic<Segment*>& p = segments[slot >> KeyTagTable::SEGMENT_BITS];
+		Segment *seg = p.load(std::memory_order_acquire);
+		if( seg == 0 ) {
+			Segment *fresh = new Segment();
+			if( p.compare_exchange_strong(seg, fresh, std::memory_order_acq_rel) )
+				seg = fresh;
+			else
+				delete fresh;	// another shard's writer got there first; seg now holds its segment
+		}
+		return seg;
+	}
+
+	std::atomic<Segment*>	segments[KeyTagTable::MAX_SEGMENTS];
+	Shard					shards[SHARDS];
+};
+
+}
+
+#endif /* SRC_PKE_LIB_EVALKEYCACHE_H_ */
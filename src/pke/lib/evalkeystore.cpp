@@ -0,0 +1,574 @@
+/*
+ * @file evalkeystore.cpp -- On-disk store of evaluation keys that are loaded on demand, and bundles of keys loaded all at once.
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @section LICENSE
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or other
+ * materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cryptocontext.h"
+#include "evalkeystore.h"
+#include "nativetowers.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace lbcrypto {
+
+namespace {
+
+const char			EvalKeyStoreMagic[8] = { 'P', 'A', 'L', 'E', 'K', 'S', '0', '1' };
+const uint32_t		EvalKeyStoreVersion = 1;
+const uint64_t		EvalKeyStorePage = 4096;
+const uint32_t		EvalKeyStoreFixedHeader = 32;	// magic, version, header length, count, tag and fingerprint lengths, reserved
+const uint32_t		EvalKeyStoreEntrySize = 24;		// index, reserved, offset, length
+const uint32_t		EvalKeyStoreBlobHeader = 24;	// A count, B count, towers, ring dimension, format, reserved
+
+const char			EvalKeyBundleMagic[8] = { 'P', 'A', 'L', 'E', 'K', 'B', '0', '1' };
+const uint32_t		EvalKeyBundleVersion = 1;
+const uint32_t		EvalKeyBundleFixedHeader = 32;	// magic, version, tag count, fingerprint length, reserved, key count
+const uint32_t		EvalKeyBundleEntrySize = 32;	// kind, tag, index, reserved, offset, length
+
+enum EvalKeyBundleKind { BundleMultKey = 0, BundleSumKey = 1, BundleAutomorphismKey = 2 };
+
+static_assert(sizeof(NativeInteger) == sizeof(uint64_t), "EvalKeyStore copies towers as raw native words");
+
+uint64_t PageAlign(uint64_t n) {
+	return (n + EvalKeyStorePage - 1) & ~(EvalKeyStorePage - 1);
+}
+
+template<typename Element>
+LPEvalKeyRelin<Element> AsRelinKey(const LPEvalKey<Element>& k) {
+	auto rk = std::dynamic_pointer_cast<LPEvalKeyRelinImpl<Element>>(k);
+	if( !rk )
+		PALISADE_THROW(not_implemented_error, "Only relinearization keys can be stored in raw form");
+	return rk;
+}
+
+// a key is stored as a small header, the tower moduli, then the towers of every A and B element
+template<typename Element>
+uint64_t KeyBlobLength(const LPEvalKeyRelin<Element>& rk) {
+	const auto& a = rk->GetAVector();
+	auto towers = NativeTowers(a[0]);
+	uint64_t words = (a.size() + rk->GetBVector().size()) * towers.size() * towers[0]->GetLength();
+	return EvalKeyStoreBlobHeader + towers.size()*sizeof(uint64_t) + words*sizeof(uint64_t);
+}
+
+template<typename Element>
+void WriteKeyBlob(StoreWriter& w, const LPEvalKeyRelin<Element>& rk) {
+	const auto& a = rk->GetAVector();
+	const auto& b = rk->GetBVector();
+	auto towers = NativeTowers(a[0]);
+	w.Word<uint32_t>(a.size());
+	w.Word<uint32_t>(b.size());
+	w.Word<uint32_t>(towers.size());
+	w.Word<uint32_t>(towers[0]->GetLength());
+	w.Word<uint32_t>(a[0].GetFormat());
+	w.Word<uint32_t>(0);
+	for( const auto t : towers )
+		w.Word<uint64_t>(t->GetModulus().ConvertToInt());
+
+	for( const auto* vec : { &a, &b } ) {
+		for( const auto& el : *vec ) {
+			for( const auto t : NativeTowers(el) )
+				w.Bytes(&t->GetValues()[0], t->GetLength()*sizeof(uint64_t));
+		}
+	}
+}
+
+// the blob is checked against the context while it is decoded
+template<typename Element>
+LPEvalKey<Element> ReadKeyBlob(const CryptoContext<Element>& cc, const string& tag, const uint8_t *blob, uint64_t length) {
+	StoreReader r(blob, length);
+
+	uint32_t numA = r.Word<uint32_t>();
+	uint32_t numB = r.Word<uint32_t>();
+	uint32_t numTowers = r.Word<uint32_t>();
+	uint32_t ringDim = r.Word<uint32_t>();
+	Format format = Format(r.Word<uint32_t>());
+	r.Word<uint32_t>();
+
+	const auto params = cc->GetElementParams();
+	if( ringDim != params->GetRingDimension() )
+		PALISADE_THROW(deserialize_error, "Stored key does not match the ring dimension of the context");
+
+	std::vector<uint64_t> moduli(numTowers);
+	for( auto& q : moduli )
+		q = r.Word<uint64_t>();
+
+	auto readElements = [&](uint32_t count) {
+		std::vector<Element> v;
+		v.reserve(count);
+		for( uint32_t n = 0; n < count; n++ ) {
+			v.emplace_back(params, format, true);
+			auto towers = MutableNativeTowers(v.back());
+			if( towers.size() != numTowers )
+				PALISADE_THROW(deserialize_error, "Stored key does not match the towers of the context");
+			for( usint t = 0; t < numTowers; t++ ) {
+				if( towers[t]->GetModulus().ConvertToInt() != moduli[t] )
+					PALISADE_THROW(deserialize_error, "Stored key does not match the moduli of the context");
+				memcpy(static_cast<void *>(&(*towers[t])[0]), r.Bytes(uint64_t(ringDim)*sizeof(uint64_t)), ringDim*sizeof(uint64_t));
+			}
+		}
+		return v;
+	};
+
+	LPEvalKeyRelin<Element> key = std::make_shared<LPEvalKeyRelinImpl<Element>>(cc);
+	key->SetAVector(readElements(numA));
+	key->SetBVector(readElements(numB));
+	key->SetKeyTag(tag);
+	return key;
+}
+
+}
+
+template<typename Element>
+void EvalKeyStore<Element>::Write(const string& filename, const std::map<usint,LPEvalKey<Element>>& keys) {
+	if( keys.empty() )
+		PALISADE_THROW(config_error, "No keys to write to EvalKeyStore");
+
+	auto first = keys.begin()->second;
+	const string tag = first->GetKeyTag();
+	const string fp = first->GetCryptoContext()->GetFingerprint();
+
+	std::vector<LPEvalKeyRelin<Element>> relin;
+	for( const auto& k : keys ) {
+		auto rk = AsRelinKey(k.second);
+		if( rk->GetKeyTag() != tag || rk->GetCryptoContext() != first->GetCryptoContext() )
+			PALISADE_THROW(config_error, "Keys written to one EvalKeyStore must share a context and key tag");
+		relin.push_back(rk);
+	}
+
+	// lay out the file: the header, then one page-aligned blob per key
+	uint64_t headerLength = EvalKeyStoreFixedHeader + tag.size() + fp.size() + keys.size()*EvalKeyStoreEntrySize;
+	std::vector<Entry> entries;
+	uint64_t offset = PageAlign(headerLength);
+	for( const auto& rk : relin ) {
+		Entry e;
+		e.offset = offset;
+		e.length = KeyBlobLength(rk);
+		entries.push_back(e);
+		offset = PageAlign(offset + e.length);
+	}
+
+	std::ofstream os(filename, std::ios::binary | std::ios::trunc);
+	if( !os.is_open() )
+		PALISADE_THROW(config_error, "Cannot open " + filename + " for writing");
+	StoreWriter w(os);
+
+	w.Bytes(EvalKeyStoreMagic, sizeof(EvalKeyStoreMagic));
+	w.Word<uint32_t>(EvalKeyStoreVersion);
+	w.Word<uint32_t>(headerLength);
+	w.Word<uint32_t>(keys.size());
+	w.Word<uint32_t>(tag.size());
+	w.Word<uint32_t>(fp.size());
+	w.Word<uint32_t>(0);
+	w.Bytes(tag.data(), tag.size());
+	w.Bytes(fp.data(), fp.size());
+	size_t n = 0;
+	for( const auto& k : keys ) {
+		w.Word<uint32_t>(k.first);
+		w.Word<uint32_t>(0);
+		w.Word<uint64_t>(entries[n].offset);
+		w.Word<uint64_t>(entries[n].length);
+		n++;
+	}
+
+	for( n = 0; n < relin.size(); n++ ) {
+		w.PadTo(entries[n].offset);
+		WriteKeyBlob(w, relin[n]);
+	}
+	w.PadTo(offset);
+
+	if( !os.good() )
+		PALISADE_THROW(config_error, "Error writing EvalKeyStore " + filename);
+}
+
+template<typename Element>
+EvalKeyStore<Element>::EvalKeyStore(const CryptoContext<Element> cc, const string& filename, size_t maxResident)
+	: m_cc(cc), m_filename(filename), m_maxResident(maxResident) {
+
+	if( !cc )
+		PALISADE_THROW(config_error, "EvalKeyStore needs a context");
+
+	std::vector<uint8_t> header;
+#ifdef _WIN32
+	m_file.open(filename, std::ios::binary);
+	if( !m_file.is_open() )
+		PALISADE_THROW(config_error, "Cannot open EvalKeyStore " + filename);
+	header.resize(EvalKeyStoreFixedHeader);
+	m_file.read(reinterpret_cast<char *>(header.data()), header.size());
+	uint32_t headerLength;
+	memcpy(&headerLength, header.data() + sizeof(EvalKeyStoreMagic) + sizeof(uint32_t), sizeof(headerLength));
+	header.resize(std::max(headerLength, EvalKeyStoreFixedHeader));
+	m_file.read(reinterpret_cast<char *>(header.data() + EvalKeyStoreFixedHeader), header.size() - EvalKeyStoreFixedHeader);
+	const uint64_t fileSize = std::numeric_limits<uint64_t>::max();
+	StoreReader r(header.data(), m_file.gcount() + EvalKeyStoreFixedHeader);
+#else
+	int fd = open(filename.c_str(), O_RDONLY);
+	if( fd < 0 )
+		PALISADE_THROW(config_error, "Cannot open EvalKeyStore " + filename);
+	struct stat st;
+	if( fstat(fd, &st) != 0 || st.st_size == 0 ) {
+		close(fd);
+		PALISADE_THROW(deserialize_error, "EvalKeyStore " + filename + " is empty");
+	}
+	m_size = st.st_size;
+	void *base = mmap(0, m_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if( base == MAP_FAILED )
+		PALISADE_THROW(config_error, "Cannot map EvalKeyStore " + filename);
+	m_base = static_cast<const uint8_t *>(base);
+	const uint64_t fileSize = m_size;
+	StoreReader r(m_base, m_size);
+#endif
+
+	try {
+		if( memcmp(r.Bytes(sizeof(EvalKeyStoreMagic)), EvalKeyStoreMagic, sizeof(EvalKeyStoreMagic)) != 0 )
+			PALISADE_THROW(deserialize_error, filename + " is not an EvalKeyStore");
+		if( r.Word<uint32_t>() != EvalKeyStoreVersion )
+			PALISADE_THROW(deserialize_error, "Unsupported EvalKeyStore version in " + filename);
+		r.Word<uint32_t>();	// header length
+		uint32_t count = r.Word<uint32_t>();
+		uint32_t tagLength = r.Word<uint32_t>();
+		uint32_t fpLength = r.Word<uint32_t>();
+		r.Word<uint32_t>();
+
+		const uint8_t *tag = r.Bytes(tagLength);
+		m_keyTag.assign(reinterpret_cast<const char *>(tag), tagLength);
+		const uint8_t *fp = r.Bytes(fpLength);
+		if( string(reinterpret_cast<const char *>(fp), fpLength) != cc->GetFingerprint() )
+			PALISADE_THROW(config_error, "EvalKeyStore " + filename + " was not written for this context");
+
+		for( uint32_t i = 0; i < count; i++ ) {
+			usint index = r.Word<uint32_t>();
+			r.Word<uint32_t>();
+			Entry e;
+			e.offset = r.Word<uint64_t>();
+			e.length = r.Word<uint64_t>();
+			if( e.offset > fileSize || e.length > fileSize - e.offset )
+				PALISADE_THROW(deserialize_error, "EvalKeyStore " + filename + " is truncated");
+			m_entries[index] = e;
+		}
+	}
+	catch( ... ) {
+#ifndef _WIN32
+		munmap(const_cast<uint8_t *>(m_base), m_size);
+#endif
+		throw;
+	}
+}
+
+template<typename Element>
+EvalKeyStore<Element>::~EvalKeyStore() {
+#ifndef _WIN32
+	munmap(const_cast<uint8_t *>(m_base), m_size);
+#endif
+}
+
+template<typename Element>
+std::vector<usint> EvalKeyStore<Element>::GetIndices() const {
+	std::vector<usint> indices;
+	for( const auto& e : m_entries )
+		indices.push_back(e.first);
+	return indices;
+}
+
+template<typename Element>
+size_t EvalKeyStore<Element>::GetResidentCount() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_resident.size();
+}
+
+template<typename Element>
+void EvalKeyStore<Element>::SetMaxResident(size_t maxResident) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_maxResident = maxResident;
+	Trim();
+}
+
+template<typename Element>
+void EvalKeyStore<Element>::Trim() {
+	// keys already handed out stay alive through their shared_ptr; only the store's reference is dropped
+	while( m_maxResident != 0 && m_resident.size() > m_maxResident ) {
+		m_resident.erase(m_lru.back().first);
+		m_lru.pop_back();
+	}
+}
+
+template<typename Element>
+LPEvalKey<Element> EvalKeyStore<Element>::GetKey(usint i) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto hit = m_resident.find(i);
+	if( hit != m_resident.end() ) {
+		m_lru.splice(m_lru.begin(), m_lru, hit->second);
+		return hit->second->second;
+	}
+
+	auto e = m_entries.find(i);
+	if( e == m_entries.end() )
+		PALISADE_THROW(config_error, "Could not find an EvalKey for index " + std::to_string(i) + " in " + m_filename);
+
+#ifdef _WIN32
+	std::vector<uint8_t> blob(e->second.length);
+	m_file.clear();
+	m_file.seekg(e->second.offset);
+	m_file.read(reinterpret_cast<char *>(blob.data()), blob.size());
+	if( uint64_t(m_file.gcount()) != e->second.length )
+		PALISADE_THROW(deserialize_error, "EvalKeyStore " + m_filename + " is truncated");
+	auto key = Materialize(e->second, blob.data());
+#else
+	auto key = Materialize(e->second, m_base + e->second.offset);
+#endif
+
+	m_lru.emplace_front(i, key);
+	m_resident[i] = m_lru.begin();
+	Trim();
+	return key;
+}
+
+template<typename Element>
+LPEvalKey<Element> EvalKeyStore<Element>::Materialize(const Entry& e, const uint8_t *blob) const {
+	return ReadKeyBlob(m_cc, m_keyTag, blob, e.length);
+}
+
+template<typename Element>
+void EvalKeyBundle<Element>::Write(std::ostream& os, const CryptoContext<Element> cc) const {
+	if( !cc )
+		PALISADE_THROW(config_error, "EvalKeyBundle needs a context");
+
+	struct Item {
+		uint32_t					kind;
+		uint32_t					tag;
+		uint32_t					index;
+		LPEvalKeyRelin<Element>		key;
+	};
+	std::vector<string> tags;
+	std::map<string,uint32_t> tagNumbers;
+	std::vector<Item> items;
+
+	auto add = [&](uint32_t kind, const string& tag, uint32_t index, const LPEvalKey<Element>& k) {
+		if( !k || k->GetCryptoContext() != cc )
+			PALISADE_THROW(config_error, "Keys written to an EvalKeyBundle must belong to its context");
+		auto t = tagNumbers.find(tag);
+		if( t == tagNumbers.end() ) {
+			t = tagNumbers.insert(std::make_pair(tag, uint32_t(tags.size()))).first;
+			tags.push_back(tag);
+		}
+		Item item = { kind, t->second, index, AsRelinKey(k) };
+		items.push_back(item);
+	};
+	for( const auto& m : multKeys )
+		for( size_t i = 0; i < m.second.size(); i++ )
+			add(BundleMultKey, m.first, i, m.second[i]);
+	for( const auto& m : sumKeys )
+		for( const auto& k : m.second )
+			add(BundleSumKey, m.first, k.first, k.second);
+	for( const auto& m : automorphismKeys )
+		for( const auto& k : m.second )
+			add(BundleAutomorphismKey, m.first, k.first, k.second);
+
+	// the tables, then the keys, each starting on a word boundary
+	const string fp = cc->GetFingerprint();
+	uint64_t tablesLength = EvalKeyBundleFixedHeader + fp.size() + items.size()*EvalKeyBundleEntrySize;
+	for( const auto& t : tags )
+		tablesLength += sizeof(uint32_t) + t.size();
+
+	StoreWriter w(os);
+	w.Bytes(EvalKeyBundleMagic, sizeof(EvalKeyBundleMagic));
+	w.Word<uint32_t>(EvalKeyBundleVersion);
+	w.Word<uint32_t>(tags.size());
+	w.Word<uint32_t>(fp.size());
+	w.Word<uint32_t>(0);
+	w.Word<uint64_t>(items.size());
+	w.Bytes(fp.data(), fp.size());
+	for( const auto& t : tags ) {
+		w.Word<uint32_t>(t.size());
+		w.Bytes(t.data(), t.size());
+	}
+
+	std::vector<uint64_t> offsets;
+	uint64_t offset = (tablesLength + 7) & ~uint64_t(7);
+	for( const auto& item : items ) {
+		uint64_t length = KeyBlobLength(item.key);
+		w.Word<uint32_t>(item.kind);
+		w.Word<uint32_t>(item.tag);
+		w.Word<uint32_t>(item.index);
+		w.Word<uint32_t>(0);
+		w.Word<uint64_t>(offset);
+		w.Word<uint64_t>(length);
+		offsets.push_back(offset);
+		offset = (offset + length + 7) & ~uint64_t(7);
+	}
+
+	for( size_t i = 0; i < items.size(); i++ ) {
+		w.PadTo(offsets[i]);
+		WriteKeyBlob(w, items[i].key);
+	}
+
+	if( !os.good() )
+		PALISADE_THROW(config_error, "Error writing EvalKeyBundle");
+}
+
+template<typename Element>
+void EvalKeyBundle<Element>::Read(std::istream& is, const CryptoContext<Element> cc) {
+	if( !cc )
+		PALISADE_THROW(config_error, "EvalKeyBundle needs a context");
+
+	multKeys.clear();
+	sumKeys.clear();
+	automorphismKeys.clear();
+
+	// the sizes in the bundle are not trusted: nothing larger than what is left in the stream is
+	// allocated, and a stream that cannot tell its length is read in chunks, so a short bundle
+	// fails before its sizes are allocated
+	uint64_t remaining = std::numeric_limits<uint64_t>::max();
+	std::streampos start = is.tellg();
+	if( start != std::streampos(-1) && is.seekg(0, std::ios::end) ) {
+		std::streampos streamEnd = is.tellg();
+		is.seekg(start);
+		if( streamEnd != std::streampos(-1) && streamEnd >= start )
+			remaining = uint64_t(streamEnd - start);
+	}
+	is.clear();
+
+	std::vector<uint8_t> buf;
+	auto readBytes = [&is, &buf, &remaining](uint64_t n) {
+		if( n > remaining )
+			PALISADE_THROW(deserialize_error, "EvalKeyBundle is truncated");
+		const uint64_t chunk = 1 << 20;
+		buf.clear();
+		for( uint64_t done = 0; done < n; ) {
+			uint64_t step = std::min(chunk, n - done);
+			buf.resize(done + step);
+			is.read(reinterpret_cast<char *>(buf.data() + done), step);
+			if( uint64_t(is.gcount()) != step )
+				PALISADE_THROW(deserialize_error, "EvalKeyBundle is truncated");
+			done += step;
+		}
+		remaining -= n;
+		return StoreReader(buf.data(), n, "EvalKeyBundle");
+	};
+
+	StoreReader h = readBytes(EvalKeyBundleFixedHeader);
+	if( memcmp(h.Bytes(sizeof(EvalKeyBundleMagic)), EvalKeyBundleMagic, sizeof(EvalKeyBundleMagic)) != 0 )
+		PALISADE_THROW(deserialize_error, "Stream does not hold an EvalKeyBundle");
+	if( h.Word<uint32_t>() != EvalKeyBundleVersion )
+		PALISADE_THROW(deserialize_error, "Unsupported EvalKeyBundle version");
+	uint32_t tagCount = h.Word<uint32_t>();
+	uint32_t fpLength = h.Word<uint32_t>();
+	h.Word<uint32_t>();
+	uint64_t count = h.Word<uint64_t>();
+	if( count > std::numeric_limits<uint32_t>::max() )
+		PALISADE_THROW(deserialize_error, "EvalKeyBundle key count is not plausible");
+
+	StoreReader f = readBytes(fpLength);
+	if( string(reinterpret_cast<const char *>(f.Bytes(fpLength)), fpLength) != cc->GetFingerprint() )
+		PALISADE_THROW(config_error, "EvalKeyBundle was not written for this context");
+
+	uint64_t tablesLength = EvalKeyBundleFixedHeader + fpLength + count*EvalKeyBundleEntrySize;
+	std::vector<string> tags;
+	for( uint32_t i = 0; i < tagCount; i++ ) {
+		StoreReader l = readBytes(sizeof(uint32_t));
+		uint32_t length = l.Word<uint32_t>();
+		StoreReader tag = readBytes(length);
+		tags.push_back( string(reinterpret_cast<const char *>(tag.Bytes(length)), length) );
+		tablesLength += sizeof(uint32_t) + length;
+	}
+
+	struct Entry {
+		uint32_t	kind;
+		uint32_t	tag;
+		uint32_t	index;
+		uint64_t	offset;
+		uint64_t	length;
+	};
+	StoreReader t = readBytes(count*EvalKeyBundleEntrySize);
+	std::vector<Entry> entries(count);
+	uint64_t end = tablesLength;
+	for( auto& e : entries ) {
+		e.kind = t.Word<uint32_t>();
+		e.tag = t.Word<uint32_t>();
+		e.index = t.Word<uint32_t>();
+		t.Word<uint32_t>();
+		e.offset = t.Word<uint64_t>();
+		e.length = t.Word<uint64_t>();
+		if( e.kind > BundleAutomorphismKey || e.tag >= tagCount || e.offset < tablesLength ||
+				e.length > std::numeric_limits<uint64_t>::max() - e.offset ||
+				(e.kind == BundleMultKey && e.index >= count) )
+			PALISADE_THROW(deserialize_error, "EvalKeyBundle table is corrupt");
+		end = std::max(end, e.offset + e.length);
+	}
+
+	// the keys follow the tables; read them in one go, then decode them in parallel
+	readBytes(end - tablesLength);
+	const uint8_t *blobs = buf.data();
+
+	std::vector<LPEvalKey<Element>> keys(count);
+	string error;
+#pragma omp parallel for schedule(dynamic)
+	for( size_t i = 0; i < count; i++ ) {
+		try {
+			keys[i] = ReadKeyBlob(cc, tags[entries[i].tag], blobs + (entries[i].offset - tablesLength), entries[i].length);
+		}
+		catch( const std::exception& e ) {
+#pragma omp critical
+			{
+				if( error.empty() )
+					error = e.what();
+			}
+		}
+	}
+	if( !error.empty() )
+		PALISADE_THROW(deserialize_error, "EvalKeyBundle key could not be decoded: " + error);
+
+	for( size_t i = 0; i < count; i++ ) {
+		const Entry& e = entries[i];
+		const string& tag = tags[e.tag];
+		if( e.kind == BundleMultKey ) {
+			auto& v = multKeys[tag];
+			if( v.size() <= e.index )
+				v.resize(e.index + 1);
+			v[e.index] = std::move(keys[i]);
+		}
+		else if( e.kind == BundleSumKey )
+			sumKeys[tag][e.index] = std::move(keys[i]);
+		else
+			automorphismKeys[tag][e.index] = std::move(keys[i]);
+	}
+
+	for( const auto& m : multKeys )
+		for( const auto& k : m.second )
+			if( !k )
+				PALISADE_THROW(deserialize_error, "EvalKeyBundle is missing an evalmult key");
+}
+
+}
@@ -0,0 +1,192 @@
+/**
+ * @file evalkeystore.h -- On-disk store of evaluation keys that are loaded on demand, and bundles of keys loaded all at once.
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or other
+ * materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef SRC_PKE_LIB_EVALKEYSTORE_H_
+#define SRC_PKE_LIB_EVALKEYSTORE_H_
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#ifdef _WIN32
+#include <fstream>
+#endif
+
+#include "palisade.h"
+
+namespace lbcrypto {
+
+/**
+ * @brief EvalKeyStore holds the automorphism (rotation) keys for one secret key in a file
+ *
+ * The file starts with a header listing, for every automorphism index, where the key lives in
+ * the file. Each key is stored at a page-aligned offset in the in-memory layout of its towers
+ * (one native word per coefficient), so a key can be materialized straight out of a memory
+ * mapping with a single copy per tower, without parsing the rest of the file.
+ *
+ * Keys are materialized the first time they are asked for; at most maxResident of them are
+ * kept in memory, and the least recently used key is dropped when the cap is reached.
+ *
+ * Only relinearization keys over native-word elements (NativePoly and DCRTPoly) can be stored.
+ * The words are written in host byte order, so a store is only portable between machines of
+ * the same endianness.
+ */
+template<typename Element>
+class EvalKeyStore {
+public:
+	/**
+	 * Write a map of automorphism keys to a key store file
+	 *
+	 * @param filename - file to write
+	 * @param keys - the keys, by automorphism index; all must share a context and key tag
+	 */
+	static void Write(const string& filename, const std::map<usint,LPEvalKey<Element>>& keys);
+
+	/**
+	 * Open a key store; only the header is read
+	 *
+	 * @param cc - context the keys were generated in; must match the fingerprint in the file
+	 * @param filename - file to open
+	 * @param maxResident - most keys kept in memory at once; 0 means no limit
+	 */
+	EvalKeyStore(const CryptoContext<Element> cc, const string& filename, size_t maxResident = 0);
+
+	~EvalKeyStore();
+
+	EvalKeyStore(const EvalKeyStore&) = delete;
+	EvalKeyStore& operator=(const EvalKeyStore&) = delete;
+
+	/**
+	 * @return the tag of the secret key the stored keys belong to
+	 */
+	const string& GetKeyTag() const { return m_keyTag; }
+
+	/**
+	 * @return the context the store was opened in
+	 */
+	const CryptoContext<Element> GetCryptoContext() const { return m_cc; }
+
+	/**
+	 * @return true if the store holds a key for automorphism index i
+	 */
+	bool HasKey(usint i) const { return m_entries.find(i) != m_entries.end(); }
+
+	/**
+	 * @return all automorphism indices in the store
+	 */
+	std::vector<usint> GetIndices() const;
+
+	/**
+	 * Return the key for automorphism index i, reading it from the file if it is not resident
+	 *
+	 * @param i - automorphism index
+	 * @return the key
+	 */
+	LPEvalKey<Element> GetKey(usint i);
+
+	/**
+	 * @return number of keys currently held in memory
+	 */
+	size_t GetResidentCount() const;
+
+	/**
+	 * Change the cap on resident keys; 0 means no limit
+	 */
+	void SetMaxResident(size_t maxResident);
+
+private:
+	struct Entry {
+		uint64_t	offset;
+		uint64_t	length;
+	};
+
+	LPEvalKey<Element> Materialize(const Entry& e, const uint8_t *blob) const;
+	void Trim();
+
+	CryptoContext<Element>				m_cc;
+	string								m_filename;
+	string								m_keyTag;
+	std::map<usint,Entry>				m_entries;
+
+#ifdef _WIN32
+	std::ifstream						m_file;
+#else
+	const uint8_t						*m_base;
+	size_t								m_size;
+#endif
+
+	typedef std::list<std::pair<usint,LPEvalKey<Element>>>	LRUList;
+	LRUList													m_lru;	/*!< most recently used first */
+	std::unordered_map<usint,typename LRUList::iterator>	m_resident;
+	size_t													m_maxResident;
+	mutable std::mutex										m_mutex;
+};
+
+/**
+ * @brief EvalKeyBundle holds every kind of evaluation key for a context, for reading or writing in one stream
+ *
+ * A bundle starts with a table that gives the kind, key tag, index, offset and length of each key,
+ * followed by the keys in the same raw tower layout that EvalKeyStore uses. Since every key can be
+ * found from the table alone, Read decodes the keys in parallel. Each key is checked against the
+ * context while it is decoded, not in a separate pass over the bundle.
+ *
+ * Only relinearization keys over native-word elements (NativePoly and DCRTPoly) can be bundled,
+ * and the words are in host byte order.
+ */
+template<typename Element>
+class EvalKeyBundle {
+public:
+	std::map<string,std::vector<LPEvalKey<Element>>>		multKeys;			/*!< evalmult keys, by key tag */
+	std::map<string,std::map<usint,LPEvalKey<Element>>>	sumKeys;			/*!< evalsum keys, by key tag */
+	std::map<string,std::map<usint,LPEvalKey<Element>>>	automorphismKeys;	/*!< evalautomorphism keys, by key tag */
+
+	/**
+	 * @return true if the bundle holds no keys
+	 */
+	bool Empty() const { return multKeys.empty() && sumKeys.empty() && automorphismKeys.empty(); }
+
+	/**
+	 * Write the bundle
+	 *
+	 * @param os - stream to write to
+	 * @param cc - context of the keys; its fingerprint is written with them
+	 */
+	void Write(std::ostream& os, const CryptoContext<Element> cc) const;
+
+	/**
+	 * Read a bundle, replacing the contents of this one
+	 *
+	 * @param is - stream to read from
+	 * @param cc - context to read the keys into; must match the fingerprint in the bundle
+	 */
+	void Read(std::istream& is, const CryptoContext<Element> cc);
+};
+
+}
+
+#endif /* SRC_PKE_LIB_EVALKEYSTORE_H_ */
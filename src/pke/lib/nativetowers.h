@@ -0,0 +1,181 @@
+/**
+ * @file nativetowers.h -- Access to the native-word towers of a ring element.
+ * @author  TPOC: contact@palisade-crypto.org
+ *
+ * @copyright Copyright (c) 2019, New Jersey Institute of Technology (NJIT)
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or other
+ * materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef SRC_PKE_LIB_NATIVETOWERS_H_
+#define SRC_PKE_LIB_NATIVETOWERS_H_
+
+#include <algorithm>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "palisade.h"
+
+namespace lbcrypto {
+
+/**
+ * The towers of an element, in order; used by the raw on-disk formats, which store
+ * elements as native words. Elements that are not built from native-word towers throw.
+ *
+ * @param e element
+ * @return pointers to the towers of e
+ */
+template<typename Element>
+std::vector<const NativePoly*> NativeTowers(const Element& e) {
+	PALISADE_THROW(not_implemented_error, "Only elements made of native-word towers can be stored in raw form");
+}
+
+inline std::vector<const NativePoly*> NativeTowers(const NativePoly& e) {
+	return std::vector<const NativePoly*>(1, &e);
+}
+
+template<typename VecType>
+std::vector<const NativePoly*> NativeTowers(const DCRTPolyImpl<VecType>& e) {
+	std::vector<const NativePoly*> t;
+	for( const auto& p : e.GetAllElements() )
+		t.push_back(&p);
+	return t;
+}
+
+/**
+ * Writable access to the towers of an element
+ *
+ * @param e element
+ * @return pointers to the towers of e
+ */
+template<typename Element>
+std::vector<NativePoly*> MutableNativeTowers(Element& e) {
+	PALISADE_THROW(not_implemented_error, "Only elements made of native-word towers can be stored in raw form");
+}
+
+inline std::vector<NativePoly*> MutableNativeTowers(NativePoly& e) {
+	return std::vector<NativePoly*>(1, &e);
+}
+
+template<typename VecType>
+std::vector<NativePoly*> MutableNativeTowers(DCRTPolyImpl<VecType>& e) {
+	std::vector<NativePoly*> t;
+	for( usint i = 0; i < e.GetNumOfElements(); i++ )
+		t.push_back(&e.ElementAtIndex(i));
+	return t;
+}
+
+/**
+ * Drop the last towers of an element until it has the given number of towers
+ *
+ * @param e element
+ * @param towers number of towers to keep
+ */
+template<typename Element>
+void DropNativeTowers(Element& e, usint towers) {
+	if( MutableNativeTowers(e).size() != towers )
+		PALISADE_THROW(not_implemented_error, "Only DCRTPoly elements can drop towers");
+}
+
+template<typename VecType>
+void DropNativeTowers(DCRTPolyImpl<VecType>& e, usint towers) {
+	while( e.GetNumOfElements() > towers )
+		e.DropLastElement();
+}
+
+/**
+ * The number of native-word towers of the elements built from a set of parameters
+ *
+ * @param params element parameters
+ * @return the number of towers
+ */
+template<typename Params>
+usint NativeTowerCount(const Params& params) {
+	return 1;
+}
+
+template<typename IntType>
+usint NativeTowerCount(const ILDCRTParams<IntType>& params) {
+	return params.GetParams().size();
+}
+
+/**
+ * @brief Writes the words of a raw on-disk format to a stream, counting the bytes written
+ */
+class StoreWriter {
+public:
+	explicit StoreWriter(std::ostream& os) : os(os), pos(0) {}
+
+	void Bytes(const void *p, uint64_t n) {
+		os.write(reinterpret_cast<const char *>(p), n);
+		pos += n;
+	}
+	template<typename T> void Word(T v) { Bytes(&v, sizeof(v)); }
+	void PadTo(uint64_t to) {
+		static const char zeros[4096] = {};
+		while( pos < to ) {
+			uint64_t n = std::min<uint64_t>(to - pos, sizeof(zeros));
+			Bytes(zeros, n);
+		}
+	}
+
+private:
+	std::ostream&	os;
+	uint64_t		pos;
+};
+
+/**
+ * @brief Reads the words of a raw on-disk format from memory; reading past the end throws
+ * deserialize_error, so no size read from the data is trusted
+ */
+class StoreReader {
+public:
+	/**
+	 * @param p start of the data
+	 * @param n length of the data
+	 * @param what name of the data in error messages
+	 */
+	StoreReader(const uint8_t *p, uint64_t n, const char *what = "EvalKeyStore file") : p(p), end(p + n), what(what) {}
+
+	const uint8_t *Bytes(uint64_t n) {
+		if( uint64_t(end - p) < n )
+			PALISADE_THROW(deserialize_error, std::string(what) + " is truncated");
+		const uint8_t *r = p;
+		p += n;
+		return r;
+	}
+	template<typename T> T Word() {
+		T v;
+		memcpy(&v, Bytes(sizeof(v)), sizeof(v));
+		return v;
+	}
+	uint64_t Remaining() const { return end - p; }
+
+private:
+	const uint8_t	*p;
+	const uint8_t	*end;
+	const char		*what;
+};
+
+}
+
+#endif /* SRC_PKE_LIB_NATIVETOWERS_H_ */
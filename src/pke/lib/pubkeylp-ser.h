@@ -100,4 +100,8 @@ CEREAL_REGISTER_POLYMORPHIC_RELATION(lbcrypto::LPEvalKeyImpl<lbcrypto::DCRTPoly>
 CEREAL_REGISTER_POLYMORPHIC_RELATION(lbcrypto::LPEvalKeyImpl<lbcrypto::DCRTPoly>, lbcrypto::LPEvalKeyNTRUImpl<lbcrypto::DCRTPoly>);
 CEREAL_REGISTER_POLYMORPHIC_RELATION(lbcrypto::LPEvalKeyImpl<lbcrypto::DCRTPoly>, lbcrypto::LPEvalKeyNTRURelinImpl<lbcrypto::DCRTPoly>);
 
+CEREAL_CLASS_VERSION( lbcrypto::LPPublicKeyImpl<lbcrypto::Poly>, lbcrypto::LPPublicKeyImpl<lbcrypto::Poly>::SerializedVersion() );
+CEREAL_CLASS_VERSION( lbcrypto::LPPublicKeyImpl<lbcrypto::NativePoly>, lbcrypto::LPPublicKeyImpl<lbcrypto::NativePoly>::SerializedVersion() );
+CEREAL_CLASS_VERSION( lbcrypto::LPPublicKeyImpl<lbcrypto::DCRTPoly>, lbcrypto::LPPublicKeyImpl<lbcrypto::DCRTPoly>::SerializedVersion() );
+
 #endif
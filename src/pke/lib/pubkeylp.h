@@ -104,6 +104,44 @@ namespace lbcrypto {
 		usint messageLength;	/**< the length of the decrypted plaintext message */
 	};
 
+	/**
+	 * @brief Seeds that stand in for the uniformly random element of a public key or ciphertext
+	 *
+	 * A seeded public key or ciphertext draws its last element from HashUtil::HashToRing of a
+	 * short seed, rather than from a DiscreteUniformGenerator. It is serialized with the seed in
+	 * place of that element, which is expanded again when the object is loaded.
+	 */
+	class ElementSeed {
+	public:
+		enum { Length = 32 };	/*!< size of a seed in bytes */
+
+		/**
+		 * @return a new seed drawn from the library PRNG
+		 */
+		static std::vector<uint8_t> Generate() {
+			std::vector<uint8_t> seed(Length);
+			for( size_t i = 0; i < Length; i += sizeof(uint32_t) ) {
+				uint32_t r = PseudoRandomNumberGenerator::GetPRNG()();
+				memcpy(&seed[i], &r, sizeof(r));
+			}
+			return seed;
+		}
+
+		/**
+		 * Expand a seed into a uniformly random ring element in EVALUATION format
+		 *
+		 * @param seed - the seed
+		 * @param params - parameters of the element
+		 * @return the element
+		 */
+		template<typename Element>
+		static Element Expand(const std::vector<uint8_t>& seed, const shared_ptr<typename Element::Params> params) {
+			if( seed.size() != Length )
+				PALISADE_THROW(math_error, "Seed must be " + std::to_string(int(Length)) + " bytes");
+			return HashUtil::HashToRing<Element>(seed.data(), seed.size(), params, EVALUATION);
+		}
+	};
+
 	/**
 	 * @brief Abstract interface class for LP Keys
 	 *
@@ -160,6 +198,7 @@ namespace lbcrypto {
 		 */
 		explicit LPPublicKeyImpl(const LPPublicKeyImpl<Element> &rhs) : LPKey<Element>(rhs.GetCryptoContext(), rhs.GetKeyTag()) {
 			m_h = rhs.m_h;
+			m_seed = rhs.m_seed;
 		}
 
 		/**
@@ -169,6 +208,7 @@ namespace lbcrypto {
 		 */
 		explicit LPPublicKeyImpl(LPPublicKeyImpl<Element> &&rhs) : LPKey<Element>(rhs.GetCryptoContext(), rhs.GetKeyTag()) {
 			m_h = std::move(rhs.m_h);
+			m_seed = std::move(rhs.m_seed);
 		}
 
 		operator bool() const { return bool(this->context) && m_h.size() != 0; }
@@ -181,6 +221,7 @@ namespace lbcrypto {
 		const LPPublicKeyImpl<Element>& operator=(const LPPublicKeyImpl<Element> &rhs) {
 			CryptoObject<Element>::operator=(rhs);
 			this->m_h = rhs.m_h;
+			this->m_seed = rhs.m_seed;
 			return *this;
 		}
 
@@ -192,6 +233,7 @@ namespace lbcrypto {
 		const LPPublicKeyImpl<Element>& operator=(LPPublicKeyImpl<Element> &&rhs) {
 			CryptoObject<Element>::operator=(rhs);
 			m_h = std::move(rhs.m_h);
+			m_seed = std::move(rhs.m_seed);
 			return *this;
 		}
 
@@ -205,6 +247,14 @@ namespace lbcrypto {
 			return this->m_h;
 		}
 
+		/**
+		 * Gets the seed that the last public key element was expanded from
+		 * @return the seed; empty if the key is not seeded
+		 */
+		const std::vector<uint8_t> &GetSeed() const {
+			return this->m_seed;
+		}
+
 		//@Set Properties
 
 		/**
@@ -213,6 +263,7 @@ namespace lbcrypto {
 		 */
 		void SetPublicElements(const std::vector<Element> &element) {
 			m_h = element;
+			m_seed.clear();
 		}
 
 		/**
@@ -221,6 +272,7 @@ namespace lbcrypto {
 		 */
 		void SetPublicElements(std::vector<Element> &&element) {
 			m_h = std::move(element);
+			m_seed.clear();
 		}
 
 		/**
@@ -229,6 +281,7 @@ namespace lbcrypto {
 		 */
 		void SetPublicElementAtIndex(usint idx, const Element &element) {
 			m_h.insert(m_h.begin() + idx, element);
+			m_seed.clear();
 		}
 
 		/**
@@ -237,6 +290,17 @@ namespace lbcrypto {
 		 */
 		void SetPublicElementAtIndex(usint idx, Element &&element) {
 			m_h.insert(m_h.begin() + idx, std::move(element));
+			m_seed.clear();
+		}
+
+		/**
+		 * Marks the key as seeded: its last element must be ElementSeed::Expand of the seed.
+		 * A seeded key is serialized with the seed in place of that element. Setting any
+		 * element afterwards drops the seed.
+		 * @param seed - the seed
+		 */
+		void SetSeed(const std::vector<uint8_t> &seed) {
+			m_seed = seed;
 		}
 
 		bool operator==(const LPPublicKeyImpl& other) const {
@@ -263,7 +327,15 @@ namespace lbcrypto {
 		void save( Archive & ar, std::uint32_t const version ) const
 		{
 			ar( ::cereal::base_class<LPKey<Element>>( this ) );
-			ar( ::cereal::make_nvp("h",m_h) );
+			if( m_seed.empty() ) {
+				ar( ::cereal::make_nvp("h",m_h) );
+			}
+			else {
+				// the last element is expanded from the seed when the key is loaded
+				std::vector<Element> h(m_h.begin(), m_h.end() - 1);
+				ar( ::cereal::make_nvp("h",h) );
+			}
+			ar( ::cereal::make_nvp("s",m_seed) );
 		}
 
 		template <class Archive>
@@ -274,13 +346,23 @@ namespace lbcrypto {
 			}
 			ar( ::cereal::base_class<LPKey<Element>>( this ) );
 			ar( ::cereal::make_nvp("h",m_h) );
+			m_seed.clear();
+			if( version >= 2 ) {
+				ar( ::cereal::make_nvp("s",m_seed) );
+				if( !m_seed.empty() ) {
+					if( !this->GetCryptoContext() )
+						PALISADE_THROW(deserialize_error, "seeded public key has no crypto context to expand its seed with");
+					m_h.push_back( ElementSeed::Expand<Element>(m_seed, this->GetCryptoParameters()->GetElementParams()) );
+				}
+			}
 		}
 
 		std::string SerializedObjectName() const { return "PublicKey"; }
-		static uint32_t	SerializedVersion() { return 1; }
+		static uint32_t	SerializedVersion() { return 2; }
 
 	private:
 		std::vector<Element> m_h;
+		std::vector<uint8_t> m_seed;	/*!< seed of the last element of m_h, if the key is seeded */
 	};
 
 	template<typename Element>
@@ -1061,6 +1143,19 @@ namespace lbcrypto {
 			 */
 			virtual Ciphertext<Element> Encrypt(const LPPrivateKey<Element> privateKey, Element plaintext) const = 0;
 
+			/**
+			 * Method for encrypting the coefficients of a packed plaintext with a public key, without
+			 * building the plaintext element: the coefficients are lifted, scaled and transformed tower
+			 * by tower as they are added to the encryption of zero
+			 *
+			 * @param publicKey public key used for encryption.
+			 * @param coefficients the plaintext coefficients, in [0, p), as made by PackedEncodingPlan::Pack.
+			 * @return the ciphertext.
+			 */
+			virtual Ciphertext<Element> EncryptPacked(const LPPublicKey<Element> publicKey, const NativeVector &coefficients) const {
+				throw std::logic_error("Fused packed encryption is not supported by this scheme");
+			}
+
 			/**
 			 * Method for decrypting plaintext using LBC
 			 *
@@ -1081,6 +1176,29 @@ namespace lbcrypto {
 			 * @return function ran correctly.
 			 */
 			virtual LPKeyPair<Element> KeyGen(CryptoContext<Element> cc, bool makeSparse=false) = 0;
+
+			/**
+			 * Method for encrypting with a private key into a seeded ciphertext, whose uniformly
+			 * random element is expanded from a seed (see ElementSeed)
+			 *
+			 * @param privateKey private key used for encryption.
+			 * @param plaintext copy of the plaintext input.
+			 * @return the seeded ciphertext.
+			 */
+			virtual Ciphertext<Element> EncryptSeeded(const LPPrivateKey<Element> privateKey, Element plaintext) const {
+				throw std::logic_error("Seeded encryption is not supported by this scheme");
+			}
+
+			/**
+			 * Function to generate a key pair whose public key is seeded: its uniformly random
+			 * element is expanded from a seed (see ElementSeed)
+			 *
+			 * @param cc crypto context.
+			 * @return the key pair.
+			 */
+			virtual LPKeyPair<Element> KeyGenSeeded(CryptoContext<Element> cc) {
+				throw std::logic_error("Seeded key generation is not supported by this scheme");
+			}
 	};
 
 
@@ -1385,15 +1503,11 @@ namespace lbcrypto {
 
 			Matrix<RationalCiphertext<Element>> xCovariance = xTransposed * (*x);
 
-			Matrix<RationalCiphertext<Element>> cofactorMatrix = xCovariance.CofactorMatrix();
-
-			Matrix<RationalCiphertext<Element>> adjugateMatrix = cofactorMatrix.Transpose();
+			RationalCiphertext<Element> determinant;
+			Matrix<RationalCiphertext<Element>> adjugateMatrix = xCovariance.Adjugate(&determinant);
 
 			*result = adjugateMatrix * (*result);
 
-			RationalCiphertext<Element> determinant;
-			xCovariance.Determinant(&determinant);
-
 				for (size_t row = 0; row < result->GetRows(); row++)
 					for (size_t col = 0; col < result->GetCols(); col++)
 						(*result)(row, col).SetDenominator(determinant.GetNumerator());
@@ -1585,19 +1699,28 @@ namespace lbcrypto {
 		Ciphertext<Element> EvalAtIndex(ConstCiphertext<Element> ciphertext,
 			int32_t index, const std::map<usint, LPEvalKey<Element>> &evalAtIndexKeys) const {
 
+			return EvalAutomorphism(ciphertext,FindAutomorphismIndex(ciphertext,index),evalAtIndexKeys);
+
+		}
+
+		/**
+		* Automorphism index of the key EvalAtIndex uses to move the i-th slot to slot 0
+		*
+		* @param ciphertext.
+		* @param i the index.
+		* @return the automorphism index
+		*/
+		static usint FindAutomorphismIndex(ConstCiphertext<Element> ciphertext, int32_t index) {
+
 			const auto cryptoParams = ciphertext->GetCryptoParameters();
 			const auto encodingParams = cryptoParams->GetEncodingParams();
 			const auto elementParams = cryptoParams->GetElementParams();
 			uint32_t m = elementParams->GetCyclotomicOrder();
 
-			uint32_t autoIndex;
-
 			if (!(m & (m-1)))  // power-of-two cyclotomics
-				autoIndex = FindAutomorphismIndex2n(index,m);
+				return FindAutomorphismIndex2n(index,m);
 			else // cyclyc-group cyclotomics
-				autoIndex = FindAutomorphismIndexCyclic(index,m,encodingParams->GetPlaintextGenerator());
-
-			return EvalAutomorphism(ciphertext,autoIndex,evalAtIndexKeys);
+				return FindAutomorphismIndexCyclic(index,m,encodingParams->GetPlaintextGenerator());
 
 		}
 
@@ -1810,9 +1933,8 @@ namespace lbcrypto {
 			covarianceMatrix(1, 0) = covarianceMatrix(0, 1);
 			covarianceMatrix(1, 1).SetNumerator(EvalInnerProduct(x1, x1, batchSize, evalSumKeys, evalMultKey));
 
-			Matrix<RationalCiphertext<Element>> cofactorMatrix = covarianceMatrix.CofactorMatrix();
-
-			Matrix<RationalCiphertext<Element>> adjugateMatrix = cofactorMatrix.Transpose();
+			RationalCiphertext<Element> determinant;
+			Matrix<RationalCiphertext<Element>> adjugateMatrix = covarianceMatrix.Adjugate(&determinant);
 
 			shared_ptr<Matrix<RationalCiphertext<Element>>> result(new Matrix<RationalCiphertext<Element>>(x->GetAllocator(), 2, 1));
 
@@ -1821,9 +1943,6 @@ namespace lbcrypto {
 
 			*result = adjugateMatrix * (*result);
 
-			RationalCiphertext<Element> determinant;
-			covarianceMatrix.Determinant(&determinant);
-
 			for (size_t row = 0; row < result->GetRows(); row++)
 				for (size_t col = 0; col < result->GetCols(); col++)
 					(*result)(row, col).SetDenominator(determinant.GetNumerator());
@@ -2166,7 +2285,7 @@ namespace lbcrypto {
 		}
 
 		/////////////////////////////////////////
-		// the three functions below are wrappers for things in LPEncryptionAlgorithm (ENCRYPT)
+		// the functions below are wrappers for things in LPEncryptionAlgorithm (ENCRYPT)
 		//
 
 		Ciphertext<Element> Encrypt(const LPPublicKey<Element> publicKey,
@@ -2209,6 +2328,37 @@ namespace lbcrypto {
 				}
 		}
 
+		Ciphertext<Element> EncryptPacked(const LPPublicKey<Element> publicKey,
+			const NativeVector &coefficients) const {
+				if(this->m_algorithmEncryption) {
+					return this->m_algorithmEncryption->EncryptPacked(publicKey,coefficients);
+				}
+				else {
+					throw std::logic_error("Encrypt operation has not been enabled");
+				}
+		}
+
+		Ciphertext<Element> EncryptSeeded(const LPPrivateKey<Element> privateKey,
+			const Element &plaintext) const {
+				if(this->m_algorithmEncryption) {
+					return this->m_algorithmEncryption->EncryptSeeded(privateKey,plaintext);
+				}
+				else {
+					throw std::logic_error("Encrypt operation has not been enabled");
+				}
+		}
+
+		LPKeyPair<Element> KeyGenSeeded(CryptoContext<Element> cc) {
+				if(this->m_algorithmEncryption) {
+					auto kp = this->m_algorithmEncryption->KeyGenSeeded(cc);
+					kp.publicKey->SetKeyTag( kp.secretKey->GetKeyTag() );
+					return kp;
+				}
+				else {
+					throw std::logic_error("KeyGen operation has not been enabled");
+				}
+		}
+
 		/////////////////////////////////////////
 		// the three functions below are wrappers for things in LPPREAlgorithm (PRE)
 		//
@@ -28,6 +28,9 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
 
 #include "../lib/cryptocontext.h"
 
@@ -127,6 +130,143 @@ TEST_F(UTAUTOMORPHISM, Test_BGV_Automorphism_Arb) {
 
 }
 
+TEST_F(UTAUTOMORPHISM, Test_BFVrns_EvalKeyStore) {
+	PackedEncoding::Destroy();
+
+	EncodingParams encodingParams(new EncodingParamsImpl(65537));
+	CryptoContext<DCRTPoly> cc = CryptoContextFactory<DCRTPoly>::genCryptoContextBFVrns(
+			encodingParams, 1.006, 4, 0, 1, 0, OPTIMIZED, 2);
+	cc->Enable(ENCRYPTION);
+	cc->Enable(SHE);
+
+	LPKeyPair<DCRTPoly> kp = cc->KeyGen();
+
+	std::vector<int32_t> indexList = { 1,2,3,4 };
+	cc->EvalAtIndexKeyGen(kp.secretKey, indexList);
+	auto originals = *cc->GetEvalAutomorphismKeyMapPtr(kp.secretKey->GetKeyTag());
+
+	const string filename = "UnitTestAutomorphism.keystore";
+	ASSERT_TRUE(CryptoContextImpl<DCRTPoly>::SerializeEvalAutomorphismKeyStore(filename, kp.secretKey->GetKeyTag()));
+	EXPECT_FALSE(CryptoContextImpl<DCRTPoly>::SerializeEvalAutomorphismKeyStore(filename + ".none", "no such tag"));
+	CryptoContextImpl<DCRTPoly>::ClearEvalAutomorphismKeys();
+
+	auto store = cc->LoadEvalAutomorphismKeyStore(filename, 2);
+	EXPECT_EQ(originals.size(), store->GetIndices().size());
+	EXPECT_EQ(0U, store->GetResidentCount()) << "keys are read on first use";
+	for( const auto& k : originals )
+		EXPECT_EQ(*k.second, *store->GetKey(k.first)) << "key for index " << k.first;
+	EXPECT_EQ(2U, store->GetResidentCount()) << "resident keys are capped";
+
+	std::vector<int64_t> initVector = { 1,2,3,4,5,6,7,8 };
+	Plaintext pt = cc->MakePackedPlaintext(initVector);
+	auto ciphertext = cc->Encrypt(kp.publicKey, pt);
+
+	vector<TimingInfo> times;
+	cc->StartTiming(&times);
+	for( auto index : indexList ) {
+		Plaintext result;
+		cc->Decrypt(kp.secretKey, cc->EvalAtIndex(ciphertext, index), &result);
+		result->SetLength(initVector.size() - index);
+		std::vector<int64_t> expected(initVector.begin() + index, initVector.end());
+		EXPECT_EQ(expected, result->GetPackedValue()) << "EvalAtIndex " << index;
+	}
+	cc->StopTiming();
+	EXPECT_EQ(indexList.size(), (size_t)std::count_if(times.begin(), times.end(),
+			[](const TimingInfo& t) { return t.operation == OpEvalAtIndex; })) << "EvalAtIndex with stored keys is timed";
+
+	CryptoContextImpl<DCRTPoly>::ClearEvalAutomorphismKeys();
+	EXPECT_THROW(cc->EvalAtIndex(ciphertext, 1), std::logic_error);
+	std::remove(filename.c_str());
+}
+
+TEST_F(UTAUTOMORPHISM, Test_BFVrns_EvalKeyBundle) {
+	PackedEncoding::Destroy();
+
+	EncodingParams encodingParams(new EncodingParamsImpl(65537, 8));
+	CryptoContext<DCRTPoly> cc = CryptoContextFactory<DCRTPoly>::genCryptoContextBFVrns(
+			encodingParams, 1.006, 4, 0, 1, 0, OPTIMIZED, 2);
+	cc->Enable(ENCRYPTION);
+	cc->Enable(SHE);
+
+	LPKeyPair<DCRTPoly> kp = cc->KeyGen();
+	LPKeyPair<DCRTPoly> other = cc->KeyGen();
+
+	std::vector<int32_t> indexList = { 1,2,3,4 };
+	cc->EvalMultKeyGen(kp.secretKey);
+	cc->EvalSumKeyGen(kp.secretKey);
+	cc->EvalAtIndexKeyGen(kp.secretKey, indexList);
+	cc->EvalMultKeyGen(other.secretKey);
+	auto originals = *cc->GetEvalAutomorphismKeyMapPtr(kp.secretKey->GetKeyTag());
+
+	std::stringstream bundle;
+	ASSERT_TRUE(CryptoContextImpl<DCRTPoly>::SerializeEvalKeyBundle(bundle, cc, kp.secretKey->GetKeyTag()));
+	std::stringstream none;
+	EXPECT_FALSE(CryptoContextImpl<DCRTPoly>::SerializeEvalKeyBundle(none, cc, "no such tag"));
+
+	CryptoContextImpl<DCRTPoly>::ClearEvalMultKeys();
+	CryptoContextImpl<DCRTPoly>::ClearEvalSumKeys();
+	CryptoContextImpl<DCRTPoly>::ClearEvalAutomorphismKeys();
+
+	ASSERT_TRUE(CryptoContextImpl<DCRTPoly>::DeserializeEvalKeyBundle(bundle, cc));
+	EXPECT_EQ(1U, CryptoContextImpl<DCRTPoly>::GetAllEvalMultKeys().size()) << "only the requested tag is bundled";
+	const auto loaded = cc->GetEvalAutomorphismKeyMapPtr(kp.secretKey->GetKeyTag());
+	EXPECT_EQ(originals.size(), loaded->size());
+	for( const auto& k : originals )
+		EXPECT_EQ(*k.second, *loaded->at(k.first)) << "key for index " << k.first;
+
+	std::vector<int64_t> initVector = { 1,2,3,4,5,6,7,8 };
+	Plaintext pt = cc->MakePackedPlaintext(initVector);
+	auto ciphertext = cc->Encrypt(kp.publicKey, pt);
+
+	Plaintext result;
+	cc->Decrypt(kp.secretKey, cc->EvalAtIndex(ciphertext, 2), &result);
+	result->SetLength(initVector.size() - 2);
+	EXPECT_EQ(std::vector<int64_t>(initVector.begin() + 2, initVector.end()), result->GetPackedValue()) << "EvalAtIndex";
+
+	cc->Decrypt(kp.secretKey, cc->EvalMult(ciphertext, ciphertext), &result);
+	result->SetLength(3);
+	EXPECT_EQ(std::vector<int64_t>({ 1,4,9 }), result->GetPackedValue()) << "EvalMult";
+
+	cc->Decrypt(kp.secretKey, cc->EvalSum(ciphertext, 8), &result);
+	EXPECT_EQ(36, result->GetPackedValue()[0]) << "EvalSum";
+
+	// a bundle is only read into the context it was written for
+	CryptoContext<DCRTPoly> cc2 = CryptoContextFactory<DCRTPoly>::genCryptoContextBFVrns(
+			encodingParams, 1.006, 4, 0, 2, 0, OPTIMIZED, 2);
+	bundle.clear();
+	bundle.seekg(0);
+	EXPECT_THROW(CryptoContextImpl<DCRTPoly>::DeserializeEvalKeyBundle(bundle, cc2), config_error);
+
+	std::stringstream truncated(bundle.str().substr(0, bundle.str().size() / 2));
+	EXPECT_THROW(CryptoContextImpl<DCRTPoly>::DeserializeEvalKeyBundle(truncated, cc), deserialize_error);
+
+	// sizes in a malformed bundle are rejected before anything of that size is allocated
+	const string stored = bundle.str();
+	auto word32 = [&stored](size_t at) { uint32_t w; memcpy(&w, stored.data() + at, sizeof(w)); return w; };
+	auto patched = [&stored](size_t at, uint64_t value, size_t width) {
+		string s = stored;
+		memcpy(&s[at], &value, width);
+		return s;
+	};
+
+	std::stringstream hugeCount(patched(24, 0xFFFFFFFFULL, sizeof(uint64_t)).substr(0, 4096));
+	EXPECT_THROW(CryptoContextImpl<DCRTPoly>::DeserializeEvalKeyBundle(hugeCount, cc), deserialize_error) << "key count";
+
+	size_t firstEntry = 32 + word32(16);
+	for( uint32_t i = 0; i < word32(12); i++ )
+		firstEntry += sizeof(uint32_t) + word32(firstEntry);
+	ASSERT_EQ(0U, word32(firstEntry)) << "the first entry is an evalmult key";
+	std::stringstream hugeIndex(patched(firstEntry + 8, 0xFFFFFFFFULL, sizeof(uint32_t)));
+	EXPECT_THROW(CryptoContextImpl<DCRTPoly>::DeserializeEvalKeyBundle(hugeIndex, cc), deserialize_error) << "key index";
+
+	std::stringstream hugeLength(patched(firstEntry + 24, 1ULL << 40, sizeof(uint64_t)));
+	EXPECT_THROW(CryptoContextImpl<DCRTPoly>::DeserializeEvalKeyBundle(hugeLength, cc), deserialize_error) << "key length";
+
+	CryptoContextImpl<DCRTPoly>::ClearEvalMultKeys();
+	CryptoContextImpl<DCRTPoly>::ClearEvalSumKeys();
+	CryptoContextImpl<DCRTPoly>::ClearEvalAutomorphismKeys();
+}
+
 TEST_F(UTAUTOMORPHISM, Test_BFV_Automorphism_Arb) {
 	
 
@@ -25,7 +25,10 @@
  */
 
 #include "include/gtest/gtest.h"
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <sstream>
 #include <vector>
 
 #include "../lib/cryptocontext.h"
@@ -34,6 +37,7 @@
 
 #include "utils/debug.h"
 #include "utils/parmfactory.h"
+#include "utils/precomputecache.h"
 
 using namespace std;
 using namespace lbcrypto;
@@ -348,4 +352,133 @@ TEST_F(UTBFVrnsCRTOperations, BFVrns_Mult_by_Gaussian) {
 
 }
 
+static std::string ReadCacheFile(const std::string& filename) {
+	std::ifstream in(filename, std::ios::binary);
+	std::stringstream s;
+	s << in.rdbuf();
+	return s.str();
+}
+
+// checks that an EvalMult computed with the (possibly cached) tables decrypts correctly
+static void CheckEvalMult(CryptoContext<DCRTPoly> cc, const string& msg) {
+	LPKeyPair<DCRTPoly> kp = cc->KeyGen();
+	cc->EvalMultKeyGen(kp.secretKey);
+
+	std::vector<int64_t> vals = { 1, 2, 3, -4 };
+	auto ct = cc->Encrypt(kp.publicKey, cc->MakeCoefPackedPlaintext(vals));
+
+	Plaintext result;
+	cc->Decrypt(kp.secretKey, cc->EvalMult(ct, ct), &result);
+	result->SetLength(7);
+	EXPECT_EQ(std::vector<int64_t>({ 1, 4, 10, 4, -7, -24, 16 }), result->GetCoefPackedValue()) << msg;
+}
+
+TEST_F(UTBFVrnsCRTOperations, BFVrns_PrecomputeCache) {
+	PrecomputeCache::SetDirectory(".");
+
+	// the first context computes the tables and stores them
+	CryptoContext<DCRTPoly> cc = CryptoContextFactory<DCRTPoly>::genCryptoContextBFVrns(
+			65537, HEStd_128_classic, 3.2, 0, 2, 0, OPTIMIZED);
+	cc->Enable(ENCRYPTION);
+	cc->Enable(SHE);
+
+	auto params = std::dynamic_pointer_cast<LPCryptoParametersBFVrns<DCRTPoly>>(cc->GetCryptoParameters());
+	const string filename = PrecomputeCache::GetFilename(params->GetCRTTablesKey());
+	const string stored = ReadCacheFile(filename);
+	ASSERT_FALSE(stored.empty()) << "tables were not stored";
+
+	const auto multInt = params->GetCRTMultIntTable();
+	const auto multFloat = params->GetCRTMultFloatTable();
+	const auto sInverse = params->GetCRTSInverseTable();
+	const auto modulusS = params->GetDCRTParamsS()->GetModulus();
+	const auto modulusQS = params->GetDCRTParamsQS()->GetModulus();
+
+	// the tables are read back, NTT tables included
+	ChineseRemainderTransformFTT<NativeVector>::Reset();
+	ASSERT_TRUE(params->PrecomputeCRTTables());
+	EXPECT_EQ(multInt, params->GetCRTMultIntTable());
+	EXPECT_EQ(multFloat, params->GetCRTMultFloatTable());
+	EXPECT_EQ(sInverse, params->GetCRTSInverseTable());
+	EXPECT_EQ(modulusS, params->GetDCRTParamsS()->GetModulus());
+	EXPECT_EQ(modulusQS, params->GetDCRTParamsQS()->GetModulus());
+
+	// a damaged file is ignored; the tables are computed and stored again
+	string damaged = stored;
+	damaged[damaged.size() - 1] ^= 1;
+	std::ofstream(filename, std::ios::binary | std::ios::trunc) << damaged;
+	ASSERT_TRUE(params->PrecomputeCRTTables());
+	EXPECT_EQ(multInt, params->GetCRTMultIntTable());
+	EXPECT_EQ(stored, ReadCacheFile(filename));
+
+	PrecomputeCache::SetDirectory("");
+	std::remove(filename.c_str());
+
+	CheckEvalMult(cc, "BFVrns EvalMult with cached tables");
+}
+
+TEST_F(UTBFVrnsCRTOperations, BFVrnsB_PrecomputeCache) {
+	PrecomputeCache::SetDirectory(".");
+
+	CryptoContext<DCRTPoly> cc = CryptoContextFactory<DCRTPoly>::genCryptoContextBFVrnsB(
+			65537, HEStd_128_classic, 3.2, 0, 2, 0, OPTIMIZED);
+	cc->Enable(ENCRYPTION);
+	cc->Enable(SHE);
 
+	auto params = std::dynamic_pointer_cast<LPCryptoParametersBFVrnsB<DCRTPoly>>(cc->GetCryptoParameters());
+	const string filename = PrecomputeCache::GetFilename(params->GetCRTTablesKey());
+	ASSERT_FALSE(ReadCacheFile(filename).empty()) << "tables were not stored";
+
+	const auto qDivqiModtgamma = params->GetDCRTParamsqDivqiModtgammaTable();
+	const auto gamma = params->GetDCRTParamsgamma();
+	const auto modulusBsk = params->GetDCRTParamsBsk()->GetModulus();
+
+	ChineseRemainderTransformFTT<NativeVector>::Reset();
+	ASSERT_TRUE(params->PrecomputeCRTTables());
+	EXPECT_EQ(qDivqiModtgamma, params->GetDCRTParamsqDivqiModtgammaTable());
+	EXPECT_EQ(gamma, params->GetDCRTParamsgamma());
+	EXPECT_EQ(modulusBsk, params->GetDCRTParamsBsk()->GetModulus());
+
+	PrecomputeCache::SetDirectory("");
+	std::remove(filename.c_str());
+
+	CheckEvalMult(cc, "BFVrnsB EvalMult with cached tables");
+}
+
+TEST_F(UTBFVrnsCRTOperations, PrecomputeCache_NTTTables) {
+	CryptoContext<DCRTPoly> cc = CryptoContextFactory<DCRTPoly>::genCryptoContextBFVrns(
+			65537, HEStd_128_classic, 3.2, 0, 2, 0, OPTIMIZED);
+	cc->Enable(ENCRYPTION);
+	cc->Enable(SHE);
+	const usint m = cc->GetCyclotomicOrder();
+
+	std::vector<NativeInteger> moduli, roots;
+	for (const auto& p : cc->GetElementParams()->GetParams()) {
+		moduli.push_back(p->GetModulus());
+		roots.push_back(p->GetRootOfUnity());
+	}
+
+	// tables left for the same moduli by a context of another order are not stored
+	PrecomputeTableWriter clean;
+	ChineseRemainderTransformFTT<NativeVector>::Reset();
+	PrecomputeCache::WriteNTTTables(clean, m, moduli, roots);
+	for (const auto& q : moduli)
+		ChineseRemainderTransformFTT<NativeVector>::PreCompute(RootOfUnity<NativeInteger>(m / 2, q), m / 2, q);
+	PrecomputeTableWriter polluted;
+	PrecomputeCache::WriteNTTTables(polluted, m, moduli, roots);
+	EXPECT_EQ(clean.GetBytes(), polluted.GetBytes());
+	ChineseRemainderTransformFTT<NativeVector>::Reset();
+
+	// stored tables are only read back for the order they were built for
+	PrecomputeCache::SetDirectory(".");
+	const string key = "UTBFVrnsCRTOperations_NTTTables";
+	ASSERT_TRUE(PrecomputeCache::Store(key, clean));
+	PrecomputeTableReader wrongOrder, rightOrder;
+	ASSERT_TRUE(PrecomputeCache::Load(key, &wrongOrder));
+	ASSERT_TRUE(PrecomputeCache::Load(key, &rightOrder));
+	EXPECT_THROW(PrecomputeCache::ReadNTTTables(wrongOrder, m / 2), deserialize_error);
+	EXPECT_NO_THROW(PrecomputeCache::ReadNTTTables(rightOrder, m));
+	std::remove(PrecomputeCache::GetFilename(key).c_str());
+	PrecomputeCache::SetDirectory("");
+
+	CheckEvalMult(cc, "BFVrns EvalMult with NTT tables read back");
+}
@@ -181,3 +181,40 @@ TEST_F(UTBFVBATCHING, Poly_EVALMULT_Arb) {
 	EXPECT_EQ(intArrayNew->GetPackedValue(), vectorOfIntsMult);
 }
 
+
+TEST_F(UTBFVBATCHING, DCRTPoly_MakePackedPlaintexts) {
+	CryptoContext<DCRTPoly> cc = CryptoContextFactory<DCRTPoly>::genCryptoContextBFVrns(
+			65537, HEStd_128_classic, 3.2, 0, 2, 0, OPTIMIZED, 2, 0, 60);
+	cc->Enable(ENCRYPTION);
+	cc->Enable(SHE);
+
+	LPKeyPair<DCRTPoly> kp = cc->KeyGen();
+
+	vector<vector<int64_t>> values(8);
+	for( size_t t = 0; t < values.size(); t++ )
+		for( int64_t i = 0; i < 16; i++ )
+			values[t].push_back( (i % 2 ? -1 : 1) * (i*5 + int64_t(t)) );
+
+	vector<Plaintext> plaintexts = cc->MakePackedPlaintexts(values);
+	ASSERT_EQ( plaintexts.size(), values.size() );
+
+	for( size_t t = 0; t < values.size(); t++ ) {
+		EXPECT_EQ( plaintexts[t]->GetElement<DCRTPoly>(), cc->MakePackedPlaintext(values[t])->GetElement<DCRTPoly>() )
+			<< "batch encoding differs from MakePackedPlaintext for vector " << t;
+
+		plaintexts[t]->Decode();
+		plaintexts[t]->SetLength(values[t].size());
+		EXPECT_EQ( plaintexts[t]->GetPackedValue(), values[t] ) << "decode of the encoding of vector " << t;
+
+		// the negative slots are lifted to the towers centered, which multiplication by a plaintext relies on
+		auto ciphertext = cc->Encrypt(kp.publicKey, plaintexts[t]);
+		Plaintext result;
+		cc->Decrypt(kp.secretKey, cc->EvalMult(ciphertext, plaintexts[t]), &result);
+		result->SetLength(values[t].size());
+		for( size_t i = 0; i < values[t].size(); i++ )
+			EXPECT_EQ( result->GetPackedValue()[i], values[t][i]*values[t][i] ) << "slot " << i << " of vector " << t;
+	}
+
+	values[3][5] = 65537;
+	EXPECT_THROW( cc->MakePackedPlaintexts(values), std::logic_error ) << "value out of range was encoded";
+}
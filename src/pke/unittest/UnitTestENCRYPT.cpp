@@ -191,3 +191,105 @@ EncryptionCoefPacked(const CryptoContext<Element> cc, const string& failmsg) {
 }
 
 GENERATE_TEST_CASES_FUNC(Encrypt_Decrypt, EncryptionCoefPacked, 128, 512)
+
+TEST_F(Encrypt_Decrypt, BFVrns_DCRTPoly_Seeded) {
+	CryptoContext<DCRTPoly> cc = CryptoContextFactory<DCRTPoly>::genCryptoContextBFVrns(
+			65537, HEStd_128_classic, 3.2, 0, 2, 0, OPTIMIZED, 2, 0, 60);
+	cc->Enable(ENCRYPTION);
+	cc->Enable(SHE);
+
+	vector<int64_t> vals = { 1,3,5,7,9,2,4,6,8,11 };
+	Plaintext plaintext = cc->MakeCoefPackedPlaintext(vals);
+	auto elementParams = cc->GetCryptoParameters()->GetElementParams();
+
+	// the last element of seeded keys and ciphertexts is the expansion of their seed
+	LPKeyPair<DCRTPoly> kp = cc->KeyGenSeeded();
+	ASSERT_EQ( kp.publicKey->GetSeed().size(), size_t(ElementSeed::Length) );
+	EXPECT_EQ( kp.publicKey->GetPublicElements().back(),
+			ElementSeed::Expand<DCRTPoly>(kp.publicKey->GetSeed(), elementParams) );
+
+	// reading the elements keeps the seed
+	Ciphertext<DCRTPoly> ciphertext = cc->EncryptSeeded(kp.secretKey, plaintext);
+	ASSERT_EQ( ciphertext->GetSeed().size(), size_t(ElementSeed::Length) );
+	EXPECT_EQ( ciphertext->GetElements().size(), 2U );
+	EXPECT_EQ( ciphertext->GetElements().back(),
+			ElementSeed::Expand<DCRTPoly>(ciphertext->GetSeed(), elementParams) );
+	EXPECT_EQ( ciphertext->GetSeed().size(), size_t(ElementSeed::Length) );
+	EXPECT_NE( ciphertext->GetSeed(), cc->EncryptSeeded(kp.secretKey, plaintext)->GetSeed() );
+
+	Plaintext result;
+	cc->Decrypt(kp.secretKey, ciphertext, &result);
+	result->SetLength(plaintext->GetLength());
+	EXPECT_EQ( *plaintext, *result ) << "seeded private key encrypt/decrypt failed";
+
+	cc->Decrypt(kp.secretKey, cc->Encrypt(kp.publicKey, plaintext), &result);
+	result->SetLength(plaintext->GetLength());
+	EXPECT_EQ( *plaintext, *result ) << "encrypt/decrypt with seeded public key failed";
+
+	Ciphertext<DCRTPoly> sum = cc->EvalAdd(ciphertext, ciphertext);
+	EXPECT_TRUE( sum->GetSeed().empty() );
+	cc->Decrypt(kp.secretKey, sum, &result);
+	result->SetLength(plaintext->GetLength());
+	for( size_t i = 0; i < vals.size(); i++ )
+		EXPECT_EQ( result->GetCoefPackedValue()[i], 2*vals[i] ) << "EvalAdd of seeded ciphertexts failed";
+
+	// writing to the elements drops the seed
+	Ciphertext<DCRTPoly> copy( new CiphertextImpl<DCRTPoly>(*ciphertext) );
+	EXPECT_EQ( copy->GetSeed(), ciphertext->GetSeed() );
+	copy->GetMutableElements();
+	EXPECT_TRUE( copy->GetSeed().empty() );
+
+	// BFVrnsB supports seeded encryption too
+	CryptoContext<DCRTPoly> ccB = CryptoContextFactory<DCRTPoly>::genCryptoContextBFVrnsB(
+			65537, HEStd_128_classic, 3.2, 0, 2, 0, OPTIMIZED, 2, 0, 60);
+	ccB->Enable(ENCRYPTION);
+	LPKeyPair<DCRTPoly> kpB = ccB->KeyGenSeeded();
+	Plaintext plaintextB = ccB->MakeCoefPackedPlaintext(vals);
+	ccB->Decrypt(kpB.secretKey, ccB->EncryptSeeded(kpB.secretKey, plaintextB), &result);
+	result->SetLength(plaintextB->GetLength());
+	EXPECT_EQ( *plaintextB, *result ) << "BFVrnsB seeded private key encrypt/decrypt failed";
+}
+
+TEST_F(Encrypt_Decrypt, BFVrns_DCRTPoly_EncryptPacked) {
+	vector<CryptoContext<DCRTPoly>> contexts = {
+			CryptoContextFactory<DCRTPoly>::genCryptoContextBFVrns(65537, HEStd_128_classic, 3.2, 0, 2, 0, OPTIMIZED, 2, 0, 60),
+			CryptoContextFactory<DCRTPoly>::genCryptoContextBFVrnsB(65537, HEStd_128_classic, 3.2, 0, 2, 0, RLWE, 2, 0, 60) };
+
+	vector<vector<int64_t>> values(4);
+	for( size_t t = 0; t < values.size(); t++ )
+		for( int64_t i = 0; i < 32; i++ )
+			values[t].push_back( (i % 3 ? 1 : -1) * (i*1021 + int64_t(t)) % 16384 );
+
+	for( auto cc : contexts ) {
+		cc->Enable(ENCRYPTION);
+		cc->Enable(SHE);
+		LPKeyPair<DCRTPoly> kp = cc->KeyGen();
+		string scheme = cc->GetEncryptionAlgorithm()->SerializedObjectName();
+
+		Ciphertext<DCRTPoly> ciphertext = cc->EncryptPacked(kp.publicKey, values[0]);
+		EXPECT_EQ( ciphertext->GetEncodingType(), Packed ) << scheme;
+
+		Plaintext result;
+		cc->Decrypt(kp.secretKey, ciphertext, &result);
+		result->SetLength(values[0].size());
+		EXPECT_EQ( result->GetPackedValue(), values[0] ) << scheme << " EncryptPacked/decrypt failed";
+
+		// the fused ciphertexts combine with ones encrypted from a plaintext
+		Ciphertext<DCRTPoly> sum = cc->EvalAdd(ciphertext, cc->Encrypt(kp.publicKey, cc->MakePackedPlaintext(values[1])));
+		cc->Decrypt(kp.secretKey, sum, &result);
+		result->SetLength(values[0].size());
+		for( size_t i = 0; i < values[0].size(); i++ )
+			EXPECT_EQ( result->GetPackedValue()[i], values[0][i] + values[1][i] ) << scheme << " slot " << i << " of the sum";
+
+		vector<Ciphertext<DCRTPoly>> ciphertexts = cc->EncryptPacked(kp.publicKey, values);
+		ASSERT_EQ( ciphertexts.size(), values.size() ) << scheme;
+		for( size_t t = 0; t < values.size(); t++ ) {
+			cc->Decrypt(kp.secretKey, ciphertexts[t], &result);
+			result->SetLength(values[t].size());
+			EXPECT_EQ( result->GetPackedValue(), values[t] ) << scheme << " batch EncryptPacked of vector " << t;
+		}
+
+		vector<int64_t> tooLarge = { 65537 };
+		EXPECT_THROW( cc->EncryptPacked(kp.publicKey, tooLarge), std::logic_error ) << scheme;
+	}
+}
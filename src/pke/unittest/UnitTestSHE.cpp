@@ -28,6 +28,7 @@
 #include <iostream>
 #include <vector>
 #include <list>
+#include <thread>
 
 #include "palisade.h"
 #include "cryptocontexthelper.h"
@@ -581,3 +582,70 @@ TEST_F(UTSHE, keyswitch_ModReduce_DCRT) {
 	
 	EXPECT_EQ(plaintext->GetStringValue(), plaintextNewModReduce->GetStringValue()) << "Mod Reduced Decrypt fails";
 }
+
+TEST_F(UTSHE, evalMultKey_cache) {
+
+	CryptoContext<DCRTPoly> cc = CryptoContextFactory<DCRTPoly>::genCryptoContextBFVrns(
+			65537, 1.006, 4, 0, 2, 0, OPTIMIZED);
+	cc->Enable(ENCRYPTION);
+	cc->Enable(SHE);
+
+	LPKeyPair<DCRTPoly> kp1 = cc->KeyGen();
+	LPKeyPair<DCRTPoly> kp2 = cc->KeyGen();
+	cc->EvalMultKeyGen(kp1.secretKey);
+	cc->EvalMultKeyGen(kp2.secretKey);
+	EXPECT_EQ(CryptoContextImpl<DCRTPoly>::GetAllEvalMultKeys().size(), 2U);
+
+	Plaintext pt = cc->MakePackedPlaintext({1,2,3,4});
+	Ciphertext<DCRTPoly> ct1 = cc->Encrypt(kp1.publicKey, pt);
+	Ciphertext<DCRTPoly> ct2 = cc->Encrypt(kp2.publicKey, pt);
+	EXPECT_NE(ct1->GetKeyHandle(), KeyTagTable::NoHandle);
+	EXPECT_EQ(ct1->GetKeyHandle(), KeyTagTable::Find(kp1.secretKey->GetKeyTag()));
+	EXPECT_NE(ct1->GetKeyHandle(), ct2->GetKeyHandle());
+
+	// evaluate with one tenant's keys while the other tenant's keys are evicted and reinserted
+	auto keys2 = *CryptoContextImpl<DCRTPoly>::GetEvalMultKeyVectorPtr(kp2.secretKey->GetKeyTag());
+	vector<Ciphertext<DCRTPoly>> results(3);
+	vector<std::thread> evaluators;
+	for( size_t t = 0; t < results.size(); t++ )
+		evaluators.push_back( std::thread([&cc, &ct1, &results, t]() {
+			for( int i = 0; i < 20; i++ )
+				results[t] = cc->EvalMult(ct1, ct1);
+		}) );
+	for( int i = 0; i < 200; i++ ) {
+		CryptoContextImpl<DCRTPoly>::ClearEvalMultKeys(kp2.secretKey->GetKeyTag());
+		CryptoContextImpl<DCRTPoly>::InsertEvalMultKey(keys2);
+	}
+	for( auto& e : evaluators )
+		e.join();
+
+	for( const auto& r : results ) {
+		Plaintext square;
+		cc->Decrypt(kp1.secretKey, r, &square);
+		square->SetLength(4);
+		EXPECT_EQ(square->GetPackedValue(), vector<int64_t>({1,4,9,16}));
+	}
+
+	// evicting a tenant's keys leaves the other tenant's in place
+	CryptoContextImpl<DCRTPoly>::ClearEvalMultKeys(kp2.secretKey->GetKeyTag());
+	EXPECT_THROW(cc->EvalMult(ct2, ct2), std::logic_error);
+	EXPECT_NO_THROW(cc->EvalMult(ct1, ct1));
+
+	// keys belong to their context
+	CryptoContextImpl<DCRTPoly>::ClearEvalMultKeys(cc);
+	EXPECT_EQ(CryptoContextImpl<DCRTPoly>::GetAllEvalMultKeys().size(), 0U);
+	EXPECT_THROW(cc->EvalMult(ct1, ct1), std::logic_error);
+
+	// the handles of tags without keys are recycled, and objects holding a stale handle resolve it again
+	EXPECT_EQ(KeyTagTable::Find(kp1.secretKey->GetKeyTag()), KeyTagTable::NoHandle);
+	for( int i = 0; i < 5000; i++ ) {
+		CryptoContextImpl<DCRTPoly>::InsertEvalMultKey(keys2);
+		CryptoContextImpl<DCRTPoly>::ClearEvalMultKeys(kp2.secretKey->GetKeyTag());
+	}
+	cc->EvalMultKeyGen(kp1.secretKey);
+	EXPECT_LT(KeyTagTable::Slot(KeyTagTable::Find(kp1.secretKey->GetKeyTag())), 1000U);
+	EXPECT_EQ(ct1->GetKeyHandle(), KeyTagTable::Find(kp1.secretKey->GetKeyTag()));
+	EXPECT_NO_THROW(cc->EvalMult(ct1, ct1));
+	EXPECT_THROW(cc->EvalMult(ct2, ct2), std::logic_error);
+	CryptoContextImpl<DCRTPoly>::ClearEvalMultKeys(cc);
+}
@@ -59,3 +59,95 @@ TEST_F(UTPKESer, BFVrns_DCRTPoly_Serial) {
 	CryptoContext<DCRTPoly> cc = GenerateTestDCRTCryptoContext("BFVrns2", 3, 20);
 	UnitTestContext<DCRTPoly>(cc);
 }
+
+TEST_F(UTPKESer, BFVrns_DCRTPoly_Compact_Ciphertext) {
+	CryptoContext<DCRTPoly> cc = CryptoContextFactory<DCRTPoly>::genCryptoContextBFVrns(
+			65537, HEStd_128_classic, 3.2, 0, 0, 0, OPTIMIZED, 2, 0, 60);
+	cc->Enable(ENCRYPTION);
+
+	LPKeyPair<DCRTPoly> kp = cc->KeyGen();
+	vector<int64_t> vals = { 1,3,5,7,9,2,4,6,8,11 };
+	Plaintext plaintext = cc->MakeCoefPackedPlaintext(vals);
+	Ciphertext<DCRTPoly> ciphertext = cc->Encrypt(kp.publicKey, plaintext);
+
+	stringstream binary;
+	Serial::Serialize(ciphertext, binary, SerType::BINARY);
+
+	// lossless, then with low-order bits dropped where there is a single tower
+	for( uint32_t dropped : { 0, 10 } ) {
+		stringstream compact;
+		Serial::Serialize(ciphertext, compact, SerType::SERCOMPACT(dropped));
+		EXPECT_LT(compact.str().size(), binary.str().size()) << "dropped " << dropped;
+
+		Ciphertext<DCRTPoly> newC;
+		Serial::Deserialize(newC, compact, SerType::COMPACT);
+		ASSERT_TRUE( newC.get() != nullptr ) << "dropped " << dropped;
+		if( dropped == 0 )
+			EXPECT_EQ( *ciphertext, *newC ) << "Ciphertext mismatch";
+
+		Plaintext result;
+		cc->Decrypt(kp.secretKey, newC, &result);
+		result->SetLength(plaintext->GetLength());
+		EXPECT_EQ( *plaintext, *result ) << "Decrypt of compact ciphertext failed, dropped " << dropped;
+	}
+}
+
+TEST_F(UTPKESer, BFVrns_DCRTPoly_Seeded) {
+	CryptoContext<DCRTPoly> cc = CryptoContextFactory<DCRTPoly>::genCryptoContextBFVrns(
+			65537, HEStd_128_classic, 3.2, 0, 2, 0, OPTIMIZED, 2, 0, 60);
+	cc->Enable(ENCRYPTION);
+	cc->Enable(SHE);
+
+	LPKeyPair<DCRTPoly> kpFull = cc->KeyGen();
+	LPKeyPair<DCRTPoly> kp = cc->KeyGenSeeded();
+	vector<int64_t> vals = { 1,3,5,7,9,2,4,6,8,11 };
+	Plaintext plaintext = cc->MakeCoefPackedPlaintext(vals);
+	Ciphertext<DCRTPoly> ciphertextFull = cc->Encrypt(kp.secretKey, plaintext);
+	Ciphertext<DCRTPoly> ciphertext = cc->EncryptSeeded(kp.secretKey, plaintext);
+
+	// the seed replaces one of the two elements
+	stringstream full, seeded;
+	Serial::Serialize(ciphertextFull, full, SerType::BINARY);
+	Serial::Serialize(ciphertext, seeded, SerType::BINARY);
+	EXPECT_LT(seeded.str().size(), full.str().size()*3/5) << "seeded ciphertext";
+
+	// reading the elements through a non-const handle keeps the seed
+	EXPECT_EQ( ciphertext->GetElements().size(), 2U );
+	EXPECT_FALSE( ciphertext->GetSeed().empty() );
+	stringstream reread;
+	Serial::Serialize(ciphertext, reread, SerType::BINARY);
+	EXPECT_EQ( seeded.str().size(), reread.str().size() ) << "reading the elements dropped the seed";
+
+	Ciphertext<DCRTPoly> newC;
+	Serial::Deserialize(newC, seeded, SerType::BINARY);
+	ASSERT_TRUE( newC.get() != nullptr );
+	EXPECT_EQ( *ciphertext, *newC ) << "Seeded ciphertext mismatch";
+	EXPECT_EQ( ciphertext->GetSeed(), newC->GetSeed() ) << "Seed mismatch";
+
+	Plaintext result;
+	cc->Decrypt(kp.secretKey, newC, &result);
+	result->SetLength(plaintext->GetLength());
+	EXPECT_EQ( *plaintext, *result ) << "Decrypt of seeded ciphertext failed";
+
+	stringstream fullKey, seededKey;
+	Serial::Serialize(kpFull.publicKey, fullKey, SerType::BINARY);
+	Serial::Serialize(kp.publicKey, seededKey, SerType::BINARY);
+	EXPECT_LT(seededKey.str().size(), fullKey.str().size()*3/5) << "seeded public key";
+
+	LPPublicKey<DCRTPoly> newPK;
+	Serial::Deserialize(newPK, seededKey, SerType::BINARY);
+	ASSERT_TRUE( newPK.get() != nullptr );
+	EXPECT_EQ( *kp.publicKey, *newPK ) << "Seeded public key mismatch";
+
+	Ciphertext<DCRTPoly> pkC = cc->Encrypt(newPK, plaintext);
+	cc->Decrypt(kp.secretKey, pkC, &result);
+	result->SetLength(plaintext->GetLength());
+	EXPECT_EQ( *plaintext, *result ) << "Decrypt with loaded seeded public key failed";
+
+	// a ciphertext computed from a seeded one is serialized in full
+	Ciphertext<DCRTPoly> sum = cc->EvalAdd(ciphertext, ciphertext);
+	EXPECT_TRUE( sum->GetSeed().empty() );
+	stringstream summed;
+	Serial::Serialize(sum, summed, SerType::BINARY);
+	EXPECT_EQ( full.str().size(), summed.str().size() );
+}
@@ -30,6 +30,13 @@
 #include "bgv-ser.h"
 #include "pubkeylp-ser.h"
 #include "ciphertext-ser.h"
+#include "ciphertextstream.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <thread>
 
 using namespace std;
 using namespace lbcrypto;
@@ -283,3 +290,224 @@ TEST_F(UTPKESer, Keys_and_ciphertext_json) {
 TEST_F(UTPKESer, Keys_and_ciphertext_binary) {
 	Test_keys_and_ciphertext(SerType::BINARY);
 }
+
+TEST_F(UTPKESer, Context_fingerprint) {
+	CryptoContext<Poly> cc = GenerateTestCryptoContext("BGV2");
+	string fp = cc->GetFingerprint();
+	EXPECT_EQ( 64U, fp.size() );
+	EXPECT_EQ( cc, CryptoContextFactory<Poly>::GetContextForFingerprint(fp) ) << "registered context not found";
+	EXPECT_EQ( fp, CryptoContextImpl<Poly>::ComputeFingerprint(cc->GetCryptoParameters(), cc->GetEncryptionAlgorithm()) );
+
+	CryptoContext<Poly> cc2 = GenerateTestCryptoContext("BGV4");
+	EXPECT_NE( fp, cc2->GetFingerprint() ) << "different parameter sets share a fingerprint";
+
+	// the fingerprint only depends on the parameters
+	CryptoContextFactory<Poly>::ReleaseAllContexts();
+	EXPECT_TRUE( CryptoContextFactory<Poly>::GetContextForFingerprint(fp) == nullptr );
+	CryptoContext<Poly> cc3 = GenerateTestCryptoContext("BGV2");
+	EXPECT_EQ( fp, cc3->GetFingerprint() );
+}
+
+TEST_F(UTPKESer, Context_registry) {
+	CryptoContext<Poly> cc = GenerateTestCryptoContext("BGV2");
+	EXPECT_EQ( cc, CryptoContextFactory<Poly>::GetContext(cc->GetCryptoParameters(), cc->GetEncryptionAlgorithm()) )
+		<< "same parameters gave a new context";
+	EXPECT_EQ( cc, CryptoContextFactory<Poly>::GetContextForPointer(cc.get()) );
+
+	// only a context that nothing else holds is evicted
+	CryptoContext<Poly> cc4 = GenerateTestCryptoContext("BGV4");
+	auto params = cc4->GetCryptoParameters();
+	auto scheme = cc4->GetEncryptionAlgorithm();
+	cc4.reset();
+	EXPECT_EQ( 1U, CryptoContextFactory<Poly>::ReleaseUnusedContexts() );
+	EXPECT_EQ( 1, CryptoContextFactory<Poly>::GetContextCount() );
+
+	// contexts looked up from several threads at once are registered once
+	vector<CryptoContext<Poly>> found(4);
+	vector<std::thread> threads;
+	for( size_t i = 0; i < found.size(); i++ )
+		threads.emplace_back([&found, i, params, scheme]() {
+			found[i] = CryptoContextFactory<Poly>::GetContext(params, scheme);
+		});
+	for( auto& t : threads )
+		t.join();
+	for( const auto& f : found )
+		EXPECT_EQ( found[0], f );
+	EXPECT_EQ( 2, CryptoContextFactory<Poly>::GetContextCount() );
+
+	found.clear();
+	EXPECT_EQ( 1U, CryptoContextFactory<Poly>::ReleaseUnusedContexts() );
+	EXPECT_EQ( 1, CryptoContextFactory<Poly>::GetContextCount() );
+	EXPECT_EQ( cc, CryptoContextFactory<Poly>::GetSingleContext() );
+
+	// a released context stays usable by whoever still holds it
+	CryptoContextFactory<Poly>::ReleaseAllContexts();
+	EXPECT_EQ( 0, CryptoContextFactory<Poly>::GetContextCount() );
+	EXPECT_EQ( cc, CryptoContextFactory<Poly>::GetContextForPointer(cc.get()) );
+	LPKeyPair<Poly> kp = cc->KeyGen();
+	EXPECT_EQ( cc, kp.publicKey->GetCryptoContext() );
+}
+
+template<typename ST>
+void Test_ciphertext_by_reference(const ST& sertype)
+{
+	CryptoContext<Poly> cc = GenerateTestCryptoContext("BGV2");
+	LPKeyPair<Poly> kp = cc->KeyGen();
+	vector<int64_t> vals = { 1,3,5,7,9,2,4,6,8,11 };
+	Plaintext plaintext = cc->MakeCoefPackedPlaintext( vals );
+	Ciphertext<Poly> ciphertext = cc->Encrypt(kp.publicKey, plaintext);
+
+	stringstream full;
+	Serial::Serialize(ciphertext, full, sertype);
+
+	// the context is sent once, and the objects that follow refer to it
+	stringstream ctx;
+	Serial::Serialize(cc, ctx, sertype);
+	stringstream s;
+	{
+		ContextReferenceScope byReference;
+		Serial::Serialize(ciphertext, s, sertype);
+	}
+	EXPECT_LT( s.str().size(), full.str().size() ) << "context is still embedded";
+
+	CryptoContextFactory<Poly>::ReleaseAllContexts();
+	CryptoContext<Poly> newcc;
+	Serial::Deserialize(newcc, ctx, sertype);
+	ASSERT_TRUE( newcc.get() != nullptr ) << "Context deser failed";
+
+	Ciphertext<Poly> newC;
+	Serial::Deserialize(newC, s, sertype);
+	ASSERT_TRUE( newC.get() != nullptr ) << "Ciphertext deser failed";
+	EXPECT_EQ( newcc, newC->GetCryptoContext() ) << "Ciphertext not bound to the loaded context";
+	EXPECT_EQ( ciphertext->GetElements(), newC->GetElements() ) << "Ciphertext mismatch";
+
+	// a reference to a context that was never loaded cannot be resolved
+	stringstream orphan;
+	{
+		ContextReferenceScope byReference;
+		Serial::Serialize(ciphertext, orphan, sertype);
+	}
+	CryptoContextFactory<Poly>::ReleaseAllContexts();
+	EXPECT_THROW( Serial::Deserialize(newC, orphan, sertype), deserialize_error );
+}
+
+TEST_F(UTPKESer, Ciphertext_by_reference_json) {
+	Test_ciphertext_by_reference(SerType::JSON);
+}
+
+TEST_F(UTPKESer, Ciphertext_by_reference_binary) {
+	Test_ciphertext_by_reference(SerType::BINARY);
+}
+
+static void Test_ciphertext_stream(size_t prefetch)
+{
+	auto makeContext = [](PlaintextModulus p) {
+		CryptoContext<DCRTPoly> cc = CryptoContextFactory<DCRTPoly>::genCryptoContextBFVrns(
+				p, 1.006, 4, 0, 2, 0, OPTIMIZED);
+		cc->Enable(ENCRYPTION);
+		cc->Enable(SHE);
+		return cc;
+	};
+	CryptoContext<DCRTPoly> cc = makeContext(65537);
+	LPKeyPair<DCRTPoly> kp = cc->KeyGen();
+	cc->EvalMultKeyGen(kp.secretKey);
+
+	vector<Ciphertext<DCRTPoly>> cts;
+	for( int64_t i = 0; i < 5; i++ ) {
+		vector<int64_t> vals = { i, i+1, i+2, 3 };
+		cts.push_back( cc->Encrypt(kp.publicKey, cc->MakePackedPlaintext(vals)) );
+	}
+	// a product has three elements and a larger depth
+	cts.push_back( cc->EvalMult(cts[0], cts[1]) );
+
+	const string filename = "UnitTestSerializePKE.ctstream";
+	{
+		CiphertextStreamWriter<DCRTPoly> w(cc, filename);
+		for( const auto& ct : cts )
+			w.Write(ct);
+		EXPECT_EQ( cts.size(), w.GetCount() );
+	}
+
+	CiphertextStreamReader<DCRTPoly> r(cc, filename, prefetch);
+	ASSERT_TRUE( r.HasIndex() );
+	EXPECT_EQ( cts.size(), r.GetCount() );
+
+	Ciphertext<DCRTPoly> ct;
+	const CiphertextImpl<DCRTPoly> *reused = nullptr;
+	for( size_t i = 0; i < cts.size(); i++ ) {
+		ASSERT_TRUE( r.Read(ct) ) << "stream ended early at " << i;
+		EXPECT_EQ( *cts[i], *ct ) << "ciphertext " << i << " mismatch";
+		EXPECT_EQ( cts[i]->GetEncodingType(), ct->GetEncodingType() );
+		if( i == 1 )
+			reused = ct.get();
+		if( i == 2 )
+			EXPECT_EQ( reused, ct.get() ) << "same-shape ciphertext was not decoded in place";
+	}
+	EXPECT_FALSE( r.Read(ct) ) << "stream did not end";
+
+	EXPECT_EQ( *cts[3], *r.ReadAt(3) );
+	ASSERT_TRUE( r.Read(ct) );
+	EXPECT_EQ( *cts[4], *ct ) << "Read does not continue after ReadAt";
+	EXPECT_EQ( *cts[5], *r.ReadAt(5) );
+	EXPECT_THROW( r.ReadAt(cts.size()), config_error );
+
+	Plaintext result;
+	cc->Decrypt(kp.secretKey, r.ReadAt(2), &result);
+	result->SetLength(4);
+	EXPECT_EQ( vector<int64_t>({ 2, 3, 4, 3 }), result->GetPackedValue() );
+
+	// a context with other parameters cannot read the stream
+	CryptoContext<DCRTPoly> other = makeContext(786433);
+	EXPECT_THROW( CiphertextStreamReader<DCRTPoly>(other, filename), config_error );
+
+	std::remove(filename.c_str());
+}
+
+TEST_F(UTPKESer, Ciphertext_stream) {
+	Test_ciphertext_stream(0);
+}
+
+TEST_F(UTPKESer, Ciphertext_stream_prefetch) {
+	Test_ciphertext_stream(2);
+}
+
+TEST_F(UTPKESer, Ciphertext_stream_corrupt) {
+	CryptoContext<DCRTPoly> cc = CryptoContextFactory<DCRTPoly>::genCryptoContextBFVrns(
+			65537, 1.006, 4, 0, 2, 0, OPTIMIZED);
+	cc->Enable(ENCRYPTION);
+	LPKeyPair<DCRTPoly> kp = cc->KeyGen();
+
+	const string filename = "UnitTestSerializePKE.corrupt.ctstream";
+	{
+		CiphertextStreamWriter<DCRTPoly> w(cc, filename);
+		w.Write(cc->Encrypt(kp.publicKey, cc->MakePackedPlaintext({ 1, 2, 3 })));
+	}
+	std::ifstream in(filename, std::ios::binary);
+	string file((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	in.close();
+
+	// the first frame follows the magic, version and fingerprint; its counts follow the key tag,
+	// encoding, reserved word and depth, and its towers follow the moduli
+	uint32_t fpLength, tagLength, numTowers;
+	memcpy(&fpLength, &file[12], sizeof(fpLength));
+	size_t frame = 16 + fpLength;
+	memcpy(&tagLength, &file[frame + 8], sizeof(tagLength));
+	size_t counts = frame + 8 + 4 + tagLength + 16;
+	memcpy(&numTowers, &file[counts + 4], sizeof(numTowers));
+	size_t towers = counts + 16 + 8*numTowers;
+
+	auto expectCorrupt = [&](size_t offset, uint64_t value, size_t n, const string& what) {
+		string bad = file;
+		memcpy(&bad[offset], &value, n);
+		std::ofstream(filename, std::ios::binary | std::ios::trunc).write(bad.data(), bad.size());
+		CiphertextStreamReader<DCRTPoly> r(cc, filename);
+		Ciphertext<DCRTPoly> ct;
+		EXPECT_THROW( r.Read(ct), deserialize_error ) << what;
+	};
+	expectCorrupt(frame, uint64_t(1) << 62, 8, "frame length past the end of the file");
+	expectCorrupt(counts, 0xffffffff, 4, "element count");
+	expectCorrupt(counts + 4, 0xffffffff, 4, "tower count");
+	expectCorrupt(towers, ~uint64_t(0), 8, "residue that is not reduced");
+
+	std::remove(filename.c_str());
+}
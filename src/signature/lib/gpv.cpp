@@ -83,20 +83,8 @@ namespace lbcrypto {
 		size_t k = m_params->GetK();
 		size_t base = m_params->GetBase();
 
-		EncodingParams ep( new EncodingParamsImpl(PlaintextModulus(512)) );
-
-		//Encode the text into a vector so it can be used in signing process. TODO: Adding some kind of digestion algorithm
-		vector<int64_t> digest;
-		HashUtil::Hash(plainText.GetPlaintext(), SHA_256, digest);
-		if(plainText.GetPlaintext().size() <= n ) {
-			for(size_t i = 0;i < n - 32;i = i + 4)
-				digest.push_back(seed[i]);
-		}
-		Plaintext hashedText( new CoefPackedEncoding(m_params->GetILParams(), ep, digest) );
-		hashedText->Encode();
-
-		Element &u = hashedText->GetElement<Element>();
-		u.SwitchFormat();
+		//Encode the text into a ring element so it can be used in signing process
+		Element u = HashToRing(m_params, plainText.GetPlaintext());
 
 		//Getting the trapdoor, its public matrix, perturbation matrix and gaussian generator to use in sampling
 		const Matrix<Element> & A = verificationKey.GetVerificationKey();
@@ -141,24 +129,8 @@ namespace lbcrypto {
 		size_t k = m_params->GetK();
 		size_t base = m_params->GetBase();
 
-		EncodingParams ep( new EncodingParamsImpl(PlaintextModulus(512)) );
-
-		//Encode the text into a vector so it can be used in signing process. TODO: Adding some kind of digestion algorithm
-		vector<int64_t> digest;
-		Plaintext hashedText;
-		HashUtil::Hash(plainText.GetPlaintext(), SHA_256, digest);
-
-		if( plainText.GetPlaintext().size()<= n ) {
-			for (size_t i = 0;i < n - 32;i = i + 4)
-				digest.push_back(seed[i]);
-		}
-
-		hashedText.reset( new CoefPackedEncoding(m_params->GetILParams(), ep, digest) );
-		hashedText->Encode();
-
-		Element &u = hashedText->GetElement<Element>();
-		u.SwitchFormat();
-
+		//Encode the text into a ring element so it can be used in signing process
+		Element u = HashToRing(m_params, plainText.GetPlaintext());
 
 		//Getting the trapdoor, its public matrix, perturbation matrix and gaussian generator to use in sampling
 		const Matrix<Element> & A = verificationKey.GetVerificationKey();
@@ -178,32 +150,126 @@ namespace lbcrypto {
 		const GPVVerificationKey<Element> & verificationKey = dynamic_cast<const GPVVerificationKey<Element> &>(vk);
 		const GPVPlaintext<Element> & plainText = dynamic_cast<const GPVPlaintext<Element> &>(pt);
 		const GPVSignature<Element> & signatureText = dynamic_cast<const GPVSignature<Element> &>(sign);
-		size_t n = m_params->GetILParams()->GetRingDimension();
 
-		EncodingParams ep( new EncodingParamsImpl(PlaintextModulus(512)) );
+		//Encode the text into a ring element so it can be used in verification process
+		Element u = HashToRing(m_params, plainText.GetPlaintext());
+
+		//Multiply signature with the verification key
+		const Matrix<Element> & A = verificationKey.GetVerificationKey();
+		const Matrix<Element> & z = signatureText.GetSignature();
+
+		//Check the verified vector is actually the encoding of the object
+		 return u == (A*z)(0, 0);
+	}
+
+	//Method for signing a batch of objects
+	template <class Element>
+	void GPVSignatureScheme<Element>::SignBatch(shared_ptr<LPSignatureParameters<Element>> sparams,const LPSignKey<Element> & sk,const LPVerificationKey<Element> &vk,
+		const vector<const LPSignPlaintext<Element>*> & pts, const vector<LPSignature<Element>*> & signs) {
+
+		if (pts.size() != signs.size())
+			throw std::logic_error("Number of plaintexts and signatures do not match");
+
+		shared_ptr<GPVSignatureParameters<Element>> m_params = std::dynamic_pointer_cast<GPVSignatureParameters<Element>>(sparams);
+		const GPVSignKey<Element> & signKey = dynamic_cast<const GPVSignKey<Element> &>(sk);
+		const GPVVerificationKey<Element> & verificationKey = dynamic_cast<const GPVVerificationKey<Element> &>(vk);
+
+		//Casts are done up front as exceptions cannot leave the parallel region
+		vector<const GPVPlaintext<Element>*> plainTexts(pts.size());
+		vector<GPVSignature<Element>*> signatureTexts(signs.size());
+		for (size_t i = 0; i < pts.size(); i++) {
+			plainTexts[i] = &dynamic_cast<const GPVPlaintext<Element> &>(*pts[i]);
+			signatureTexts[i] = &dynamic_cast<GPVSignature<Element> &>(*signs[i]);
+		}
+
+		//Getting parameters for calculations
+		size_t n = m_params->GetILParams()->GetRingDimension();
+		size_t k = m_params->GetK();
+		size_t base = m_params->GetBase();
 
-		//Encode the text into a vector so it can be used in signing process. TODO: Adding some kind of digestion algorithm
-		vector<int64_t> digest;
-		Plaintext hashedText;
-		HashUtil::Hash(plainText.GetPlaintext(), SHA_256, digest);
+		//Getting the trapdoor, its public matrix and gaussian generators to use in sampling; they are shared by the whole batch
+		const Matrix<Element> & A = verificationKey.GetVerificationKey();
+		const RLWETrapdoorPair<Element> & T = signKey.GetSignKey();
+		typename Element::DggType & dgg = m_params->GetDiscreteGaussianGenerator();
+		typename Element::DggType & dggLargeSigma = m_params->GetDiscreteGaussianGeneratorLargeSigma();
 
-		if( plainText.GetPlaintext().size() <= n ) {
-			for (size_t i = 0;i < n - 32;i = i + 4)
-				digest.push_back(seed[i]);
+		//Perturbation vectors do not depend on the texts, so the pool for the batch is sampled first
+		vector<shared_ptr<Matrix<Element>>> perturbations(pts.size());
+#pragma omp parallel for schedule(dynamic)
+		for (size_t i = 0; i < pts.size(); i++)
+			perturbations[i] = RLWETrapdoorUtility<Element>::GaussSampOffline(n, k, T, dgg, dggLargeSigma, base);
+
+#pragma omp parallel for schedule(dynamic)
+		for (size_t i = 0; i < pts.size(); i++) {
+			Element u = HashToRing(m_params, plainTexts[i]->GetPlaintext());
+			Matrix<Element> zHat = RLWETrapdoorUtility<Element>::GaussSampOnline(n, k, A, T, u, dgg, perturbations[i], base);
+			signatureTexts[i]->SetSignature(std::make_shared<Matrix<Element>>(zHat));
 		}
+	}
 
-		hashedText.reset( new CoefPackedEncoding(m_params->GetILParams(), ep, digest) );
-		hashedText->Encode();
+	//Method for verifying a batch of objects & signatures
+	template <class Element>
+	vector<bool> GPVSignatureScheme<Element>::VerifyBatch(shared_ptr<LPSignatureParameters<Element>> sparams,const LPVerificationKey<Element> & vk,
+		const vector<const LPSignature<Element>*> & signs, const vector<const LPSignPlaintext<Element>*> & pts) {
 
-		Element &u = hashedText->GetElement<Element>();
-		u.SwitchFormat();
+		if (pts.size() != signs.size())
+			throw std::logic_error("Number of plaintexts and signatures do not match");
 
-		//Multiply signature with the verification key
+		shared_ptr<GPVSignatureParameters<Element>> m_params = std::dynamic_pointer_cast<GPVSignatureParameters<Element>>(sparams);
+		const GPVVerificationKey<Element> & verificationKey = dynamic_cast<const GPVVerificationKey<Element> &>(vk);
 		const Matrix<Element> & A = verificationKey.GetVerificationKey();
-		const Matrix<Element> & z = signatureText.GetSignature();
 
-		//Check the verified vector is actually the encoding of the object
-		 return u == (A*z)(0, 0);
+		size_t count = pts.size();
+		vector<bool> results(count, false);
+		if (count == 0)
+			return results;
+
+		vector<const GPVPlaintext<Element>*> plainTexts(count);
+		vector<const GPVSignature<Element>*> signatureTexts(count);
+		for (size_t i = 0; i < count; i++) {
+			plainTexts[i] = &dynamic_cast<const GPVPlaintext<Element> &>(*pts[i]);
+			signatureTexts[i] = &dynamic_cast<const GPVSignature<Element> &>(*signs[i]);
+		}
+
+		//Signatures of the wrong shape are rejected instead of failing the whole batch
+		vector<char> wellFormed(count);
+		for (size_t i = 0; i < count; i++) {
+			const Matrix<Element> & z = signatureTexts[i]->GetSignature();
+			wellFormed[i] = (z.GetRows() == A.GetCols() && z.GetCols() == 1);
+		}
+
+		//Each column of A * [z_1 ... z_N] is computed where the texts are hashed, so the signatures
+		//are not copied into one matrix and a single parallel pass covers the whole batch
+		vector<char> verified(count, 0);
+#pragma omp parallel for schedule(dynamic)
+		for (size_t i = 0; i < count; i++) {
+			if (!wellFormed[i])
+				continue;
+			Element u = HashToRing(m_params, plainTexts[i]->GetPlaintext());
+			const Matrix<Element> & z = signatureTexts[i]->GetSignature();
+			Element Az = A(0, 0) * z(0, 0);
+			for (size_t j = 1; j < A.GetCols(); j++)
+				Az += A(0, j) * z(j, 0);
+			//Check the verified vector is actually the encoding of the object
+			verified[i] = (u == Az);
+		}
+
+		for (size_t i = 0; i < count; i++)
+			results[i] = verified[i] != 0;
+
+		return results;
+	}
+
+	//Method for hashing a text into a ring element
+	template <class Element>
+	Element GPVSignatureScheme<Element>::HashToRing(shared_ptr<GPVSignatureParameters<Element>> m_params, const string & text) const {
+		//The scheme seed separates the hash of this key pair from other key pairs
+		HashState state(SHA_256);
+		state.Update(reinterpret_cast<const uint8_t*>(seed.data()), seed.size());
+		state.Update(text);
+		vector<uint8_t> digest = state.Finalize();
+
+		return HashUtil::HashToRing<Element>(digest.data(), digest.size(), m_params->GetILParams(), EVALUATION);
 	}
 
 }
@@ -398,7 +398,39 @@ namespace lbcrypto {
 		*@param vk public verification key generated after trapdoor - output of the function
 		*/
 		void KeyGen(shared_ptr<LPSignatureParameters<Element>> m_params,LPSignKey<Element>* sk, LPVerificationKey<Element>* vk);
+
+		/**
+		*Method for signing a batch of texts. The texts are hashed, the perturbation vectors are sampled
+		*and the signatures are generated in parallel
+		*@param m_params parameters used for signing
+		*@param sk private signing key
+		*@param vk public verification key
+		*@param pts encodings of the texts to be signed
+		*@param signs signatures generated for the texts, in the same order - output of the function
+		*/
+		void SignBatch(shared_ptr<LPSignatureParameters<Element>> m_params,const LPSignKey<Element> & sk,const LPVerificationKey<Element> &vk,
+		const vector<const LPSignPlaintext<Element>*> & pts, const vector<LPSignature<Element>*> & signs);
+
+		/**
+		*Method for verifying a batch of texts & signatures. The product of the verification key with all
+		*signatures and the hashing of the texts are done in one parallel pass
+		*@param m_params parameters used for the scheme
+		*@param vk public verification key
+		*@param signs signatures to be verified
+		*@param pts encodings of the texts to be verified, in the same order as the signatures
+		*@return result of the verification process for each text
+		*/
+		vector<bool> VerifyBatch(shared_ptr<LPSignatureParameters<Element>> m_params,const LPVerificationKey<Element> & vk,
+		const vector<const LPSignature<Element>*> & signs, const vector<const LPSignPlaintext<Element>*> & pts);
 	private:
+		/**
+		*Method for hashing a text into a ring element in evaluation format
+		*@param m_params parameters used for the scheme
+		*@param text the text to be hashed
+		*@return the hashed text as a ring element
+		*/
+		Element HashToRing(shared_ptr<GPVSignatureParameters<Element>> m_params, const string & text) const;
+
 		std::vector<char> seed;
 		/*
 		*@brief Overloaded dummy method
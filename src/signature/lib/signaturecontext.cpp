@@ -93,4 +93,14 @@ namespace lbcrypto{
     bool  SignatureContext<Element>::Verify(const LPSignPlaintext<Element> & pt, const LPSignature<Element> & signature, const LPVerificationKey<Element> & vk){
         return m_scheme->Verify(m_params,vk,signature,pt);
     } 
+    //Method for signing a batch of plaintexts
+    template <class Element>
+    void SignatureContext<Element>::SignBatch(const vector<const LPSignPlaintext<Element>*> & pts,const LPSignKey<Element> & sk, const LPVerificationKey<Element> & vk,const vector<LPSignature<Element>*> & signs){
+        m_scheme->SignBatch(m_params,sk,vk,pts,signs);
+    }
+    //Method for verifying a batch of plaintexts and signatures
+    template <class Element>
+    vector<bool> SignatureContext<Element>::VerifyBatch(const vector<const LPSignPlaintext<Element>*> & pts, const vector<const LPSignature<Element>*> & signs, const LPVerificationKey<Element> & vk){
+        return m_scheme->VerifyBatch(m_params,vk,signs,pts);
+    }
 }
\ No newline at end of file
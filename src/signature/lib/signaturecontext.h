@@ -91,6 +91,22 @@ namespace lbcrypto{
              *@return Verification result 
              */
             bool Verify(const LPSignPlaintext<Element> & pt, const LPSignature<Element> & signature, const LPVerificationKey<Element> & vk);
+            /**
+             *@brief Method for signing a batch of plaintexts in parallel
+             *@param pts Plaintexts to be signed
+             *@param sk Sign key
+             *@param vk Verification key
+             *@param signs Signatures corresponding to the plaintexts, in the same order - Output
+             */
+            void SignBatch(const vector<const LPSignPlaintext<Element>*> & pts,const LPSignKey<Element> & sk, const LPVerificationKey<Element> & vk,const vector<LPSignature<Element>*> & signs);
+            /**
+             *@brief Method for verifying a batch of plaintexts and signatures
+             *@param pts Plaintexts
+             *@param signs Signatures to be verified, one per plaintext
+             *@param vk Key used for verification
+             *@return Verification result for each plaintext
+             */
+            vector<bool> VerifyBatch(const vector<const LPSignPlaintext<Element>*> & pts, const vector<const LPSignature<Element>*> & signs, const LPVerificationKey<Element> & vk);
 
         private:
             //The signature scheme used
@@ -189,6 +189,26 @@ class LPSignatureScheme{
      * @return verification result
      */
     virtual bool Verify(shared_ptr<LPSignatureParameters<Element>> m_params,const LPVerificationKey<Element> & vk,const LPSignature<Element> & sign, const LPSignPlaintext<Element> & pt);
+    /**
+     * @brief Method for signing a batch of plaintexts
+     * @param m_params Parameters used for the scheme
+     * @param sk Secret key used for signing
+     * @param vk Public key used for verification
+     * @param pts Plaintexts to be signed
+     * @param signs Signatures generated, one per plaintext - Output
+     */
+    virtual void SignBatch(shared_ptr<LPSignatureParameters<Element>> m_params,const LPSignKey<Element> & sk,const LPVerificationKey<Element> &vk,
+    const vector<const LPSignPlaintext<Element>*> & pts, const vector<LPSignature<Element>*> & signs);
+    /**
+     * @brief Method for verification of a batch of signatures
+     * @param m_params Parameters used for the scheme
+     * @param vk Public key used for verification
+     * @param signs Signatures to be verified
+     * @param pts Plaintexts to be used for verification, one per signature
+     * @return verification result for each signature
+     */
+    virtual vector<bool> VerifyBatch(shared_ptr<LPSignatureParameters<Element>> m_params,const LPVerificationKey<Element> & vk,
+    const vector<const LPSignature<Element>*> & signs, const vector<const LPSignPlaintext<Element>*> & pts);
     /*
     * @brief Dummy method to force abstract base class
     */
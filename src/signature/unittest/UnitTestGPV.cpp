@@ -216,6 +216,49 @@ TEST(UTSignatureGPV, sign_verify_multiple_keys) {
 			<< "Failed signature 1 - key pair 2 verification";
 
 }
+
+//TEST FOR BATCH SIGNING AND VERIFICATION. EACH SIGNATURE SHOULD VERIFY ONLY AGAINST ITS OWN TEXT
+TEST(UTSignatureGPV, sign_verify_batch) {
+  DEBUG_FLAG(false);
+
+  DEBUG("Context Generation");
+	SignatureContext<NativePoly> context;
+  context.GenerateGPVContext(1024);
+  DEBUG("Key Generation");
+  GPVVerificationKey<NativePoly> vk;
+  GPVSignKey<NativePoly> sk;
+  context.KeyGen(&sk,&vk);
+
+  const size_t batchSize = 6;
+  vector<GPVPlaintext<NativePoly>> plaintexts(batchSize);
+  vector<GPVSignature<NativePoly>> signatures(batchSize);
+  vector<const LPSignPlaintext<NativePoly>*> pts;
+  vector<LPSignature<NativePoly>*> signs;
+  vector<const LPSignature<NativePoly>*> constSigns;
+  for (size_t i = 0; i < batchSize; i++) {
+    plaintexts[i].SetPlaintext("Audit log entry " + std::to_string(i));
+    pts.push_back(&plaintexts[i]);
+    signs.push_back(&signatures[i]);
+    constSigns.push_back(&signatures[i]);
+  }
+
+  DEBUG("Signing");
+  context.SignBatch(pts,sk,vk,signs);
+  DEBUG("Verification");
+  vector<bool> results = context.VerifyBatch(pts,constSigns,vk);
+  ASSERT_EQ(batchSize, results.size());
+  for (size_t i = 0; i < batchSize; i++) {
+    EXPECT_EQ(true, results[i]) << "Failed batch verification of text " << i;
+    EXPECT_EQ(true, context.Verify(plaintexts[i],signatures[i],vk)) << "Failed single verification of text " << i;
+  }
+
+  //Swap two signatures; only those two should fail
+  std::swap(constSigns[1], constSigns[4]);
+  results = context.VerifyBatch(pts,constSigns,vk);
+  for (size_t i = 0; i < batchSize; i++)
+    EXPECT_EQ(i != 1 && i != 4, results[i]) << "Wrong batch verification result for text " << i;
+}
+
 /*
 int main(int argc, char **argv) {
 	::testing::InitGoogleTest(&argc, argv);